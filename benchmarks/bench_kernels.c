@@ -0,0 +1,208 @@
+/**
+ * @file bench_kernels.c
+ * @brief Pricing and ratio-test kernel benchmark
+ *
+ * Times the scans of src/kernels at every level the CPU supports on
+ * synthetic vectors of n entries (default 1e6, first argument):
+ *
+ * - weighted pricing (d_j, w_j, status: 20 bytes per variable) and
+ *   Dantzig pricing (d_j, status: 12 bytes);
+ * - the two Harris passes over a dense pivot column (alpha_i and the
+ *   basic variable per row, then x, lb or ub gathered per blocking row),
+ *   and over a list of every fourth row in shuffled order.
+ *
+ * Each scan is repeated for at least MIN_BENCH_TIME seconds; the report
+ * gives the time per scan, the bytes streamed per second and the speedup
+ * over the scalar kernels. The results of all levels are checked against
+ * the scalar ones.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "convexfeld/cxf_types.h"
+#include "convexfeld/cxf_kernels.h"
+
+#define DEFAULT_N 1000000
+#define MIN_BENCH_TIME 0.2  /* Repeat each scan for at least this long */
+#define SPARSE_STRIDE 4     /* Sparse column: every SPARSE_STRIDE-th row */
+
+static const char *level_names[] = {"scalar", "avx2", "avx512"};
+
+static double get_time_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static unsigned seed = 12345u;
+
+static double uniform(void) {
+    seed = seed * 1103515245u + 12345u;
+    return (double)(seed >> 8) / 16777216.0;
+}
+
+/* Benchmark data */
+typedef struct {
+    int n;
+    double *dj, *weights;
+    int *status;
+    double *alpha, *x, *lb, *ub;
+    int *basic_vars, *rows;
+    int sparse_count;
+} BenchData;
+
+static int bench_alloc(BenchData *d, int n) {
+    d->n = n;
+    d->dj = malloc((size_t)n * sizeof(double));
+    d->weights = malloc((size_t)n * sizeof(double));
+    d->status = malloc((size_t)n * sizeof(int));
+    d->alpha = malloc((size_t)n * sizeof(double));
+    d->x = malloc((size_t)n * sizeof(double));
+    d->lb = malloc((size_t)n * sizeof(double));
+    d->ub = malloc((size_t)n * sizeof(double));
+    d->basic_vars = malloc((size_t)n * sizeof(int));
+    d->rows = malloc((size_t)n * sizeof(int));
+    if (!d->dj || !d->weights || !d->status || !d->alpha || !d->x ||
+        !d->lb || !d->ub || !d->basic_vars || !d->rows) {
+        return -1;
+    }
+
+    /* Pricing: a third basic, few attractive variables (late in a solve) */
+    for (int j = 0; j < n; j++) {
+        double u = uniform();
+        d->status[j] = (u < 0.33) ? j % 1000 : (u < 0.9) ? -1 : -2;
+        d->dj[j] = (uniform() - 0.05) * 10.0;
+        if (d->status[j] == -2) d->dj[j] = -d->dj[j];
+        d->weights[j] = 1.0 + 100.0 * uniform();
+    }
+
+    /* Ratio test: each row has its own basic variable, bounds mostly finite */
+    for (int i = 0; i < n; i++) {
+        d->alpha[i] = (uniform() < 0.5) ? 0.0 : uniform() * 2.0 - 1.0;
+        d->basic_vars[i] = (int)((i * 7919LL) % n);
+        d->lb[i] = (uniform() < 0.1) ? -CXF_INFINITY : 0.0;
+        d->ub[i] = (uniform() < 0.3) ? CXF_INFINITY : 10.0;
+        d->x[i] = 10.0 * uniform();
+    }
+    d->sparse_count = 0;
+    for (int i = 0; i < n; i += SPARSE_STRIDE) {
+        d->rows[d->sparse_count++] = i;
+    }
+    for (int k = d->sparse_count - 1; k > 0; k--) {
+        int r = (int)(uniform() * (double)(k + 1));
+        int t = d->rows[k];
+        d->rows[k] = d->rows[r];
+        d->rows[r] = t;
+    }
+    return 0;
+}
+
+static void bench_free(BenchData *d) {
+    free(d->dj);
+    free(d->weights);
+    free(d->status);
+    free(d->alpha);
+    free(d->x);
+    free(d->lb);
+    free(d->ub);
+    free(d->basic_vars);
+    free(d->rows);
+}
+
+/* One scan of the given kind; returns its result for the cross-check */
+static int run_scan(const BenchData *d, int kind) {
+    const CxfKernels *k = cxf_kernels();
+    CxfRatioScan scan = {d->alpha, NULL, d->n, d->basic_vars, d->x, d->lb, d->ub,
+                         d->n, CXF_INFINITY};
+    double ratio;
+    int row;
+    switch (kind) {
+    case 0:
+        return k->price(d->dj, d->weights, d->status, d->n, 1e-6, NULL);
+    case 1:
+        return k->price(d->dj, NULL, d->status, d->n, 1e-6, NULL);
+    case 2:
+    case 3:
+        if (kind == 3) {
+            scan.rows = d->rows;
+            scan.count = d->sparse_count;
+        }
+        row = k->ratio_min(&scan, 1e-9, 1e-6, &ratio);
+        if (row < 0) return -1;
+        return k->ratio_pivot(&scan, 1e-9, ratio + 1e-3, row);
+    default:
+        return -1;
+    }
+}
+
+int main(int argc, char **argv) {
+    int n = (argc > 1) ? atoi(argv[1]) : DEFAULT_N;
+    if (n <= 0) {
+        fprintf(stderr, "usage: %s [n]\n", argv[0]);
+        return 1;
+    }
+
+    BenchData data;
+    if (bench_alloc(&data, n) != 0) {
+        fprintf(stderr, "out of memory\n");
+        bench_free(&data);
+        return 1;
+    }
+
+    static const char *kinds[] = {
+        "price weighted", "price dantzig", "ratio dense", "ratio sparse"
+    };
+    /* Bytes streamed per scan: pricing reads every entry, the ratio test
+     * alpha and basic_vars per row plus x and one bound per blocking row */
+    double bytes[4] = {
+        (double)n * 20.0,
+        (double)n * 12.0,
+        (double)n * 12.0 + 0.5 * (double)n * 16.0,
+        (double)data.sparse_count * (16.0 + 0.5 * 16.0)
+    };
+
+    int top = cxf_kernel_level();
+    printf("Kernel benchmark: n = %d, widest level %s\n\n", n, level_names[top]);
+    printf("%-16s %-8s %12s %10s %9s\n", "scan", "level", "time/scan", "GB/s", "speedup");
+
+    int mismatches = 0;
+    for (int kind = 0; kind < 4; kind++) {
+        double scalar_time = 0.0;
+        int reference = 0;
+        for (int level = CXF_KERNEL_SCALAR; level <= top; level++) {
+            cxf_kernel_select(level);
+            int result = run_scan(&data, kind);
+            if (level == CXF_KERNEL_SCALAR) {
+                reference = result;
+            } else if (result != reference) {
+                mismatches++;
+            }
+
+            int reps = 0;
+            double start = get_time_sec();
+            double elapsed;
+            do {
+                run_scan(&data, kind);
+                reps++;
+                elapsed = get_time_sec() - start;
+            } while (elapsed < MIN_BENCH_TIME);
+            double per_scan = elapsed / reps;
+            if (level == CXF_KERNEL_SCALAR) {
+                scalar_time = per_scan;
+            }
+
+            printf("%-16s %-8s %10.3f ms %10.2f %8.2fx\n", kinds[kind],
+                   level_names[level], per_scan * 1e3, bytes[kind] / per_scan * 1e-9,
+                   scalar_time / per_scan);
+        }
+    }
+
+    if (mismatches > 0) {
+        printf("\n%d result mismatches against the scalar kernels\n", mismatches);
+    }
+    bench_free(&data);
+    return mismatches > 0 ? 1 : 0;
+}
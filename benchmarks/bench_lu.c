@@ -0,0 +1,607 @@
+/**
+ * @file bench_lu.c
+ * @brief Basis LU factorization benchmark on Netlib models
+ *
+ * For every Netlib model, builds a structural-heavy basis and times
+ * cxf_lu_factorize on it. Reports basis size, fill, time per
+ * factorization and the scaled FTRAN residual
+ * ||B x - b||_inf / (||B||_inf ||x||_inf + ||b||_inf) as a sanity check;
+ * the scaling keeps ill-conditioned bases from tripping the check.
+ *
+ * It then applies a run of basis updates (nonbasic structurals replacing
+ * the position of their largest pivot entry) with both the PFI eta chain
+ * and the Forrest-Tomlin update, and reports the FTRAN+BTRAN time after
+ * the updates relative to the time on the fresh factors.
+ *
+ * Unit-vector FTRAN/BTRAN on the fresh factors are also timed with the
+ * hypersparse solves enabled and disabled, reporting the speedup, and
+ * BTRAN of a right-hand side with every BTRAN_RHS_STRIDE-th entry set is
+ * timed with the row-wise and the column-wise sweeps. The same kind of
+ * right-hand sides, CXF_SOLVE_MULTI_LANES at a time, are solved one by
+ * one and with cxf_ftran_multi/cxf_btran_multi. Dense FTRAN+BTRAN are
+ * timed with fp64 factors and in mixed-precision mode (float32 sweeps
+ * plus fp64 refinement), with the residual of each. Finally the
+ * factorization is timed with the dense bump kernel disabled, enabled,
+ * and enabled with DENSE_THREADS threads.
+ *
+ * The solver does not export its final basis, so the basis is built by
+ * greedily matching each structural column to its largest uncovered row
+ * entry and covering the remaining rows with slacks. Columns that the
+ * factorization cannot pivot (numerical rank deficiency) are swapped for
+ * slacks of the unpivoted rows by the factorization's singular-basis
+ * repair.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <dirent.h>
+#include "convexfeld/convexfeld.h"
+#include "convexfeld/cxf_mps.h"
+#include "convexfeld/cxf_basis.h"
+#include "convexfeld/cxf_matrix.h"
+#include "convexfeld/cxf_solver.h"
+
+#define MAX_NAME_LEN 64
+#define MIN_BENCH_TIME 0.2  /* Repeat factorization for at least this long */
+#define MIN_SOLVE_TIME 0.05 /* Repeat solves for at least this long */
+#define DEFAULT_UPDATES 200
+#define BTRAN_RHS_STRIDE 8
+#define DENSE_THREADS 4
+
+/* Internal entry points */
+int cxf_solver_refactor(SolverContext *ctx, CxfEnv *env);
+int cxf_lu_factorize(LUFactors *lu, SolverContext *ctx);
+int cxf_ftran(BasisState *basis, const double *column, double *result);
+int cxf_btran_vec(BasisState *basis, const double *input, double *result);
+int cxf_btran(BasisState *basis, int row, double *result);
+int cxf_pivot_with_eta(BasisState *basis, int pivotRow, const double *pivotCol,
+                       int enteringVar, int leavingVar);
+int cxf_ftran_multi(BasisState *basis, int k, const double *columns, double *result);
+int cxf_btran_multi(BasisState *basis, int k, const double *input, double *result);
+int cxf_set_thread_count(CxfEnv *env, int thread_count);
+
+static double get_time_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Greedy structural basis: match columns to largest uncovered row.
+ * @return Number of structural columns in the basis.
+ */
+static int build_structural_basis(SolverContext *ctx) {
+    int n = ctx->num_vars;
+    int m = ctx->num_constrs;
+    SparseMatrix *A = ctx->model_ref->matrix;
+    int *row_owner = (int *)malloc((size_t)m * sizeof(int));
+    int structurals = 0;
+
+    for (int i = 0; i < m; i++) row_owner[i] = -1;
+
+    for (int j = 0; j < n; j++) {
+        int best = -1;
+        double best_abs = 0.0;
+        for (int64_t p = A->col_ptr[j]; p < A->col_ptr[j + 1]; p++) {
+            int i = A->row_idx[p];
+            double a = fabs(A->values[p]);
+            if (row_owner[i] < 0 && a > best_abs) {
+                best_abs = a;
+                best = i;
+            }
+        }
+        if (best >= 0 && best_abs > 1e-3) {
+            row_owner[best] = j;
+            structurals++;
+        }
+    }
+
+    /* Basis position i holds the column matched to row i (or its slack) */
+    for (int i = 0; i < m; i++) {
+        ctx->basis->basic_vars[i] = (row_owner[i] >= 0) ? row_owner[i] : n + i;
+    }
+
+    free(row_owner);
+    return structurals;
+}
+
+/**
+ * @brief Factor the basis once; cxf_lu_factorize hands the positions that
+ *        find no pivot to slacks.
+ * @return Number of structural columns left in the basis, or -1.
+ */
+static int repair_basis(SolverContext *ctx, int structurals) {
+    int n = ctx->num_vars;
+    int m = ctx->num_constrs;
+    LUFactors *lu = cxf_lu_create(m, 2 * (int64_t)m, 2 * (int64_t)m);
+    int result = -1;
+
+    if (lu != NULL && cxf_lu_factorize(lu, ctx) == 0) {
+        result = structurals;
+        for (int k = 0; k < lu->repairs; k++) {
+            if (lu->repair_var[k] < n) result--;
+        }
+    }
+
+    cxf_lu_free(lu);
+    return result;
+}
+
+/**
+ * @brief Scaled FTRAN residual for b = (1, 2, ..., m) / m.
+ * @return Residual (0 without rows, HUGE_VAL if out of memory).
+ */
+static double ftran_residual(SolverContext *ctx) {
+    int n = ctx->num_vars;
+    int m = ctx->num_constrs;
+    if (m <= 0) {
+        return 0.0;
+    }
+
+    SparseMatrix *A = ctx->model_ref->matrix;
+    double *b = (double *)malloc((size_t)m * sizeof(double));
+    double *x = (double *)malloc((size_t)m * sizeof(double));
+    double *r = (double *)calloc((size_t)m, sizeof(double));
+    double *row_abs = (double *)calloc((size_t)m, sizeof(double));
+    if (b == NULL || x == NULL || r == NULL || row_abs == NULL) {
+        free(b); free(x); free(r); free(row_abs);
+        return HUGE_VAL;
+    }
+    double res = 0.0;
+    double norm_B = 0.0;
+    double norm_x = 0.0;
+
+    for (int i = 0; i < m; i++) b[i] = (double)(i + 1) / (double)m;
+    cxf_ftran(ctx->basis, b, x);
+
+    for (int j = 0; j < m; j++) {
+        int var = ctx->basis->basic_vars[j];
+        if (var < n) {
+            for (int64_t p = A->col_ptr[var]; p < A->col_ptr[var + 1]; p++) {
+                r[A->row_idx[p]] += A->values[p] * x[j];
+                row_abs[A->row_idx[p]] += fabs(A->values[p]);
+            }
+        } else {
+            r[var - n] += ctx->basis->diag_coeff[var - n] * x[j];
+            row_abs[var - n] += fabs(ctx->basis->diag_coeff[var - n]);
+        }
+        if (fabs(x[j]) > norm_x) norm_x = fabs(x[j]);
+    }
+    for (int i = 0; i < m; i++) {
+        double d = fabs(r[i] - b[i]);
+        if (d > res) res = d;
+        if (row_abs[i] > norm_B) norm_B = row_abs[i];
+    }
+
+    free(b); free(x); free(r); free(row_abs);
+    return res / (norm_B * norm_x + 1.0);
+}
+
+/**
+ * @brief Time one FTRAN plus one BTRAN on the current factors.
+ * @return Seconds per FTRAN+BTRAN pair.
+ */
+static double solve_time(SolverContext *ctx, double *b, double *x) {
+    int reps = 0;
+    double t0 = get_time_sec();
+    double elapsed = 0.0;
+    do {
+        cxf_ftran(ctx->basis, b, x);
+        cxf_btran_vec(ctx->basis, b, x);
+        reps++;
+        elapsed = get_time_sec() - t0;
+    } while (elapsed < MIN_SOLVE_TIME);
+    return elapsed / reps;
+}
+
+/**
+ * @brief Time FTRAN of unit columns and BTRAN of unit rows.
+ *
+ * @param threshold Hypersparse density threshold (negative disables).
+ * @return Seconds per FTRAN+BTRAN pair.
+ */
+static double unit_solve_time(SolverContext *ctx, double threshold) {
+    BasisState *basis = ctx->basis;
+    int m = ctx->num_constrs;
+    double *e = (double *)calloc((size_t)m, sizeof(double));
+    double *x = (double *)malloc((size_t)m * sizeof(double));
+    if (e == NULL || x == NULL) {
+        free(e);
+        free(x);
+        return 0.0;
+    }
+
+    basis->lu->hyper_threshold = threshold;
+    basis->lu->ftran_density = basis->lu->btran_density = 0.0;
+    int reps = 0;
+    double t0 = get_time_sec();
+    double elapsed = 0.0;
+    do {
+        int i = (int)(((int64_t)reps * 7919) % m);
+        e[i] = 1.0;
+        cxf_ftran(basis, e, x);
+        e[i] = 0.0;
+        cxf_btran(basis, i, x);
+        reps++;
+        elapsed = get_time_sec() - t0;
+    } while (elapsed < MIN_SOLVE_TIME);
+    basis->lu->hyper_threshold = CXF_HYPER_DENSITY;
+
+    free(e);
+    free(x);
+    return elapsed / reps;
+}
+
+/**
+ * @brief Time BTRAN of a moderately sparse right-hand side.
+ *
+ * @param threshold Row-wise sweep density threshold (negative disables).
+ * @return Seconds per BTRAN.
+ */
+static double btran_sweep_time(SolverContext *ctx, double threshold) {
+    BasisState *basis = ctx->basis;
+    int m = ctx->num_constrs;
+    double *b = (double *)calloc((size_t)m, sizeof(double));
+    double *y = (double *)malloc((size_t)m * sizeof(double));
+    if (b == NULL || y == NULL) {
+        free(b);
+        free(y);
+        return 0.0;
+    }
+    for (int i = 0; i < m; i += BTRAN_RHS_STRIDE) {
+        b[i] = 1.0;
+    }
+
+    basis->lu->hyper_threshold = -1.0;
+    basis->lu->rowwise_threshold = threshold;
+    basis->lu->btran_density = 0.0;
+    int reps = 0;
+    double t0 = get_time_sec();
+    double elapsed = 0.0;
+    do {
+        cxf_btran_vec(basis, b, y);
+        reps++;
+        elapsed = get_time_sec() - t0;
+    } while (elapsed < MIN_SOLVE_TIME);
+    basis->lu->hyper_threshold = CXF_HYPER_DENSITY;
+    basis->lu->rowwise_threshold = CXF_ROWWISE_DENSITY;
+
+    free(b);
+    free(y);
+    return elapsed / reps;
+}
+
+/**
+ * @brief Time FTRAN+BTRAN of CXF_SOLVE_MULTI_LANES right-hand sides.
+ *
+ * Vector j has every BTRAN_RHS_STRIDE-th entry set, starting at entry j.
+ *
+ * @param multi 1 for one multi-vector call each, 0 for one call per vector.
+ * @return Seconds per batch.
+ */
+static double multi_solve_time(SolverContext *ctx, int multi) {
+    BasisState *basis = ctx->basis;
+    int m = ctx->num_constrs;
+    int k = CXF_SOLVE_MULTI_LANES;
+    double *b = (double *)calloc((size_t)m * (size_t)k, sizeof(double));
+    double *x = (double *)malloc((size_t)m * (size_t)k * sizeof(double));
+    if (b == NULL || x == NULL) {
+        free(b);
+        free(x);
+        return 0.0;
+    }
+    for (int j = 0; j < k; j++) {
+        for (int i = j % m; i < m; i += BTRAN_RHS_STRIDE) {
+            b[(size_t)j * (size_t)m + (size_t)i] = 1.0;
+        }
+    }
+
+    int reps = 0;
+    double t0 = get_time_sec();
+    double elapsed = 0.0;
+    do {
+        if (multi) {
+            cxf_ftran_multi(basis, k, b, x);
+            cxf_btran_multi(basis, k, b, x);
+        } else {
+            for (int j = 0; j < k; j++) {
+                cxf_ftran(basis, b + (size_t)j * (size_t)m, x + (size_t)j * (size_t)m);
+                cxf_btran_vec(basis, b + (size_t)j * (size_t)m, x + (size_t)j * (size_t)m);
+            }
+        }
+        reps++;
+        elapsed = get_time_sec() - t0;
+    } while (elapsed < MIN_SOLVE_TIME);
+
+    free(b);
+    free(x);
+    return elapsed / reps;
+}
+
+/**
+ * @brief Time dense FTRAN+BTRAN with fp64 factors or in mixed precision.
+ *
+ * Refactors with the mode switched, then restores the fp64 factors.
+ *
+ * @param mixed 1 for float32 sweeps with fp64 refinement, 0 for fp64.
+ * @param res Scaled FTRAN residual in that mode.
+ * @param fallback Set to 1 if refinement fell back to the fp64 factors.
+ * @return Seconds per FTRAN+BTRAN pair.
+ */
+static double mixed_solve_time(SolverContext *ctx, CxfEnv *env, int mixed,
+                               double *res, int *fallback) {
+    BasisState *basis = ctx->basis;
+    int m = ctx->num_constrs;
+    double *b = (double *)malloc((size_t)m * sizeof(double));
+    double *x = (double *)malloc((size_t)m * sizeof(double));
+    double t = 0.0;
+
+    *res = 0.0;
+    *fallback = 0;
+    basis->mixed_precision = mixed;
+    if (b != NULL && x != NULL && cxf_solver_refactor(ctx, env) == 0) {
+        basis->lu->hyper_threshold = -1.0;
+        for (int i = 0; i < m; i++) b[i] = (double)(i + 1) / (double)m;
+        t = solve_time(ctx, b, x);
+        *res = ftran_residual(ctx);
+        *fallback = mixed && !(basis->lu->single_L || basis->lu->single_U);
+        basis->lu->hyper_threshold = CXF_HYPER_DENSITY;
+    }
+    basis->mixed_precision = 0;
+    cxf_solver_refactor(ctx, env);
+
+    free(b);
+    free(x);
+    return t;
+}
+
+/**
+ * @brief Apply basis updates with the given method and time the solves.
+ *
+ * Restores the starting basis and its factorization afterwards.
+ *
+ * @return Solve time after the updates relative to the fresh factors,
+ *         or -1 if the run failed.
+ */
+/**
+ * @brief Seconds per refactorization with the given dense switch size
+ *        (0 disables the dense kernel) and thread count.
+ */
+static double refactor_time(SolverContext *ctx, CxfEnv *env, int dense_min,
+                            int threads) {
+    int saved = env->thread_count;
+    cxf_set_thread_count(env, threads);
+    ctx->basis->lu->dense_min = dense_min;
+
+    int reps = 0;
+    double t0 = get_time_sec();
+    double elapsed = 0.0;
+    do {
+        if (cxf_solver_refactor(ctx, env) != 0) break;
+        reps++;
+        elapsed = get_time_sec() - t0;
+    } while (elapsed < MIN_BENCH_TIME);
+
+    ctx->basis->lu->dense_min = CXF_LU_DENSE_MIN;
+    env->thread_count = saved;
+    cxf_solver_refactor(ctx, env);
+    return (reps > 0) ? elapsed / reps : 0.0;
+}
+
+static double bench_updates(SolverContext *ctx, CxfEnv *env, int method,
+                            int num_updates, int *applied) {
+    BasisState *basis = ctx->basis;
+    int n = ctx->num_vars;
+    int m = ctx->num_constrs;
+    SparseMatrix *A = ctx->model_ref->matrix;
+    int *saved = (int *)malloc((size_t)m * sizeof(int));
+    double *a = (double *)calloc((size_t)m, sizeof(double));
+    double *alpha = (double *)malloc((size_t)m * sizeof(double));
+    double ratio = -1.0;
+
+    *applied = 0;
+    if (saved == NULL || a == NULL || alpha == NULL) goto done;
+    memcpy(saved, basis->basic_vars, (size_t)m * sizeof(int));
+
+    for (int j = 0; j < n + m; j++) basis->var_status[j] = -1;
+    for (int i = 0; i < m; i++) basis->var_status[basis->basic_vars[i]] = i;
+
+    basis->update_method = method;
+    if (cxf_solver_refactor(ctx, env) != 0) goto done;
+
+    for (int i = 0; i < m; i++) a[i] = (double)(i + 1) / (double)m;
+    double fresh = solve_time(ctx, a, alpha);
+
+    /* Walk the structurals with a stride so updates spread over the basis */
+    int j = 0;
+    for (int tries = 0; tries < n && *applied < num_updates; tries++) {
+        j = (j + 7919) % n;
+        if (basis->var_status[j] >= 0) continue;
+
+        memset(a, 0, (size_t)m * sizeof(double));
+        for (int64_t p = A->col_ptr[j]; p < A->col_ptr[j + 1]; p++) {
+            a[A->row_idx[p]] = A->values[p];
+        }
+        cxf_ftran(basis, a, alpha);
+
+        int r = 0;
+        for (int i = 1; i < m; i++) {
+            if (fabs(alpha[i]) > fabs(alpha[r])) r = i;
+        }
+        if (fabs(alpha[r]) < 1e-3) continue;
+        if (cxf_pivot_with_eta(basis, r, alpha, j, basis->basic_vars[r]) != CXF_OK) {
+            break;
+        }
+        (*applied)++;
+    }
+
+    for (int i = 0; i < m; i++) a[i] = (double)(i + 1) / (double)m;
+    ratio = solve_time(ctx, a, alpha) / fresh;
+
+    memcpy(basis->basic_vars, saved, (size_t)m * sizeof(int));
+    cxf_solver_refactor(ctx, env);
+
+done:
+    free(saved);
+    free(a);
+    free(alpha);
+    return ratio;
+}
+
+static void run_benchmark(const char *mps_path, const char *name,
+                          int num_updates, int *failures) {
+    CxfEnv *env = NULL;
+    CxfModel *model = NULL;
+    SolverContext *ctx = NULL;
+
+    if (cxf_loadenv(&env, NULL) != CXF_OK) return;
+    if (cxf_newmodel(env, &model, name, 0, NULL, NULL, NULL, NULL, NULL) != CXF_OK ||
+        cxf_readmps(model, mps_path) != CXF_OK || model->num_constrs == 0 ||
+        cxf_simplex_init(model, &ctx) != CXF_OK) {
+        printf("  %-12s SKIP\n", name);
+        cxf_freemodel(model);
+        cxf_freeenv(env);
+        return;
+    }
+
+    int m = ctx->num_constrs;
+    int structurals = repair_basis(ctx, build_structural_basis(ctx));
+
+    int64_t nnz_B = 0;
+    for (int j = 0; j < m; j++) {
+        int var = ctx->basis->basic_vars[j];
+        nnz_B += (var < ctx->num_vars) ?
+            model->matrix->col_ptr[var + 1] - model->matrix->col_ptr[var] : 1;
+    }
+
+    int reps = 0;
+    int status = 0;
+    double t0 = get_time_sec();
+    double elapsed = 0.0;
+    do {
+        status = cxf_solver_refactor(ctx, env);
+        reps++;
+        elapsed = get_time_sec() - t0;
+    } while (status == 0 && elapsed < MIN_BENCH_TIME);
+
+    if (status != 0) {
+        printf("  %-12s m=%6d struct=%6d nnz(B)=%8lld  SINGULAR (%d)\n",
+               name, m, structurals, (long long)nnz_B, status);
+    } else {
+        LUFactors *lu = ctx->basis->lu;
+        double res = ftran_residual(ctx);
+        printf("  %-12s m=%6d struct=%6d nnz(B)=%8lld nnz(L+U)=%9lld bump=%6d dense=%6d  %9.3f ms  res=%.1e\n",
+               name, m, structurals, (long long)nnz_B,
+               (long long)(lu->L_nnz + lu->U_nnz + m), lu->bump_size,
+               lu->dense_size, 1e3 * elapsed / reps, res);
+        if (!(res < 1e-6)) (*failures)++;
+
+        double dense = unit_solve_time(ctx, -1.0);
+        double hyper = unit_solve_time(ctx, CXF_HYPER_DENSITY);
+        printf("  %-12s   unit FTRAN+BTRAN: %8.2f us dense  %8.2f us hypersparse  x%.2f\n",
+               "", 1e6 * dense, 1e6 * hyper, (hyper > 0.0) ? dense / hyper : 0.0);
+
+        double cols = btran_sweep_time(ctx, -1.0);
+        double rows = btran_sweep_time(ctx, 1.0);
+        printf("  %-12s   BTRAN 1/%d rhs:    %8.2f us columns %8.2f us rows         x%.2f\n",
+               "", BTRAN_RHS_STRIDE, 1e6 * cols, 1e6 * rows, (rows > 0.0) ? cols / rows : 0.0);
+
+        double single = multi_solve_time(ctx, 0);
+        double batch = multi_solve_time(ctx, 1);
+        printf("  %-12s   %d x FTRAN+BTRAN:   %8.2f us single  %8.2f us multi          x%.2f\n",
+               "", CXF_SOLVE_MULTI_LANES, 1e6 * single, 1e6 * batch,
+               (batch > 0.0) ? single / batch : 0.0);
+
+        double res64 = 0.0, res32 = 0.0;
+        int fell_back = 0;
+        double fp64 = mixed_solve_time(ctx, env, 0, &res64, &fell_back);
+        double fp32 = mixed_solve_time(ctx, env, 1, &res32, &fell_back);
+        printf("  %-12s   dense FTRAN+BTRAN:  %8.2f us fp64    %8.2f us mixed          x%.2f  res=%.1e/%.1e%s\n",
+               "", 1e6 * fp64, 1e6 * fp32, (fp32 > 0.0) ? fp64 / fp32 : 0.0,
+               res64, res32, fell_back ? "  (fell back to fp64)" : "");
+        if (!(res32 < 1e-6)) (*failures)++;
+
+        if (lu->dense_size > 0) {
+            double sparse = refactor_time(ctx, env, 0, 1);
+            double dense1 = refactor_time(ctx, env, CXF_LU_DENSE_MIN, 1);
+            double denseN = refactor_time(ctx, env, CXF_LU_DENSE_MIN, DENSE_THREADS);
+            printf("  %-12s   refactor:          %8.3f ms sparse  %8.3f ms dense  %8.3f ms dense x%d threads\n",
+                   "", 1e3 * sparse, 1e3 * dense1, 1e3 * denseN, DENSE_THREADS);
+        }
+
+        if (num_updates > 0) {
+            int pfi_applied = 0;
+            int ft_applied = 0;
+            double pfi = bench_updates(ctx, env, CXF_BASIS_UPDATE_PFI,
+                                       num_updates, &pfi_applied);
+            double ft = bench_updates(ctx, env, CXF_BASIS_UPDATE_FT,
+                                      num_updates, &ft_applied);
+            printf("  %-12s   after %4d updates: solve time x%.2f (PFI)  x%.2f (FT)\n",
+                   "", ft_applied, pfi, ft);
+        }
+    }
+
+    cxf_simplex_final(ctx);
+    cxf_freemodel(model);
+    cxf_freeenv(env);
+}
+
+int main(int argc, char **argv) {
+    const char *mps_dir = "benchmarks/netlib/feasible";
+    const char *filter = NULL;
+    int num_updates = DEFAULT_UPDATES;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--dir") == 0 && i + 1 < argc) {
+            mps_dir = argv[++i];
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (strcmp(argv[i], "--updates") == 0 && i + 1 < argc) {
+            num_updates = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--help") == 0) {
+            printf("Usage: %s [--dir DIR] [--filter NAME] [--updates N]\n", argv[0]);
+            printf("  --dir DIR     Directory with .mps files (default: %s)\n", mps_dir);
+            printf("  --filter NAME Only run models containing NAME\n");
+            printf("  --updates N   Basis updates per model (default: %d, 0 to skip)\n",
+                   DEFAULT_UPDATES);
+            return 0;
+        }
+    }
+
+    printf("ConvexFeld Basis LU Benchmark\n");
+    printf("=============================\n");
+
+    DIR *dir = opendir(mps_dir);
+    if (!dir) {
+        fprintf(stderr, "Cannot open directory: %s\n", mps_dir);
+        return 1;
+    }
+
+    int failures = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        const char *fname = entry->d_name;
+        size_t len = strlen(fname);
+        if (len < 5 || strcmp(fname + len - 4, ".mps") != 0) continue;
+
+        char prob_name[MAX_NAME_LEN];
+        size_t name_len = len - 4 < MAX_NAME_LEN - 1 ? len - 4 : MAX_NAME_LEN - 1;
+        memcpy(prob_name, fname, name_len);
+        prob_name[name_len] = '\0';
+
+        if (filter && strstr(prob_name, filter) == NULL) continue;
+
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", mps_dir, fname);
+        run_benchmark(path, prob_name, num_updates, &failures);
+    }
+    closedir(dir);
+
+    printf("\nResidual failures: %d\n", failures);
+    return failures > 0 ? 1 : 0;
+}
@@ -30,6 +30,7 @@ typedef struct {
 
 static Problem g_problems[MAX_PROBLEMS];
 static int g_num_problems = 0;
+static int g_method = 0;
 
 static int load_reference_solutions(const char *csv_path) {
     FILE *f = fopen(csv_path, "r");
@@ -110,6 +111,7 @@ static void run_benchmark(const char *mps_path, const char *name, Stats *stats)
         stats->errors++;
         return;
     }
+    cxf_setintparam(env, "Method", g_method);
 
     rc = cxf_newmodel(env, &model, name, 0, NULL, NULL, NULL, NULL, NULL);
     if (rc != CXF_OK) {
@@ -177,11 +179,14 @@ int main(int argc, char **argv) {
             csv_path = argv[++i];
         } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
             filter = argv[++i];
+        } else if (strcmp(argv[i], "--method") == 0 && i + 1 < argc) {
+            g_method = atoi(argv[++i]);
         } else if (strcmp(argv[i], "--help") == 0) {
-            printf("Usage: %s [--dir DIR] [--csv CSV] [--filter NAME]\n", argv[0]);
+            printf("Usage: %s [--dir DIR] [--csv CSV] [--filter NAME] [--method M]\n", argv[0]);
             printf("  --dir DIR     Directory with .mps files (default: %s)\n", mps_dir);
             printf("  --csv CSV     Reference solutions CSV (default: %s)\n", csv_path);
             printf("  --filter NAME Only run benchmarks containing NAME\n");
+            printf("  --method M    Simplex algorithm: 0=primal (default), 1=dual\n");
             return 0;
         }
     }
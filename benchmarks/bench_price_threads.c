@@ -0,0 +1,165 @@
+/**
+ * @file bench_price_threads.c
+ * @brief Column-wise pivot row PRICE over a worker pool
+ *
+ * Times cxf_price_row with a dense rho (the column-wise kernel) on a
+ * synthetic wide matrix of m rows and n columns (defaults 200 and 200000,
+ * each column with COL_NNZ entries in random rows), sequentially and over
+ * pools of 2, 4, ... threads up to the number of logical processors (or
+ * the third argument). A third of the columns are basic.
+ *
+ * Each PRICE is repeated for at least MIN_BENCH_TIME seconds; the report
+ * gives the time per PRICE and the speedup over the sequential one. The
+ * pivot row of every thread count, index order included, is checked to
+ * be bit-identical to the sequential one.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "convexfeld/cxf_types.h"
+#include "convexfeld/cxf_matrix.h"
+
+#define DEFAULT_M 200
+#define DEFAULT_N 200000
+#define COL_NNZ 8           /* Entries per column */
+#define MIN_BENCH_TIME 0.3  /* Repeat each PRICE for at least this long */
+
+SparseMatrix *cxf_sparse_create(void);
+void cxf_sparse_free(SparseMatrix *mat);
+int cxf_sparse_init_csc(SparseMatrix *mat, int num_rows, int num_cols, int64_t nnz);
+PriceRows *cxf_price_rows_create(const SparseMatrix *matrix);
+void cxf_price_rows_free(PriceRows *rows);
+void cxf_price_rows_sync(PriceRows *rows, const int *var_status);
+int cxf_price_row(PriceRows *rows, const SparseMatrix *matrix,
+                  const int *var_status, const double *slack_coeff,
+                  const double *rho, VectorContainer *alpha);
+VectorContainer *cxf_vector_create(int dim);
+void cxf_vector_free(VectorContainer *vec);
+CxfThreadPool *cxf_pool_create(int threads);
+void cxf_pool_free(CxfThreadPool *pool);
+int cxf_pool_size(const CxfThreadPool *pool);
+int cxf_get_logical_processors(void);
+
+static double get_time_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static unsigned seed = 12345u;
+
+static unsigned next_rand(void) {
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+static SparseMatrix *make_matrix(int m, int n) {
+    SparseMatrix *mat = cxf_sparse_create();
+    if (mat == NULL || cxf_sparse_init_csc(mat, m, n, (int64_t)n * COL_NNZ) != CXF_OK) {
+        cxf_sparse_free(mat);
+        return NULL;
+    }
+    int nnz = (COL_NNZ < m) ? COL_NNZ : m;
+    int64_t p = 0;
+    for (int j = 0; j < n; j++) {
+        mat->col_ptr[j] = p;
+        /* Distinct rows: a random start and a stride */
+        int row = (int)(next_rand() % (unsigned)m);
+        int stride = 1 + (int)(next_rand() % (unsigned)((m - 1) / nnz + 1));
+        for (int k = 0; k < nnz; k++) {
+            mat->row_idx[p] = (row + k * stride) % m;
+            mat->values[p] = 1.0 + (double)(next_rand() % 1000) / 100.0;
+            p++;
+        }
+    }
+    mat->col_ptr[n] = p;
+    mat->nnz = p;
+    return mat;
+}
+
+int main(int argc, char **argv) {
+    int m = (argc > 1) ? atoi(argv[1]) : DEFAULT_M;
+    int n = (argc > 2) ? atoi(argv[2]) : DEFAULT_N;
+    int max_threads = (argc > 3) ? atoi(argv[3]) : cxf_get_logical_processors();
+    if (m <= 1 || n <= 0 || max_threads < 1) {
+        fprintf(stderr, "usage: %s [m] [n] [max_threads]\n", argv[0]);
+        return 1;
+    }
+
+    SparseMatrix *mat = make_matrix(m, n);
+    PriceRows *rows = mat ? cxf_price_rows_create(mat) : NULL;
+    VectorContainer *alpha = cxf_vector_create(n + m);
+    VectorContainer *ref = cxf_vector_create(n + m);
+    int *status = malloc((size_t)(n + m) * sizeof(int));
+    double *rho = malloc((size_t)m * sizeof(double));
+    if (rows == NULL || alpha == NULL || ref == NULL || status == NULL || rho == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (int j = 0; j < n + m; j++) {
+        status[j] = (next_rand() % 3 == 0) ? 0 : -1;
+    }
+    for (int i = 0; i < m; i++) {
+        rho[i] = (double)((int)(next_rand() % 2001) - 1000) / 1000.0;
+    }
+    cxf_price_rows_sync(rows, status);
+
+    printf("PRICE benchmark: m = %d, n = %d, %d entries per column\n\n", m, n, COL_NNZ);
+    printf("%8s %12s %9s\n", "threads", "time/price", "speedup");
+
+    double serial_time = 0.0;
+    int mismatches = 0;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        CxfThreadPool *pool = cxf_pool_create(threads);
+        if (threads > 1 && pool == NULL) {
+            printf("%8d  (no worker threads in this build)\n", threads);
+            break;
+        }
+        rows->pool = pool;
+
+        VectorContainer *out = (threads == 1) ? ref : alpha;
+        if (cxf_price_row(rows, mat, status, NULL, rho, out) != CXF_PRICE_COLUMN) {
+            fprintf(stderr, "rho not priced column-wise\n");
+            return 1;
+        }
+        if (threads > 1 &&
+            (out->size != ref->size ||
+             memcmp(out->indices, ref->indices, (size_t)ref->size * sizeof(int)) != 0 ||
+             memcmp(out->values, ref->values, (size_t)(n + m) * sizeof(double)) != 0)) {
+            mismatches++;
+        }
+
+        int reps = 0;
+        double start = get_time_sec();
+        double elapsed;
+        do {
+            cxf_price_row(rows, mat, status, NULL, rho, out);
+            reps++;
+            elapsed = get_time_sec() - start;
+        } while (elapsed < MIN_BENCH_TIME);
+        double per_price = elapsed / reps;
+        if (threads == 1) {
+            serial_time = per_price;
+        }
+        printf("%8d %10.3f ms %8.2fx\n", cxf_pool_size(pool), per_price * 1e3,
+               serial_time / per_price);
+
+        rows->pool = NULL;
+        cxf_pool_free(pool);
+    }
+
+    if (mismatches > 0) {
+        printf("\n%d thread counts differ from the sequential pivot row\n", mismatches);
+    }
+    free(rho);
+    free(status);
+    cxf_vector_free(ref);
+    cxf_vector_free(alpha);
+    cxf_price_rows_free(rows);
+    cxf_sparse_free(mat);
+    return mismatches > 0 ? 1 : 0;
+}
@@ -11,6 +11,10 @@
 
 #include "cxf_types.h"
 
+/** Basis update methods (BasisUpdate parameter) */
+#define CXF_BASIS_UPDATE_PFI 0  /**< Append a column eta per pivot */
+#define CXF_BASIS_UPDATE_FT  1  /**< Forrest-Tomlin update of the U factor */
+
 /**
  * @brief LU factorization storage for basis matrix.
  *
@@ -19,7 +23,30 @@
  * - L is lower triangular with unit diagonal (diagonal implicit)
  * - U is upper triangular with explicit diagonal
  *
- * Both L and U are stored in column-wise sparse format (CSC).
+ * Both L and U are stored in column-wise sparse format (CSC) indexed by
+ * elimination step: column k of L holds the multipliers of pivot k with
+ * row indices > k, column k of U holds the entries above the diagonal
+ * with row indices < k.
+ *
+ * Forrest-Tomlin updates (cxf_lu_ft_update) modify U in place: column k
+ * of U occupies U_col_len[k] entries starting at U_col_ptr[k], U is upper
+ * triangular with respect to the pivot order U_seq rather than step
+ * order, and the row transformations of each update are kept in the
+ * row-eta file R. After a fresh factorization U_seq is the identity and
+ * R is empty.
+ *
+ * Row-wise copies of L and U (Lr, Ur) serve the transposed solves of
+ * BTRAN and the row gathers of the update; Ur is maintained by every
+ * update. Lr is only built when rowwise is set; without it BTRAN always
+ * runs the column-wise sweep. The hs_* arrays are workspace for the hypersparse solves, which
+ * only visit the columns reachable from the nonzeros of the right-hand
+ * side (cxf_lu_hyper_solve).
+ *
+ * In mixed-precision mode (single set) the factor values are also kept
+ * as float32 copies, which the dense FTRAN/BTRAN sweeps read instead of
+ * the fp64 values; the solves then refine their results in fp64 against
+ * the basis columns. The U copies go stale at the first Forrest-Tomlin
+ * update (single_U cleared), the L copies at the next factorization.
  */
 typedef struct LUFactors {
     /* L factor (unit diagonal implicit) */
@@ -27,6 +54,7 @@ typedef struct LUFactors {
     int *L_row_idx;       /**< Row indices for L [L_nnz] */
     double *L_values;     /**< Values for L [L_nnz] (unit diag implicit) */
     int64_t L_nnz;        /**< Number of nonzeros in L (excluding diagonal) */
+    int64_t L_capacity;   /**< Allocated length of L_row_idx/L_values */
 
     /* U factor (explicit diagonal) */
     int64_t *U_col_ptr;   /**< Column pointers for U [m+1] */
@@ -34,13 +62,84 @@ typedef struct LUFactors {
     double *U_values;     /**< Values for U [U_nnz] */
     double *U_diag;       /**< Diagonal elements of U [m] */
     int64_t U_nnz;        /**< Number of nonzeros in U (excluding diagonal) */
+    int64_t U_capacity;   /**< Allocated length of U_row_idx/U_values */
+    int *U_col_len;       /**< Entries in each U column [m] */
+    int64_t U_used;       /**< Used length of U storage, including holes */
+    int *U_seq;           /**< Pivot order of U [m]: U_seq[p] = step */
+    int *U_seq_pos;       /**< Inverse of U_seq [m] */
+
+    /* Forrest-Tomlin row-eta file: R_j adds -sum(R_val * v[R_idx]) to v[R_pivot] */
+    int R_count;          /**< Number of row etas (= updates since refactor) */
+    int R_capacity;       /**< Allocated length of R_pivot/R_start */
+    int *R_pivot;         /**< Step modified by each row eta [R_capacity] */
+    int64_t *R_start;     /**< Start of each row eta in R_idx/R_val [R_capacity+1] */
+    int *R_idx;           /**< Step indices of row eta entries */
+    double *R_val;        /**< Multipliers of row eta entries */
+    int64_t R_nnz_capacity; /**< Allocated length of R_idx/R_val */
+
+    /* Row-wise L (fixed between factorizations) */
+    int64_t *Lr_ptr;      /**< Row pointers of row-wise L [m+1] */
+    int *Lr_idx;          /**< Column (step) indices of row-wise L */
+    double *Lr_val;       /**< Values of row-wise L */
+    int64_t Lr_capacity;  /**< Allocated length of Lr_idx/Lr_val */
+
+    /* Row-wise U (kept in step with U by updates) */
+    int64_t *Ur_start;    /**< Start of each U row in Ur_idx/Ur_val [m] */
+    int *Ur_len;          /**< Entries in each U row [m] */
+    int *Ur_cap;          /**< Room reserved for each U row [m] */
+    int *Ur_idx;          /**< Column (step) indices of row-wise U */
+    double *Ur_val;       /**< Values of row-wise U */
+    int64_t Ur_used;      /**< Used length of Ur storage, including gaps */
+    int64_t Ur_capacity;  /**< Allocated length of Ur_idx/Ur_val */
+
+    /* Update workspace */
+    double *work;         /**< Dense workspace [2*m], zero between updates */
+    int *iwork;           /**< Integer workspace [2*m] */
+
+    /* Hypersparse solve workspace and density prediction */
+    double *hs_x;         /**< Step-space values, zero between solves [m] */
+    int *hs_list;         /**< Nonzero steps of hs_x [m] */
+    int *hs_pattern;      /**< Nonzero indices of a caller vector [m] */
+    int *hs_out;          /**< Reach in topological order [m] */
+    int *hs_stack;        /**< DFS node stack [m] */
+    int64_t *hs_next;     /**< DFS resume position per stack level [m] */
+    int *hs_mark;         /**< DFS visit marks, compared to hs_stamp [m] */
+    int hs_stamp;         /**< Current visit mark */
+    double hyper_threshold; /**< Result density below which solves go hypersparse */
+    double rowwise_threshold; /**< Result density below which BTRAN sweeps rows */
+    double ftran_density; /**< Running average of FTRAN result density */
+    double btran_density; /**< Running average of BTRAN result density */
 
     /* Permutation arrays */
     int *perm_row;        /**< Row permutation P [m]: perm_row[k] = original row */
     int *perm_col;        /**< Column permutation Q [m]: perm_col[k] = original col */
+    int *perm_row_inv;    /**< Inverse of perm_row [m]: step of each original row */
+    int *perm_col_inv;    /**< Inverse of perm_col [m]: step of each basis position */
+
+    /* Mixed-precision copies of the factor values (single == 1) */
+    float *L_val32;       /**< float32 copy of L_values */
+    float *Lr_val32;      /**< float32 copy of Lr_val */
+    float *U_val32;       /**< float32 copy of U_values */
+    float *Ur_val32;      /**< float32 copy of Ur_val */
+    int64_t L32_capacity; /**< Allocated length of L_val32 and Lr_val32 */
+    int64_t U32_capacity; /**< Allocated length of U_val32 and Ur_val32 */
+    int single;           /**< 1 to build float32 copies on factorization */
+    int single_L;         /**< 1 while the L copies match L */
+    int single_U;         /**< 1 while the U copies match U */
+
+    /* Singular basis repair */
+    int repairs;          /**< Basis positions the last factorization gave to slacks */
+    int *repair_var;      /**< Variables those repairs removed from the basis [m] */
 
     /* Dimensions */
     int m;                /**< Number of rows/columns in factorization */
+    int rank;             /**< Pivots found by the last factorization (m if valid) */
+    int64_t factor_ops;   /**< Work of the last factorization (entries touched) */
+    int bump_size;        /**< Rows left to Markowitz after the singleton pass */
+    int dense_size;       /**< Trailing steps factored by the dense kernel */
+    int dense_min;        /**< Smallest Schur complement handed to the dense kernel */
+    int threads;          /**< Threads for the dense kernel (<= 1: sequential) */
+    int rowwise;          /**< 1 to build row-wise L for BTRAN (Ur is always kept) */
     int valid;            /**< 1 if factorization is valid, 0 otherwise */
 } LUFactors;
 
@@ -83,16 +182,32 @@ struct BasisState {
      * Applied in FTRAN (before etas) and BTRAN (after etas). */
     double *diag_coeff;       /**< Initial basis diagonal [m] (±1 values) */
 
-    /* LU factorization (computed by cxf_basis_refactor) */
+    /* LU factorization (computed by cxf_solver_refactor) */
     LUFactors *lu;            /**< LU factors, NULL if using eta-only mode */
+    int update_method;        /**< CXF_BASIS_UPDATE_PFI or CXF_BASIS_UPDATE_FT */
+    int rowwise_factors;      /**< Copied to lu->rowwise on refactorization */
+    int mixed_precision;      /**< Copied to lu->single on refactorization */
+    const SparseMatrix *matrix; /**< Constraint matrix for refinement residuals */
 
-    /* Eta factorization */
+    /* Eta file: PFI etas packed in chronological order (oldest first).
+     * Eta k replaces basis column eta_row[k] by a column with pivot
+     * eta_pivot[k] and off-diagonal entries eta_idx/eta_val[eta_start[k]
+     * .. eta_start[k+1]). The arrays are carved from eta_buffer and only
+     * grow; refactorization empties the file by setting eta_count = 0. */
     int eta_count;            /**< Number of eta vectors */
-    int eta_capacity;         /**< Capacity for eta vectors */
-    EtaFactors *eta_head;     /**< Head of eta linked list */
+    int eta_capacity;         /**< Eta slots in eta_row/eta_var/eta_pivot */
+    int *eta_row;             /**< Pivot row of each eta [eta_capacity] */
+    int *eta_var;             /**< Entering variable of each eta [eta_capacity] */
+    double *eta_pivot;        /**< Pivot element of each eta [eta_capacity] */
+    int64_t *eta_start;       /**< Entry offsets [eta_capacity + 1] */
+    int64_t eta_nnz_capacity; /**< Entry slots in eta_idx/eta_val */
+    int *eta_idx;             /**< Row indices of eta entries */
+    double *eta_val;          /**< Values of eta entries */
+    EtaBuffer eta_buffer;     /**< Arena backing the eta file arrays */
 
     /* Working storage */
     double *work;             /**< Working array [m] */
+    ScratchArena *scratch;    /**< Temporaries arena lent by the solver (NULL: heap) */
 
     /* Refactorization control */
     int refactor_freq;        /**< Refactorization frequency */
@@ -157,15 +272,223 @@ void cxf_lu_clear(LUFactors *lu);
 /**
  * @brief Compute LU factorization of current basis matrix.
  *
- * Uses Markowitz-ordered Gaussian elimination with threshold pivoting.
- * Stores result in lu structure.
+ * Uses sparse Markowitz-ordered Gaussian elimination with threshold
+ * pivoting, working directly on the basis columns of the CSC constraint
+ * matrix. Work and memory scale with nnz(B) plus fill-in. Factor storage
+ * in lu is grown as needed.
+ *
+ * A singular basis is repaired instead of rejected: each basis position
+ * without a pivot gets the slack of an uncovered row, basic_vars and
+ * var_status are updated, and lu->repairs / lu->repair_var report the
+ * variables that left the basis.
  *
  * @param lu LUFactors structure to store results.
  * @param ctx SolverContext with basis and matrix access.
- * @return 0 on success, 3 for singular matrix, 1001 for OOM.
+ * @return 0 on success (possibly after repairs), 1001 for OOM.
  */
 int cxf_lu_factorize(LUFactors *lu, SolverContext *ctx);
 
+/**
+ * @brief Reset the update state after a fresh factorization.
+ *
+ * Sets U_col_len from U_col_ptr, makes U_seq the identity, empties
+ * the row-eta file, inverts the permutations and rebuilds the row-wise
+ * copies of L and U (and the float32 copies in mixed-precision mode).
+ *
+ * @param lu LUFactors holding a fresh factorization.
+ * @return CXF_OK on success, CXF_ERROR_OUT_OF_MEMORY on allocation failure.
+ */
+int cxf_lu_reset_updates(LUFactors *lu);
+
+/**
+ * @brief Forrest-Tomlin update for a basis column replacement.
+ *
+ * Replaces the basis column at the given position by the entering
+ * column whose FTRAN result is pivotCol. The spike U * Q^T * pivotCol is
+ * written over the U column of that position, the column is moved to the
+ * end of the pivot order, and the row it leaves behind is eliminated
+ * with a new row eta. The factors are left untouched if the new
+ * diagonal fails the stability check.
+ *
+ * @param lu Valid LUFactors representing the current basis.
+ * @param position Basis position of the leaving variable.
+ * @param pivotCol FTRAN result B^(-1) * a_entering, length m.
+ * @param pattern Nonzero positions of pivotCol, or NULL to scan all m.
+ * @param count Number of entries in pattern.
+ * @return CXF_OK on success, -1 if the update is unstable (caller should
+ *         refactor), CXF_ERROR_OUT_OF_MEMORY on allocation failure.
+ */
+int cxf_lu_ft_update(LUFactors *lu, int position, const double *pivotCol,
+                     const int *pattern, int count);
+
+/*******************************************************************************
+ * Mixed-precision solves
+ ******************************************************************************/
+
+/** Most fp64 refinement steps before a solve falls back to fp64 factors */
+#define CXF_REFINE_STEPS 2
+
+/**
+ * @brief Rebuild the float32 copies of the factor values.
+ *
+ * Does nothing (and clears single_L/single_U) unless lu->single is set.
+ * Called by cxf_lu_reset_updates after the row-wise copies are built.
+ *
+ * @param lu LUFactors holding a fresh factorization.
+ * @return CXF_OK on success, CXF_ERROR_OUT_OF_MEMORY on allocation failure.
+ */
+int cxf_lu_build_single(LUFactors *lu);
+
+/**
+ * @brief Stop using the float32 copies until the next factorization.
+ *
+ * @param lu LUFactors.
+ */
+void cxf_lu_drop_single(LUFactors *lu);
+
+/**
+ * @brief Residual of a basis solve in fp64: r = b - B * x, or b - B^T * x.
+ *
+ * Basis columns come from basis->matrix for structurals and from
+ * diag_coeff for slacks.
+ *
+ * @param basis Basis state with basis->matrix set.
+ * @param transpose 0 for B * x, 1 for B^T * x.
+ * @param b Right-hand side [m].
+ * @param x Solution [m].
+ * @param r Output residual [m].
+ * @return max |r_i| divided by (1 + max |b_i|).
+ */
+double cxf_basis_residual(const BasisState *basis, int transpose,
+                          const double *b, const double *x, double *r);
+
+/*******************************************************************************
+ * Condition estimate
+ ******************************************************************************/
+
+/** Estimated condition number above which a basis counts as ill-conditioned */
+#define CXF_COND_ILL 1e9
+
+/** Estimated condition number above which a basis is severely ill-conditioned */
+#define CXF_COND_SEVERE 1e12
+
+/**
+ * @brief Estimate the 1-norm condition number of the current basis.
+ *
+ * Hager/Higham estimate of ||B||_1 * ||B^(-1)||_1 from a few FTRAN and
+ * BTRAN calls with the current factors (a lower bound, usually within a
+ * factor of 3).
+ *
+ * @param basis Basis state with valid factors and basis->matrix set.
+ * @param cond Output: condition estimate (1.0 for an empty basis).
+ * @return CXF_OK on success, CXF_ERROR_INVALID_ARGUMENT without a matrix,
+ *         or an error code from the solves.
+ */
+int cxf_basis_condest(BasisState *basis, double *cond);
+
+/*******************************************************************************
+ * Dense LU of the factorization bump
+ ******************************************************************************/
+
+/** Default smallest Schur complement that may switch to the dense kernel */
+#define CXF_LU_DENSE_MIN 100
+
+/**
+ * @brief Blocked dense LU with partial pivoting: A(perm, cperm) = L * U.
+ *
+ * @param a Column-major n x n matrix, overwritten with L (strict lower
+ *          triangle, unit diagonal implicit) and U.
+ * @param n Dimension.
+ * @param perm Row permutation: position k holds original row perm[k] [n].
+ * @param cperm Column permutation [n]; columns without a pivot go last.
+ * @param threads Threads for the trailing updates (<= 1: sequential).
+ * @return Number of pivots found (n unless singular).
+ */
+int cxf_lu_dense_factor(double *a, int n, int *perm, int *cperm, int threads);
+
+/*******************************************************************************
+ * Hypersparse triangular solves
+ ******************************************************************************/
+
+/** Triangular factors for cxf_lu_hyper_solve */
+#define CXF_LU_SOLVE_L   0  /**< L * x = b (unit lower, column-wise) */
+#define CXF_LU_SOLVE_U   1  /**< U * x = b (upper in pivot order, column-wise) */
+#define CXF_LU_SOLVE_LT  2  /**< L^T * x = b (via row-wise L) */
+#define CXF_LU_SOLVE_UT  3  /**< U^T * x = b (via row-wise U) */
+
+/** Default result density below which FTRAN/BTRAN go hypersparse */
+#define CXF_HYPER_DENSITY 0.10
+
+/** Default result density below which BTRAN sweeps the row-wise factors */
+#define CXF_ROWWISE_DENSITY 0.40
+
+/**
+ * @brief Rebuild the row-wise copies of L and U from the column-wise factors.
+ *
+ * Row-wise L is skipped unless lu->rowwise is set.
+ *
+ * @param lu LUFactors holding a fresh factorization.
+ * @return CXF_OK on success, CXF_ERROR_OUT_OF_MEMORY on allocation failure.
+ */
+int cxf_lu_build_rowwise(LUFactors *lu);
+
+/**
+ * @brief Sparse triangular solve with one factor (Gilbert-Peierls).
+ *
+ * A depth-first search from the nonzeros listed in list finds every step
+ * the solution can touch, in topological order; only those columns are
+ * then visited. x must be zero outside list on entry.
+ *
+ * @param lu Valid LUFactors.
+ * @param factor CXF_LU_SOLVE_L, _U, _LT or _UT.
+ * @param x Step-space right-hand side, overwritten with the solution [m].
+ * @param list Nonzero steps of x on entry; on return every step that may
+ *             be nonzero, in solve order (room for m entries).
+ * @param count Number of entries in list on entry.
+ * @return Number of entries in list on return.
+ */
+int cxf_lu_hyper_solve(LUFactors *lu, int factor, double *x, int *list, int count);
+
+/**
+ * @brief Hypersparse LU part of FTRAN: x = Q^T * U^(-1) * R * L^(-1) * P * x.
+ *
+ * Declines (returns -1, x untouched) when the right-hand side or the
+ * recent FTRAN results are denser than lu->hyper_threshold, so that the
+ * caller runs the dense sweep instead.
+ *
+ * @param lu Valid LUFactors.
+ * @param x Right-hand side indexed by row, overwritten with the solution
+ *          indexed by basis position [m].
+ * @param pattern Nonzero indices of x on entry, of the result on return.
+ * @param count Number of entries in pattern on entry.
+ * @return Number of entries in pattern on return, or -1 if declined.
+ */
+int cxf_lu_ftran_hyper(LUFactors *lu, double *x, int *pattern, int count);
+
+/**
+ * @brief Hypersparse LU part of BTRAN: x = P^T * L^(-T) * R^T * U^(-T) * Q * x.
+ *
+ * Declines like cxf_lu_ftran_hyper, and always when the factors carry no
+ * row-wise L (lu->rowwise == 0).
+ *
+ * @param lu Valid LUFactors.
+ * @param x Right-hand side indexed by basis position, overwritten with the
+ *          solution indexed by row [m].
+ * @param pattern Nonzero indices of x on entry, of the result on return.
+ * @param count Number of entries in pattern on entry.
+ * @return Number of entries in pattern on return, or -1 if declined.
+ */
+int cxf_lu_btran_hyper(LUFactors *lu, double *x, int *pattern, int count);
+
+/**
+ * @brief Fold the density of a solve result into a running average.
+ *
+ * @param average Running average to update (ftran_density or btran_density).
+ * @param nnz Nonzeros in the result.
+ * @param m Dimension.
+ */
+void cxf_lu_track_density(double *average, int nnz, int m);
+
 /*******************************************************************************
  * BasisSnapshot functions (M5.1.7)
  ******************************************************************************/
@@ -223,4 +546,36 @@ void cxf_basis_snapshot_free(BasisSnapshot *snapshot);
  */
 int cxf_btran_vec(BasisState *basis, const double *input, double *result);
 
+/*******************************************************************************
+ * FTRAN/BTRAN with several right-hand sides
+ ******************************************************************************/
+
+/** Vectors interleaved per sweep (one cache line of doubles per step) */
+#define CXF_SOLVE_MULTI_LANES 8
+
+/**
+ * @brief Forward transformation of k vectors: X = B^(-1) * A.
+ *
+ * Sweeps the factors and the eta file once per CXF_SOLVE_MULTI_LANES
+ * vectors instead of once per vector.
+ *
+ * @param basis Basis state with factorization.
+ * @param k Number of vectors.
+ * @param columns Input vectors, vector j at columns[j * m] [k * m].
+ * @param result Output vectors in the same layout [k * m]; may alias columns.
+ * @return CXF_OK on success, error code on failure.
+ */
+int cxf_ftran_multi(BasisState *basis, int k, const double *columns, double *result);
+
+/**
+ * @brief Backward transformation of k vectors: Y = B^(-T) * C.
+ *
+ * @param basis Basis state with factorization.
+ * @param k Number of vectors.
+ * @param input Input vectors, vector j at input[j * m] [k * m].
+ * @param result Output vectors in the same layout [k * m]; may alias input.
+ * @return CXF_OK on success, error code on failure.
+ */
+int cxf_btran_multi(BasisState *basis, int k, const double *input, double *result);
+
 #endif /* CXF_BASIS_H */
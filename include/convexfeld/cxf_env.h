@@ -39,6 +39,16 @@ struct CxfEnv {
     int max_eta_count;        /**< Maximum eta vectors before forced refactor */
     int64_t max_eta_memory;   /**< Maximum eta memory before forced refactor */
     int refactor_interval;    /**< Iterations between routine refactorizations */
+    int basis_update;         /**< Basis update: 0=PFI eta chain, 1=Forrest-Tomlin */
+    int rowwise_factors;      /**< 1 to keep row-wise L for BTRAN, 0 column-wise only */
+    int mixed_precision;      /**< 1 for float32 factor sweeps with fp64 refinement */
+
+    /* Algorithm */
+    int method;               /**< Simplex algorithm: 0=primal, 1=dual */
+    int simplex_pricing;      /**< Primal pricing: -1=auto (Devex), 0=partial, 1=steepest edge, 2=Devex */
+
+    /* Threading */
+    int thread_count;         /**< Threads for parallel kernels (0 = auto: pool per physical core, dense LU sequential) */
 
     /* Reference counting and versioning */
     int ref_count;            /**< Reference counter for environment lifetime */
@@ -180,7 +190,8 @@ CallbackContext *cxf_get_callback_context(CxfEnv *env);
 /**
  * @brief Set an integer parameter value.
  *
- * Supported parameters: OutputFlag, Verbosity, RefactorInterval, MaxEtaCount.
+ * Supported parameters: OutputFlag, Verbosity, RefactorInterval, MaxEtaCount,
+ * BasisUpdate, RowwiseFactors, MixedPrecision, Method, SimplexPricing.
  *
  * @param env Environment to modify
  * @param paramname Parameter name (case-sensitive)
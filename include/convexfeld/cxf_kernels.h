@@ -0,0 +1,120 @@
+/**
+ * @file cxf_kernels.h
+ * @brief Vector kernels for the pricing and ratio-test scans.
+ *
+ * The full pricing scan and the two Harris passes of the ratio test run
+ * over long double arrays with a status or basic-variable array beside
+ * them. Each scan has a scalar version and, on x86-64, AVX2 and AVX-512
+ * versions; the widest one the CPU supports is chosen on first use.
+ * All versions return the same result bit for bit.
+ */
+
+#ifndef CXF_KERNELS_H
+#define CXF_KERNELS_H
+
+/* Kernel levels (cxf_kernel_level, cxf_kernel_select) */
+#define CXF_KERNEL_SCALAR 0  /**< Portable C */
+#define CXF_KERNEL_AVX2   1  /**< 4 doubles per vector */
+#define CXF_KERNEL_AVX512 2  /**< 8 doubles per vector */
+
+/**
+ * @brief Best attractive nonbasic variable of a pricing scan.
+ *
+ * Attractive: status -1 with d_j < -tol, status -2 with d_j > tol, status
+ * -3 with |d_j| > tol. The score is the improvement |d_j|, divided by
+ * sqrt(w_j) when weights are given (weights below 1e-10 count as 1). Ties
+ * go to the smaller index.
+ *
+ * @param dj Reduced costs [n]
+ * @param weights Pricing weights [n], or NULL for Dantzig pricing
+ * @param status Variable status [n]
+ * @param n Number of variables
+ * @param tol Optimality tolerance
+ * @param scanned Output: number of nonbasic variables, or NULL
+ * @return Index of the best variable, or -1 if none is attractive
+ */
+typedef int (*CxfPriceKernel)(const double *dj, const double *weights,
+                              const int *status, int n, double tol,
+                              int *scanned);
+
+/**
+ * @brief Rows of a ratio test and the basic variables behind them.
+ *
+ * Row i of the pivot column blocks when |alpha_i| > the pivot tolerance,
+ * its basic variable is valid, and the bound it moves toward (lower for
+ * alpha_i > 0, upper otherwise) is finite; its ratio is
+ * (x - bound) / alpha_i.
+ */
+typedef struct CxfRatioScan {
+    const double *alpha;      /**< Pivot column, indexed by row */
+    const int *rows;          /**< Rows to visit, or NULL for 0..count-1 */
+    int count;                /**< Number of rows */
+    const int *basic_vars;    /**< Basic variable of each row */
+    const double *x;          /**< Values of all variables */
+    const double *lb;         /**< Lower bounds */
+    const double *ub;         /**< Upper bounds */
+    int total_vars;           /**< Valid basic variables are below this */
+    double infinity;          /**< Bounds at or beyond this are infinite */
+} CxfRatioScan;
+
+/**
+ * @brief First Harris pass: the blocking row of least ratio >= -feas_tol.
+ *
+ * Ties go to the smaller row.
+ *
+ * @param scan Rows of the ratio test
+ * @param pivot_tol Pivot tolerance
+ * @param feas_tol Feasibility tolerance
+ * @param min_ratio Output: the least ratio (infinity if no row blocks)
+ * @return Row of the least ratio, or -1 if no row blocks
+ */
+typedef int (*CxfRatioMinKernel)(const CxfRatioScan *scan, double pivot_tol,
+                                 double feas_tol, double *min_ratio);
+
+/**
+ * @brief Second Harris pass: the largest pivot among ratios <= threshold.
+ *
+ * min_row is kept unless another row has a strictly larger |alpha_i|;
+ * among such rows ties go to the smaller row.
+ *
+ * @param scan Rows of the ratio test
+ * @param pivot_tol Pivot tolerance of the first pass
+ * @param threshold Least ratio plus the feasibility tolerance
+ * @param min_row Row found by the first pass
+ * @return The leaving row
+ */
+typedef int (*CxfRatioPivotKernel)(const CxfRatioScan *scan, double pivot_tol,
+                                   double threshold, int min_row);
+
+/**
+ * @brief One set of kernels.
+ */
+typedef struct CxfKernels {
+    int level;                      /**< CXF_KERNEL_* */
+    CxfPriceKernel price;           /**< Pricing scan */
+    CxfRatioMinKernel ratio_min;    /**< First Harris pass */
+    CxfRatioPivotKernel ratio_pivot; /**< Second Harris pass */
+} CxfKernels;
+
+/**
+ * @brief The kernels in use (chosen on the first call).
+ */
+const CxfKernels *cxf_kernels(void);
+
+/**
+ * @brief Widest kernel level the build and the CPU support.
+ */
+int cxf_kernel_level(void);
+
+/**
+ * @brief Use the kernels of a given level, capped at cxf_kernel_level.
+ *
+ * For benchmarks and tests comparing the levels; not thread-safe, call it
+ * before a solve.
+ *
+ * @param level CXF_KERNEL_*
+ * @return The level now in use
+ */
+int cxf_kernel_select(int level);
+
+#endif /* CXF_KERNELS_H */
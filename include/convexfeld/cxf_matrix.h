@@ -44,4 +44,36 @@ struct SparseMatrix {
     char *sense;              /**< Constraint senses [num_rows] */
 };
 
+/** @brief PRICE kernels chosen by cxf_price_row */
+#define CXF_PRICE_COLUMN 0    /**< Column-wise over the nonbasic columns */
+#define CXF_PRICE_ROW    1    /**< Row-wise, dense accumulation */
+#define CXF_PRICE_HYPER  2    /**< Row-wise, sparse accumulation with an index list */
+
+/**
+ * @brief Row-wise copy of A for the pivot row PRICE.
+ *
+ * Each row holds its nonbasic entries first, in [row_start[i],
+ * nonbasic_end[i]), followed by the entries of basic columns. When a
+ * column enters or leaves the basis each of its entries is swapped across
+ * the boundary of its row, so the row-wise PRICE never reads basic
+ * columns. entry_pos and entry_src map CSC entries of the source matrix
+ * to row positions and back.
+ */
+struct PriceRows {
+    const SparseMatrix *matrix; /**< Source matrix (CSC) */
+    int num_rows;             /**< Number of rows (m) */
+    int num_cols;             /**< Number of columns (n) */
+    int64_t *row_start;       /**< Row pointers [num_rows + 1] */
+    int64_t *nonbasic_end;    /**< End of the nonbasic part of each row [num_rows] */
+    int *col_idx;             /**< Column indices [nnz] */
+    double *values;           /**< Values [nnz] */
+    int64_t *entry_pos;       /**< Row position of each CSC entry [nnz] */
+    int64_t *entry_src;       /**< CSC entry at each row position [nnz] */
+    char *basic;              /**< Columns currently in the basic part [num_cols] */
+    int *rho_rows;            /**< Nonzero rows of the last BTRAN result [num_rows] */
+    int64_t mode_count[3];    /**< Calls per CXF_PRICE_* kernel */
+    int *block_count;         /**< Nonzeros per column block of a parallel column-wise PRICE */
+    CxfThreadPool *pool;      /**< Workers for the column-wise PRICE, NULL: sequential (not owned) */
+};
+
 #endif /* CXF_MATRIX_H */
@@ -41,6 +41,7 @@ struct CxfModel {
     double *pi;               /**< Dual values [num_constrs] */
     int status;               /**< Optimization status (CxfStatus) */
     double obj_val;           /**< Objective value */
+    double basis_cond;        /**< Condition estimate of the last factored basis */
 
     /* Model state */
     int initialized;          /**< 1 if ready for optimization */
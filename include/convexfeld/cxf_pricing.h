@@ -11,6 +11,11 @@
 
 #include "cxf_types.h"
 
+/** Blocks of a pooled candidate scan (see candidates.c) */
+#define CXF_CANDIDATE_BLOCKS 64
+/** Longest candidate list a pooled scan keeps per block */
+#define CXF_CANDIDATE_LIST   16
+
 /**
  * @brief Pricing context for partial pricing.
  *
@@ -30,8 +35,27 @@ struct PricingContext {
     int **candidate_arrays;   /**< Variable indices per level [max_levels] */
     int *candidate_sizes;     /**< Allocated size per level [max_levels] */
 
-    /* Steepest edge weights */
+    /* Steepest edge / Devex weights */
     double *weights;          /**< SE/Devex weights [num_vars], NULL if unused */
+    unsigned char *reference; /**< Devex reference framework, 1 = member [num_vars], NULL unless Devex */
+    int weights_ready;        /**< 0 until the weights are set for the current basis */
+    int64_t weight_pivots;    /**< Updates since the weights were last set exactly */
+    double weight_error;      /**< Largest ratio (minus 1) between an updated entering weight and its exact value since then */
+    int64_t weight_resets;    /**< Exact recomputations (SE) or framework resets (Devex) */
+
+    /* Attractive nonbasic variables by d_j^2 / w_j (SE/Devex, see heap.c) */
+    int *heap;                /**< Indexed max-heap of variables [num_vars], NULL if unused */
+    int *heap_pos;            /**< Position of each variable in the heap, -1 if absent [num_vars] */
+    double *heap_key;         /**< d_j^2 / w_j, -1 if not attractive [num_vars] */
+    int heap_size;            /**< Variables in the heap */
+    int heap_ready;           /**< 0 until built for the current reduced costs and weights */
+    int heap_active;          /**< 0 while pivot rows are too dense for the heap to pay */
+    double heap_tol;          /**< Optimality tolerance the heap was built with */
+
+    /* Parallel scan (see steepest.c) */
+    CxfThreadPool *pool;      /**< Workers for the full pricing scan, NULL: sequential (not owned) */
+    int *block_lists;         /**< Best candidates per scan block [CXF_CANDIDATE_BLOCKS * CXF_CANDIDATE_LIST] */
+    int *block_counts;        /**< Candidates per scan block [CXF_CANDIDATE_BLOCKS] */
 
     /* Cache */
     int *cached_counts;       /**< Cached result count (-1=invalid) [max_levels] */
@@ -12,6 +12,9 @@
 #include "cxf_types.h"
 #include "cxf_timing.h"
 
+/** Candidates FTRAN'd together for the minor iterations of multiple pricing */
+#define CXF_MULTI_PRICE 6
+
 /**
  * @brief Solver context for LP optimization.
  *
@@ -51,19 +54,44 @@ struct SolverContext {
     double scale_factor;      /**< Work scaling factor */
     TimingState *timing;      /**< Timing state (NULL to disable) */
 
-    /* Refactorization tracking */
-    int eta_count;            /**< Number of eta vectors since last refactor */
-    int64_t eta_memory;       /**< Memory used by eta vectors (bytes) */
-    double total_ftran_time;  /**< Accumulated FTRAN time */
-    int ftran_count;          /**< Number of FTRAN operations */
-    double baseline_ftran;    /**< Baseline FTRAN time (after refactor) */
+    /* Refactorization tracking. Solve cost is measured in work units
+     * (factor and update nonzeros a FTRAN/BTRAN pass touches), which keeps
+     * the refactorization schedule deterministic. */
+    int eta_count;            /**< Basis updates since last refactor */
+    int64_t eta_memory;       /**< Memory used by update storage (bytes) */
+    double total_ftran_time;  /**< Accumulated solve work since last refactor */
+    int ftran_count;          /**< Number of solves accumulated */
+    double baseline_ftran;    /**< Solve work right after the last refactor */
+    double refactor_cost;     /**< Work of the last refactorization */
+    double pivot_residual;    /**< Relative pivot residual of the last update */
+    double basis_cond;        /**< Condition estimate of the last refactored basis */
+    double pivot_tol;         /**< Ratio-test pivot tolerance (raised when ill-conditioned) */
     int iteration;            /**< Current iteration number */
     int last_refactor_iter;   /**< Iteration of last refactorization */
 
     /* Preallocated iteration work arrays (size num_constrs)
      * Allocated once in init, reused across iterations to avoid malloc/free */
-    double *work_column;      /**< Column extraction buffer [num_constrs] */
+    VectorContainer *work_column; /**< Entering column, FTRAN'd in place (sparse) [num_constrs] */
     double *work_cB;          /**< Basic variable costs [num_constrs] */
+    double *work_rho;         /**< Row r of B^(-1), e_r^T B^(-1) [num_constrs] */
+    VectorContainer *work_alpha; /**< Pivot row e_r^T B^(-1) [A I] (sparse) [num_vars + num_constrs] */
+    PriceRows *price_rows;    /**< Row-wise copy of A for the pivot row PRICE */
+    CxfThreadPool *pool;      /**< Workers for PRICE, the d_j updates and pricing, NULL: sequential */
+    double *work_tau;         /**< B^(-T) alpha_q for the steepest-edge update [num_constrs] */
+    VectorContainer *work_edge; /**< a_j^T B^(-T) alpha_q over the pivot row (sparse) [num_vars + num_constrs] */
+
+    /* Multiple pricing (partial pricing): the candidate columns of the
+     * current major iteration, kept current across its minor iterations */
+    double *minor_cols;       /**< Candidate columns B^(-1) a_j, dense [CXF_MULTI_PRICE * num_constrs], NULL when off */
+    int minor_vars[CXF_MULTI_PRICE]; /**< Candidate per slot, -1 once it has entered */
+    double minor_dj[CXF_MULTI_PRICE]; /**< Reduced cost per slot */
+    int minor_count;          /**< Slots loaded (0: the next iteration prices) */
+    double minor_floor;       /**< Improvement |d_j| below which a candidate is not taken */
+
+    /* Per-solve scratch arena for kernel temporaries (FTRAN/BTRAN work
+     * vectors, eta pointer lists). Lent to basis->scratch; heapAllocs
+     * stays flat once the iteration loop reaches steady state. */
+    ScratchArena scratch;
 };
 
 /*******************************************************************************
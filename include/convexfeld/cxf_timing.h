@@ -11,6 +11,17 @@
 /* Maximum timing sections */
 #define CXF_MAX_TIMING_SECTIONS 8
 
+/* Refactorization causes (see cxf_timing_refactor_cause) */
+#define CXF_REFACTOR_NONE        0  /**< No refactorization needed */
+#define CXF_REFACTOR_INITIAL     1  /**< No valid factors to update */
+#define CXF_REFACTOR_UNSTABLE    2  /**< Forrest-Tomlin update fell back to an eta */
+#define CXF_REFACTOR_ACCURACY    3  /**< Pivot residual check failed */
+#define CXF_REFACTOR_ETA_COUNT   4  /**< Updates exceeded MaxEtaCount */
+#define CXF_REFACTOR_ETA_MEMORY  5  /**< Update storage exceeded max_eta_memory */
+#define CXF_REFACTOR_INTERVAL    6  /**< RefactorInterval iterations elapsed */
+#define CXF_REFACTOR_COST        7  /**< Solve cost growth paid for a refactorization */
+#define CXF_REFACTOR_NUM_CAUSES  8
+
 /**
  * @brief Timing state structure for profiling.
  *
@@ -29,6 +40,14 @@ typedef struct TimingState {
     double avg_time[CXF_MAX_TIMING_SECTIONS];       /**< Average time */
 
     double iteration_rate;    /**< Overall iterations per second */
+
+    /* Refactorization decisions */
+    int refactor_count;       /**< Refactorizations performed */
+    int refactor_causes[CXF_REFACTOR_NUM_CAUSES]; /**< Refactorizations per cause */
+    int last_refactor_cause;  /**< Cause of the latest refactorization */
+    int last_refactor_updates; /**< Basis updates discarded by the latest one */
+    double refactor_time;     /**< Wall time spent refactoring (seconds) */
+    int basis_repairs;        /**< Basic columns replaced by slacks (singular bases) */
 } TimingState;
 
 /**
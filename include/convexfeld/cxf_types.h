@@ -124,6 +124,10 @@ typedef enum {
 /** @brief Zero tolerance for numerical comparisons */
 #define CXF_ZERO_TOL        1e-12
 
+/** @brief Stand-in for an exact zero produced by cancellation in a
+ *  sparse accumulator, so the entry stays consistent with its index list */
+#define CXF_TINY_VALUE      1e-50
+
 /** @brief Maximum length of names (variables, constraints, model) */
 #define CXF_MAX_NAME_LEN    255
 
@@ -165,6 +169,12 @@ typedef struct CxfModel CxfModel;
  */
 typedef struct SparseMatrix SparseMatrix;
 
+/**
+ * @brief Row-wise copy of A partitioned into nonbasic and basic entries.
+ * @see include/convexfeld/cxf_matrix.h
+ */
+typedef struct PriceRows PriceRows;
+
 /**
  * @brief Solver context - working state during optimization.
  * @see include/convexfeld/cxf_solver.h
@@ -195,11 +205,22 @@ typedef struct PricingContext PricingContext;
  */
 typedef struct CallbackContext CallbackContext;
 
+/**
+ * @brief Persistent worker threads for the parallel kernels.
+ * @see src/threading/pool.c
+ */
+typedef struct CxfThreadPool CxfThreadPool;
+
 /**
  * @brief Vector container for sparse vectors with indices and values.
  *
  * Used throughout ConvexFeld for storing sparse vectors, index lists,
  * and coefficient arrays.
+ *
+ * Containers made by cxf_vector_create are sparse accumulators of
+ * dimension capacity: values is dense and indices lists exactly the
+ * positions where values is nonzero. Operations that cancel an entry to
+ * zero store CXF_TINY_VALUE instead. cxf_vector_clear costs O(size).
  */
 typedef struct VectorContainer {
     int *indices;      /**< Array of indices (may be NULL) */
@@ -234,6 +255,40 @@ typedef struct EtaBuffer {
     size_t minChunkSize;     /**< Minimum chunk size */
 } EtaBuffer;
 
+/**
+ * @brief Block in the scratch arena.
+ *
+ * The data area follows the header in the same allocation.
+ */
+typedef struct ScratchBlock {
+    struct ScratchBlock *next; /**< Next (larger or later) block */
+    size_t capacity;           /**< Data capacity in bytes */
+    size_t used;               /**< Bytes handed out from this block */
+} ScratchBlock;
+
+/**
+ * @brief Stack-style arena for short-lived kernel temporaries.
+ *
+ * Callers take a mark, carve arrays with cxf_scratch_alloc and release
+ * back to the mark when done, so nested kernels share the same blocks.
+ * Released blocks are kept, so once the arena has grown to the peak
+ * demand of an iteration it performs no further heap allocation.
+ */
+typedef struct ScratchArena {
+    ScratchBlock *first;     /**< Head of block chain */
+    ScratchBlock *active;    /**< Block currently allocated from */
+    size_t minBlockSize;     /**< Minimum size of a new block */
+    int64_t heapAllocs;      /**< Blocks obtained from the heap so far */
+} ScratchArena;
+
+/**
+ * @brief Position in a scratch arena returned by cxf_scratch_mark.
+ */
+typedef struct ScratchMark {
+    ScratchBlock *block;     /**< Active block at the mark (NULL: empty) */
+    size_t used;             /**< Bytes used in that block at the mark */
+} ScratchMark;
+
 /** @brief Maximum chunk size for eta buffer (64KB) */
 #define CXF_MAX_CHUNK_SIZE 65536
 
@@ -68,6 +68,8 @@ int cxf_getintattr(CxfModel *model, const char *attrname, int *valueP) {
  *   - "Runtime": model->update_time
  *   - "ObjBound": Same as ObjVal for LP
  *   - "ObjBoundC": Same as ObjVal for LP
+ *   - "BasisCondition": 1-norm condition estimate of the last factored
+ *     basis (0 before the first solve)
  *   - "MaxCoeff": 1.0 (stub)
  *   - "MinCoeff": 1.0 (stub)
  *
@@ -103,6 +105,11 @@ int cxf_getdblattr(CxfModel *model, const char *attrname, double *valueP) {
         return CXF_OK;
     }
 
+    if (strcmp(attrname, "BasisCondition") == 0) {
+        *valueP = model->basis_cond;
+        return CXF_OK;
+    }
+
     if (strcmp(attrname, "MaxCoeff") == 0) {
         /* Stub: return 1.0 */
         *valueP = 1.0;
@@ -17,6 +17,11 @@ extern void cxf_free(void *ptr);
 #define DEFAULT_MAX_ETA_COUNT     100
 #define DEFAULT_MAX_ETA_MEMORY    (1024 * 1024)  /* 1 MB */
 #define DEFAULT_REFACTOR_INTERVAL 50
+#define DEFAULT_BASIS_UPDATE      1      /* Forrest-Tomlin */
+#define DEFAULT_ROWWISE_FACTORS   1
+#define DEFAULT_MIXED_PRECISION   0
+#define DEFAULT_METHOD            0      /* Primal simplex */
+#define DEFAULT_SIMPLEX_PRICING   -1     /* Auto (Devex) */
 
 /**
  * @brief Internal helper to initialize common environment fields.
@@ -49,6 +54,16 @@ static void cxf_env_init_fields(CxfEnv *env, const char *logfilename, int set_ac
     env->max_eta_count = DEFAULT_MAX_ETA_COUNT;
     env->max_eta_memory = DEFAULT_MAX_ETA_MEMORY;
     env->refactor_interval = DEFAULT_REFACTOR_INTERVAL;
+    env->basis_update = DEFAULT_BASIS_UPDATE;
+    env->rowwise_factors = DEFAULT_ROWWISE_FACTORS;
+    env->mixed_precision = DEFAULT_MIXED_PRECISION;
+
+    /* Algorithm default */
+    env->method = DEFAULT_METHOD;
+    env->simplex_pricing = DEFAULT_SIMPLEX_PRICING;
+
+    /* Threading defaults */
+    env->thread_count = 0;
 
     /* Reference counting and versioning */
     env->ref_count = 1;
@@ -50,6 +50,7 @@ static void cxf_model_init_fields(CxfModel *model, CxfEnv *env,
     /* Status */
     model->status = CXF_OK;
     model->obj_val = 0.0;
+    model->basis_cond = 0.0;
     model->initialized = 0;
     model->modification_blocked = 0;
 
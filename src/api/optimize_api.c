@@ -83,10 +83,9 @@ int cxf_optimize_internal(CxfModel *model) {
         return CXF_ERROR_INVALID_ARGUMENT;  /* Callback requested abort */
     }
 
-    /* Delegate to LP solver
+    /* Delegate to LP solver (the Method parameter picks primal or dual)
      * Future: dispatch based on problem type (LP/QP/MIP/NLP)
-     * Future: add preprocessing call if needed
-     * Future: check parameters for method selection (primal/dual simplex) */
+     * Future: add preprocessing call if needed */
     status = cxf_solve_lp(model);
 
     /* Post-optimization callback */
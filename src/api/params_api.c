@@ -69,6 +69,51 @@ int cxf_setintparam(CxfEnv *env, const char *paramname, int newvalue) {
         return CXF_OK;
     }
 
+    /* BasisUpdate: 0 (PFI eta chain) or 1 (Forrest-Tomlin) */
+    if (strcmp(paramname, "BasisUpdate") == 0) {
+        if (newvalue != 0 && newvalue != 1) {
+            return CXF_ERROR_INVALID_ARGUMENT;
+        }
+        env->basis_update = newvalue;
+        return CXF_OK;
+    }
+
+    /* RowwiseFactors: 0 (column-wise BTRAN only) or 1 (row-wise L and U) */
+    if (strcmp(paramname, "RowwiseFactors") == 0) {
+        if (newvalue != 0 && newvalue != 1) {
+            return CXF_ERROR_INVALID_ARGUMENT;
+        }
+        env->rowwise_factors = newvalue;
+        return CXF_OK;
+    }
+
+    /* MixedPrecision: 0 (fp64 factors) or 1 (float32 sweeps, fp64 refinement) */
+    if (strcmp(paramname, "MixedPrecision") == 0) {
+        if (newvalue != 0 && newvalue != 1) {
+            return CXF_ERROR_INVALID_ARGUMENT;
+        }
+        env->mixed_precision = newvalue;
+        return CXF_OK;
+    }
+
+    /* Method: 0 (primal simplex) or 1 (dual simplex) */
+    if (strcmp(paramname, "Method") == 0) {
+        if (newvalue != 0 && newvalue != 1) {
+            return CXF_ERROR_INVALID_ARGUMENT;
+        }
+        env->method = newvalue;
+        return CXF_OK;
+    }
+
+    /* SimplexPricing: -1 (auto), 0 (partial), 1 (steepest edge), 2 (Devex) */
+    if (strcmp(paramname, "SimplexPricing") == 0) {
+        if (newvalue < -1 || newvalue > 2) {
+            return CXF_ERROR_INVALID_ARGUMENT;
+        }
+        env->simplex_pricing = newvalue;
+        return CXF_OK;
+    }
+
     /* Unknown parameter */
     return CXF_ERROR_INVALID_ARGUMENT;
 }
@@ -119,6 +164,36 @@ int cxf_getintparam(CxfEnv *env, const char *paramname, int *valueP) {
         return CXF_OK;
     }
 
+    /* BasisUpdate */
+    if (strcmp(paramname, "BasisUpdate") == 0) {
+        *valueP = env->basis_update;
+        return CXF_OK;
+    }
+
+    /* RowwiseFactors */
+    if (strcmp(paramname, "RowwiseFactors") == 0) {
+        *valueP = env->rowwise_factors;
+        return CXF_OK;
+    }
+
+    /* MixedPrecision */
+    if (strcmp(paramname, "MixedPrecision") == 0) {
+        *valueP = env->mixed_precision;
+        return CXF_OK;
+    }
+
+    /* Method */
+    if (strcmp(paramname, "Method") == 0) {
+        *valueP = env->method;
+        return CXF_OK;
+    }
+
+    /* SimplexPricing */
+    if (strcmp(paramname, "SimplexPricing") == 0) {
+        *valueP = env->simplex_pricing;
+        return CXF_OK;
+    }
+
     /* Unknown parameter */
     return CXF_ERROR_INVALID_ARGUMENT;
 }
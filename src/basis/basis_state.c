@@ -13,6 +13,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+/* Eta buffer arena (memory/vectors.c) */
+extern void cxf_eta_buffer_init(EtaBuffer *buffer, size_t min_chunk_size);
+extern void cxf_eta_buffer_free(EtaBuffer *buffer);
+
 /* Default refactorization frequency (pivots between refactorizations) */
 #define DEFAULT_REFACTOR_FREQ 100
 
@@ -43,8 +47,11 @@ BasisState *cxf_basis_create(int m, int n) {
     basis->n = n;
     basis->eta_count = 0;
     basis->eta_capacity = 0;
-    basis->eta_head = NULL;
+    basis->eta_nnz_capacity = 0;
+    cxf_eta_buffer_init(&basis->eta_buffer, CXF_MIN_CHUNK_SIZE);
+    basis->scratch = NULL;
     basis->lu = NULL;  /* LU factors allocated on first refactorization */
+    basis->rowwise_factors = 1;
     basis->pivots_since_refactor = 0;
     basis->refactor_freq = DEFAULT_REFACTOR_FREQ;
     basis->iteration = 0;
@@ -86,7 +93,7 @@ BasisState *cxf_basis_create(int m, int n) {
  * @brief Free a BasisState and all associated memory.
  *
  * Deallocates the BasisState structure including all arrays and
- * the entire eta vector linked list. Safe to call with NULL.
+ * the eta buffer holding the eta vectors. Safe to call with NULL.
  *
  * @param basis BasisState to free (may be NULL).
  */
@@ -95,15 +102,8 @@ void cxf_basis_free(BasisState *basis) {
         return;
     }
 
-    /* Free eta linked list */
-    EtaFactors *eta = basis->eta_head;
-    while (eta != NULL) {
-        EtaFactors *next = eta->next;
-        free(eta->indices);
-        free(eta->values);
-        free(eta);
-        eta = next;
-    }
+    /* Free the eta file (all arrays live in the eta buffer) */
+    cxf_eta_buffer_free(&basis->eta_buffer);
 
     /* Free LU factorization */
     cxf_lu_free(basis->lu);
@@ -142,7 +142,6 @@ int cxf_basis_init(BasisState *basis, int m, int n) {
 
     /* Reset eta list state */
     basis->eta_count = 0;
-    basis->eta_head = NULL;
     basis->pivots_since_refactor = 0;
 
     /* Clear arrays */
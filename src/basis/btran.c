@@ -17,23 +17,193 @@
 #include <string.h>
 #include <math.h>
 
-/** Maximum stack-allocated eta pointers before heap allocation */
-#define MAX_STACK_ETAS 64
+/* Scratch arena (memory/scratch.c) */
+extern ScratchMark cxf_scratch_mark(const ScratchArena *arena);
+extern void *cxf_scratch_alloc(ScratchArena *arena, size_t size);
+extern void cxf_scratch_release(ScratchArena *arena, ScratchMark mark);
+
+/**
+ * @brief Solve U^T * z = temp by rows of U (scatter, skips zero z_k).
+ *
+ * U^T is lower triangular in pivot order U_seq; once z_k is known, row k
+ * of U holds its contribution to the later steps.
+ */
+static void solve_ut_rows(const LUFactors *lu, int m, double *temp) {
+    for (int pos = 0; pos < m; pos++) {
+        int k = lu->U_seq[pos];
+        double z = temp[k];
+        if (z == 0.0) continue;
+        z /= lu->U_diag[k];
+        temp[k] = z;
+        int64_t end = lu->Ur_start[k] + lu->Ur_len[k];
+        for (int64_t p = lu->Ur_start[k]; p < end; p++) {
+            temp[lu->Ur_idx[p]] -= lu->Ur_val[p] * z;
+        }
+    }
+}
+
+/**
+ * @brief Solve U^T * z = temp by columns of U (one dot product per step).
+ *
+ * Column k of U holds U[j,k] for j earlier in the order, i.e. row k of U^T.
+ */
+static void solve_ut_cols(const LUFactors *lu, int m, double *temp) {
+    for (int pos = 0; pos < m; pos++) {
+        int k = lu->U_seq[pos];
+        double sum = temp[k];
+        int64_t end = lu->U_col_ptr[k] + lu->U_col_len[k];
+        for (int64_t p = lu->U_col_ptr[k]; p < end; p++) {
+            int j = lu->U_row_idx[p];  /* Already solved */
+            sum -= lu->U_values[p] * temp[j];
+        }
+        temp[k] = sum / lu->U_diag[k];
+    }
+}
+
+/**
+ * @brief Solve L^T * w = temp by rows of L (scatter, skips zero w_k).
+ *
+ * Backward over the steps; row k of L holds L[k,j] for j < k.
+ */
+static void solve_lt_rows(const LUFactors *lu, int m, double *temp) {
+    for (int k = m - 1; k >= 0; k--) {
+        double w = temp[k];
+        if (w == 0.0) continue;
+        for (int64_t p = lu->Lr_ptr[k]; p < lu->Lr_ptr[k + 1]; p++) {
+            temp[lu->Lr_idx[p]] -= lu->Lr_val[p] * w;
+        }
+    }
+}
+
+/**
+ * @brief Solve L^T * w = temp by columns of L (one dot product per step).
+ *
+ * Column k of L holds L[j,k] for j > k, i.e. row k of L^T (unit diagonal).
+ */
+static void solve_lt_cols(const LUFactors *lu, int m, double *temp) {
+    for (int k = m - 1; k >= 0; k--) {
+        double sum = temp[k];
+        for (int64_t p = lu->L_col_ptr[k]; p < lu->L_col_ptr[k + 1]; p++) {
+            sum -= lu->L_values[p] * temp[lu->L_row_idx[p]];
+        }
+        temp[k] = sum;
+    }
+}
+
+/**
+ * @brief solve_ut_rows reading the float32 copy of row-wise U.
+ */
+static void solve_ut_rows32(const LUFactors *lu, int m, double *temp) {
+    const float *val = lu->Ur_val32;
+    for (int pos = 0; pos < m; pos++) {
+        int k = lu->U_seq[pos];
+        double z = temp[k];
+        if (z == 0.0) continue;
+        z /= lu->U_diag[k];
+        temp[k] = z;
+        int64_t end = lu->Ur_start[k] + lu->Ur_len[k];
+        for (int64_t p = lu->Ur_start[k]; p < end; p++) {
+            temp[lu->Ur_idx[p]] -= (double)val[p] * z;
+        }
+    }
+}
+
+/**
+ * @brief solve_ut_cols reading the float32 copy of U.
+ */
+static void solve_ut_cols32(const LUFactors *lu, int m, double *temp) {
+    const float *val = lu->U_val32;
+    for (int pos = 0; pos < m; pos++) {
+        int k = lu->U_seq[pos];
+        double sum = temp[k];
+        int64_t end = lu->U_col_ptr[k] + lu->U_col_len[k];
+        for (int64_t p = lu->U_col_ptr[k]; p < end; p++) {
+            sum -= (double)val[p] * temp[lu->U_row_idx[p]];
+        }
+        temp[k] = sum / lu->U_diag[k];
+    }
+}
+
+/**
+ * @brief solve_lt_rows reading the float32 copy of row-wise L.
+ */
+static void solve_lt_rows32(const LUFactors *lu, int m, double *temp) {
+    const float *val = lu->Lr_val32;
+    for (int k = m - 1; k >= 0; k--) {
+        double w = temp[k];
+        if (w == 0.0) continue;
+        for (int64_t p = lu->Lr_ptr[k]; p < lu->Lr_ptr[k + 1]; p++) {
+            temp[lu->Lr_idx[p]] -= (double)val[p] * w;
+        }
+    }
+}
+
+/**
+ * @brief solve_lt_cols reading the float32 copy of L.
+ */
+static void solve_lt_cols32(const LUFactors *lu, int m, double *temp) {
+    const float *val = lu->L_val32;
+    for (int k = m - 1; k >= 0; k--) {
+        double sum = temp[k];
+        for (int64_t p = lu->L_col_ptr[k]; p < lu->L_col_ptr[k + 1]; p++) {
+            sum -= (double)val[p] * temp[lu->L_row_idx[p]];
+        }
+        temp[k] = sum;
+    }
+}
+
+/**
+ * @brief Whether the dense BTRAN should sweep the row-wise factors.
+ *
+ * The row-wise sweeps skip the steps whose value is zero, which pays off
+ * while right-hand side and recent results stay below rowwise_threshold;
+ * denser solves run the column-wise dot products, which write each value
+ * once.
+ */
+static int rowwise_wanted(const LUFactors *lu, int count) {
+    double limit = lu->rowwise_threshold * lu->m;
+    return lu->rowwise && count <= limit && lu->btran_density * lu->m <= limit;
+}
 
 /**
  * @brief Apply LU transpose solve for BTRAN.
  *
  * Solves B^T * y = e using LU factors.
- * For B = P^T * L * U * Q:
- *   B^T = Q^T * U^T * L^T * P
- * So solve by: permute, U^T solve, L^T solve, permute back.
+ * For B = P^T * L * R^(-1) * U * Q (R = Forrest-Tomlin row etas):
+ *   B^T = Q^T * U^T * R^(-T) * L^T * P
+ * So solve by: permute, U^T solve, apply R^T, L^T solve, permute back.
+ *
+ * Sparse right-hand sides whose results are expected to stay sparse take
+ * the hypersparse path (cxf_lu_btran_hyper); the others sweep the
+ * row-wise or the column-wise factors depending on density, reading the
+ * float32 factor copies while they are valid.
  *
  * @param lu LUFactors structure.
+ * @param scratch Arena for the permuted work vector (NULL: heap).
  * @param m Dimension.
  * @param result Vector (modified in place).
+ * @param single Set to 1 if a float32 copy was used, else 0.
  */
-static void apply_lu_btran(const LUFactors *lu, int m, double *result) {
-    double *temp = (double *)malloc((size_t)m * sizeof(double));
+static void apply_lu_btran(LUFactors *lu, ScratchArena *scratch, int m,
+                           double *result, int *single) {
+    *single = 0;
+    int nnz = 0;
+    for (int i = 0; i < m; i++) {
+        if (result[i] != 0.0) lu->hs_pattern[nnz++] = i;
+    }
+    if (cxf_lu_btran_hyper(lu, result, lu->hs_pattern, nnz) >= 0) {
+        return;
+    }
+    int rows = rowwise_wanted(lu, nnz);
+
+    ScratchMark mark = {NULL, 0};
+    double *temp;
+    if (scratch != NULL) {
+        mark = cxf_scratch_mark(scratch);
+        temp = (double *)cxf_scratch_alloc(scratch, (size_t)m * sizeof(double));
+    } else {
+        temp = (double *)malloc((size_t)m * sizeof(double));
+    }
     if (temp == NULL) return;
 
     /* Step 1: Apply column permutation Q: temp = Q * result
@@ -42,43 +212,57 @@ static void apply_lu_btran(const LUFactors *lu, int m, double *result) {
         temp[k] = result[lu->perm_col[k]];
     }
 
-    /* Step 2: Solve U^T * z = temp (forward substitution)
-     * U^T is lower triangular (U is upper triangular)
-     * For each row k, divide by diagonal then subtract from later rows */
-    for (int k = 0; k < m; k++) {
-        if (fabs(lu->U_diag[k]) > 1e-15) {
-            temp[k] /= lu->U_diag[k];
+    /* Step 2: Solve U^T * z = temp (forward substitution in pivot order) */
+    if (lu->single_U) {
+        if (rows) {
+            solve_ut_rows32(lu, m, temp);
+        } else {
+            solve_ut_cols32(lu, m, temp);
         }
-        /* U^T[j,k] = U[k,j] for j > k
-         * U_col_ptr[k] to U_col_ptr[k+1] gives entries in U column k above diagonal
-         * These become entries in U^T row k to the right */
-        for (int64_t p = lu->U_col_ptr[k]; p < lu->U_col_ptr[k + 1]; p++) {
-            int j = lu->U_row_idx[p];  /* j > k (step index in upper triangle) */
-            temp[j] -= lu->U_values[p] * temp[k];
+    } else if (rows) {
+        solve_ut_rows(lu, m, temp);
+    } else {
+        solve_ut_cols(lu, m, temp);
+    }
+
+    /* Step 2b: Apply transposed Forrest-Tomlin row etas (newest to oldest) */
+    for (int r = lu->R_count - 1; r >= 0; r--) {
+        double v = temp[lu->R_pivot[r]];
+        if (v == 0.0) continue;
+        for (int64_t p = lu->R_start[r]; p < lu->R_start[r + 1]; p++) {
+            temp[lu->R_idx[p]] -= lu->R_val[p] * v;
         }
     }
 
-    /* Step 3: Solve L^T * w = temp (backward substitution)
-     * L^T is upper triangular with unit diagonal (L is lower with unit diag)
-     * For each column k from m-1 to 0, subtract from result[k] */
-    for (int k = m - 1; k >= 0; k--) {
-        /* L^T[k,j] = L[j,k] for j > k
-         * L_col_ptr[k] gives entries in L column k below diagonal */
-        for (int64_t p = lu->L_col_ptr[k]; p < lu->L_col_ptr[k + 1]; p++) {
-            int j = lu->L_row_idx[p];  /* j > k (row index in lower triangle) */
-            temp[k] -= lu->L_values[p] * temp[j];
+    /* Step 3: Solve L^T * w = temp (backward substitution, unit diagonal) */
+    if (lu->single_L) {
+        if (rows) {
+            solve_lt_rows32(lu, m, temp);
+        } else {
+            solve_lt_cols32(lu, m, temp);
         }
-        /* Unit diagonal, no division needed */
+    } else if (rows) {
+        solve_lt_rows(lu, m, temp);
+    } else {
+        solve_lt_cols(lu, m, temp);
     }
+    *single = lu->single_L || lu->single_U;
 
     /* Step 4: Apply row permutation P^T: result = P^T * temp
      * P: perm_row[k] = original row at position k
      * P^T: result[perm_row[k]] = temp[k] */
+    nnz = 0;
     for (int k = 0; k < m; k++) {
         result[lu->perm_row[k]] = temp[k];
+        if (temp[k] != 0.0) nnz++;
     }
+    cxf_lu_track_density(&lu->btran_density, nnz, m);
 
-    free(temp);
+    if (scratch != NULL) {
+        cxf_scratch_release(scratch, mark);
+    } else {
+        free(temp);
+    }
 }
 
 /**
@@ -96,6 +280,174 @@ static void apply_diag_btran(const double *diag_coeff, int m, double *result) {
     }
 }
 
+/**
+ * @brief Apply the transposed eta vectors (newest to oldest).
+ *
+ * Reads the chronological eta file back to front.
+ *
+ * @param basis BasisState holding the eta file.
+ * @param m Dimension.
+ * @param result Vector (modified in place).
+ * @return CXF_OK on success, error code on failure.
+ */
+static int apply_etas_transposed(const BasisState *basis, int m, double *result) {
+    const int64_t *start = basis->eta_start;
+    const int *idx = basis->eta_idx;
+    const double *val = basis->eta_val;
+
+    for (int e = basis->eta_count - 1; e >= 0; e--) {
+        int pivot_row = basis->eta_row[e];
+        double pivot_elem = basis->eta_pivot[e];
+
+        /* Bounds check pivot row */
+        if (pivot_row < 0 || pivot_row >= m) {
+            return CXF_ERROR_INVALID_ARGUMENT;
+        }
+
+        /* Numerical stability check */
+        if (pivot_elem == 0.0 || !isfinite(pivot_elem)) {
+            return CXF_ERROR_INVALID_ARGUMENT;
+        }
+
+        /* Compute dot product of off-diagonal entries with result */
+        double temp = 0.0;
+        for (int64_t k = start[e]; k < start[e + 1]; k++) {
+            int j = idx[k];
+            if (j >= 0 && j < m && j != pivot_row) {
+                temp += val[k] * result[j];
+            }
+        }
+
+        /* Update pivot position */
+        result[pivot_row] = (result[pivot_row] - temp) / pivot_elem;
+    }
+    return CXF_OK;
+}
+
+/**
+ * @brief y = B^(-T) * y: transposed etas, then the LU solve (or diagonal).
+ *
+ * @param basis BasisState containing the factorization.
+ * @param y Vector (modified in place).
+ * @param single Set to 1 if the float32 factor copies were used.
+ * @return CXF_OK on success, error code on failure.
+ */
+static int solve_in_place(BasisState *basis, double *y, int *single) {
+    int m = basis->m;
+    *single = 0;
+
+    /* Apply eta vectors in reverse order (newest to oldest) */
+    int rc = apply_etas_transposed(basis, m, y);
+    if (rc != CXF_OK) {
+        return rc;
+    }
+
+    /* Apply B_0^(-T) - must be done AFTER eta vectors */
+    if (basis->lu != NULL && basis->lu->valid) {
+        apply_lu_btran(basis->lu, basis->scratch, m, y, single);
+    } else if (basis->diag_coeff != NULL) {
+        apply_diag_btran(basis->diag_coeff, m, y);
+    }
+    return CXF_OK;
+}
+
+/**
+ * @brief Iterative refinement of y = B^(-T) * c after a float32 solve.
+ *
+ * Same scheme as the FTRAN refinement (ftran.c) with the residual
+ * c - B^T * y; falls back to the fp64 factors if it does not converge.
+ *
+ * @param basis BasisState with basis->matrix set.
+ * @param c Right-hand side (not aliasing y).
+ * @param y Solution from the float32 solve, refined in place.
+ * @return CXF_OK on success, error code on failure.
+ */
+static int refine(BasisState *basis, const double *c, double *y) {
+    int m = basis->m;
+    ScratchArena *scratch = basis->scratch;
+    ScratchMark mark = {NULL, 0};
+    double *r;
+    if (scratch != NULL) {
+        mark = cxf_scratch_mark(scratch);
+        r = (double *)cxf_scratch_alloc(scratch, (size_t)m * sizeof(double));
+    } else {
+        r = (double *)malloc((size_t)m * sizeof(double));
+    }
+    if (r == NULL) return CXF_ERROR_OUT_OF_MEMORY;
+
+    int rc = CXF_OK;
+    int converged = 0;
+    int single;
+    for (int step = 0; rc == CXF_OK; step++) {
+        double res = cxf_basis_residual(basis, 1, c, y, r);
+        if (step > 0 && res <= CXF_FEASIBILITY_TOL) {
+            converged = 1;
+            break;
+        }
+        if (step == CXF_REFINE_STEPS) break;
+        rc = solve_in_place(basis, r, &single);
+        for (int i = 0; i < m && rc == CXF_OK; i++) {
+            y[i] += r[i];
+        }
+    }
+
+    if (rc == CXF_OK && !converged) {
+        cxf_lu_drop_single(basis->lu);
+        memcpy(y, c, (size_t)m * sizeof(double));
+        rc = solve_in_place(basis, y, &single);
+    }
+
+    if (scratch != NULL) {
+        cxf_scratch_release(scratch, mark);
+    } else {
+        free(r);
+    }
+    return rc;
+}
+
+/**
+ * @brief Solve in place, refining a float32 result against the input.
+ *
+ * @param basis BasisState containing the factorization.
+ * @param y Right-hand side on entry, B^(-T) times it on return.
+ * @return CXF_OK on success, error code on failure.
+ */
+static int solve_refined(BasisState *basis, double *y) {
+    const LUFactors *lu = basis->lu;
+    if (lu == NULL || !lu->valid || !(lu->single_L || lu->single_U)) {
+        int single;
+        return solve_in_place(basis, y, &single);
+    }
+
+    size_t bytes = (size_t)basis->m * sizeof(double);
+    ScratchMark mark = {NULL, 0};
+    double *c;
+    if (basis->scratch != NULL) {
+        mark = cxf_scratch_mark(basis->scratch);
+        c = (double *)cxf_scratch_alloc(basis->scratch, bytes);
+    } else {
+        c = (double *)malloc(bytes);
+    }
+    if (c == NULL) {
+        cxf_lu_drop_single(basis->lu);
+    } else {
+        memcpy(c, y, bytes);
+    }
+
+    int single;
+    int rc = solve_in_place(basis, y, &single);
+    if (rc == CXF_OK && single) {
+        rc = refine(basis, c, y);
+    }
+
+    if (basis->scratch != NULL) {
+        cxf_scratch_release(basis->scratch, mark);
+    } else {
+        free(c);
+    }
+    return rc;
+}
+
 /**
  * @brief Backward transformation: solve y^T B = e_row^T.
  *
@@ -109,6 +461,7 @@ static void apply_diag_btran(const double *diag_coeff, int m, double *result) {
  * To compute B^(-T) * y:
  * 1. Apply E_k^(-T), E_{k-1}^(-T), ..., E_1^(-T) (newest to oldest)
  * 2. Apply B_0^(-T) last
+ * 3. In mixed-precision mode: refine the result in fp64
  *
  * @param basis BasisState containing the eta factorization.
  * @param row Row index for unit vector e_row (0 <= row < basis->m).
@@ -135,77 +488,8 @@ int cxf_btran(BasisState *basis, int row, double *result) {
     memset(result, 0, (size_t)m * sizeof(double));
     result[row] = 1.0;
 
-    /* Step 2: Apply eta vectors in reverse order (newest to oldest) */
-    int eta_count = basis->eta_count;
-    if (eta_count > 0) {
-        /* Use stack allocation for small eta counts, heap for large */
-        EtaFactors *stack_etas[MAX_STACK_ETAS];
-        EtaFactors **etas = stack_etas;
-
-        if (eta_count > MAX_STACK_ETAS) {
-            etas = (EtaFactors **)malloc((size_t)eta_count * sizeof(EtaFactors *));
-            if (etas == NULL) {
-                return CXF_ERROR_OUT_OF_MEMORY;
-            }
-        }
-
-        /* Traverse linked list to collect eta pointers */
-        EtaFactors *eta = basis->eta_head;
-        int count = 0;
-        while (eta != NULL && count < eta_count) {
-            etas[count++] = eta;
-            eta = eta->next;
-        }
-
-        /* Apply eta vectors: etas[0] = newest, iterate 0 to count-1 */
-        for (int i = 0; i < count; i++) {
-            eta = etas[i];
-            int pivot_row = eta->pivot_row;
-            double pivot_elem = eta->pivot_elem;
-
-            /* Bounds check pivot row */
-            if (pivot_row < 0 || pivot_row >= m) {
-                if (etas != stack_etas) {
-                    free(etas);
-                }
-                return CXF_ERROR_INVALID_ARGUMENT;
-            }
-
-            /* Numerical stability check */
-            if (pivot_elem == 0.0 || !isfinite(pivot_elem)) {
-                if (etas != stack_etas) {
-                    free(etas);
-                }
-                return CXF_ERROR_INVALID_ARGUMENT;
-            }
-
-            /* Compute dot product of off-diagonal entries with result */
-            double temp = 0.0;
-            for (int k = 0; k < eta->nnz; k++) {
-                int j = eta->indices[k];
-                if (j >= 0 && j < m && j != pivot_row) {
-                    temp += eta->values[k] * result[j];
-                }
-            }
-
-            /* Update pivot position */
-            result[pivot_row] = (result[pivot_row] - temp) / pivot_elem;
-        }
-
-        /* Cleanup heap allocation if used */
-        if (etas != stack_etas) {
-            free(etas);
-        }
-    }
-
-    /* Step 3: Apply B_0^(-T) - must be done AFTER eta vectors */
-    if (basis->lu != NULL && basis->lu->valid) {
-        apply_lu_btran(basis->lu, m, result);
-    } else if (basis->diag_coeff != NULL) {
-        apply_diag_btran(basis->diag_coeff, m, result);
-    }
-
-    return CXF_OK;
+    /* Step 2: Apply etas (newest to oldest), then B_0^(-T) */
+    return solve_refined(basis, result);
 }
 
 /**
@@ -240,75 +524,6 @@ int cxf_btran_vec(BasisState *basis, const double *input, double *result) {
     /* Step 1: Initialize result = input */
     memcpy(result, input, (size_t)m * sizeof(double));
 
-    /* Step 2: Apply eta vectors in reverse order (newest to oldest) */
-    int eta_count = basis->eta_count;
-    if (eta_count > 0) {
-        /* Use stack allocation for small eta counts, heap for large */
-        EtaFactors *stack_etas[MAX_STACK_ETAS];
-        EtaFactors **etas = stack_etas;
-
-        if (eta_count > MAX_STACK_ETAS) {
-            etas = (EtaFactors **)malloc((size_t)eta_count * sizeof(EtaFactors *));
-            if (etas == NULL) {
-                return CXF_ERROR_OUT_OF_MEMORY;
-            }
-        }
-
-        /* Traverse linked list to collect eta pointers */
-        EtaFactors *eta = basis->eta_head;
-        int count = 0;
-        while (eta != NULL && count < eta_count) {
-            etas[count++] = eta;
-            eta = eta->next;
-        }
-
-        /* Apply eta vectors: etas[0] = newest, iterate 0 to count-1 */
-        for (int i = 0; i < count; i++) {
-            eta = etas[i];
-            int pivot_row = eta->pivot_row;
-            double pivot_elem = eta->pivot_elem;
-
-            /* Bounds check pivot row */
-            if (pivot_row < 0 || pivot_row >= m) {
-                if (etas != stack_etas) {
-                    free(etas);
-                }
-                return CXF_ERROR_INVALID_ARGUMENT;
-            }
-
-            /* Numerical stability check */
-            if (pivot_elem == 0.0 || !isfinite(pivot_elem)) {
-                if (etas != stack_etas) {
-                    free(etas);
-                }
-                return CXF_ERROR_INVALID_ARGUMENT;
-            }
-
-            /* Compute dot product of off-diagonal entries with result */
-            double temp = 0.0;
-            for (int k = 0; k < eta->nnz; k++) {
-                int j = eta->indices[k];
-                if (j >= 0 && j < m && j != pivot_row) {
-                    temp += eta->values[k] * result[j];
-                }
-            }
-
-            /* Update pivot position */
-            result[pivot_row] = (result[pivot_row] - temp) / pivot_elem;
-        }
-
-        /* Cleanup heap allocation if used */
-        if (etas != stack_etas) {
-            free(etas);
-        }
-    }
-
-    /* Step 3: Apply B_0^(-T) - must be done AFTER eta vectors */
-    if (basis->lu != NULL && basis->lu->valid) {
-        apply_lu_btran(basis->lu, m, result);
-    } else if (basis->diag_coeff != NULL) {
-        apply_diag_btran(basis->diag_coeff, m, result);
-    }
-
-    return CXF_OK;
+    /* Step 2: Apply etas (newest to oldest), then B_0^(-T) */
+    return solve_refined(basis, result);
 }
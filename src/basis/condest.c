@@ -0,0 +1,157 @@
+/**
+ * @file condest.c
+ * @brief 1-norm condition estimate of the basis (Hager/Higham).
+ *
+ * kappa_1(B) = ||B||_1 * ||B^(-1)||_1. The first factor is the largest
+ * column sum of the basis columns. The second is estimated without
+ * forming B^(-1): Hager's method maximizes ||B^(-1) x||_1 over the unit
+ * 1-norm ball by a gradient walk over its vertices, each step costing one
+ * FTRAN and one BTRAN. Higham's alternating-sign vector guards against
+ * the cases where the walk stops at a poor local maximum. The result is
+ * a lower bound that is almost always within a factor of 3 of the truth.
+ */
+
+#include "convexfeld/cxf_basis.h"
+#include "convexfeld/cxf_matrix.h"
+#include "convexfeld/cxf_types.h"
+#include <stdlib.h>
+#include <math.h>
+
+/* Scratch arena (memory/scratch.c) */
+extern ScratchMark cxf_scratch_mark(const ScratchArena *arena);
+extern void *cxf_scratch_alloc(ScratchArena *arena, size_t size);
+extern void cxf_scratch_release(ScratchArena *arena, ScratchMark mark);
+
+/* FTRAN (ftran.c) */
+extern int cxf_ftran(BasisState *basis, const double *column, double *result);
+
+/* Most gradient steps of the Hager walk */
+#define CONDEST_MAX_STEPS 5
+
+/**
+ * @brief ||B||_1: largest 1-norm of a basis column.
+ */
+static double basis_norm1(const BasisState *basis) {
+    int m = basis->m;
+    int n_orig = basis->n - m;
+    const SparseMatrix *A = basis->matrix;
+    double norm = 0.0;
+
+    for (int k = 0; k < m; k++) {
+        int var = basis->basic_vars[k];
+        double sum = 0.0;
+        if (var >= n_orig) {
+            sum = fabs(basis->diag_coeff[var - n_orig]);
+        } else {
+            for (int64_t p = A->col_ptr[var]; p < A->col_ptr[var + 1]; p++) {
+                sum += fabs(A->values[p]);
+            }
+        }
+        if (sum > norm) norm = sum;
+    }
+    return norm;
+}
+
+static double norm1(const double *v, int m) {
+    double sum = 0.0;
+    for (int i = 0; i < m; i++) {
+        sum += fabs(v[i]);
+    }
+    return sum;
+}
+
+/**
+ * @brief Estimate the 1-norm condition number of the current basis.
+ *
+ * @param basis Basis state with valid factors and basis->matrix set
+ *              (set by cxf_solver_refactor).
+ * @param cond Output: estimate of ||B||_1 * ||B^(-1)||_1.
+ * @return CXF_OK on success, CXF_ERROR_INVALID_ARGUMENT without a matrix,
+ *         CXF_ERROR_OUT_OF_MEMORY, or the error of a failed solve.
+ */
+int cxf_basis_condest(BasisState *basis, double *cond) {
+    if (basis == NULL || cond == NULL) {
+        return CXF_ERROR_NULL_ARGUMENT;
+    }
+    int m = basis->m;
+    *cond = 1.0;
+    if (m == 0) {
+        return CXF_OK;
+    }
+    if (basis->matrix == NULL) {
+        return CXF_ERROR_INVALID_ARGUMENT;
+    }
+
+    ScratchArena *scratch = basis->scratch;
+    ScratchMark mark = {NULL, 0};
+    size_t bytes = (size_t)m * sizeof(double);
+    double *x, *y;
+    if (scratch != NULL) {
+        mark = cxf_scratch_mark(scratch);
+        x = (double *)cxf_scratch_alloc(scratch, bytes);
+        y = (double *)cxf_scratch_alloc(scratch, bytes);
+    } else {
+        x = (double *)malloc(bytes);
+        y = (double *)malloc(bytes);
+    }
+    int rc = CXF_OK;
+    if (x == NULL || y == NULL) {
+        rc = CXF_ERROR_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    /* Hager: start from the barycenter of the 1-norm ball */
+    double est = 0.0;
+    int last = -1;
+    for (int i = 0; i < m; i++) {
+        x[i] = 1.0 / m;
+    }
+    for (int step = 0; step < CONDEST_MAX_STEPS; step++) {
+        rc = cxf_ftran(basis, x, y);
+        if (rc != CXF_OK) goto done;
+        double ny = norm1(y, m);
+        if (step > 0 && ny <= est) break;
+        est = ny;
+
+        /* Gradient z = B^(-T) sign(y) */
+        for (int i = 0; i < m; i++) {
+            y[i] = (y[i] >= 0.0) ? 1.0 : -1.0;
+        }
+        rc = cxf_btran_vec(basis, y, x);
+        if (rc != CXF_OK) goto done;
+        int j = 0;
+        double ztx = 0.0;  /* z^T x for the x of this step */
+        for (int i = 0; i < m; i++) {
+            if (fabs(x[i]) > fabs(x[j])) j = i;
+            if (last < 0) ztx += x[i] / m;
+        }
+        if (last >= 0) ztx = x[last];
+        if (fabs(x[j]) <= ztx) break;  /* No vertex improves: local maximum */
+        last = j;
+        for (int i = 0; i < m; i++) {
+            x[i] = 0.0;
+        }
+        x[j] = 1.0;
+    }
+
+    /* Higham: alternating-sign vector, scaled to be a lower bound too */
+    for (int i = 0; i < m; i++) {
+        double t = (m > 1) ? 1.0 + (double)i / (m - 1) : 1.0;
+        x[i] = (i % 2 == 0) ? t : -t;
+    }
+    rc = cxf_ftran(basis, x, y);
+    if (rc != CXF_OK) goto done;
+    double alt = 2.0 * norm1(y, m) / (3.0 * m);
+    if (alt > est) est = alt;
+
+    *cond = basis_norm1(basis) * est;
+
+done:
+    if (scratch != NULL) {
+        cxf_scratch_release(scratch, mark);
+    } else {
+        free(x);
+        free(y);
+    }
+    return rc;
+}
@@ -15,62 +15,344 @@
 #include <string.h>
 #include <math.h>
 
-/** Maximum stack-allocated eta pointers before heap allocation */
-#define MAX_STACK_ETAS 64
+/* Scratch arena (memory/scratch.c) */
+extern ScratchMark cxf_scratch_mark(const ScratchArena *arena);
+extern void *cxf_scratch_alloc(ScratchArena *arena, size_t size);
+extern void cxf_scratch_release(ScratchArena *arena, ScratchMark mark);
+
+/**
+ * @brief Solve L * w = temp in place (unit lower triangular, column-wise).
+ */
+static void solve_l(const LUFactors *lu, int m, double *temp) {
+    for (int k = 0; k < m; k++) {
+        double tk = temp[k];
+        if (tk == 0.0) continue;  /* Skip zeros */
+        for (int64_t p = lu->L_col_ptr[k]; p < lu->L_col_ptr[k + 1]; p++) {
+            int j = lu->L_row_idx[p];  /* Row index > k (below diagonal) */
+            temp[j] -= lu->L_values[p] * tk;
+        }
+    }
+}
+
+/**
+ * @brief solve_l reading the float32 copy of L.
+ */
+static void solve_l32(const LUFactors *lu, int m, double *temp) {
+    const float *val = lu->L_val32;
+    for (int k = 0; k < m; k++) {
+        double tk = temp[k];
+        if (tk == 0.0) continue;
+        for (int64_t p = lu->L_col_ptr[k]; p < lu->L_col_ptr[k + 1]; p++) {
+            temp[lu->L_row_idx[p]] -= (double)val[p] * tk;
+        }
+    }
+}
+
+/**
+ * @brief Solve U * y = temp in place, in reverse pivot order U_seq.
+ *
+ * Divide by the diagonal, then update rows earlier in the order.
+ */
+static void solve_u(const LUFactors *lu, int m, double *temp) {
+    for (int pos = m - 1; pos >= 0; pos--) {
+        int k = lu->U_seq[pos];
+        if (temp[k] == 0.0) continue;  /* Skip zeros */
+        double yk = temp[k] / lu->U_diag[k];
+        temp[k] = yk;
+        int64_t end = lu->U_col_ptr[k] + lu->U_col_len[k];
+        for (int64_t p = lu->U_col_ptr[k]; p < end; p++) {
+            int j = lu->U_row_idx[p];  /* Earlier in pivot order */
+            temp[j] -= lu->U_values[p] * yk;
+        }
+    }
+}
+
+/**
+ * @brief solve_u reading the float32 copy of U (diagonal stays fp64).
+ */
+static void solve_u32(const LUFactors *lu, int m, double *temp) {
+    const float *val = lu->U_val32;
+    for (int pos = m - 1; pos >= 0; pos--) {
+        int k = lu->U_seq[pos];
+        if (temp[k] == 0.0) continue;
+        double yk = temp[k] / lu->U_diag[k];
+        temp[k] = yk;
+        int64_t end = lu->U_col_ptr[k] + lu->U_col_len[k];
+        for (int64_t p = lu->U_col_ptr[k]; p < end; p++) {
+            temp[lu->U_row_idx[p]] -= (double)val[p] * yk;
+        }
+    }
+}
 
 /**
  * @brief Apply LU forward/backward substitution.
  *
- * Solves B * x = b where B = P^T * L * U * Q (with permutations).
- * Steps: temp = P * b, L * w = temp, U * y = w, x = Q^T * y
+ * Solves B * x = b where B = P^T * L * R^(-1) * U * Q (with permutations),
+ * R being the product of Forrest-Tomlin row etas (identity after refactor).
+ * Steps: temp = P * b, L * w = temp, apply R, U * y = w, x = Q^T * y
+ *
+ * Sparse right-hand sides whose results are expected to stay sparse take
+ * the hypersparse path (cxf_lu_ftran_hyper) instead of the dense sweeps.
+ * The dense sweeps read the float32 factor copies while they are valid.
  *
  * @param lu LUFactors structure with factorization.
+ * @param scratch Arena for the permuted work vector (NULL: heap).
  * @param m Dimension.
  * @param result Vector (modified in place).
+ * @param pattern Nonzero indices of result on entry and on return.
+ * @param count Number of entries in pattern on entry.
+ * @param single Set to 1 if a float32 copy was used, else 0.
+ * @return Number of entries in pattern on return.
  */
-static void apply_lu_solve(const LUFactors *lu, int m, double *result) {
+static int apply_lu_solve(LUFactors *lu, ScratchArena *scratch, int m,
+                          double *result, int *pattern, int count,
+                          int *single) {
+    *single = 0;
+    int hyper = cxf_lu_ftran_hyper(lu, result, pattern, count);
+    if (hyper >= 0) {
+        return hyper;
+    }
+
     /* Step 1: Permute input by row permutation: temp = P * result
      * perm_row[k] = original row that becomes position k */
-    double *temp = (double *)malloc((size_t)m * sizeof(double));
-    if (temp == NULL) return;  /* Fall back to eta-only on alloc failure */
+    ScratchMark mark = {NULL, 0};
+    double *temp;
+    if (scratch != NULL) {
+        mark = cxf_scratch_mark(scratch);
+        temp = (double *)cxf_scratch_alloc(scratch, (size_t)m * sizeof(double));
+    } else {
+        temp = (double *)malloc((size_t)m * sizeof(double));
+    }
+    if (temp == NULL) return count;  /* Fall back to eta-only on alloc failure */
 
     for (int k = 0; k < m; k++) {
         temp[k] = result[lu->perm_row[k]];
     }
 
     /* Step 2: Forward substitution L * w = temp
-     * L is unit lower triangular, stored column-wise.
+     * L is unit lower triangular, stored column-wise in step space.
      * For each column k, update rows below k. */
-    for (int k = 0; k < m; k++) {
-        if (fabs(temp[k]) < 1e-15) continue;  /* Skip zeros */
-        for (int64_t p = lu->L_col_ptr[k]; p < lu->L_col_ptr[k + 1]; p++) {
-            int j = lu->L_row_idx[p];  /* Row index > k (below diagonal) */
-            temp[j] -= lu->L_values[p] * temp[k];
+    if (lu->single_L) {
+        solve_l32(lu, m, temp);
+    } else {
+        solve_l(lu, m, temp);
+    }
+
+    /* Step 2b: Apply Forrest-Tomlin row etas (oldest to newest) */
+    for (int r = 0; r < lu->R_count; r++) {
+        double sum = 0.0;
+        for (int64_t p = lu->R_start[r]; p < lu->R_start[r + 1]; p++) {
+            sum += lu->R_val[p] * temp[lu->R_idx[p]];
         }
+        temp[lu->R_pivot[r]] -= sum;
     }
 
     /* Step 3: Backward substitution U * y = temp
-     * U is upper triangular with explicit diagonal. */
-    for (int k = m - 1; k >= 0; k--) {
-        /* Subtract off-diagonal contributions */
-        for (int64_t p = lu->U_col_ptr[k]; p < lu->U_col_ptr[k + 1]; p++) {
-            int j = lu->U_row_idx[p];  /* Step index > k (right of diagonal) */
-            temp[k] -= lu->U_values[p] * temp[j];
-        }
-        /* Divide by diagonal */
-        if (fabs(lu->U_diag[k]) > 1e-15) {
-            temp[k] /= lu->U_diag[k];
-        }
+     * U is upper triangular in pivot order U_seq, stored column-wise. */
+    if (lu->single_U) {
+        solve_u32(lu, m, temp);
+    } else {
+        solve_u(lu, m, temp);
     }
+    *single = lu->single_L || lu->single_U;
 
     /* Step 4: Permute output by column permutation: result = Q^T * temp
      * perm_col[k] = original col that becomes position k
      * Q^T: result[perm_col[k]] = temp[k] */
+    count = 0;
     for (int k = 0; k < m; k++) {
-        result[lu->perm_col[k]] = temp[k];
+        int i = lu->perm_col[k];
+        result[i] = temp[k];
+        if (temp[k] != 0.0) pattern[count++] = i;
+    }
+    cxf_lu_track_density(&lu->ftran_density, count, m);
+
+    if (scratch != NULL) {
+        cxf_scratch_release(scratch, mark);
+    } else {
+        free(temp);
+    }
+    return count;
+}
+
+/**
+ * @brief Apply the eta vectors in chronological order (oldest to newest).
+ *
+ * The eta file is stored in chronological order, so it is read front to
+ * back without any pointer collection.
+ * With a pattern, result is a sparse accumulator: only entries the etas
+ * touch are visited, and new nonzeros are appended to the pattern.
+ *
+ * @param basis BasisState holding the eta file.
+ * @param m Dimension.
+ * @param result Vector (modified in place).
+ * @param pattern Nonzero indices of result, or NULL for a dense vector.
+ * @param count Number of entries in pattern (updated).
+ * @return CXF_OK on success, error code on failure.
+ */
+static int apply_etas(const BasisState *basis, int m, double *result,
+                      int *pattern, int *count) {
+    const int64_t *start = basis->eta_start;
+    const int *idx = basis->eta_idx;
+    const double *val = basis->eta_val;
+
+    for (int e = 0; e < basis->eta_count; e++) {
+        int pivot_row = basis->eta_row[e];
+        double pivot_elem = basis->eta_pivot[e];
+
+        /* Bounds check pivot row */
+        if (pivot_row < 0 || pivot_row >= m) {
+            return CXF_ERROR_INVALID_ARGUMENT;
+        }
+
+        /* Numerical stability check */
+        if (pivot_elem == 0.0 || !isfinite(pivot_elem)) {
+            return CXF_ERROR_INVALID_ARGUMENT;
+        }
+
+        /* Apply eta transformation for E^(-1):
+         *   factor = result[r] / pivot_elem
+         *   result[r] = factor
+         *   result[j] = result[j] - col[j] * factor  for j != r
+         */
+        if (result[pivot_row] == 0.0) {
+            continue;  /* Nothing to eliminate */
+        }
+        double factor = result[pivot_row] / pivot_elem;
+        result[pivot_row] = factor;
+
+        /* Apply off-diagonal entries */
+        for (int64_t k = start[e]; k < start[e + 1]; k++) {
+            int j = idx[k];
+            if (j < 0 || j >= m || j == pivot_row) continue;
+            double old = result[j];
+            double v = old - val[k] * factor;
+            if (pattern != NULL) {
+                if (old == 0.0) {
+                    pattern[(*count)++] = j;
+                } else if (v == 0.0) {
+                    v = CXF_TINY_VALUE;
+                }
+            }
+            result[j] = v;
+        }
     }
 
-    free(temp);
+    return CXF_OK;
+}
+
+/**
+ * @brief x = B^(-1) * x: LU solve (or diagonal scaling), then the etas.
+ *
+ * @param basis BasisState containing the factorization.
+ * @param x Vector (modified in place).
+ * @param pattern Nonzero indices of x (sparse accumulator), or NULL for a
+ *                dense vector.
+ * @param count Number of entries in pattern (updated; NULL if dense).
+ * @param single Set to 1 if the float32 factor copies were used.
+ * @return CXF_OK on success, error code on failure.
+ */
+static int solve_in_place(BasisState *basis, double *x, int *pattern,
+                          int *count, int *single) {
+    int m = basis->m;
+    *single = 0;
+
+    if (basis->lu != NULL && basis->lu->valid) {
+        LUFactors *lu = basis->lu;
+        if (pattern != NULL) {
+            *count = apply_lu_solve(lu, basis->scratch, m, x, pattern, *count, single);
+        } else {
+            int nnz = 0;
+            for (int i = 0; i < m; i++) {
+                if (x[i] != 0.0) lu->hs_pattern[nnz++] = i;
+            }
+            apply_lu_solve(lu, basis->scratch, m, x, lu->hs_pattern, nnz, single);
+        }
+    } else if (basis->diag_coeff != NULL) {
+        /* Fall back to diagonal scaling (legacy mode) */
+        int nz = (pattern != NULL) ? *count : m;
+        for (int k = 0; k < nz; k++) {
+            int i = (pattern != NULL) ? pattern[k] : k;
+            x[i] *= basis->diag_coeff[i];
+        }
+    }
+
+    return apply_etas(basis, m, x, pattern, count);
+}
+
+/**
+ * @brief Whether the next solve may read the float32 factor copies.
+ */
+static int single_active(const BasisState *basis) {
+    const LUFactors *lu = basis->lu;
+    return lu != NULL && lu->valid && (lu->single_L || lu->single_U);
+}
+
+/**
+ * @brief Iterative refinement of x = B^(-1) * b after a float32 solve.
+ *
+ * Each step solves B * d = b - B * x with the same factors and adds d
+ * to x, at least once and at most CXF_REFINE_STEPS times, until the fp64
+ * residual is within CXF_FEASIBILITY_TOL. Otherwise the float32 copies
+ * are dropped and x is recomputed with the fp64 factors.
+ *
+ * @param basis BasisState with basis->matrix set.
+ * @param b Right-hand side (not aliasing x).
+ * @param x Solution from the float32 solve, refined in place.
+ * @return CXF_OK on success, error code on failure.
+ */
+static int refine(BasisState *basis, const double *b, double *x) {
+    int m = basis->m;
+    ScratchArena *scratch = basis->scratch;
+    ScratchMark mark = {NULL, 0};
+    double *r;
+    if (scratch != NULL) {
+        mark = cxf_scratch_mark(scratch);
+        r = (double *)cxf_scratch_alloc(scratch, (size_t)m * sizeof(double));
+    } else {
+        r = (double *)malloc((size_t)m * sizeof(double));
+    }
+    if (r == NULL) return CXF_ERROR_OUT_OF_MEMORY;
+
+    int rc = CXF_OK;
+    int converged = 0;
+    int single;
+    for (int step = 0; rc == CXF_OK; step++) {
+        double res = cxf_basis_residual(basis, 0, b, x, r);
+        if (step > 0 && res <= CXF_FEASIBILITY_TOL) {
+            converged = 1;
+            break;
+        }
+        if (step == CXF_REFINE_STEPS) break;
+        rc = solve_in_place(basis, r, NULL, NULL, &single);
+        for (int i = 0; i < m && rc == CXF_OK; i++) {
+            x[i] += r[i];
+        }
+    }
+
+    if (rc == CXF_OK && !converged) {
+        cxf_lu_drop_single(basis->lu);
+        memcpy(x, b, (size_t)m * sizeof(double));
+        rc = solve_in_place(basis, x, NULL, NULL, &single);
+    }
+
+    if (scratch != NULL) {
+        cxf_scratch_release(scratch, mark);
+    } else {
+        free(r);
+    }
+    return rc;
+}
+
+/**
+ * @brief Copy of a right-hand side kept for refinement (NULL: heap).
+ */
+static double *save_rhs(BasisState *basis, const double *x) {
+    size_t bytes = (size_t)basis->m * sizeof(double);
+    double *b = (basis->scratch != NULL) ?
+        (double *)cxf_scratch_alloc(basis->scratch, bytes) : (double *)malloc(bytes);
+    if (b != NULL) memcpy(b, x, bytes);
+    return b;
 }
 
 /**
@@ -83,6 +365,7 @@ static void apply_lu_solve(const LUFactors *lu, int m, double *result) {
  * 1. Copy input column to result
  * 2. If LU factors valid: apply LU solve (forward + backward substitution)
  * 3. Apply eta vectors in chronological order (oldest to newest)
+ * 4. In mixed-precision mode: refine the result in fp64
  *
  * @param basis BasisState containing the factorization.
  * @param column Input column vector to transform (length = basis->m).
@@ -102,90 +385,80 @@ int cxf_ftran(BasisState *basis, const double *column, double *result) {
         return CXF_OK;
     }
 
-    /* Step 1: Copy input column to result */
+    ScratchMark mark = {NULL, 0};
+    if (basis->scratch != NULL) mark = cxf_scratch_mark(basis->scratch);
+    double *b = NULL;
+    if (single_active(basis)) {
+        b = save_rhs(basis, column);
+        if (b == NULL) cxf_lu_drop_single(basis->lu);
+    }
+
+    /* Steps 1-3: Copy input column to result, LU solve, etas */
     memcpy(result, column, (size_t)m * sizeof(double));
+    int single;
+    int rc = solve_in_place(basis, result, NULL, NULL, &single);
 
-    /* Step 2: Apply LU solve if factors are available */
-    if (basis->lu != NULL && basis->lu->valid) {
-        apply_lu_solve(basis->lu, m, result);
-    } else if (basis->diag_coeff != NULL) {
-        /* Fall back to diagonal scaling (legacy mode) */
-        for (int i = 0; i < m; i++) {
-            result[i] *= basis->diag_coeff[i];
-        }
+    /* Step 4: Refine a float32 result */
+    if (rc == CXF_OK && single) {
+        rc = refine(basis, b, result);
     }
 
-    /* Step 3: Apply eta vectors in chronological order (oldest to newest) */
-    int eta_count = basis->eta_count;
-    if (eta_count == 0) {
-        return CXF_OK;
+    if (basis->scratch != NULL) {
+        cxf_scratch_release(basis->scratch, mark);
+    } else {
+        free(b);
     }
+    return rc;
+}
 
-    /* Use stack allocation for small eta counts, heap for large */
-    EtaFactors *stack_etas[MAX_STACK_ETAS];
-    EtaFactors **etas = stack_etas;
-
-    if (eta_count > MAX_STACK_ETAS) {
-        etas = (EtaFactors **)malloc((size_t)eta_count * sizeof(EtaFactors *));
-        if (etas == NULL) {
-            return CXF_ERROR_OUT_OF_MEMORY;
-        }
+/**
+ * @brief Forward transformation of a sparse accumulator, in place.
+ *
+ * Same as cxf_ftran, but x carries the nonzero pattern of the column in
+ * and of the result out, so a sparse column with a sparse result never
+ * costs O(m). A refined mixed-precision result has its pattern rebuilt
+ * by a scan of all m entries (it came from the dense sweeps anyway).
+ *
+ * @param basis BasisState containing the factorization.
+ * @param x Sparse accumulator of dimension basis->m (see VectorContainer).
+ * @return CXF_OK on success, error code on failure.
+ */
+int cxf_ftran_sparse(BasisState *basis, VectorContainer *x) {
+    if (basis == NULL || x == NULL) {
+        return CXF_ERROR_NULL_ARGUMENT;
     }
 
-    /* Traverse linked list to collect eta pointers
-     * Head is newest, tail (last in list) is oldest */
-    EtaFactors *eta = basis->eta_head;
-    int count = 0;
-    while (eta != NULL && count < eta_count) {
-        etas[count++] = eta;
-        eta = eta->next;
+    int m = basis->m;
+    if (m == 0) {
+        return CXF_OK;
+    }
+    if (x->capacity != m) {
+        return CXF_ERROR_INVALID_ARGUMENT;
     }
 
-    /* Apply eta vectors in chronological order (oldest to newest)
-     * etas[0] = newest (head), etas[count-1] = oldest
-     * So iterate from count-1 down to 0 */
-    for (int i = count - 1; i >= 0; i--) {
-        eta = etas[i];
-        int pivot_row = eta->pivot_row;
-        double pivot_elem = eta->pivot_elem;
-
-        /* Bounds check pivot row */
-        if (pivot_row < 0 || pivot_row >= m) {
-            if (etas != stack_etas) {
-                free(etas);
-            }
-            return CXF_ERROR_INVALID_ARGUMENT;
-        }
-
-        /* Numerical stability check */
-        if (pivot_elem == 0.0 || !isfinite(pivot_elem)) {
-            if (etas != stack_etas) {
-                free(etas);
-            }
-            return CXF_ERROR_INVALID_ARGUMENT;
-        }
+    ScratchMark mark = {NULL, 0};
+    if (basis->scratch != NULL) mark = cxf_scratch_mark(basis->scratch);
+    double *b = NULL;
+    if (single_active(basis)) {
+        b = save_rhs(basis, x->values);
+        if (b == NULL) cxf_lu_drop_single(basis->lu);
+    }
 
-        /* Apply eta transformation for E^(-1):
-         *   factor = result[r] / pivot_elem
-         *   result[r] = factor
-         *   result[j] = result[j] - col[j] * factor  for j != r
-         */
-        double factor = result[pivot_row] / pivot_elem;
-        result[pivot_row] = factor;
+    int single;
+    int rc = solve_in_place(basis, x->values, x->indices, &x->size, &single);
 
-        /* Apply off-diagonal entries */
-        for (int k = 0; k < eta->nnz; k++) {
-            int j = eta->indices[k];
-            if (j >= 0 && j < m && j != pivot_row) {
-                result[j] -= eta->values[k] * factor;
-            }
+    if (rc == CXF_OK && single) {
+        rc = refine(basis, b, x->values);
+        x->size = 0;
+        for (int i = 0; i < m; i++) {
+            if (x->values[i] != 0.0) x->indices[x->size++] = i;
         }
     }
 
-    /* Cleanup heap allocation if used */
-    if (etas != stack_etas) {
-        free(etas);
+    if (basis->scratch != NULL) {
+        cxf_scratch_release(basis->scratch, mark);
+    } else {
+        free(b);
     }
-
-    return CXF_OK;
+    return rc;
 }
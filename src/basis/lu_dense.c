@@ -0,0 +1,281 @@
+/**
+ * @file lu_dense.c
+ * @brief Blocked dense LU with partial pivoting for the factorization bump.
+ *
+ * cxf_lu_factorize hands the Schur complement over to this kernel once
+ * it has become dense (see CXF_LU_DENSE_MIN). The matrix is factored
+ * right-looking in panels of DENSE_PANEL columns: each panel is factored
+ * unblocked with partial pivoting, then the trailing columns are solved
+ * against the panel's unit lower triangle and updated with the panel's
+ * multipliers. The update walks the rows in tiles of DENSE_ROW_TILE so
+ * the part of the panel in use stays in cache, and folds four panel
+ * columns into each pass over a trailing column.
+ *
+ * A column without an acceptable pivot is swapped with the last column
+ * not yet rejected and factored again from there, so a singular matrix
+ * still yields as many pivots as the greedy order can find, with the
+ * rejected columns collected at the end.
+ *
+ * Trailing columns are independent of each other, so with more than one
+ * thread (cxf_set_thread_count) the update of each panel is split into
+ * contiguous column ranges, one per thread. The result does not depend
+ * on the thread count.
+ */
+
+#include "convexfeld/cxf_basis.h"
+#include "convexfeld/cxf_types.h"
+#include <stddef.h>
+#include <math.h>
+
+#ifdef CXF_HAVE_PTHREADS
+#include <pthread.h>
+#endif
+
+/* Columns per panel */
+#define DENSE_PANEL 48
+
+/* Rows per tile of the trailing update */
+#define DENSE_ROW_TILE 256
+
+/* Fewest trailing columns per thread worth starting a thread for */
+#define DENSE_PAR_MIN_COLS 64
+
+/* Most threads used by the trailing update */
+#define DENSE_MAX_THREADS 64
+
+/* Smallest acceptable pivot (as in the sparse kernel) */
+#define DENSE_MIN_PIVOT 1e-12
+
+/** Element (i, j) of the column-major n x n matrix a */
+#define A(i, j) a[(ptrdiff_t)(j) * n + (i)]
+
+/**
+ * @brief Trailing update of one panel for a range of columns.
+ */
+typedef struct {
+    double *a;
+    int n;
+    int k0;       /**< First column of the panel */
+    int nb;       /**< Panel width */
+    int c0;       /**< First trailing column of the range */
+    int c1;       /**< One past the last trailing column of the range */
+} DenseUpdate;
+
+/**
+ * @brief Solve with the panel's unit lower triangle, then apply the
+ *        Schur complement update, for columns c0..c1-1.
+ */
+static void update_columns(const DenseUpdate *u) {
+    double *a = u->a;
+    int n = u->n;
+    int k0 = u->k0;
+    int k1 = u->k0 + u->nb;
+
+    /* U12 = L11^(-1) * A12 */
+    for (int c = u->c0; c < u->c1; c++) {
+        for (int j = k0; j < k1; j++) {
+            double v = A(j, c);
+            if (v == 0.0) continue;
+            for (int i = j + 1; i < k1; i++) {
+                A(i, c) -= A(i, j) * v;
+            }
+        }
+    }
+
+    /* A22 -= L21 * U12, row tile by row tile */
+    for (int r0 = k1; r0 < n; r0 += DENSE_ROW_TILE) {
+        int r1 = (r0 + DENSE_ROW_TILE < n) ? r0 + DENSE_ROW_TILE : n;
+        for (int c = u->c0; c < u->c1; c++) {
+            double *restrict ac = &A(0, c);
+            int j = k0;
+            for (; j + 4 <= k1; j += 4) {
+                double v0 = A(j, c), v1 = A(j + 1, c);
+                double v2 = A(j + 2, c), v3 = A(j + 3, c);
+                if (v0 == 0.0 && v1 == 0.0 && v2 == 0.0 && v3 == 0.0) continue;
+                const double *l0 = &A(0, j), *l1 = &A(0, j + 1);
+                const double *l2 = &A(0, j + 2), *l3 = &A(0, j + 3);
+                for (int i = r0; i < r1; i++) {
+                    ac[i] -= l0[i] * v0 + l1[i] * v1 + l2[i] * v2 + l3[i] * v3;
+                }
+            }
+            for (; j < k1; j++) {
+                double v = A(j, c);
+                if (v == 0.0) continue;
+                const double *l = &A(0, j);
+                for (int i = r0; i < r1; i++) {
+                    ac[i] -= l[i] * v;
+                }
+            }
+        }
+    }
+}
+
+#ifdef CXF_HAVE_PTHREADS
+static void *update_worker(void *arg) {
+    update_columns((const DenseUpdate *)arg);
+    return NULL;
+}
+#endif
+
+/**
+ * @brief Update the trailing columns of a panel, split over threads.
+ */
+static void trailing_update(double *a, int n, int k0, int nb, int last,
+                            int threads) {
+    int first = k0 + nb;
+    int cols = last - first;
+    if (cols <= 0) return;
+
+    int parts = cols / DENSE_PAR_MIN_COLS;
+    if (parts > threads) parts = threads;
+    if (parts > DENSE_MAX_THREADS) parts = DENSE_MAX_THREADS;
+    if (parts < 1) parts = 1;
+
+    DenseUpdate work[DENSE_MAX_THREADS];
+    for (int t = 0; t < parts; t++) {
+        work[t].a = a;
+        work[t].n = n;
+        work[t].k0 = k0;
+        work[t].nb = nb;
+        work[t].c0 = first + (int)((int64_t)cols * t / parts);
+        work[t].c1 = first + (int)((int64_t)cols * (t + 1) / parts);
+    }
+
+#ifdef CXF_HAVE_PTHREADS
+    if (parts > 1) {
+        pthread_t tid[DENSE_MAX_THREADS];
+        int started[DENSE_MAX_THREADS];
+        for (int t = 1; t < parts; t++) {
+            started[t] = pthread_create(&tid[t], NULL, update_worker, &work[t]) == 0;
+            if (!started[t]) {
+                update_columns(&work[t]);  /* Run it here instead */
+            }
+        }
+        update_columns(&work[0]);
+        for (int t = 1; t < parts; t++) {
+            if (started[t]) pthread_join(tid[t], NULL);
+        }
+        return;
+    }
+#endif
+
+    for (int t = 0; t < parts; t++) {
+        update_columns(&work[t]);
+    }
+}
+
+/**
+ * @brief Largest entry of column j on or below the diagonal.
+ */
+static double pivot_search(const double *a, int n, int j, int *p) {
+    double best = fabs(A(j, j));
+    *p = j;
+    for (int i = j + 1; i < n; i++) {
+        double v = fabs(A(i, j));
+        if (v > best) {
+            best = v;
+            *p = i;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Unblocked LU with partial pivoting of panel columns k0..k0+nb-1.
+ *
+ * Row interchanges are applied across the whole matrix. A column without
+ * an acceptable pivot is swapped with column *last - 1, which is brought
+ * up to date with the panel's earlier pivots, and *last is decremented.
+ *
+ * @return Number of panel columns factored (fewer than nb if *last moved
+ *         into the panel).
+ */
+static int panel_factor(double *a, int n, int k0, int nb, int *perm,
+                        int *cperm, int *last) {
+    int k1 = k0 + nb;
+    for (int j = k0; j < k1 && j < *last; j++) {
+        int p;
+        double best = pivot_search(a, n, j, &p);
+        while (best < DENSE_MIN_PIVOT && j < *last - 1) {
+            int c = --(*last);
+            for (int i = 0; i < n; i++) {
+                double t = A(i, j);
+                A(i, j) = A(i, c);
+                A(i, c) = t;
+            }
+            int t = cperm[j];
+            cperm[j] = cperm[c];
+            cperm[c] = t;
+
+            /* Columns past the panel have not seen its pivots yet */
+            if (c >= k1) {
+                for (int jj = k0; jj < j; jj++) {
+                    double v = A(jj, j);
+                    if (v == 0.0) continue;
+                    for (int i = jj + 1; i < n; i++) {
+                        A(i, j) -= A(i, jj) * v;
+                    }
+                }
+            }
+            best = pivot_search(a, n, j, &p);
+        }
+        if (best < DENSE_MIN_PIVOT) {
+            *last = j;
+            break;
+        }
+
+        if (p != j) {
+            for (int c = 0; c < n; c++) {
+                double t = A(j, c);
+                A(j, c) = A(p, c);
+                A(p, c) = t;
+            }
+            int t = perm[j];
+            perm[j] = perm[p];
+            perm[p] = t;
+        }
+
+        double piv = A(j, j);
+        for (int i = j + 1; i < n; i++) {
+            A(i, j) /= piv;
+        }
+        for (int c = j + 1; c < k1 && c < *last; c++) {
+            double v = A(j, c);
+            if (v == 0.0) continue;
+            for (int i = j + 1; i < n; i++) {
+                A(i, c) -= A(i, j) * v;
+            }
+        }
+    }
+    return ((k1 < *last) ? k1 : *last) - k0;
+}
+
+/**
+ * @brief Blocked dense LU with partial pivoting: A(perm, cperm) = L * U.
+ *
+ * On return the strict lower triangle of a holds the multipliers of L
+ * (unit diagonal implicit) and the upper triangle holds U.
+ *
+ * @param a Column-major n x n matrix, overwritten with the factors.
+ * @param n Dimension.
+ * @param perm Row permutation: position k holds original row perm[k] [n].
+ * @param cperm Column permutation: position k holds original column
+ *              cperm[k] [n]; columns without a pivot are moved to the end.
+ * @param threads Threads for the trailing updates (<= 1: sequential).
+ * @return Number of pivots found (rank); n unless the matrix is singular,
+ *         in which case the leading rank x rank block is factored.
+ */
+int cxf_lu_dense_factor(double *a, int n, int *perm, int *cperm, int threads) {
+    for (int k = 0; k < n; k++) {
+        perm[k] = k;
+        cperm[k] = k;
+    }
+
+    int last = n;
+    for (int k0 = 0; k0 < last; k0 += DENSE_PANEL) {
+        int nb = (k0 + DENSE_PANEL < last) ? DENSE_PANEL : last - k0;
+        nb = panel_factor(a, n, k0, nb, perm, cperm, &last);
+        trailing_update(a, n, k0, nb, last, threads);
+    }
+    return last;
+}
@@ -1,9 +1,19 @@
 /**
  * @file lu_factorize.c
- * @brief Markowitz-ordered LU factorization for basis matrix.
+ * @brief Sparse Markowitz-ordered LU factorization for basis matrix.
  *
- * Implements sparse LU factorization with Markowitz pivot selection
- * and threshold pivoting for numerical stability.
+ * Implements sparse right-looking LU factorization with Markowitz pivot
+ * selection and threshold pivoting for numerical stability. A symbolic
+ * triangular pass first peels off slack, column-singleton and row-singleton
+ * pivots in O(nnz(B)); only the remaining "bump" reaches the Markowitz
+ * kernel. The active submatrix is held column-wise (with values) and
+ * row-wise (pattern only) in growable pools, and rows/columns are kept in
+ * count buckets so the pivot search only visits the sparsest lines. Work
+ * and memory scale with nnz(B) plus fill-in rather than m^2. Once the
+ * remaining Schur complement is large and dense, it is finished by the
+ * blocked dense kernel (lu_dense.c). A singular basis is repaired rather
+ * than rejected: the basis positions that found no pivot are given to the
+ * slacks of the rows left uncovered.
  *
  * Spec: docs/specs/functions/basis/cxf_basis_refactor.md
  */
@@ -21,15 +31,975 @@
 #define MARKOWITZ_THRESHOLD 0.1
 #define MIN_PIVOT 1e-12
 
+/* Number of rows/columns examined before accepting the best candidate */
+#define MARKOWITZ_SEARCH_LIMIT 4
+
+/* Schur complement density at which the dense kernel takes over */
+#define DENSE_SWITCH_FILL 0.3
+
+/* Factorization status codes */
+#define LU_OK             0
+#define LU_OUT_OF_MEMORY  1001
+
+/**
+ * @brief Working storage for the sparse Markowitz elimination.
+ *
+ * Columns and rows of the active submatrix live in pools; a line that
+ * outgrows its slot is moved to the end of its pool, and the pool is
+ * compacted when it runs out of room.
+ */
+typedef struct {
+    int m;
+
+    /* Active submatrix, column-wise with values */
+    int64_t *col_start;       /**< Start of each column in the pool [m] */
+    int *col_len;             /**< Active entries per column [m] */
+    int *col_cap;             /**< Slot size per column [m] */
+    int *col_row;             /**< Row indices pool */
+    double *col_val;          /**< Values pool */
+    int64_t col_used;         /**< Pool entries handed out */
+    int64_t col_size;         /**< Pool capacity */
+
+    /* Active submatrix, row-wise pattern */
+    int64_t *row_start;       /**< Start of each row in the pool [m] */
+    int *row_len;             /**< Active entries per row [m] */
+    int *row_cap;             /**< Slot size per row [m] */
+    int *row_col;             /**< Column indices pool */
+    int64_t row_used;         /**< Pool entries handed out */
+    int64_t row_size;         /**< Pool capacity */
+
+    /* Count buckets (doubly linked lists keyed by active count) */
+    int *col_head;            /**< First column with count k [m+1] */
+    int *col_next;            /**< Next column in bucket [m] */
+    int *col_prev;            /**< Previous column in bucket [m] */
+    int *row_head;            /**< First row with count k [m+1] */
+    int *row_next;            /**< Next row in bucket [m] */
+    int *row_prev;            /**< Previous row in bucket [m] */
+
+    /* Scatter workspace for column updates */
+    int *mark;                /**< Stamp of last scatter per row [m] */
+    int *pos;                 /**< Offset of row within scattered column [m] */
+    int stamp;                /**< Current scatter stamp */
+
+    /* Pivot row and pivot column buffers */
+    int *prow_col;            /**< Pivot row column indices [m] */
+    double *prow_val;         /**< Pivot row values [m] */
+    int *lcol_row;            /**< Pivot column row indices [m] */
+    double *lcol_val;         /**< Multipliers [m] */
+
+    /* Row-wise U under construction (original column indices) */
+    int64_t *urow_ptr;        /**< Start of each U row [m+1] */
+    int *urow_col;            /**< Column indices */
+    double *urow_val;         /**< Values */
+    int64_t urow_nnz;         /**< Entries stored */
+    int64_t urow_cap;         /**< Capacity */
+
+    int64_t active_nnz;       /**< Entries in the active submatrix */
+    int64_t ops;              /**< Entries touched by the elimination */
+} MarkowitzWork;
+
+/*******************************************************************************
+ * Workspace management
+ ******************************************************************************/
+
+static void mw_free(MarkowitzWork *w) {
+    free(w->col_start); free(w->col_len); free(w->col_cap);
+    free(w->col_row); free(w->col_val);
+    free(w->row_start); free(w->row_len); free(w->row_cap);
+    free(w->row_col);
+    free(w->col_head); free(w->col_next); free(w->col_prev);
+    free(w->row_head); free(w->row_next); free(w->row_prev);
+    free(w->mark); free(w->pos);
+    free(w->prow_col); free(w->prow_val);
+    free(w->lcol_row); free(w->lcol_val);
+    free(w->urow_ptr); free(w->urow_col); free(w->urow_val);
+}
+
+static int mw_alloc(MarkowitzWork *w, int m, int64_t nnz) {
+    size_t sm = (size_t)m;
+    memset(w, 0, sizeof(*w));
+    w->m = m;
+
+    w->col_size = 2 * nnz + 4 * (int64_t)m;
+    w->row_size = w->col_size;
+    w->urow_cap = nnz + (int64_t)m;
+
+    w->col_start = (int64_t *)malloc(sm * sizeof(int64_t));
+    w->col_len = (int *)calloc(sm, sizeof(int));
+    w->col_cap = (int *)calloc(sm, sizeof(int));
+    w->col_row = (int *)malloc((size_t)w->col_size * sizeof(int));
+    w->col_val = (double *)malloc((size_t)w->col_size * sizeof(double));
+    w->row_start = (int64_t *)malloc(sm * sizeof(int64_t));
+    w->row_len = (int *)calloc(sm, sizeof(int));
+    w->row_cap = (int *)calloc(sm, sizeof(int));
+    w->row_col = (int *)malloc((size_t)w->row_size * sizeof(int));
+    w->col_head = (int *)malloc((sm + 1) * sizeof(int));
+    w->col_next = (int *)malloc(sm * sizeof(int));
+    w->col_prev = (int *)malloc(sm * sizeof(int));
+    w->row_head = (int *)malloc((sm + 1) * sizeof(int));
+    w->row_next = (int *)malloc(sm * sizeof(int));
+    w->row_prev = (int *)malloc(sm * sizeof(int));
+    w->mark = (int *)calloc(sm, sizeof(int));
+    w->pos = (int *)malloc(sm * sizeof(int));
+    w->prow_col = (int *)malloc(sm * sizeof(int));
+    w->prow_val = (double *)malloc(sm * sizeof(double));
+    w->lcol_row = (int *)malloc(sm * sizeof(int));
+    w->lcol_val = (double *)malloc(sm * sizeof(double));
+    w->urow_ptr = (int64_t *)malloc((sm + 1) * sizeof(int64_t));
+    w->urow_col = (int *)malloc((size_t)w->urow_cap * sizeof(int));
+    w->urow_val = (double *)malloc((size_t)w->urow_cap * sizeof(double));
+
+    if (w->col_start == NULL || w->col_len == NULL || w->col_cap == NULL ||
+        w->col_row == NULL || w->col_val == NULL ||
+        w->row_start == NULL || w->row_len == NULL || w->row_cap == NULL ||
+        w->row_col == NULL ||
+        w->col_head == NULL || w->col_next == NULL || w->col_prev == NULL ||
+        w->row_head == NULL || w->row_next == NULL || w->row_prev == NULL ||
+        w->mark == NULL || w->pos == NULL ||
+        w->prow_col == NULL || w->prow_val == NULL ||
+        w->lcol_row == NULL || w->lcol_val == NULL ||
+        w->urow_ptr == NULL || w->urow_col == NULL || w->urow_val == NULL) {
+        mw_free(w);
+        return -1;
+    }
+
+    for (int k = 0; k <= m; k++) {
+        w->col_head[k] = -1;
+        w->row_head[k] = -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Rebuild the column pool without holes, leaving room for extra.
+ */
+static int col_compact(MarkowitzWork *w, int64_t extra) {
+    int64_t live = 0;
+    for (int j = 0; j < w->m; j++) live += w->col_len[j] + 2;
+
+    int64_t size = 2 * live + extra;
+    if (size < w->col_size) size = w->col_size;
+
+    int *rows = (int *)malloc((size_t)size * sizeof(int));
+    double *vals = (double *)malloc((size_t)size * sizeof(double));
+    if (rows == NULL || vals == NULL) {
+        free(rows); free(vals);
+        return -1;
+    }
+
+    int64_t used = 0;
+    for (int j = 0; j < w->m; j++) {
+        int len = w->col_len[j];
+        memcpy(rows + used, w->col_row + w->col_start[j], (size_t)len * sizeof(int));
+        memcpy(vals + used, w->col_val + w->col_start[j], (size_t)len * sizeof(double));
+        w->col_start[j] = used;
+        w->col_cap[j] = len + 2;
+        used += len + 2;
+    }
+
+    free(w->col_row); free(w->col_val);
+    w->col_row = rows;
+    w->col_val = vals;
+    w->col_used = used;
+    w->col_size = size;
+    return 0;
+}
+
+/**
+ * @brief Rebuild the row pattern pool without holes, leaving room for extra.
+ */
+static int row_compact(MarkowitzWork *w, int64_t extra) {
+    int64_t live = 0;
+    for (int i = 0; i < w->m; i++) live += w->row_len[i] + 2;
+
+    int64_t size = 2 * live + extra;
+    if (size < w->row_size) size = w->row_size;
+
+    int *cols = (int *)malloc((size_t)size * sizeof(int));
+    if (cols == NULL) return -1;
+
+    int64_t used = 0;
+    for (int i = 0; i < w->m; i++) {
+        int len = w->row_len[i];
+        memcpy(cols + used, w->row_col + w->row_start[i], (size_t)len * sizeof(int));
+        w->row_start[i] = used;
+        w->row_cap[i] = len + 2;
+        used += len + 2;
+    }
+
+    free(w->row_col);
+    w->row_col = cols;
+    w->row_used = used;
+    w->row_size = size;
+    return 0;
+}
+
+/**
+ * @brief Append entry (row, val) to active column j, growing its slot.
+ */
+static int col_append(MarkowitzWork *w, int j, int row, double val) {
+    if (w->col_len[j] == w->col_cap[j]) {
+        int old_cap = w->col_cap[j];
+        int new_cap = 2 * old_cap + 4;
+        if (w->col_start[j] + old_cap == w->col_used &&
+            w->col_used + (new_cap - old_cap) <= w->col_size) {
+            /* Last slot in the pool: grow in place */
+            w->col_used += new_cap - old_cap;
+        } else {
+            if (w->col_used + new_cap > w->col_size &&
+                col_compact(w, new_cap) != 0) {
+                return -1;
+            }
+            int64_t dst = w->col_used;
+            memmove(w->col_row + dst, w->col_row + w->col_start[j],
+                    (size_t)w->col_len[j] * sizeof(int));
+            memmove(w->col_val + dst, w->col_val + w->col_start[j],
+                    (size_t)w->col_len[j] * sizeof(double));
+            w->col_start[j] = dst;
+            w->col_used += new_cap;
+        }
+        w->col_cap[j] = new_cap;
+    }
+    int64_t p = w->col_start[j] + w->col_len[j];
+    w->col_row[p] = row;
+    w->col_val[p] = val;
+    w->col_len[j]++;
+    return 0;
+}
+
+/**
+ * @brief Append column index col to the pattern of active row i.
+ */
+static int row_append(MarkowitzWork *w, int i, int col) {
+    if (w->row_len[i] == w->row_cap[i]) {
+        int old_cap = w->row_cap[i];
+        int new_cap = 2 * old_cap + 4;
+        if (w->row_start[i] + old_cap == w->row_used &&
+            w->row_used + (new_cap - old_cap) <= w->row_size) {
+            w->row_used += new_cap - old_cap;
+        } else {
+            if (w->row_used + new_cap > w->row_size &&
+                row_compact(w, new_cap) != 0) {
+                return -1;
+            }
+            int64_t dst = w->row_used;
+            memmove(w->row_col + dst, w->row_col + w->row_start[i],
+                    (size_t)w->row_len[i] * sizeof(int));
+            w->row_start[i] = dst;
+            w->row_used += new_cap;
+        }
+        w->row_cap[i] = new_cap;
+    }
+    w->row_col[w->row_start[i] + w->row_len[i]] = col;
+    w->row_len[i]++;
+    return 0;
+}
+
+/*******************************************************************************
+ * Count buckets
+ ******************************************************************************/
+
+static void bucket_insert(int *head, int *next, int *prev, int count, int k) {
+    prev[k] = -1;
+    next[k] = head[count];
+    if (head[count] >= 0) prev[head[count]] = k;
+    head[count] = k;
+}
+
+static void bucket_remove(int *head, int *next, int *prev, int count, int k) {
+    if (prev[k] >= 0) {
+        next[prev[k]] = next[k];
+    } else {
+        head[count] = next[k];
+    }
+    if (next[k] >= 0) prev[next[k]] = prev[k];
+}
+
+/**
+ * @brief Unlink the empty active columns and rows from bucket 0.
+ *
+ * An empty line (structurally singular basis) can take no pivot, and no
+ * later step touches it again: it is in no other line's pattern. So the
+ * elimination carries on around it and leaves its position to the repair.
+ */
+static void drop_empty_lines(MarkowitzWork *w) {
+    w->col_head[0] = -1;
+    w->row_head[0] = -1;
+}
+
+/*******************************************************************************
+ * Factor storage growth
+ ******************************************************************************/
+
+static int lu_reserve_L(LUFactors *lu, int64_t need) {
+    if (need <= lu->L_capacity) return 0;
+    int64_t cap = lu->L_capacity * 2;
+    if (cap < need) cap = need;
+    int *idx = (int *)realloc(lu->L_row_idx, (size_t)cap * sizeof(int));
+    if (idx == NULL) return -1;
+    lu->L_row_idx = idx;
+    double *val = (double *)realloc(lu->L_values, (size_t)cap * sizeof(double));
+    if (val == NULL) return -1;
+    lu->L_values = val;
+    lu->L_capacity = cap;
+    return 0;
+}
+
+static int lu_reserve_U(LUFactors *lu, int64_t need) {
+    if (need <= lu->U_capacity) return 0;
+    int64_t cap = lu->U_capacity * 2;
+    if (cap < need) cap = need;
+    int *idx = (int *)realloc(lu->U_row_idx, (size_t)cap * sizeof(int));
+    if (idx == NULL) return -1;
+    lu->U_row_idx = idx;
+    double *val = (double *)realloc(lu->U_values, (size_t)cap * sizeof(double));
+    if (val == NULL) return -1;
+    lu->U_values = val;
+    lu->U_capacity = cap;
+    return 0;
+}
+
+static int urow_reserve(MarkowitzWork *w, int64_t need) {
+    if (need <= w->urow_cap) return 0;
+    int64_t cap = w->urow_cap * 2;
+    if (cap < need) cap = need;
+    int *idx = (int *)realloc(w->urow_col, (size_t)cap * sizeof(int));
+    if (idx == NULL) return -1;
+    w->urow_col = idx;
+    double *val = (double *)realloc(w->urow_val, (size_t)cap * sizeof(double));
+    if (val == NULL) return -1;
+    w->urow_val = val;
+    w->urow_cap = cap;
+    return 0;
+}
+
+/*******************************************************************************
+ * Pivot search
+ ******************************************************************************/
+
+/**
+ * @brief Markowitz search over the count buckets with threshold pivoting.
+ *
+ * Visits columns and rows in order of increasing count. An entry is
+ * eligible if |a_ij| >= MARKOWITZ_THRESHOLD * max_k |a_kj|. The search
+ * stops once MARKOWITZ_SEARCH_LIMIT lines were examined with a candidate
+ * in hand, or when no unexamined line can beat the best score.
+ *
+ * @return 0 if a pivot was found, -1 otherwise.
+ */
+static int find_pivot(const MarkowitzWork *w, int *piv_row, int *piv_col) {
+    int best_r = -1, best_c = -1;
+    int64_t best_score = INT64_MAX;
+    double best_abs = 0.0;
+    int examined = 0;
+
+    for (int k = 1; k <= w->m; k++) {
+        int64_t km1 = (int64_t)(k - 1);
+
+        /* Columns with k active entries */
+        for (int j = w->col_head[k]; j >= 0; j = w->col_next[j]) {
+            const int *rows = w->col_row + w->col_start[j];
+            const double *vals = w->col_val + w->col_start[j];
+            int len = w->col_len[j];
+
+            double col_max = 0.0;
+            for (int t = 0; t < len; t++) {
+                double a = fabs(vals[t]);
+                if (a > col_max) col_max = a;
+            }
+            double threshold = MARKOWITZ_THRESHOLD * col_max;
+
+            for (int t = 0; t < len; t++) {
+                double a = fabs(vals[t]);
+                if (a < threshold || a < MIN_PIVOT) continue;
+                int64_t score = (int64_t)(w->row_len[rows[t]] - 1) * km1;
+                if (score < best_score || (score == best_score && a > best_abs)) {
+                    best_score = score;
+                    best_abs = a;
+                    best_r = rows[t];
+                    best_c = j;
+                }
+            }
+
+            examined++;
+            if (best_r >= 0 &&
+                (examined >= MARKOWITZ_SEARCH_LIMIT || best_score <= km1 * km1)) {
+                goto done;
+            }
+        }
+
+        /* Rows with k active entries */
+        for (int i = w->row_head[k]; i >= 0; i = w->row_next[i]) {
+            const int *cols = w->row_col + w->row_start[i];
+            for (int t = 0; t < w->row_len[i]; t++) {
+                int j = cols[t];
+                const int *rows = w->col_row + w->col_start[j];
+                const double *vals = w->col_val + w->col_start[j];
+
+                double col_max = 0.0, a = 0.0;
+                for (int s = 0; s < w->col_len[j]; s++) {
+                    double v = fabs(vals[s]);
+                    if (v > col_max) col_max = v;
+                    if (rows[s] == i) a = v;
+                }
+                if (a < MARKOWITZ_THRESHOLD * col_max || a < MIN_PIVOT) continue;
+
+                int64_t score = km1 * (int64_t)(w->col_len[j] - 1);
+                if (score < best_score || (score == best_score && a > best_abs)) {
+                    best_score = score;
+                    best_abs = a;
+                    best_r = i;
+                    best_c = j;
+                }
+            }
+
+            examined++;
+            if (best_r >= 0 &&
+                (examined >= MARKOWITZ_SEARCH_LIMIT || best_score <= km1 * km1)) {
+                goto done;
+            }
+        }
+
+        /* Every unexamined line now has count > k */
+        if (best_r >= 0 && best_score <= (int64_t)k * (int64_t)k) {
+            goto done;
+        }
+    }
+
+done:
+    if (best_r < 0) return -1;
+    *piv_row = best_r;
+    *piv_col = best_c;
+    return 0;
+}
+
+/*******************************************************************************
+ * Elimination step
+ ******************************************************************************/
+
+/**
+ * @brief Eliminate pivot (r, c): emit L column and U row, update Schur complement.
+ *
+ * @return 0 on success, -1 on allocation failure.
+ */
+static int eliminate(MarkowitzWork *w, LUFactors *lu, int step, int r, int c) {
+    /* Pivot value */
+    double piv = 0.0;
+    {
+        const int *rows = w->col_row + w->col_start[c];
+        for (int t = 0; t < w->col_len[c]; t++) {
+            if (rows[t] == r) {
+                piv = w->col_val[w->col_start[c] + t];
+                break;
+            }
+        }
+    }
+
+    bucket_remove(w->col_head, w->col_next, w->col_prev, w->col_len[c], c);
+    bucket_remove(w->row_head, w->row_next, w->row_prev, w->row_len[r], r);
+    w->active_nnz -= w->col_len[c];
+
+    /* Pivot row: detach row r from every other active column */
+    int np = 0;
+    for (int t = 0; t < w->row_len[r]; t++) {
+        int j = w->row_col[w->row_start[r] + t];
+        if (j == c) continue;
+
+        bucket_remove(w->col_head, w->col_next, w->col_prev, w->col_len[j], j);
+
+        int64_t base = w->col_start[j];
+        int len = w->col_len[j];
+        for (int s = 0; s < len; s++) {
+            if (w->col_row[base + s] == r) {
+                w->prow_col[np] = j;
+                w->prow_val[np] = w->col_val[base + s];
+                np++;
+                w->col_row[base + s] = w->col_row[base + len - 1];
+                w->col_val[base + s] = w->col_val[base + len - 1];
+                w->col_len[j]--;
+                break;
+            }
+        }
+    }
+    w->row_len[r] = 0;
+    w->active_nnz -= np;
+
+    /* Row `step` of U (original column indices, remapped at the end) */
+    if (urow_reserve(w, w->urow_nnz + np) != 0) return -1;
+    w->urow_ptr[step] = w->urow_nnz;
+    for (int t = 0; t < np; t++) {
+        w->urow_col[w->urow_nnz] = w->prow_col[t];
+        w->urow_val[w->urow_nnz] = w->prow_val[t];
+        w->urow_nnz++;
+    }
+
+    /* Pivot column: multipliers, detach column c from every other active row */
+    int nl = 0;
+    for (int t = 0; t < w->col_len[c]; t++) {
+        int i = w->col_row[w->col_start[c] + t];
+        if (i == r) continue;
+
+        w->lcol_row[nl] = i;
+        w->lcol_val[nl] = w->col_val[w->col_start[c] + t] / piv;
+        nl++;
+
+        bucket_remove(w->row_head, w->row_next, w->row_prev, w->row_len[i], i);
+
+        int64_t base = w->row_start[i];
+        int len = w->row_len[i];
+        for (int s = 0; s < len; s++) {
+            if (w->row_col[base + s] == c) {
+                w->row_col[base + s] = w->row_col[base + len - 1];
+                w->row_len[i]--;
+                break;
+            }
+        }
+    }
+    w->col_len[c] = 0;
+
+    /* Column `step` of L (original row indices, remapped at the end) */
+    if (lu_reserve_L(lu, lu->L_nnz + nl) != 0) return -1;
+    lu->L_col_ptr[step] = lu->L_nnz;
+    for (int t = 0; t < nl; t++) {
+        lu->L_row_idx[lu->L_nnz] = w->lcol_row[t];
+        lu->L_values[lu->L_nnz] = w->lcol_val[t];
+        lu->L_nnz++;
+    }
+
+    lu->perm_row[step] = r;
+    lu->perm_col[step] = c;
+    lu->U_diag[step] = piv;
+
+    w->ops += np + nl + (int64_t)np * nl;
+
+    /* Schur complement update: a_ij -= l_i * u_j for each pivot-row column j */
+    for (int t = 0; t < np; t++) {
+        int j = w->prow_col[t];
+        double u = w->prow_val[t];
+
+        if (nl > 0) {
+            w->stamp++;
+            for (int s = 0; s < w->col_len[j]; s++) {
+                int i = w->col_row[w->col_start[j] + s];
+                w->mark[i] = w->stamp;
+                w->pos[i] = s;
+            }
+
+            for (int q = 0; q < nl; q++) {
+                int i = w->lcol_row[q];
+                double delta = -w->lcol_val[q] * u;
+                if (w->mark[i] == w->stamp) {
+                    w->col_val[w->col_start[j] + w->pos[i]] += delta;
+                } else {
+                    /* Fill-in */
+                    if (col_append(w, j, i, delta) != 0) return -1;
+                    if (row_append(w, i, j) != 0) return -1;
+                    w->active_nnz++;
+                }
+            }
+        }
+
+        bucket_insert(w->col_head, w->col_next, w->col_prev, w->col_len[j], j);
+    }
+
+    for (int q = 0; q < nl; q++) {
+        int i = w->lcol_row[q];
+        bucket_insert(w->row_head, w->row_next, w->row_prev, w->row_len[i], i);
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+ * Triangular preprocessing
+ ******************************************************************************/
+
+/**
+ * @brief Peel column and row singletons off the loaded basis matrix.
+ *
+ * Column singletons (slacks included) go first: each emits an empty L
+ * column and its row as a row of U, and removing the row can turn other
+ * columns into singletons. Row singletons follow: each emits its column
+ * as a column of L and an empty row of U, and removing the column can
+ * turn other rows into singletons. Neither kind changes the Schur
+ * complement, and removing a row singleton's column never creates a
+ * column singleton, so two passes suffice and only counts are updated:
+ * O(nnz(B)) overall. Row singletons must pass the threshold test; the
+ * rejected ones, like tiny column singletons, stay in the bump.
+ *
+ * On return the pools hold only the bump and its lines are in the count
+ * buckets.
+ *
+ * @param row_val Values matching the row patterns in w->row_col.
+ * @return Number of pivots taken (steps 0 to n-1), or -1 on allocation failure.
+ */
+static int triangular_pass(MarkowitzWork *w, LUFactors *lu, const double *row_val) {
+    int m = w->m;
+    int *stack = (int *)malloc((size_t)m * sizeof(int));
+    unsigned char *row_done = (unsigned char *)calloc((size_t)m, 1);
+    unsigned char *col_done = (unsigned char *)calloc((size_t)m, 1);
+    if (stack == NULL || row_done == NULL || col_done == NULL) {
+        free(stack); free(row_done); free(col_done);
+        return -1;
+    }
+
+    int step = 0;
+    int top = 0;
+    int rc = 0;
+
+    /* Column singletons: each column reaches count 1 at most once */
+    for (int j = 0; j < m; j++) {
+        if (w->col_len[j] == 1) stack[top++] = j;
+    }
+    while (top > 0) {
+        int c = stack[--top];
+        if (col_done[c] || w->col_len[c] != 1) continue;
+
+        int r = -1;
+        double piv = 0.0;
+        int64_t base = w->col_start[c];
+        for (int t = 0; t < w->col_cap[c]; t++) {
+            if (!row_done[w->col_row[base + t]]) {
+                r = w->col_row[base + t];
+                piv = w->col_val[base + t];
+                break;
+            }
+        }
+        if (r < 0 || fabs(piv) < MIN_PIVOT) continue;  /* Left to the bump */
+
+        /* Row `step` of U: the rest of row r */
+        if (urow_reserve(w, w->urow_nnz + w->row_len[r]) != 0) {
+            rc = -1;
+            break;
+        }
+        w->urow_ptr[step] = w->urow_nnz;
+        int64_t rbase = w->row_start[r];
+        for (int t = 0; t < w->row_cap[r]; t++) {
+            int j = w->row_col[rbase + t];
+            if (j == c || col_done[j]) continue;
+            w->urow_col[w->urow_nnz] = j;
+            w->urow_val[w->urow_nnz] = row_val[rbase + t];
+            w->urow_nnz++;
+            if (--w->col_len[j] == 1) stack[top++] = j;
+        }
+        w->ops += w->col_cap[c] + w->row_cap[r];
+
+        lu->L_col_ptr[step] = lu->L_nnz;
+        lu->perm_row[step] = r;
+        lu->perm_col[step] = c;
+        lu->U_diag[step] = piv;
+        row_done[r] = 1;
+        col_done[c] = 1;
+        w->row_len[r] = 0;
+        w->col_len[c] = 0;
+        step++;
+    }
+
+    /* Row singletons: each row reaches count 1 at most once */
+    top = 0;
+    for (int i = 0; rc == 0 && i < m; i++) {
+        if (!row_done[i] && w->row_len[i] == 1) stack[top++] = i;
+    }
+    while (rc == 0 && top > 0) {
+        int r = stack[--top];
+        if (row_done[r] || w->row_len[r] != 1) continue;
+
+        int c = -1;
+        int64_t rbase = w->row_start[r];
+        for (int t = 0; t < w->row_cap[r]; t++) {
+            if (!col_done[w->row_col[rbase + t]]) {
+                c = w->row_col[rbase + t];
+                break;
+            }
+        }
+        if (c < 0) continue;
+
+        /* Threshold test against the active part of column c */
+        int64_t base = w->col_start[c];
+        double piv = 0.0, col_max = 0.0;
+        for (int t = 0; t < w->col_cap[c]; t++) {
+            int i = w->col_row[base + t];
+            if (row_done[i]) continue;
+            double a = fabs(w->col_val[base + t]);
+            if (a > col_max) col_max = a;
+            if (i == r) piv = w->col_val[base + t];
+        }
+        if (fabs(piv) < MIN_PIVOT || fabs(piv) < MARKOWITZ_THRESHOLD * col_max) {
+            continue;  /* Left to the bump */
+        }
+
+        /* Column `step` of L: the rest of column c */
+        if (lu_reserve_L(lu, lu->L_nnz + w->col_len[c]) != 0) {
+            rc = -1;
+            break;
+        }
+        lu->L_col_ptr[step] = lu->L_nnz;
+        for (int t = 0; t < w->col_cap[c]; t++) {
+            int i = w->col_row[base + t];
+            if (i == r || row_done[i]) continue;
+            lu->L_row_idx[lu->L_nnz] = i;
+            lu->L_values[lu->L_nnz] = w->col_val[base + t] / piv;
+            lu->L_nnz++;
+            if (--w->row_len[i] == 1) stack[top++] = i;
+        }
+        w->ops += w->col_cap[c] + w->row_cap[r];
+
+        w->urow_ptr[step] = w->urow_nnz;
+        lu->perm_row[step] = r;
+        lu->perm_col[step] = c;
+        lu->U_diag[step] = piv;
+        row_done[r] = 1;
+        col_done[c] = 1;
+        w->row_len[r] = 0;
+        w->col_len[c] = 0;
+        step++;
+    }
+
+    if (rc == 0) {
+        /* Drop pivoted lines from the bump and fill the count buckets */
+        for (int j = 0; j < m; j++) {
+            if (col_done[j]) continue;
+            int64_t base = w->col_start[j];
+            int len = 0;
+            for (int t = 0; t < w->col_cap[j]; t++) {
+                if (row_done[w->col_row[base + t]]) continue;
+                w->col_row[base + len] = w->col_row[base + t];
+                w->col_val[base + len] = w->col_val[base + t];
+                len++;
+            }
+            w->col_len[j] = len;
+            w->active_nnz += len;
+            bucket_insert(w->col_head, w->col_next, w->col_prev, len, j);
+        }
+        for (int i = 0; i < m; i++) {
+            if (row_done[i]) continue;
+            int64_t base = w->row_start[i];
+            int len = 0;
+            for (int t = 0; t < w->row_cap[i]; t++) {
+                if (col_done[w->row_col[base + t]]) continue;
+                w->row_col[base + len++] = w->row_col[base + t];
+            }
+            w->row_len[i] = len;
+            bucket_insert(w->row_head, w->row_next, w->row_prev, len, i);
+        }
+    }
+
+    free(stack);
+    free(row_done);
+    free(col_done);
+    return (rc == 0) ? step : -1;
+}
+
+/*******************************************************************************
+ * Dense finish
+ ******************************************************************************/
+
+/**
+ * @brief Whether the Schur complement left at a step should go dense.
+ */
+static int dense_wanted(const MarkowitzWork *w, const LUFactors *lu, int step) {
+    int64_t n = w->m - step;
+    return lu->dense_min > 0 && n >= lu->dense_min &&
+           (double)w->active_nnz >= DENSE_SWITCH_FILL * (double)(n * n);
+}
+
+/**
+ * @brief Factor the Schur complement left at a step with the dense kernel.
+ *
+ * Gathers the active rows and columns into a dense matrix, factors it
+ * (cxf_lu_dense_factor) and emits its L columns and U rows as steps
+ * step..step+rank-1, dropping exact zeros. Rows follow the partial
+ * pivoting order; columns keep their relative order except for those
+ * without a pivot, which are left for the repair.
+ *
+ * @return LU_OK (lu->rank < m if the matrix is singular) or LU_OUT_OF_MEMORY.
+ */
+static int dense_finish(MarkowitzWork *w, LUFactors *lu, int step) {
+    int m = w->m;
+    int n = m - step;
+
+    /* Active lines: those not yet pivoted. The scatter buffers are free
+     * from here on; mark holds the local index of each active row. */
+    int *rows = w->prow_col;
+    int *cols = w->lcol_row;
+    int *local = w->mark;
+    for (int i = 0; i < m; i++) local[i] = 0;
+    for (int k = 0; k < step; k++) local[lu->perm_row[k]] = -1;
+    int nr = 0;
+    for (int i = 0; i < m; i++) {
+        if (local[i] == 0) {
+            local[i] = nr;
+            rows[nr++] = i;
+        }
+    }
+    for (int j = 0; j < m; j++) w->pos[j] = 0;
+    for (int k = 0; k < step; k++) w->pos[lu->perm_col[k]] = 1;
+    int nc = 0;
+    for (int j = 0; j < m; j++) {
+        if (!w->pos[j]) cols[nc++] = j;
+    }
+
+    double *a = (double *)calloc((size_t)n * (size_t)n, sizeof(double));
+    int *perm = (int *)malloc(2 * (size_t)n * sizeof(int));
+    if (a == NULL || perm == NULL) {
+        free(a);
+        free(perm);
+        return LU_OUT_OF_MEMORY;
+    }
+    for (int t = 0; t < n; t++) {
+        int j = cols[t];
+        double *col = a + (ptrdiff_t)t * n;
+        for (int s = 0; s < w->col_len[j]; s++) {
+            col[local[w->col_row[w->col_start[j] + s]]] = w->col_val[w->col_start[j] + s];
+        }
+    }
+
+    int *cperm = perm + n;
+    int rank = cxf_lu_dense_factor(a, n, perm, cperm, lu->threads);
+    w->ops += (int64_t)n * n * n / 3;
+
+    /* Emit steps; row perm[t] and column cperm[t] of the dense matrix
+     * are pivot t */
+    int rc = LU_OK;
+    for (int t = 0; t < rank; t++) {
+        const double *col = a + (ptrdiff_t)t * n;
+
+        if (lu_reserve_L(lu, lu->L_nnz + (n - t - 1)) != 0 ||
+            urow_reserve(w, w->urow_nnz + (rank - t - 1)) != 0) {
+            rc = LU_OUT_OF_MEMORY;
+            break;
+        }
+        lu->L_col_ptr[step + t] = lu->L_nnz;
+        for (int i = t + 1; i < n; i++) {
+            if (col[i] == 0.0) continue;
+            lu->L_row_idx[lu->L_nnz] = rows[perm[i]];
+            lu->L_values[lu->L_nnz] = col[i];
+            lu->L_nnz++;
+        }
+        w->urow_ptr[step + t] = w->urow_nnz;
+        for (int c = t + 1; c < rank; c++) {
+            double v = a[(ptrdiff_t)c * n + t];
+            if (v == 0.0) continue;
+            w->urow_col[w->urow_nnz] = cols[cperm[c]];
+            w->urow_val[w->urow_nnz] = v;
+            w->urow_nnz++;
+        }
+
+        lu->perm_row[step + t] = rows[perm[t]];
+        lu->perm_col[step + t] = cols[cperm[t]];
+        lu->U_diag[step + t] = col[t];
+        lu->rank = step + t + 1;
+    }
+    lu->dense_size = n;
+
+    free(a);
+    free(perm);
+    return rc;
+}
+
+/*******************************************************************************
+ * Singular basis repair
+ ******************************************************************************/
+
+/**
+ * @brief Complete a rank-deficient factorization with slack pivots.
+ *
+ * Pairs each basis position that found no pivot with a row that was not
+ * covered and puts the slack of that row in the position. A slack column
+ * is zero in every pivoted row, so the new basis is nonsingular and its
+ * factors are the ones computed so far plus one trivial step per slack:
+ * L and U gain nothing but the slack coefficient on the diagonal, once
+ * the U entries of the replaced columns are dropped.
+ *
+ * The basis header is updated: removed variables become nonbasic at their
+ * lower bound (their values are the caller's to fix) and are listed in
+ * lu->repair_var.
+ */
+static void repair_with_slacks(MarkowitzWork *w, LUFactors *lu,
+                               BasisState *basis, int n_orig) {
+    int m = w->m;
+    int step = lu->rank;
+    int *row_done = w->mark;
+    int *pos_done = w->pos;
+
+    for (int i = 0; i < m; i++) {
+        row_done[i] = 0;
+        pos_done[i] = 0;
+    }
+    for (int k = 0; k < step; k++) {
+        row_done[lu->perm_row[k]] = 1;
+        pos_done[lu->perm_col[k]] = 1;
+    }
+
+    /* Drop U entries in the positions that are replaced */
+    int64_t q = 0;
+    for (int s = 0; s < step; s++) {
+        int64_t end = (s + 1 < step) ? w->urow_ptr[s + 1] : w->urow_nnz;
+        int64_t p = w->urow_ptr[s];
+        w->urow_ptr[s] = q;
+        for (; p < end; p++) {
+            if (!pos_done[w->urow_col[p]]) continue;
+            w->urow_col[q] = w->urow_col[p];
+            w->urow_val[q] = w->urow_val[p];
+            q++;
+        }
+    }
+    w->urow_nnz = q;
+
+    int r = 0;
+    lu->repairs = 0;
+    for (int j = 0; j < m; j++) {
+        if (pos_done[j]) continue;
+        while (row_done[r]) r++;
+        row_done[r] = 1;
+
+        int var = basis->basic_vars[j];
+        lu->repair_var[lu->repairs++] = var;
+        if (var >= 0 && var < n_orig + m) {
+            basis->var_status[var] = -1;
+        }
+        basis->basic_vars[j] = n_orig + r;
+
+        lu->perm_row[step] = r;
+        lu->perm_col[step] = j;
+        lu->U_diag[step] = basis->diag_coeff[r];
+        lu->L_col_ptr[step] = lu->L_nnz;
+        w->urow_ptr[step] = w->urow_nnz;
+        step++;
+    }
+
+    /* A removed variable may still hold another position (a duplicate
+     * column), and a slack may have moved, so restate every basic one */
+    for (int j = 0; j < m; j++) {
+        int var = basis->basic_vars[j];
+        if (var >= 0 && var < n_orig + m) {
+            basis->var_status[var] = j;
+        }
+    }
+    lu->rank = m;
+}
+
+/*******************************************************************************
+ * Main factorization
+ ******************************************************************************/
+
 /**
  * @brief Compute LU factorization of basis matrix.
  *
- * Uses dense working matrix with Markowitz pivot selection.
- * Output is stored in sparse LUFactors structure.
+ * Loads the basis columns from the CSC constraint matrix (slack columns
+ * from diag_coeff) into the sparse active submatrix and eliminates one
+ * Markowitz pivot per step. The result is P * B * Q = L * U with L and U
+ * stored column-wise in step space in the LUFactors structure.
+ *
+ * A singular basis is repaired: every basis position that found no pivot
+ * (exactly zero or below MIN_PIVOT) receives the slack of a row left
+ * uncovered, basic_vars/var_status are updated, and the factors describe
+ * the repaired basis. lu->repairs counts the replaced positions and
+ * lu->repair_var lists the variables that left the basis.
  *
  * @param lu LUFactors structure to store results (must be pre-allocated).
  * @param ctx SolverContext with basis and matrix access.
- * @return 0 on success, 3 for singular matrix, 1001 for OOM.
+ * @return 0 on success (possibly after repairs), 1001 for OOM.
  */
 int cxf_lu_factorize(LUFactors *lu, SolverContext *ctx) {
     if (lu == NULL || ctx == NULL || ctx->basis == NULL) {
@@ -38,10 +1008,13 @@ int cxf_lu_factorize(LUFactors *lu, SolverContext *ctx) {
 
     BasisState *basis = ctx->basis;
     int m = basis->m;
+    lu->repairs = 0;
 
     if (m == 0) {
+        lu->rank = 0;
+        lu->R_count = 0;
         lu->valid = 1;
-        return 0;
+        return LU_OK;
     }
 
     CxfModel *model = ctx->model_ref;
@@ -52,261 +1025,171 @@ int cxf_lu_factorize(LUFactors *lu, SolverContext *ctx) {
     SparseMatrix *A = model->matrix;
     int n_orig = ctx->num_vars;
 
-    /* Allocate dense working matrix B[m][m] */
-    double *B = (double *)calloc((size_t)m * (size_t)m, sizeof(double));
-    if (B == NULL) {
-        return 1001;  /* Out of memory */
+    /* Count nonzeros of B for the initial pool sizes */
+    int64_t nnz_B = 0;
+    for (int j = 0; j < m; j++) {
+        int var = basis->basic_vars[j];
+        if (var >= 0 && var < n_orig) {
+            nnz_B += A->col_ptr[var + 1] - A->col_ptr[var];
+        } else {
+            nnz_B++;
+        }
     }
 
-    /* Track row/col counts for Markowitz, and elimination state */
-    int *row_count = (int *)calloc((size_t)m, sizeof(int));
-    int *col_count = (int *)calloc((size_t)m, sizeof(int));
-    int *row_elim = (int *)calloc((size_t)m, sizeof(int));  /* 1 if row eliminated */
-    int *col_elim = (int *)calloc((size_t)m, sizeof(int));  /* 1 if col eliminated */
-
-    if (row_count == NULL || col_count == NULL ||
-        row_elim == NULL || col_elim == NULL) {
-        free(B); free(row_count); free(col_count);
-        free(row_elim); free(col_elim);
-        return 1001;
+    MarkowitzWork w;
+    if (mw_alloc(&w, m, nnz_B) != 0) {
+        return LU_OUT_OF_MEMORY;
     }
+    w.ops = nnz_B;
 
-    /* Extract basis columns into dense B matrix.
+    /* Extract basis columns into the active submatrix.
      * Column j of B corresponds to basic variable basis->basic_vars[j].
      * - If var < n_orig: extract from constraint matrix A
      * - If var >= n_orig: slack variable, unit vector at row (var - n_orig) */
+    int64_t used = 0;
     for (int j = 0; j < m; j++) {
         int var = basis->basic_vars[j];
+        w.col_start[j] = used;
 
-        if (var < n_orig) {
-            /* Structural variable - extract from A */
+        if (var >= 0 && var < n_orig) {
             for (int64_t k = A->col_ptr[var]; k < A->col_ptr[var + 1]; k++) {
                 int row = A->row_idx[k];
-                if (row < m) {
-                    B[row * m + j] = A->values[k];
+                if (row < m && A->values[k] != 0.0) {
+                    w.col_row[used] = row;
+                    w.col_val[used] = A->values[k];
+                    used++;
                 }
             }
         } else {
-            /* Slack variable - unit vector at row (var - n_orig) */
             int slack_row = var - n_orig;
             if (slack_row >= 0 && slack_row < m) {
                 /* Slack coefficient is based on constraint sense.
                  * Use diag_coeff which already accounts for this. */
-                B[slack_row * m + j] = basis->diag_coeff[slack_row];
+                w.col_row[used] = slack_row;
+                w.col_val[used] = basis->diag_coeff[slack_row];
+                used++;
             }
         }
+
+        w.col_len[j] = (int)(used - w.col_start[j]);
+        w.col_cap[j] = w.col_len[j];
     }
+    w.col_used = used;
 
-    /* Count non-zeros per row and column */
+    /* Row patterns, with values for the triangular pass */
+    double *row_val = (double *)malloc((size_t)(used > 0 ? used : 1) * sizeof(double));
+    if (row_val == NULL) {
+        mw_free(&w);
+        return LU_OUT_OF_MEMORY;
+    }
+    for (int j = 0; j < m; j++) {
+        for (int t = 0; t < w.col_len[j]; t++) {
+            w.row_len[w.col_row[w.col_start[j] + t]]++;
+        }
+    }
+    used = 0;
     for (int i = 0; i < m; i++) {
-        for (int j = 0; j < m; j++) {
-            if (fabs(B[i * m + j]) > MIN_PIVOT) {
-                row_count[i]++;
-                col_count[j]++;
-            }
+        w.row_start[i] = used;
+        w.row_cap[i] = w.row_len[i];
+        used += w.row_len[i];
+        w.row_len[i] = 0;
+    }
+    w.row_used = used;
+    for (int j = 0; j < m; j++) {
+        for (int t = 0; t < w.col_len[j]; t++) {
+            int i = w.col_row[w.col_start[j] + t];
+            int64_t dst = w.row_start[i] + w.row_len[i]++;
+            w.row_col[dst] = j;
+            row_val[dst] = w.col_val[w.col_start[j] + t];
         }
     }
 
-    /* Temporary storage for L entries (multipliers) */
-    int L_cap = m * 2;  /* Initial estimate */
-    int *L_i = (int *)malloc((size_t)L_cap * sizeof(int));
-    int *L_j = (int *)malloc((size_t)L_cap * sizeof(int));
-    double *L_v = (double *)malloc((size_t)L_cap * sizeof(double));
-    int L_count = 0;
-
-    if (L_i == NULL || L_j == NULL || L_v == NULL) {
-        free(B); free(row_count); free(col_count);
-        free(row_elim); free(col_elim);
-        free(L_i); free(L_j); free(L_v);
-        return 1001;
+    /* Slack and singleton pivots; only the bump is left for Markowitz */
+    lu->L_nnz = 0;
+    int first = triangular_pass(&w, lu, row_val);
+    free(row_val);
+    if (first < 0) {
+        mw_free(&w);
+        return LU_OUT_OF_MEMORY;
     }
+    lu->rank = first;
+    lu->bump_size = m - first;
+    lu->dense_size = 0;
 
-    /* Markowitz LU factorization */
-    for (int step = 0; step < m; step++) {
-        /* Find pivot using Markowitz criterion with threshold */
-        int best_row = -1, best_col = -1;
-        int64_t best_score = (int64_t)(m + 1) * (int64_t)(m + 1);
-        double best_pivot = 0.0;
+    /* Markowitz LU factorization of the bump, finished densely once the
+     * Schur complement fills in */
+    for (int step = first; step < m; step++) {
+        int r, c;
 
-        for (int j = 0; j < m; j++) {
-            if (col_elim[j]) continue;
+        drop_empty_lines(&w);
 
-            /* Find max in this column for threshold */
-            double col_max = 0.0;
-            for (int i = 0; i < m; i++) {
-                if (row_elim[i]) continue;
-                double val = fabs(B[i * m + j]);
-                if (val > col_max) col_max = val;
-            }
-
-            if (col_max < MIN_PIVOT) continue;  /* Skip zero column */
-
-            double threshold = MARKOWITZ_THRESHOLD * col_max;
-
-            /* Find best pivot in this column */
-            for (int i = 0; i < m; i++) {
-                if (row_elim[i]) continue;
-                double val = fabs(B[i * m + j]);
-
-                if (val >= threshold) {
-                    int64_t score = (int64_t)(row_count[i] - 1) *
-                                    (int64_t)(col_count[j] - 1);
-
-                    if (score < best_score ||
-                        (score == best_score && val > fabs(best_pivot))) {
-                        best_score = score;
-                        best_row = i;
-                        best_col = j;
-                        best_pivot = B[i * m + j];
-                    }
-                }
+        if (dense_wanted(&w, lu, step)) {
+            int rc = dense_finish(&w, lu, step);
+            if (rc != LU_OK) {
+                mw_free(&w);
+                return rc;
             }
+            break;
         }
 
-        if (best_row < 0 || fabs(best_pivot) < MIN_PIVOT) {
-            /* Singular matrix */
-            free(B); free(row_count); free(col_count);
-            free(row_elim); free(col_elim);
-            free(L_i); free(L_j); free(L_v);
-            return 3;  /* Singular basis */
+        if (find_pivot(&w, &r, &c) != 0) {
+            break;  /* Only empty or numerically singular lines left */
         }
 
-        /* Record permutation */
-        lu->perm_row[step] = best_row;
-        lu->perm_col[step] = best_col;
-
-        /* Store U diagonal */
-        lu->U_diag[step] = best_pivot;
-
-        /* Eliminate */
-        row_elim[best_row] = 1;
-        col_elim[best_col] = 1;
-
-        for (int i = 0; i < m; i++) {
-            if (row_elim[i]) continue;
-            double val = B[i * m + best_col];
-            if (fabs(val) < MIN_PIVOT) continue;
-
-            double mult = val / best_pivot;
-
-            /* Store L entry (multiplier) */
-            if (L_count >= L_cap) {
-                L_cap *= 2;
-                int *new_i = realloc(L_i, (size_t)L_cap * sizeof(int));
-                int *new_j = realloc(L_j, (size_t)L_cap * sizeof(int));
-                double *new_v = realloc(L_v, (size_t)L_cap * sizeof(double));
-                if (new_i == NULL || new_j == NULL || new_v == NULL) {
-                    free(B); free(row_count); free(col_count);
-                    free(row_elim); free(col_elim);
-                    free(L_i); free(L_j); free(L_v);
-                    return 1001;
-                }
-                L_i = new_i; L_j = new_j; L_v = new_v;
-            }
-            L_i[L_count] = i;
-            L_j[L_count] = step;  /* Elimination step = L column */
-            L_v[L_count] = mult;
-            L_count++;
-
-            /* Update row */
-            B[i * m + best_col] = 0.0;
-            row_count[i]--;
-            for (int jj = 0; jj < m; jj++) {
-                if (col_elim[jj]) continue;
-                double piv_val = B[best_row * m + jj];
-                if (fabs(piv_val) < MIN_PIVOT) continue;
-
-                double old_val = B[i * m + jj];
-                double new_val = old_val - mult * piv_val;
-
-                if (fabs(old_val) < MIN_PIVOT && fabs(new_val) >= MIN_PIVOT) {
-                    row_count[i]++;
-                    col_count[jj]++;
-                } else if (fabs(old_val) >= MIN_PIVOT && fabs(new_val) < MIN_PIVOT) {
-                    row_count[i]--;
-                    col_count[jj]--;
-                }
-                B[i * m + jj] = new_val;
-            }
+        if (eliminate(&w, lu, step, r, c) != 0) {
+            mw_free(&w);
+            return LU_OUT_OF_MEMORY;
         }
-
-        col_count[best_col] = 0;  /* Column eliminated */
+        lu->rank = step + 1;
     }
+    if (lu->rank < m) {
+        repair_with_slacks(&w, lu, basis, n_orig);
+    }
+    lu->L_col_ptr[m] = lu->L_nnz;
+    w.urow_ptr[m] = w.urow_nnz;
 
-    /* Extract U entries (off-diagonal) from remaining B */
-    /* U is stored column-wise. For each elimination step, store non-zeros
-     * in the pivot row that haven't been eliminated yet. */
-
-    /* Count U non-zeros and build column pointers */
-    lu->U_nnz = 0;
-    for (int step = 0; step < m; step++) {
-        int piv_row = lu->perm_row[step];
-        lu->U_col_ptr[step] = lu->U_nnz;
-
-        /* Count non-zeros in pivot row (excluding diagonal and eliminated cols) */
-        for (int j_step = step + 1; j_step < m; j_step++) {
-            int col = lu->perm_col[j_step];
-            if (fabs(B[piv_row * m + col]) >= MIN_PIVOT) {
-                lu->U_nnz++;
-            }
-        }
+    /* Map L row indices and U column indices into step space.
+     * Reuse the scatter buffers as inverse permutations. */
+    int *inv_row = w.mark;
+    int *inv_col = w.pos;
+    for (int k = 0; k < m; k++) {
+        inv_row[lu->perm_row[k]] = k;
+        inv_col[lu->perm_col[k]] = k;
     }
-    lu->U_col_ptr[m] = lu->U_nnz;
-
-    /* Fill U values */
-    if (lu->U_nnz > 0) {
-        int64_t idx = 0;
-        for (int step = 0; step < m; step++) {
-            int piv_row = lu->perm_row[step];
-            for (int j_step = step + 1; j_step < m; j_step++) {
-                int col = lu->perm_col[j_step];
-                double val = B[piv_row * m + col];
-                if (fabs(val) >= MIN_PIVOT) {
-                    lu->U_row_idx[idx] = j_step;  /* Store step index, not original row */
-                    lu->U_values[idx] = val;
-                    idx++;
-                }
-            }
-        }
+    for (int64_t p = 0; p < lu->L_nnz; p++) {
+        lu->L_row_idx[p] = inv_row[lu->L_row_idx[p]];
     }
 
-    /* Build L in column-wise format */
-    lu->L_nnz = (int64_t)L_count;
-    memset(lu->L_col_ptr, 0, (size_t)(m + 1) * sizeof(int64_t));
-
-    /* Count entries per column */
-    for (int k = 0; k < L_count; k++) {
-        lu->L_col_ptr[L_j[k] + 1]++;
+    /* Transpose row-wise U into column-wise U */
+    if (lu_reserve_U(lu, w.urow_nnz) != 0) {
+        mw_free(&w);
+        return LU_OUT_OF_MEMORY;
     }
-
-    /* Cumulative sum */
-    for (int j = 1; j <= m; j++) {
-        lu->L_col_ptr[j] += lu->L_col_ptr[j - 1];
+    memset(lu->U_col_ptr, 0, (size_t)(m + 1) * sizeof(int64_t));
+    for (int64_t p = 0; p < w.urow_nnz; p++) {
+        lu->U_col_ptr[inv_col[w.urow_col[p]] + 1]++;
     }
-
-    /* Fill L entries */
-    int64_t *work_ptr = (int64_t *)calloc((size_t)m, sizeof(int64_t));
-    if (work_ptr == NULL) {
-        free(B); free(row_count); free(col_count);
-        free(row_elim); free(col_elim);
-        free(L_i); free(L_j); free(L_v);
-        return 1001;
+    for (int k = 0; k < m; k++) {
+        lu->U_col_ptr[k + 1] += lu->U_col_ptr[k];
     }
-
-    for (int k = 0; k < L_count; k++) {
-        int col = L_j[k];
-        int64_t pos = lu->L_col_ptr[col] + work_ptr[col];
-        lu->L_row_idx[pos] = L_i[k];
-        lu->L_values[pos] = L_v[k];
-        work_ptr[col]++;
+    int64_t *next = w.col_start;  /* m-length scratch, no longer needed */
+    memcpy(next, lu->U_col_ptr, (size_t)m * sizeof(int64_t));
+    for (int step = 0; step < m; step++) {
+        for (int64_t p = w.urow_ptr[step]; p < w.urow_ptr[step + 1]; p++) {
+            int col = inv_col[w.urow_col[p]];
+            int64_t dst = next[col]++;
+            lu->U_row_idx[dst] = step;
+            lu->U_values[dst] = w.urow_val[p];
+        }
     }
+    lu->U_nnz = w.urow_nnz;
+    lu->factor_ops = w.ops + lu->L_nnz + lu->U_nnz;
 
-    free(work_ptr);
-    free(B);
-    free(row_count); free(col_count);
-    free(row_elim); free(col_elim);
-    free(L_i); free(L_j); free(L_v);
+    mw_free(&w);
 
+    if (cxf_lu_reset_updates(lu) != CXF_OK) {
+        return LU_OUT_OF_MEMORY;
+    }
     lu->valid = 1;
-    return 0;
+    return LU_OK;
 }
@@ -3,7 +3,7 @@
  * @brief LUFactors structure lifecycle functions.
  *
  * Implements creation, destruction, and clearing of LU factorization storage.
- * The actual factorization algorithm is in refactor.c.
+ * The actual factorization algorithm is in lu_factorize.c.
  */
 
 #include "convexfeld/cxf_basis.h"
@@ -34,9 +34,12 @@ LUFactors *cxf_lu_create(int m, int64_t L_nnz_estimate, int64_t U_nnz_estimate)
     }
 
     lu->m = m;
+    lu->rank = 0;
     lu->valid = 0;
     lu->L_nnz = 0;
     lu->U_nnz = 0;
+    lu->L_capacity = L_nnz_estimate;
+    lu->U_capacity = U_nnz_estimate;
 
     /* Allocate L factor storage */
     lu->L_col_ptr = (int64_t *)calloc((size_t)(m + 1), sizeof(int64_t));
@@ -48,23 +51,75 @@ LUFactors *cxf_lu_create(int m, int64_t L_nnz_estimate, int64_t U_nnz_estimate)
     lu->U_row_idx = (int *)malloc((size_t)U_nnz_estimate * sizeof(int));
     lu->U_values = (double *)malloc((size_t)U_nnz_estimate * sizeof(double));
     lu->U_diag = (double *)malloc((size_t)m * sizeof(double));
+    lu->U_col_len = (int *)calloc((size_t)m, sizeof(int));
+    lu->U_seq = (int *)malloc((size_t)m * sizeof(int));
+    lu->U_seq_pos = (int *)malloc((size_t)m * sizeof(int));
+
+    /* Row-wise copies */
+    lu->Lr_capacity = L_nnz_estimate;
+    lu->Ur_capacity = U_nnz_estimate;
+    lu->Lr_ptr = (int64_t *)calloc((size_t)(m + 1), sizeof(int64_t));
+    lu->Lr_idx = (int *)malloc((size_t)L_nnz_estimate * sizeof(int));
+    lu->Lr_val = (double *)malloc((size_t)L_nnz_estimate * sizeof(double));
+    lu->Ur_start = (int64_t *)calloc((size_t)m, sizeof(int64_t));
+    lu->Ur_len = (int *)calloc((size_t)m, sizeof(int));
+    lu->Ur_cap = (int *)calloc((size_t)m, sizeof(int));
+    lu->Ur_idx = (int *)malloc((size_t)U_nnz_estimate * sizeof(int));
+    lu->Ur_val = (double *)malloc((size_t)U_nnz_estimate * sizeof(double));
+
+    /* Update workspace; the row-eta file is allocated on first update */
+    lu->work = (double *)calloc((size_t)(2 * m), sizeof(double));
+    lu->iwork = (int *)malloc((size_t)(2 * m) * sizeof(int));
+
+    /* Hypersparse solve workspace */
+    lu->hs_x = (double *)calloc((size_t)m, sizeof(double));
+    lu->hs_list = (int *)malloc((size_t)m * sizeof(int));
+    lu->hs_pattern = (int *)malloc((size_t)m * sizeof(int));
+    lu->hs_out = (int *)malloc((size_t)m * sizeof(int));
+    lu->hs_stack = (int *)malloc((size_t)m * sizeof(int));
+    lu->hs_next = (int64_t *)malloc((size_t)m * sizeof(int64_t));
+    lu->hs_mark = (int *)calloc((size_t)m, sizeof(int));
+    lu->hs_stamp = 0;
+    lu->hyper_threshold = CXF_HYPER_DENSITY;
+    lu->rowwise_threshold = CXF_ROWWISE_DENSITY;
+    lu->rowwise = 1;
+    lu->dense_min = CXF_LU_DENSE_MIN;
+    lu->threads = 1;
+    lu->ftran_density = 0.0;
+    lu->btran_density = 0.0;
 
     /* Allocate permutation arrays */
     lu->perm_row = (int *)malloc((size_t)m * sizeof(int));
     lu->perm_col = (int *)malloc((size_t)m * sizeof(int));
+    lu->perm_row_inv = (int *)malloc((size_t)m * sizeof(int));
+    lu->perm_col_inv = (int *)malloc((size_t)m * sizeof(int));
+    lu->repair_var = (int *)malloc((size_t)m * sizeof(int));
 
     /* Check all allocations succeeded */
     if (lu->L_col_ptr == NULL || lu->L_row_idx == NULL || lu->L_values == NULL ||
         lu->U_col_ptr == NULL || lu->U_row_idx == NULL || lu->U_values == NULL ||
-        lu->U_diag == NULL || lu->perm_row == NULL || lu->perm_col == NULL) {
+        lu->U_diag == NULL || lu->U_col_len == NULL || lu->U_seq == NULL ||
+        lu->U_seq_pos == NULL || lu->Lr_ptr == NULL || lu->Lr_idx == NULL ||
+        lu->Lr_val == NULL || lu->Ur_start == NULL || lu->Ur_len == NULL ||
+        lu->Ur_cap == NULL || lu->Ur_idx == NULL || lu->Ur_val == NULL ||
+        lu->work == NULL || lu->iwork == NULL || lu->hs_x == NULL ||
+        lu->hs_list == NULL || lu->hs_pattern == NULL || lu->hs_out == NULL ||
+        lu->hs_stack == NULL || lu->hs_next == NULL || lu->hs_mark == NULL ||
+        lu->perm_row == NULL || lu->perm_col == NULL ||
+        lu->perm_row_inv == NULL || lu->perm_col_inv == NULL ||
+        lu->repair_var == NULL) {
         cxf_lu_free(lu);
         return NULL;
     }
 
-    /* Initialize permutations to identity */
+    /* Initialize permutations and pivot order to identity */
     for (int i = 0; i < m; i++) {
         lu->perm_row[i] = i;
         lu->perm_col[i] = i;
+        lu->perm_row_inv[i] = i;
+        lu->perm_col_inv[i] = i;
+        lu->U_seq[i] = i;
+        lu->U_seq_pos[i] = i;
     }
 
     return lu;
@@ -87,8 +142,39 @@ void cxf_lu_free(LUFactors *lu) {
     free(lu->U_row_idx);
     free(lu->U_values);
     free(lu->U_diag);
+    free(lu->U_col_len);
+    free(lu->U_seq);
+    free(lu->U_seq_pos);
+    free(lu->R_pivot);
+    free(lu->R_start);
+    free(lu->R_idx);
+    free(lu->R_val);
+    free(lu->Lr_ptr);
+    free(lu->Lr_idx);
+    free(lu->Lr_val);
+    free(lu->Ur_start);
+    free(lu->Ur_len);
+    free(lu->Ur_cap);
+    free(lu->Ur_idx);
+    free(lu->Ur_val);
+    free(lu->work);
+    free(lu->iwork);
+    free(lu->hs_x);
+    free(lu->hs_list);
+    free(lu->hs_pattern);
+    free(lu->hs_out);
+    free(lu->hs_stack);
+    free(lu->hs_next);
+    free(lu->hs_mark);
     free(lu->perm_row);
     free(lu->perm_col);
+    free(lu->perm_row_inv);
+    free(lu->perm_col_inv);
+    free(lu->L_val32);
+    free(lu->Lr_val32);
+    free(lu->U_val32);
+    free(lu->Ur_val32);
+    free(lu->repair_var);
     free(lu);
 }
 
@@ -105,8 +191,12 @@ void cxf_lu_clear(LUFactors *lu) {
     }
 
     lu->valid = 0;
+    lu->rank = 0;
     lu->L_nnz = 0;
     lu->U_nnz = 0;
+    lu->U_used = 0;
+    lu->R_count = 0;
+    lu->repairs = 0;
 
     /* Reset column pointers to empty columns */
     if (lu->L_col_ptr != NULL) {
@@ -121,4 +211,52 @@ void cxf_lu_clear(LUFactors *lu) {
         if (lu->perm_row != NULL) lu->perm_row[i] = i;
         if (lu->perm_col != NULL) lu->perm_col[i] = i;
     }
+    (void)cxf_lu_reset_updates(lu);  /* Empty factors need no new storage */
+}
+
+/**
+ * @brief Reset the update state after a fresh factorization.
+ *
+ * @param lu LUFactors holding a fresh factorization.
+ * @return CXF_OK on success, CXF_ERROR_OUT_OF_MEMORY on allocation failure.
+ */
+int cxf_lu_reset_updates(LUFactors *lu) {
+    if (lu == NULL) {
+        return CXF_ERROR_NULL_ARGUMENT;
+    }
+
+    for (int k = 0; k < lu->m; k++) {
+        if (lu->U_col_len != NULL) {
+            lu->U_col_len[k] = (int)(lu->U_col_ptr[k + 1] - lu->U_col_ptr[k]);
+        }
+        if (lu->U_seq != NULL) lu->U_seq[k] = k;
+        if (lu->U_seq_pos != NULL) lu->U_seq_pos[k] = k;
+    }
+    lu->U_used = lu->U_nnz;
+    lu->R_count = 0;
+
+    /* Room for the columns the updates append: twice the fresh U */
+    if (2 * lu->U_nnz > lu->U_capacity) {
+        int64_t cap = 2 * lu->U_nnz;
+        int *idx = (int *)realloc(lu->U_row_idx, (size_t)cap * sizeof(int));
+        if (idx == NULL) return CXF_ERROR_OUT_OF_MEMORY;
+        lu->U_row_idx = idx;
+        double *val = (double *)realloc(lu->U_values, (size_t)cap * sizeof(double));
+        if (val == NULL) return CXF_ERROR_OUT_OF_MEMORY;
+        lu->U_values = val;
+        lu->U_capacity = cap;
+    }
+    if (lu->R_start != NULL) {
+        lu->R_start[0] = 0;
+    }
+
+    for (int k = 0; k < lu->m; k++) {
+        lu->perm_row_inv[lu->perm_row[k]] = k;
+        lu->perm_col_inv[lu->perm_col[k]] = k;
+    }
+    int rc = cxf_lu_build_rowwise(lu);
+    if (rc != CXF_OK) {
+        return rc;
+    }
+    return cxf_lu_build_single(lu);
 }
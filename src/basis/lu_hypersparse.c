@@ -0,0 +1,386 @@
+/**
+ * @file lu_hypersparse.c
+ * @brief Hypersparse triangular solves with the basis LU factors.
+ *
+ * FTRAN of a sparse column and BTRAN of a unit row typically produce
+ * results with a handful of nonzeros, yet the dense sweeps in ftran.c and
+ * btran.c visit all m steps. Following Gilbert and Peierls, the solves
+ * here first find the set of steps reachable from the right-hand side
+ * nonzeros in the graph of the factor (a depth-first search, which also
+ * yields a valid elimination order), then only process those columns.
+ * Work is proportional to the flops performed rather than to m.
+ *
+ * The transposed solves of BTRAN need the factors by rows; the row-wise
+ * copies are built here after each factorization and Ur is maintained by
+ * the Forrest-Tomlin update (lu_update.c).
+ */
+
+#include "convexfeld/cxf_basis.h"
+#include "convexfeld/cxf_types.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+/* Weight of the newest result in the running density averages */
+#define HYPER_DENSITY_WEIGHT 0.1
+
+/**
+ * @brief Column access to one triangular factor.
+ *
+ * Column k holds len[k] entries from start[k], or runs to start[k + 1]
+ * when len is NULL. A NULL diag means unit diagonal.
+ */
+typedef struct {
+    const int64_t *start;
+    const int *len;
+    const int *idx;
+    const double *val;
+    const double *diag;
+} HyperFactor;
+
+static void hyper_factor(const LUFactors *lu, int factor, HyperFactor *f) {
+    switch (factor) {
+        case CXF_LU_SOLVE_L:
+            f->start = lu->L_col_ptr;
+            f->len = NULL;
+            f->idx = lu->L_row_idx;
+            f->val = lu->L_values;
+            f->diag = NULL;
+            break;
+        case CXF_LU_SOLVE_U:
+            f->start = lu->U_col_ptr;
+            f->len = lu->U_col_len;
+            f->idx = lu->U_row_idx;
+            f->val = lu->U_values;
+            f->diag = lu->U_diag;
+            break;
+        case CXF_LU_SOLVE_LT:
+            f->start = lu->Lr_ptr;
+            f->len = NULL;
+            f->idx = lu->Lr_idx;
+            f->val = lu->Lr_val;
+            f->diag = NULL;
+            break;
+        default:
+            f->start = lu->Ur_start;
+            f->len = lu->Ur_len;
+            f->idx = lu->Ur_idx;
+            f->val = lu->Ur_val;
+            f->diag = lu->U_diag;
+            break;
+    }
+}
+
+static inline int64_t hyper_col_end(const HyperFactor *f, int k) {
+    return (f->len != NULL) ? f->start[k] + f->len[k] : f->start[k + 1];
+}
+
+/**
+ * @brief Start a new visit generation for hs_mark.
+ */
+static int hyper_new_stamp(LUFactors *lu) {
+    if (lu->hs_stamp == INT_MAX) {
+        memset(lu->hs_mark, 0, (size_t)lu->m * sizeof(int));
+        lu->hs_stamp = 0;
+    }
+    return ++lu->hs_stamp;
+}
+
+/**
+ * @brief Steps reachable from the seeds in the graph of the factor.
+ *
+ * Iterative depth-first search; each step is appended when its search
+ * finishes, so hs_out[top..m) lists the reach in topological order.
+ *
+ * @return top.
+ */
+static int hyper_reach(LUFactors *lu, const HyperFactor *f,
+                       const int *seeds, int count) {
+    int m = lu->m;
+    int *mark = lu->hs_mark;
+    int *stack = lu->hs_stack;
+    int64_t *next = lu->hs_next;
+    int *out = lu->hs_out;
+    int stamp = hyper_new_stamp(lu);
+    int top = m;
+
+    for (int q = 0; q < count; q++) {
+        int s = seeds[q];
+        if (mark[s] == stamp) continue;
+        mark[s] = stamp;
+
+        int head = 0;
+        stack[0] = s;
+        next[0] = f->start[s];
+        while (head >= 0) {
+            int k = stack[head];
+            int64_t end = hyper_col_end(f, k);
+            int64_t p = next[head];
+            while (p < end && mark[f->idx[p]] == stamp) p++;
+            if (p < end) {
+                int j = f->idx[p];
+                next[head] = p + 1;
+                mark[j] = stamp;
+                stack[++head] = j;
+                next[head] = f->start[j];
+            } else {
+                out[--top] = k;
+                head--;
+            }
+        }
+    }
+    return top;
+}
+
+/**
+ * @brief Sparse triangular solve with one factor (Gilbert-Peierls).
+ */
+int cxf_lu_hyper_solve(LUFactors *lu, int factor, double *x, int *list, int count) {
+    HyperFactor f;
+    hyper_factor(lu, factor, &f);
+
+    int top = hyper_reach(lu, &f, list, count);
+    int n = 0;
+    for (int q = top; q < lu->m; q++) {
+        int k = lu->hs_out[q];
+        list[n++] = k;
+        double xk = x[k];
+        if (xk == 0.0) continue;
+        if (f.diag != NULL) {
+            xk /= f.diag[k];
+            x[k] = xk;
+        }
+        int64_t end = hyper_col_end(&f, k);
+        for (int64_t p = f.start[k]; p < end; p++) {
+            x[f.idx[p]] -= f.val[p] * xk;
+        }
+    }
+    return n;
+}
+
+/**
+ * @brief Whether a solve with this right-hand side should go hypersparse.
+ */
+static int hyper_wanted(const LUFactors *lu, double average, int count) {
+    double limit = lu->hyper_threshold * lu->m;
+    return count <= limit && average * lu->m <= limit;
+}
+
+/**
+ * @brief Move the nonzeros of hs_x listed in hs_list into x[perm[k]].
+ */
+static int hyper_gather(LUFactors *lu, const int *perm, int n,
+                        double *x, int *pattern) {
+    double *w = lu->hs_x;
+    int count = 0;
+    for (int q = 0; q < n; q++) {
+        int k = lu->hs_list[q];
+        double v = w[k];
+        w[k] = 0.0;
+        if (v != 0.0) {
+            int i = perm[k];
+            x[i] = v;
+            pattern[count++] = i;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Hypersparse LU part of FTRAN.
+ */
+int cxf_lu_ftran_hyper(LUFactors *lu, double *x, int *pattern, int count) {
+    if (!hyper_wanted(lu, lu->ftran_density, count)) {
+        return -1;
+    }
+
+    double *w = lu->hs_x;
+    int *list = lu->hs_list;
+
+    /* Scatter P * x into step space */
+    for (int q = 0; q < count; q++) {
+        int i = pattern[q];
+        int k = lu->perm_row_inv[i];
+        w[k] = x[i];
+        x[i] = 0.0;
+        list[q] = k;
+    }
+
+    int n = cxf_lu_hyper_solve(lu, CXF_LU_SOLVE_L, w, list, count);
+
+    /* Row etas (oldest to newest) may fill in their pivot step */
+    if (lu->R_count > 0) {
+        int stamp = hyper_new_stamp(lu);
+        for (int q = 0; q < n; q++) {
+            lu->hs_mark[list[q]] = stamp;
+        }
+        for (int r = 0; r < lu->R_count; r++) {
+            double sum = 0.0;
+            for (int64_t p = lu->R_start[r]; p < lu->R_start[r + 1]; p++) {
+                sum += lu->R_val[p] * w[lu->R_idx[p]];
+            }
+            if (sum == 0.0) continue;
+            int t = lu->R_pivot[r];
+            w[t] -= sum;
+            if (lu->hs_mark[t] != stamp) {
+                lu->hs_mark[t] = stamp;
+                list[n++] = t;
+            }
+        }
+    }
+
+    n = cxf_lu_hyper_solve(lu, CXF_LU_SOLVE_U, w, list, n);
+
+    count = hyper_gather(lu, lu->perm_col, n, x, pattern);
+    cxf_lu_track_density(&lu->ftran_density, count, lu->m);
+    return count;
+}
+
+/**
+ * @brief Hypersparse LU part of BTRAN.
+ */
+int cxf_lu_btran_hyper(LUFactors *lu, double *x, int *pattern, int count) {
+    if (!lu->rowwise || !hyper_wanted(lu, lu->btran_density, count)) {
+        return -1;
+    }
+
+    double *w = lu->hs_x;
+    int *list = lu->hs_list;
+
+    /* Scatter Q * x into step space */
+    for (int q = 0; q < count; q++) {
+        int i = pattern[q];
+        int k = lu->perm_col_inv[i];
+        w[k] = x[i];
+        x[i] = 0.0;
+        list[q] = k;
+    }
+
+    int n = cxf_lu_hyper_solve(lu, CXF_LU_SOLVE_UT, w, list, count);
+
+    /* Transposed row etas (newest to oldest) scatter from their pivot step */
+    if (lu->R_count > 0) {
+        int stamp = hyper_new_stamp(lu);
+        for (int q = 0; q < n; q++) {
+            lu->hs_mark[list[q]] = stamp;
+        }
+        for (int r = lu->R_count - 1; r >= 0; r--) {
+            double v = w[lu->R_pivot[r]];
+            if (v == 0.0) continue;
+            for (int64_t p = lu->R_start[r]; p < lu->R_start[r + 1]; p++) {
+                int j = lu->R_idx[p];
+                w[j] -= lu->R_val[p] * v;
+                if (lu->hs_mark[j] != stamp) {
+                    lu->hs_mark[j] = stamp;
+                    list[n++] = j;
+                }
+            }
+        }
+    }
+
+    n = cxf_lu_hyper_solve(lu, CXF_LU_SOLVE_LT, w, list, n);
+
+    count = hyper_gather(lu, lu->perm_row, n, x, pattern);
+    cxf_lu_track_density(&lu->btran_density, count, lu->m);
+    return count;
+}
+
+/**
+ * @brief Fold the density of a solve result into a running average.
+ */
+void cxf_lu_track_density(double *average, int nnz, int m) {
+    if (m <= 0) return;
+    *average += HYPER_DENSITY_WEIGHT * ((double)nnz / m - *average);
+}
+
+/**
+ * @brief Rebuild row-wise L as the transpose of the column-wise L.
+ */
+static int build_rowwise_L(LUFactors *lu) {
+    int m = lu->m;
+    int64_t L_nnz = lu->L_col_ptr[m];
+    if (L_nnz > lu->Lr_capacity) {
+        int64_t cap = 2 * L_nnz;
+        int *idx = (int *)realloc(lu->Lr_idx, (size_t)cap * sizeof(int));
+        if (idx == NULL) return CXF_ERROR_OUT_OF_MEMORY;
+        lu->Lr_idx = idx;
+        double *val = (double *)realloc(lu->Lr_val, (size_t)cap * sizeof(double));
+        if (val == NULL) return CXF_ERROR_OUT_OF_MEMORY;
+        lu->Lr_val = val;
+        lu->Lr_capacity = cap;
+    }
+    memset(lu->Lr_ptr, 0, (size_t)(m + 1) * sizeof(int64_t));
+    for (int64_t p = 0; p < L_nnz; p++) {
+        lu->Lr_ptr[lu->L_row_idx[p] + 1]++;
+    }
+    for (int i = 0; i < m; i++) {
+        lu->Lr_ptr[i + 1] += lu->Lr_ptr[i];
+    }
+    int *fill = lu->iwork;
+    for (int i = 0; i < m; i++) {
+        fill[i] = 0;
+    }
+    for (int k = 0; k < m; k++) {
+        for (int64_t p = lu->L_col_ptr[k]; p < lu->L_col_ptr[k + 1]; p++) {
+            int i = lu->L_row_idx[p];
+            int64_t dst = lu->Lr_ptr[i] + fill[i]++;
+            lu->Lr_idx[dst] = k;
+            lu->Lr_val[dst] = lu->L_values[p];
+        }
+    }
+    return CXF_OK;
+}
+
+/**
+ * @brief Rebuild the row-wise copies of L and U from the column-wise factors.
+ *
+ * Rows of U are packed without slack; the update relocates a row to the
+ * end of the storage when it needs to grow, so the storage is sized for
+ * twice the fresh U plus a few entries per row. Row-wise L is only needed
+ * by BTRAN and is skipped unless lu->rowwise is set.
+ */
+int cxf_lu_build_rowwise(LUFactors *lu) {
+    int m = lu->m;
+
+    if (lu->rowwise) {
+        int rc = build_rowwise_L(lu);
+        if (rc != CXF_OK) return rc;
+    }
+
+    /* Row-wise U, with the slack ft_compact_Ur grows it by */
+    if (2 * lu->U_nnz + 4 * (int64_t)m > lu->Ur_capacity) {
+        int64_t cap = 2 * lu->U_nnz + 4 * (int64_t)m;
+        int *idx = (int *)realloc(lu->Ur_idx, (size_t)cap * sizeof(int));
+        if (idx == NULL) return CXF_ERROR_OUT_OF_MEMORY;
+        lu->Ur_idx = idx;
+        double *val = (double *)realloc(lu->Ur_val, (size_t)cap * sizeof(double));
+        if (val == NULL) return CXF_ERROR_OUT_OF_MEMORY;
+        lu->Ur_val = val;
+        lu->Ur_capacity = cap;
+    }
+    memset(lu->Ur_len, 0, (size_t)m * sizeof(int));
+    for (int k = 0; k < m; k++) {
+        int64_t end = lu->U_col_ptr[k] + lu->U_col_len[k];
+        for (int64_t p = lu->U_col_ptr[k]; p < end; p++) {
+            lu->Ur_len[lu->U_row_idx[p]]++;
+        }
+    }
+    int64_t used = 0;
+    for (int i = 0; i < m; i++) {
+        lu->Ur_start[i] = used;
+        lu->Ur_cap[i] = lu->Ur_len[i];
+        used += lu->Ur_len[i];
+        lu->Ur_len[i] = 0;
+    }
+    lu->Ur_used = used;
+    for (int k = 0; k < m; k++) {
+        int64_t end = lu->U_col_ptr[k] + lu->U_col_len[k];
+        for (int64_t p = lu->U_col_ptr[k]; p < end; p++) {
+            int i = lu->U_row_idx[p];
+            int64_t dst = lu->Ur_start[i] + lu->Ur_len[i]++;
+            lu->Ur_idx[dst] = k;
+            lu->Ur_val[dst] = lu->U_values[p];
+        }
+    }
+    return CXF_OK;
+}
@@ -0,0 +1,478 @@
+/**
+ * @file lu_update.c
+ * @brief Forrest-Tomlin update of the basis LU factors.
+ *
+ * Replaces one basis column in P * B * Q = L * U without refactoring.
+ * The spike of the entering column overwrites the U column of the leaving
+ * position, which then moves to the end of the U pivot order. The row it
+ * leaves behind is eliminated against the later rows of U and the
+ * multipliers are appended to the row-eta file. FTRAN/BTRAN cost thus
+ * stays close to that of a fresh factorization, instead of growing with
+ * every pivot as it does with the PFI eta chain.
+ */
+
+#include "convexfeld/cxf_basis.h"
+#include "convexfeld/cxf_types.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* Return code for an update rejected by the stability check */
+#define FT_UNSTABLE  -1
+
+/* Smallest acceptable new diagonal */
+#define FT_MIN_PIVOT  1e-11
+
+/* Allowed relative mismatch between the new diagonal and the one implied
+ * by the simplex pivot element (det(B') / det(B) = pivotCol[position]) */
+#define FT_STABILITY_TOL  1e-6
+
+/* Spike and row-eta entries below this magnitude are dropped */
+#define FT_DROP_TOL  1e-14
+
+/**
+ * @brief Heapsort of int64 keys (qsort may allocate a merge buffer).
+ */
+static void sort_int64(int64_t *a, int n) {
+    for (int top = n / 2 - 1, end = n - 1; end > 0;) {
+        int root;
+        if (top >= 0) {
+            root = top--;
+        } else {
+            int64_t t = a[0];
+            a[0] = a[end];
+            a[end--] = t;
+            root = 0;
+        }
+        for (;;) {
+            int child = 2 * root + 1;
+            if (child > end) break;
+            if (child < end && a[child + 1] > a[child]) child++;
+            if (a[root] >= a[child]) break;
+            int64_t t = a[root];
+            a[root] = a[child];
+            a[child] = t;
+            root = child;
+        }
+    }
+}
+
+/**
+ * @brief Squeeze the holes out of segmented storage without a new buffer.
+ *
+ * Moving the segments down in the order of their start positions never
+ * overwrites a segment that is still to be moved. The order comes from
+ * sorting start * count + segment in hs_next, which is free outside the
+ * hypersparse solves.
+ *
+ * @param lu Factors (for the hs_next workspace)
+ * @param start Segment starts [count], updated
+ * @param len Segment lengths [count]
+ * @param count Number of segments (at most m)
+ * @param idx Index storage
+ * @param val Value storage
+ * @return Used length after compaction
+ */
+static int64_t ft_compact_in_place(LUFactors *lu, int64_t *start, const int *len,
+                                   int count, int *idx, double *val) {
+    int64_t *order = lu->hs_next;
+    int n = 0;
+    for (int k = 0; k < count; k++) {
+        if (len[k] > 0) {
+            order[n++] = start[k] * count + k;
+        } else {
+            start[k] = 0;
+        }
+    }
+    sort_int64(order, n);
+
+    int64_t used = 0;
+    for (int q = 0; q < n; q++) {
+        int k = (int)(order[q] % count);
+        if (start[k] != used) {
+            memmove(idx + used, idx + start[k], (size_t)len[k] * sizeof(int));
+            memmove(val + used, val + start[k], (size_t)len[k] * sizeof(double));
+            start[k] = used;
+        }
+        used += len[k];
+    }
+    return used;
+}
+
+/**
+ * @brief Ensure room for extra entries at the end of U storage.
+ *
+ * Columns replaced by updates leave holes behind, so when U runs out of
+ * room the holes are dropped: in place while the live entries fill at
+ * most 3/4 of the storage, otherwise by copying into a larger buffer in
+ * step order.
+ */
+static int ft_reserve_U(LUFactors *lu, int64_t extra) {
+    if (lu->U_used + extra <= lu->U_capacity) {
+        return CXF_OK;
+    }
+
+    if (4 * (lu->U_nnz + extra) <= 3 * lu->U_capacity) {
+        lu->U_used = ft_compact_in_place(lu, lu->U_col_ptr, lu->U_col_len, lu->m,
+                                         lu->U_row_idx, lu->U_values);
+        lu->U_col_ptr[lu->m] = lu->U_used;
+        return CXF_OK;
+    }
+
+    int64_t cap = 2 * (lu->U_nnz + extra);
+    if (cap < lu->U_capacity) cap = lu->U_capacity;
+
+    int *idx = (int *)malloc((size_t)cap * sizeof(int));
+    double *val = (double *)malloc((size_t)cap * sizeof(double));
+    if (idx == NULL || val == NULL) {
+        free(idx);
+        free(val);
+        return CXF_ERROR_OUT_OF_MEMORY;
+    }
+
+    int64_t used = 0;
+    for (int k = 0; k < lu->m; k++) {
+        int len = lu->U_col_len[k];
+        memcpy(idx + used, lu->U_row_idx + lu->U_col_ptr[k], (size_t)len * sizeof(int));
+        memcpy(val + used, lu->U_values + lu->U_col_ptr[k], (size_t)len * sizeof(double));
+        lu->U_col_ptr[k] = used;
+        used += len;
+    }
+    lu->U_col_ptr[lu->m] = used;
+
+    free(lu->U_row_idx);
+    free(lu->U_values);
+    lu->U_row_idx = idx;
+    lu->U_values = val;
+    lu->U_capacity = cap;
+    lu->U_used = used;
+    return CXF_OK;
+}
+
+/**
+ * @brief Repack row-wise U with room for extra entries, in place while
+ *        the rows fill at most 3/4 of the storage.
+ */
+static int ft_compact_Ur(LUFactors *lu, int64_t extra) {
+    int64_t total = 0;
+    for (int i = 0; i < lu->m; i++) {
+        total += lu->Ur_len[i];
+    }
+    if (4 * (total + extra) <= 3 * lu->Ur_capacity) {
+        lu->Ur_used = ft_compact_in_place(lu, lu->Ur_start, lu->Ur_len, lu->m,
+                                          lu->Ur_idx, lu->Ur_val);
+        for (int i = 0; i < lu->m; i++) {
+            lu->Ur_cap[i] = lu->Ur_len[i];
+        }
+        return CXF_OK;
+    }
+
+    int64_t cap = 2 * (total + extra) + 4 * (int64_t)lu->m;
+    if (cap < lu->Ur_capacity) cap = lu->Ur_capacity;
+
+    int *idx = (int *)malloc((size_t)cap * sizeof(int));
+    double *val = (double *)malloc((size_t)cap * sizeof(double));
+    if (idx == NULL || val == NULL) {
+        free(idx);
+        free(val);
+        return CXF_ERROR_OUT_OF_MEMORY;
+    }
+
+    int64_t used = 0;
+    for (int i = 0; i < lu->m; i++) {
+        int len = lu->Ur_len[i];
+        memcpy(idx + used, lu->Ur_idx + lu->Ur_start[i], (size_t)len * sizeof(int));
+        memcpy(val + used, lu->Ur_val + lu->Ur_start[i], (size_t)len * sizeof(double));
+        lu->Ur_start[i] = used;
+        lu->Ur_cap[i] = len;
+        used += len;
+    }
+
+    free(lu->Ur_idx);
+    free(lu->Ur_val);
+    lu->Ur_idx = idx;
+    lu->Ur_val = val;
+    lu->Ur_capacity = cap;
+    lu->Ur_used = used;
+    return CXF_OK;
+}
+
+/**
+ * @brief Append entry (i, col) to row i of row-wise U.
+ *
+ * A full row moves to the end of the storage with room to grow.
+ */
+static int ft_append_Ur(LUFactors *lu, int i, int col, double value) {
+    int len = lu->Ur_len[i];
+    if (len == lu->Ur_cap[i]) {
+        int cap = 2 * len + 4;
+        if (lu->Ur_used + cap > lu->Ur_capacity &&
+            ft_compact_Ur(lu, cap) != CXF_OK) {
+            return CXF_ERROR_OUT_OF_MEMORY;
+        }
+        int64_t from = lu->Ur_start[i];
+        int64_t to = lu->Ur_used;
+        memmove(lu->Ur_idx + to, lu->Ur_idx + from, (size_t)len * sizeof(int));
+        memmove(lu->Ur_val + to, lu->Ur_val + from, (size_t)len * sizeof(double));
+        lu->Ur_start[i] = to;
+        lu->Ur_cap[i] = cap;
+        lu->Ur_used += cap;
+    }
+    int64_t p = lu->Ur_start[i] + len;
+    lu->Ur_idx[p] = col;
+    lu->Ur_val[p] = value;
+    lu->Ur_len[i] = len + 1;
+    return CXF_OK;
+}
+
+/**
+ * @brief Remove entry (i, col) from row i of row-wise U.
+ */
+static void ft_remove_Ur(LUFactors *lu, int i, int col) {
+    int64_t start = lu->Ur_start[i];
+    int64_t last = start + lu->Ur_len[i] - 1;
+    for (int64_t p = start; p <= last; p++) {
+        if (lu->Ur_idx[p] == col) {
+            lu->Ur_idx[p] = lu->Ur_idx[last];
+            lu->Ur_val[p] = lu->Ur_val[last];
+            lu->Ur_len[i]--;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Ensure room for one more row eta with nnz entries.
+ */
+static int ft_reserve_R(LUFactors *lu, int64_t nnz) {
+    if (lu->R_count + 1 > lu->R_capacity) {
+        int cap = (lu->R_capacity > 0) ? 2 * lu->R_capacity : 64;
+        int *pivot = (int *)realloc(lu->R_pivot, (size_t)cap * sizeof(int));
+        if (pivot == NULL) return CXF_ERROR_OUT_OF_MEMORY;
+        lu->R_pivot = pivot;
+        int64_t *start = (int64_t *)realloc(lu->R_start, (size_t)(cap + 1) * sizeof(int64_t));
+        if (start == NULL) return CXF_ERROR_OUT_OF_MEMORY;
+        if (lu->R_capacity == 0) start[0] = 0;
+        lu->R_start = start;
+        lu->R_capacity = cap;
+    }
+
+    int64_t need = lu->R_start[lu->R_count] + nnz;
+    if (need > lu->R_nnz_capacity) {
+        int64_t cap = 2 * need;
+        if (cap < 4 * (int64_t)lu->m) cap = 4 * (int64_t)lu->m;
+        int *idx = (int *)realloc(lu->R_idx, (size_t)cap * sizeof(int));
+        if (idx == NULL) return CXF_ERROR_OUT_OF_MEMORY;
+        lu->R_idx = idx;
+        double *val = (double *)realloc(lu->R_val, (size_t)cap * sizeof(double));
+        if (val == NULL) return CXF_ERROR_OUT_OF_MEMORY;
+        lu->R_val = val;
+        lu->R_nnz_capacity = cap;
+    }
+    return CXF_OK;
+}
+
+/**
+ * @brief Add v to spike[i], listing i when it becomes nonzero.
+ */
+static inline void ft_spike_add(double *spike, int *slist, int *ns, int i, double v) {
+    double old = spike[i];
+    double sum = old + v;
+    if (sum == old) {
+        return;  /* Also keeps an underflowed v from listing i twice */
+    }
+    if (old == 0.0) {
+        slist[(*ns)++] = i;
+    } else if (sum == 0.0) {
+        sum = CXF_TINY_VALUE;
+    }
+    spike[i] = sum;
+}
+
+/**
+ * @brief Zero the listed entries of the update workspace.
+ */
+static void ft_clear(double *v, const int *list, int n) {
+    for (int q = 0; q < n; q++) {
+        v[list[q]] = 0.0;
+    }
+}
+
+/**
+ * @brief Forrest-Tomlin update for a basis column replacement.
+ *
+ * Algorithm:
+ * 1. Recover the spike s = U * Q^T * pivotCol (= R * L^(-1) * P * a_q)
+ * 2. Gather row t of U, t being the step of the leaving position
+ * 3. Solve r^T * U22 = row_t^T over the pivots after t for the multipliers
+ * 4. New diagonal d = s_t - r^T * s; reject if it disagrees with the
+ *    simplex pivot element
+ * 5. Remove row t from U, store s as column t, append r as a row eta
+ *    and move t to the end of the pivot order
+ *
+ * Row t comes from row-wise U and step 3 is a hypersparse U^T solve, so
+ * both cost in proportion to the entries involved rather than to m. With
+ * a pattern the spike is built from the nonzeros of pivotCol only; the
+ * spike and multiplier workspaces are kept zero between updates.
+ *
+ * @param lu Valid LUFactors representing the current basis.
+ * @param position Basis position of the leaving variable.
+ * @param pivotCol FTRAN result B^(-1) * a_entering, length m.
+ * @param pattern Nonzero positions of pivotCol, or NULL to scan all m.
+ * @param count Number of entries in pattern.
+ * @return CXF_OK on success, -1 if the update is unstable,
+ *         CXF_ERROR_OUT_OF_MEMORY on allocation failure.
+ */
+int cxf_lu_ft_update(LUFactors *lu, int position, const double *pivotCol,
+                     const int *pattern, int count) {
+    if (lu == NULL || pivotCol == NULL) {
+        return CXF_ERROR_NULL_ARGUMENT;
+    }
+
+    int m = lu->m;
+    if (!lu->valid || position < 0 || position >= m) {
+        return CXF_ERROR_INVALID_ARGUMENT;
+    }
+
+    double *spike = lu->work;
+    double *rowv = lu->work + m;
+    int *rcols = lu->iwork;
+    int *slist = lu->iwork + m;
+    int ns = 0;
+
+    int t = lu->perm_col_inv[position];
+
+    /* Step 1: spike s = U * z with z[k] = pivotCol[perm_col[k]] */
+    int nz = (pattern != NULL) ? count : m;
+    for (int q = 0; q < nz; q++) {
+        int k = (pattern != NULL) ? lu->perm_col_inv[pattern[q]] : q;
+        double zk = pivotCol[lu->perm_col[k]];
+        if (zk == 0.0) continue;
+        ft_spike_add(spike, slist, &ns, k, lu->U_diag[k] * zk);
+        int64_t end = lu->U_col_ptr[k] + lu->U_col_len[k];
+        for (int64_t p = lu->U_col_ptr[k]; p < end; p++) {
+            ft_spike_add(spike, slist, &ns, lu->U_row_idx[p], lu->U_values[p] * zk);
+        }
+    }
+
+    /* Step 2: row t of U, from row-wise U */
+    int tpos = lu->U_seq_pos[t];
+    int nr = lu->Ur_len[t];
+    for (int q = 0; q < nr; q++) {
+        int64_t p = lu->Ur_start[t] + q;
+        rowv[lu->Ur_idx[p]] = lu->Ur_val[p];
+        rcols[q] = lu->Ur_idx[p];
+    }
+
+    /* Step 3: multipliers U22^T * r = row_t (overwrite rowv). The reach
+     * of row t only contains steps after t in the pivot order. */
+    int *rlist = lu->hs_list;
+    memcpy(rlist, rcols, (size_t)nr * sizeof(int));
+    int nlist = (nr > 0) ? cxf_lu_hyper_solve(lu, CXF_LU_SOLVE_UT, rowv, rlist, nr) : 0;
+    int r_nnz = 0;
+    for (int q = 0; q < nlist; q++) {
+        if (fabs(rowv[rlist[q]]) > FT_DROP_TOL) r_nnz++;
+    }
+
+    /* Step 4: new diagonal and stability check */
+    double d = spike[t];
+    for (int q = 0; q < nlist; q++) {
+        int j = rlist[q];
+        d -= rowv[j] * spike[j];
+    }
+    double expected = pivotCol[position] * lu->U_diag[t];
+    if (!isfinite(d) || fabs(d) < FT_MIN_PIVOT ||
+        fabs(d - expected) > FT_STABILITY_TOL * fabs(d)) {
+        ft_clear(spike, slist, ns);
+        ft_clear(rowv, rlist, nlist);
+        return FT_UNSTABLE;
+    }
+
+    /* Step 5: commit */
+    int s_nnz = 0;
+    for (int q = 0; q < ns; q++) {
+        int i = slist[q];
+        if (i != t && fabs(spike[i]) > FT_DROP_TOL) s_nnz++;
+    }
+    if (ft_reserve_U(lu, s_nnz) != CXF_OK || ft_reserve_R(lu, r_nnz) != CXF_OK) {
+        ft_clear(spike, slist, ns);
+        ft_clear(rowv, rlist, nlist);
+        return CXF_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* U changes in place below; its float32 copies are stale from here */
+    lu->single_U = 0;
+
+    /* Remove row t from the later columns */
+    for (int q = 0; q < nr; q++) {
+        int j = rcols[q];
+        int64_t start = lu->U_col_ptr[j];
+        int64_t last = start + lu->U_col_len[j] - 1;
+        for (int64_t p = start; p <= last; p++) {
+            if (lu->U_row_idx[p] == t) {
+                lu->U_row_idx[p] = lu->U_row_idx[last];
+                lu->U_values[p] = lu->U_values[last];
+                lu->U_col_len[j]--;
+                lu->U_nnz--;
+                break;
+            }
+        }
+    }
+
+    lu->Ur_len[t] = 0;
+
+    /* Spike becomes column t, appended at the end of U storage */
+    int64_t start = lu->U_used;
+    int64_t old_end = lu->U_col_ptr[t] + lu->U_col_len[t];
+    for (int64_t p = lu->U_col_ptr[t]; p < old_end; p++) {
+        ft_remove_Ur(lu, lu->U_row_idx[p], t);
+    }
+    lu->U_nnz -= lu->U_col_len[t];
+    for (int q = 0; q < ns; q++) {
+        int i = slist[q];
+        if (i != t && fabs(spike[i]) > FT_DROP_TOL) {
+            lu->U_row_idx[lu->U_used] = i;
+            lu->U_values[lu->U_used] = spike[i];
+            lu->U_used++;
+            if (ft_append_Ur(lu, i, t, spike[i]) != CXF_OK) {
+                /* Row-wise U is now out of step; force a refactor */
+                ft_clear(spike, slist, ns);
+                ft_clear(rowv, rlist, nlist);
+                lu->valid = 0;
+                return CXF_ERROR_OUT_OF_MEMORY;
+            }
+        }
+    }
+    lu->U_col_ptr[t] = start;
+    lu->U_col_len[t] = (int)(lu->U_used - start);
+    lu->U_nnz += lu->U_col_len[t];
+    lu->U_diag[t] = d;
+
+    /* Row eta: v[t] -= sum r_j * v[j] */
+    int64_t rp = lu->R_start[lu->R_count];
+    for (int q = 0; q < nlist; q++) {
+        int j = rlist[q];
+        if (fabs(rowv[j]) > FT_DROP_TOL) {
+            lu->R_idx[rp] = j;
+            lu->R_val[rp] = rowv[j];
+            rp++;
+        }
+    }
+    lu->R_pivot[lu->R_count] = t;
+    lu->R_count++;
+    lu->R_start[lu->R_count] = rp;
+
+    ft_clear(spike, slist, ns);
+    ft_clear(rowv, rlist, nlist);
+
+    /* Move t to the end of the pivot order */
+    for (int pos = tpos; pos < m - 1; pos++) {
+        int j = lu->U_seq[pos + 1];
+        lu->U_seq[pos] = j;
+        lu->U_seq_pos[j] = pos;
+    }
+    lu->U_seq[m - 1] = t;
+    lu->U_seq_pos[t] = m - 1;
+
+    return CXF_OK;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file mixed_precision.c
+ * @brief float32 factor copies and fp64 residuals for mixed-precision solves.
+ *
+ * With the MixedPrecision parameter set, the dense FTRAN/BTRAN sweeps read
+ * float32 copies of the L and U values, halving the bytes moved per solve.
+ * Each result is then corrected by iterative refinement in fp64: the
+ * residual against the actual basis columns is solved for once more and
+ * added back (see ftran.c and btran.c). A solve whose residual does not
+ * reach CXF_FEASIBILITY_TOL within CXF_REFINE_STEPS corrections drops the
+ * float32 copies and is repeated with the fp64 factors.
+ */
+
+#include "convexfeld/cxf_basis.h"
+#include "convexfeld/cxf_matrix.h"
+#include "convexfeld/cxf_types.h"
+#include <stdlib.h>
+#include <math.h>
+
+/**
+ * @brief Grow a float array to hold at least need entries.
+ */
+static int grow_float(float **array, int64_t need) {
+    float *p = (float *)realloc(*array, (size_t)need * sizeof(float));
+    if (p == NULL) return CXF_ERROR_OUT_OF_MEMORY;
+    *array = p;
+    return CXF_OK;
+}
+
+/**
+ * @brief Rebuild the float32 copies of the factor values.
+ */
+int cxf_lu_build_single(LUFactors *lu) {
+    if (lu == NULL) {
+        return CXF_ERROR_NULL_ARGUMENT;
+    }
+
+    lu->single_L = 0;
+    lu->single_U = 0;
+    if (!lu->single) {
+        return CXF_OK;
+    }
+
+    int m = lu->m;
+    int64_t L_nnz = lu->L_col_ptr[m];
+    int64_t U_len = (lu->U_used > lu->Ur_used) ? lu->U_used : lu->Ur_used;
+
+    if (L_nnz > lu->L32_capacity) {
+        int64_t cap = 2 * L_nnz;
+        if (grow_float(&lu->L_val32, cap) != CXF_OK ||
+            grow_float(&lu->Lr_val32, cap) != CXF_OK) {
+            return CXF_ERROR_OUT_OF_MEMORY;
+        }
+        lu->L32_capacity = cap;
+    }
+    if (U_len > lu->U32_capacity) {
+        int64_t cap = 2 * U_len;
+        if (grow_float(&lu->U_val32, cap) != CXF_OK ||
+            grow_float(&lu->Ur_val32, cap) != CXF_OK) {
+            return CXF_ERROR_OUT_OF_MEMORY;
+        }
+        lu->U32_capacity = cap;
+    }
+
+    for (int64_t p = 0; p < L_nnz; p++) {
+        lu->L_val32[p] = (float)lu->L_values[p];
+    }
+    if (lu->rowwise) {
+        for (int64_t p = 0; p < L_nnz; p++) {
+            lu->Lr_val32[p] = (float)lu->Lr_val[p];
+        }
+    }
+    for (int64_t p = 0; p < lu->U_used; p++) {
+        lu->U_val32[p] = (float)lu->U_values[p];
+    }
+    for (int64_t p = 0; p < lu->Ur_used; p++) {
+        lu->Ur_val32[p] = (float)lu->Ur_val[p];
+    }
+
+    lu->single_L = 1;
+    lu->single_U = 1;
+    return CXF_OK;
+}
+
+/**
+ * @brief Stop using the float32 copies until the next factorization.
+ */
+void cxf_lu_drop_single(LUFactors *lu) {
+    if (lu == NULL) return;
+    lu->single_L = 0;
+    lu->single_U = 0;
+}
+
+/**
+ * @brief Residual of a basis solve in fp64: r = b - B * x, or b - B^T * x.
+ */
+double cxf_basis_residual(const BasisState *basis, int transpose,
+                          const double *b, const double *x, double *r) {
+    int m = basis->m;
+    int n_orig = basis->n - m;
+    const SparseMatrix *A = basis->matrix;
+
+    double bnorm = 0.0;
+    for (int i = 0; i < m; i++) {
+        r[i] = b[i];
+        if (fabs(b[i]) > bnorm) bnorm = fabs(b[i]);
+    }
+
+    for (int k = 0; k < m; k++) {
+        int var = basis->basic_vars[k];
+        if (var >= n_orig) {
+            /* Slack of row var - n_orig */
+            int row = var - n_orig;
+            if (transpose) {
+                r[k] -= basis->diag_coeff[row] * x[row];
+            } else {
+                r[row] -= basis->diag_coeff[row] * x[k];
+            }
+            continue;
+        }
+        if (transpose) {
+            double sum = 0.0;
+            for (int64_t p = A->col_ptr[var]; p < A->col_ptr[var + 1]; p++) {
+                sum += A->values[p] * x[A->row_idx[p]];
+            }
+            r[k] -= sum;
+        } else {
+            double xk = x[k];
+            if (xk == 0.0) continue;
+            for (int64_t p = A->col_ptr[var]; p < A->col_ptr[var + 1]; p++) {
+                r[A->row_idx[p]] -= A->values[p] * xk;
+            }
+        }
+    }
+
+    double rnorm = 0.0;
+    for (int i = 0; i < m; i++) {
+        if (fabs(r[i]) > rnorm) rnorm = fabs(r[i]);
+    }
+    return rnorm / (1.0 + bnorm);
+}
@@ -3,8 +3,8 @@
  * @brief Product Form of Inverse pivot update implementation.
  *
  * Implements basis update using eta vectors for the Product Form of
- * Inverse (PFI) representation. Creates Type 2 eta factors that represent
- * the basis change after a simplex pivot.
+ * Inverse (PFI) representation. Appends an eta representing the basis
+ * change after a simplex pivot to the packed eta file of the basis.
  *
  * Spec: docs/specs/functions/basis/cxf_pivot_with_eta.md
  */
@@ -12,39 +12,80 @@
 #include "convexfeld/cxf_basis.h"
 #include "convexfeld/cxf_types.h"
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
+/* Eta buffer arena (memory/vectors.c) */
+extern void *cxf_alloc_eta(CxfEnv *env, EtaBuffer *buffer, size_t size);
+
 /**
- * @brief Update basis using product form of inverse (eta vector).
- *
- * Creates an eta vector representing the basis change after a simplex pivot
- * and appends it to the eta list. The eta vector represents an elementary
- * transformation matrix that differs from the identity only in the pivot column.
- *
- * Algorithm:
- * 1. Validate pivot element is sufficiently large
- * 2. Compute eta multiplier = 1 / pivot
- * 3. Count nonzeros in pivot column (excluding pivot row)
- * 4. Allocate eta structure with sparse storage
- * 5. Store eta entries: eta[i] = -pivotCol[i] / pivot for i != pivotRow
- * 6. Link new eta to basis eta list (prepend to head)
- * 7. Update basis header and variable status arrays
+ * @brief Carve an 8-byte aligned array from the eta buffer.
+ */
+static void *eta_carve(BasisState *basis, size_t bytes) {
+    return cxf_alloc_eta(NULL, &basis->eta_buffer, (bytes + 7) & ~(size_t)7);
+}
+
+/**
+ * @brief Make room in the eta file for one more eta with nnz entries.
  *
- * @param basis BasisState containing current basis factorization.
- * @param pivotRow Row index of leaving variable (0 <= pivotRow < m).
- * @param pivotCol Pivot column from FTRAN (B^(-1) * a_entering), length m.
- * @param enteringVar Index of entering variable.
- * @param leavingVar Index of leaving variable.
- * @return CXF_OK on success, CXF_ERROR_OUT_OF_MEMORY on allocation failure,
- *         -1 if pivot element is too small (|pivot| < CXF_PIVOT_TOL).
+ * Full arrays are replaced by twice larger copies carved from the eta
+ * buffer. The old copies stay in the buffer until the basis is freed,
+ * which bounds the waste by the final size.
  */
-int cxf_pivot_with_eta(BasisState *basis, int pivotRow, const double *pivotCol,
-                       int enteringVar, int leavingVar) {
-    /* Validate arguments */
-    if (basis == NULL || pivotCol == NULL) {
-        return CXF_ERROR_NULL_ARGUMENT;
+static int eta_file_reserve(BasisState *basis, int64_t nnz) {
+    int count = basis->eta_count;
+
+    if (count == basis->eta_capacity) {
+        int cap = 2 * basis->eta_capacity + 16;
+        int *row = (int *)eta_carve(basis, (size_t)cap * sizeof(int));
+        int *var = (int *)eta_carve(basis, (size_t)cap * sizeof(int));
+        double *pivot = (double *)eta_carve(basis, (size_t)cap * sizeof(double));
+        int64_t *start = (int64_t *)eta_carve(basis, (size_t)(cap + 1) * sizeof(int64_t));
+        if (row == NULL || var == NULL || pivot == NULL || start == NULL) {
+            return CXF_ERROR_OUT_OF_MEMORY;
+        }
+        if (count > 0) {
+            memcpy(row, basis->eta_row, (size_t)count * sizeof(int));
+            memcpy(var, basis->eta_var, (size_t)count * sizeof(int));
+            memcpy(pivot, basis->eta_pivot, (size_t)count * sizeof(double));
+            memcpy(start, basis->eta_start, (size_t)count * sizeof(int64_t));
+        }
+        start[count] = (count > 0) ? basis->eta_start[count] : 0;
+        basis->eta_row = row;
+        basis->eta_var = var;
+        basis->eta_pivot = pivot;
+        basis->eta_start = start;
+        basis->eta_capacity = cap;
     }
 
+    int64_t used = basis->eta_start[count];
+    if (used + nnz > basis->eta_nnz_capacity) {
+        int64_t cap = 2 * (used + nnz) + 4 * (int64_t)basis->m;
+        int *idx = (int *)eta_carve(basis, (size_t)cap * sizeof(int));
+        double *val = (double *)eta_carve(basis, (size_t)cap * sizeof(double));
+        if (idx == NULL || val == NULL) {
+            return CXF_ERROR_OUT_OF_MEMORY;
+        }
+        if (used > 0) {
+            memcpy(idx, basis->eta_idx, (size_t)used * sizeof(int));
+            memcpy(val, basis->eta_val, (size_t)used * sizeof(double));
+        }
+        basis->eta_idx = idx;
+        basis->eta_val = val;
+        basis->eta_nnz_capacity = cap;
+    }
+    return CXF_OK;
+}
+
+/**
+ * @brief Shared body of cxf_pivot_with_eta and cxf_pivot_with_eta_sparse.
+ *
+ * @param pattern Nonzero rows of pivotCol, or NULL to scan all m.
+ * @param count Number of entries in pattern.
+ */
+static int pivot_update(BasisState *basis, int pivotRow, const double *pivotCol,
+                        const int *pattern, int count,
+                        int enteringVar, int leavingVar) {
     int m = basis->m;
 
     /* Validate pivot row index */
@@ -58,61 +99,62 @@ int cxf_pivot_with_eta(BasisState *basis, int pivotRow, const double *pivotCol,
         return -1;  /* Pivot too small - caller should refactorize */
     }
 
+    /* Forrest-Tomlin mode: update U in place while the LU factors alone
+     * represent the basis. An unstable update falls back to an eta, which
+     * stays valid on top of the factors until the next refactorization. */
+    if (basis->update_method == CXF_BASIS_UPDATE_FT && basis->lu != NULL &&
+        basis->lu->valid && basis->eta_count == 0) {
+        int rc = cxf_lu_ft_update(basis->lu, pivotRow, pivotCol, pattern, count);
+        if (rc == CXF_OK) {
+            basis->basic_vars[pivotRow] = enteringVar;
+            basis->var_status[enteringVar] = pivotRow;
+            basis->var_status[leavingVar] = -1;
+            basis->pivots_since_refactor++;
+            return CXF_OK;
+        }
+        if (rc != -1) {
+            return rc;
+        }
+    }
+
     /* Step 2: Store pivot directly (not reciprocal) for correct FTRAN/BTRAN */
 
     /* Step 3: Count nonzeros in pivot column (excluding pivot row)
      * Drop values below CXF_ZERO_TOL to maintain sparsity */
+    int nz = (pattern != NULL) ? count : m;
     int nnz = 0;
-    for (int i = 0; i < m; i++) {
+    for (int q = 0; q < nz; q++) {
+        int i = (pattern != NULL) ? pattern[q] : q;
         if (i != pivotRow && fabs(pivotCol[i]) > CXF_ZERO_TOL) {
             nnz++;
         }
     }
 
-    /* Step 4: Allocate eta structure */
-    EtaFactors *eta = (EtaFactors *)calloc(1, sizeof(EtaFactors));
-    if (eta == NULL) {
+    /* Step 4: Reserve room at the end of the eta file (eta_start[0] is
+     * always 0, so a refactorization only has to reset eta_count) */
+    if (eta_file_reserve(basis, nnz) != CXF_OK) {
         return CXF_ERROR_OUT_OF_MEMORY;
     }
 
-    eta->type = 2;              /* Type 2 = pivot update */
-    eta->pivot_row = pivotRow;
-    eta->pivot_var = enteringVar;
-    eta->pivot_elem = pivot;    /* Store actual pivot, not reciprocal */
-    eta->obj_coeff = 0.0;       /* Not used for pivot updates */
-    eta->status = 0;            /* Not used for pivot updates */
-    eta->nnz = nnz;
-    eta->next = NULL;
-
-    /* Allocate sparse arrays if needed */
-    if (nnz > 0) {
-        eta->indices = (int *)calloc((size_t)nnz, sizeof(int));
-        eta->values = (double *)calloc((size_t)nnz, sizeof(double));
-
-        if (eta->indices == NULL || eta->values == NULL) {
-            free(eta->indices);
-            free(eta->values);
-            free(eta);
-            return CXF_ERROR_OUT_OF_MEMORY;
-        }
-
-        /* Step 5: Store eta entries in sparse format
-         * Store raw column values; FTRAN/BTRAN apply correct formulas */
-        int k = 0;
-        for (int i = 0; i < m; i++) {
-            if (i != pivotRow && fabs(pivotCol[i]) > CXF_ZERO_TOL) {
-                eta->indices[k] = i;
-                eta->values[k] = pivotCol[i];  /* Store column value directly */
-                k++;
-            }
+    /* Step 5: Append eta entries in sparse format
+     * Store raw column values; FTRAN/BTRAN apply correct formulas */
+    int k = basis->eta_count;
+    int64_t p = basis->eta_start[k];
+    for (int q = 0; q < nz; q++) {
+        int i = (pattern != NULL) ? pattern[q] : q;
+        if (i != pivotRow && fabs(pivotCol[i]) > CXF_ZERO_TOL) {
+            basis->eta_idx[p] = i;
+            basis->eta_val[p] = pivotCol[i];  /* Store column value directly */
+            p++;
         }
     }
 
-    /* Step 6: Link new eta to basis eta list (prepend to head)
-     * New etas are added at the head for chronological ordering */
-    eta->next = basis->eta_head;
-    basis->eta_head = eta;
-    basis->eta_count++;
+    /* Step 6: Commit the eta (chronological order, newest last) */
+    basis->eta_row[k] = pivotRow;
+    basis->eta_var[k] = enteringVar;
+    basis->eta_pivot[k] = pivot;    /* Store actual pivot, not reciprocal */
+    basis->eta_start[k + 1] = p;
+    basis->eta_count = k + 1;
 
     /* Step 7: Update basis state arrays */
     basis->basic_vars[pivotRow] = enteringVar;
@@ -122,3 +164,64 @@ int cxf_pivot_with_eta(BasisState *basis, int pivotRow, const double *pivotCol,
 
     return CXF_OK;
 }
+
+/**
+ * @brief Update basis using product form of inverse (eta vector).
+ *
+ * Creates an eta vector representing the basis change after a simplex pivot
+ * and appends it to the eta file. The eta vector represents an elementary
+ * transformation matrix that differs from the identity only in the pivot column.
+ * With update_method CXF_BASIS_UPDATE_FT and valid LU factors, the LU
+ * factors are updated in place (cxf_lu_ft_update) instead.
+ *
+ * Algorithm:
+ * 1. Validate pivot element is sufficiently large
+ * 2. Compute eta multiplier = 1 / pivot
+ * 3. Count nonzeros in pivot column (excluding pivot row)
+ * 4. Reserve room at the end of the eta file
+ * 5. Store eta entries: raw pivotCol[i] for i != pivotRow
+ * 6. Record pivot row, entering variable and pivot element
+ * 7. Update basis header and variable status arrays
+ *
+ * @param basis BasisState containing current basis factorization.
+ * @param pivotRow Row index of leaving variable (0 <= pivotRow < m).
+ * @param pivotCol Pivot column from FTRAN (B^(-1) * a_entering), length m.
+ * @param enteringVar Index of entering variable.
+ * @param leavingVar Index of leaving variable.
+ * @return CXF_OK on success, CXF_ERROR_OUT_OF_MEMORY on allocation failure,
+ *         -1 if pivot element is too small (|pivot| < CXF_PIVOT_TOL).
+ */
+int cxf_pivot_with_eta(BasisState *basis, int pivotRow, const double *pivotCol,
+                       int enteringVar, int leavingVar) {
+    /* Validate arguments */
+    if (basis == NULL || pivotCol == NULL) {
+        return CXF_ERROR_NULL_ARGUMENT;
+    }
+
+    return pivot_update(basis, pivotRow, pivotCol, NULL, 0, enteringVar, leavingVar);
+}
+
+/**
+ * @brief Basis update from a sparse pivot column.
+ *
+ * Same as cxf_pivot_with_eta, visiting only the nonzeros of the pivot
+ * column when building the eta or the Forrest-Tomlin spike.
+ *
+ * @param basis BasisState containing current basis factorization.
+ * @param pivotRow Row index of leaving variable (0 <= pivotRow < m).
+ * @param pivotCol FTRAN result B^(-1) * a_entering as a sparse accumulator.
+ * @param enteringVar Index of entering variable.
+ * @param leavingVar Index of leaving variable.
+ * @return CXF_OK on success, CXF_ERROR_OUT_OF_MEMORY on allocation failure,
+ *         -1 if pivot element is too small (|pivot| < CXF_PIVOT_TOL).
+ */
+int cxf_pivot_with_eta_sparse(BasisState *basis, int pivotRow,
+                              const VectorContainer *pivotCol,
+                              int enteringVar, int leavingVar) {
+    if (basis == NULL || pivotCol == NULL) {
+        return CXF_ERROR_NULL_ARGUMENT;
+    }
+
+    return pivot_update(basis, pivotRow, pivotCol->values, pivotCol->indices,
+                        pivotCol->size, enteringVar, leavingVar);
+}
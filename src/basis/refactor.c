@@ -12,6 +12,7 @@
 
 #include "convexfeld/cxf_basis.h"
 #include "convexfeld/cxf_solver.h"
+#include "convexfeld/cxf_model.h"
 #include "convexfeld/cxf_env.h"
 #include "convexfeld/cxf_types.h"
 #include <stdlib.h>
@@ -21,29 +22,23 @@
 /* Error codes for refactorization */
 #define REFACTOR_OK             0
 #define REFACTOR_OUT_OF_MEMORY  1001
-#define REFACTOR_SINGULAR       3
+
+/* Thread configuration (threading/config.c) */
+extern int cxf_get_threads(CxfEnv *env);
 
 /* Minimum pivot tolerance */
 #define MIN_PIVOT_TOL  1e-10
 
 /**
- * @brief Clear all eta vectors from a BasisState.
+ * @brief Empty the eta file of a BasisState in O(1).
+ *
+ * The packed eta arrays stay allocated for the next update cycle.
  *
  * @param basis BasisState to clear.
  */
-static void clear_eta_list(BasisState *basis) {
+static void clear_eta_file(BasisState *basis) {
     if (basis == NULL) return;
 
-    EtaFactors *eta = basis->eta_head;
-    while (eta != NULL) {
-        EtaFactors *next = eta->next;
-        free(eta->indices);
-        free(eta->values);
-        free(eta);
-        eta = next;
-    }
-
-    basis->eta_head = NULL;
     basis->eta_count = 0;
     basis->pivots_since_refactor = 0;
 }
@@ -63,8 +58,8 @@ int cxf_basis_refactor(BasisState *basis) {
         return CXF_ERROR_NULL_ARGUMENT;
     }
 
-    /* Clear existing eta list */
-    clear_eta_list(basis);
+    /* Empty the eta file */
+    clear_eta_file(basis);
 
     /* Reset diag_coeff to identity.
      * After refactorization, we treat the current basis as the new "initial"
@@ -90,7 +85,7 @@ int cxf_basis_refactor(BasisState *basis) {
  * in the LUFactors structure for use by FTRAN/BTRAN.
  *
  * @param ctx SolverContext containing basis and model.
- * @param env Environment with tolerances.
+ * @param env Environment (thread count for the dense kernel; may be NULL).
  * @return 0 on success, error code on failure.
  */
 int cxf_solver_refactor(SolverContext *ctx, CxfEnv *env) {
@@ -101,8 +96,8 @@ int cxf_solver_refactor(SolverContext *ctx, CxfEnv *env) {
     BasisState *basis = ctx->basis;
     int m = basis->m;
 
-    /* Clear existing eta list */
-    clear_eta_list(basis);
+    /* Empty the eta file */
+    clear_eta_file(basis);
 
     /* Reset refactorization counters */
     ctx->eta_count = 0;
@@ -116,8 +111,6 @@ int cxf_solver_refactor(SolverContext *ctx, CxfEnv *env) {
         return REFACTOR_OK;
     }
 
-    (void)env;  /* Currently unused, will be used for tolerances */
-
     /* Allocate LU factors if not present */
     if (basis->lu == NULL) {
         /* Estimate nnz: typically ~2*m for sparse LP bases */
@@ -130,6 +123,10 @@ int cxf_solver_refactor(SolverContext *ctx, CxfEnv *env) {
         /* Clear existing factorization */
         cxf_lu_clear(basis->lu);
     }
+    basis->lu->rowwise = basis->rowwise_factors;
+    basis->matrix = (ctx->model_ref != NULL) ? ctx->model_ref->matrix : NULL;
+    basis->lu->single = basis->mixed_precision && basis->matrix != NULL;
+    basis->lu->threads = cxf_get_threads(env);
 
     /* Check for identity basis (all slacks at row positions).
      * For pure slack basis, LU is trivial (L=I, U=diag). */
@@ -157,11 +154,19 @@ int cxf_solver_refactor(SolverContext *ctx, CxfEnv *env) {
         lu->U_col_ptr[m] = 0;
         lu->L_nnz = 0;
         lu->U_nnz = 0;
+        lu->rank = m;
+        lu->factor_ops = m;
+        lu->bump_size = 0;
+        lu->dense_size = 0;
+        if (cxf_lu_reset_updates(lu) != CXF_OK) {
+            return REFACTOR_OUT_OF_MEMORY;
+        }
         lu->valid = 1;
         return REFACTOR_OK;
     }
 
-    /* Perform Markowitz LU factorization */
+    /* Perform Markowitz LU factorization; a singular basis is repaired
+     * with slacks and reported in lu->repairs */
     int status = cxf_lu_factorize(basis->lu, ctx);
     if (status != 0) {
         /* Factorization failed - clear LU and fall back to eta-only */
@@ -0,0 +1,411 @@
+/**
+ * @file solve_multi.c
+ * @brief FTRAN/BTRAN for several right-hand sides at once.
+ *
+ * cxf_ftran_multi and cxf_btran_multi apply B^(-1) or B^(-T) to k
+ * vectors in one sweep over L, U, the Forrest-Tomlin row etas and the
+ * PFI eta file. The vectors are interleaved in a scratch block, lane l
+ * of step i at w[i * LANES + l], so every factor entry is loaded once
+ * and applied to all lanes by a fixed-length inner loop the compiler
+ * unrolls and vectorizes. Vectors are processed LANES at a time; a short
+ * last block is padded with zero lanes.
+ *
+ * When the recent results are sparse enough for the hypersparse solves
+ * (see cxf_lu_ftran_hyper), each vector is solved on its own instead:
+ * visiting the reach of one vector beats sweeping all of the factors.
+ */
+
+#include "convexfeld/cxf_basis.h"
+#include "convexfeld/cxf_types.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* One-vector solves (ftran.c, btran.c) */
+extern int cxf_ftran(BasisState *basis, const double *column, double *result);
+
+/* Scratch arena (memory/scratch.c) */
+extern ScratchMark cxf_scratch_mark(const ScratchArena *arena);
+extern void *cxf_scratch_alloc(ScratchArena *arena, size_t size);
+extern void cxf_scratch_release(ScratchArena *arena, ScratchMark mark);
+
+#define LANES CXF_SOLVE_MULTI_LANES
+
+/** Lanes of step i in an interleaved block */
+#define STEP(w, i) ((w) + (ptrdiff_t)(i) * LANES)
+
+/**
+ * @brief Whether any lane of a step is nonzero.
+ */
+static inline int lanes_nonzero(const double *w) {
+    int any = 0;
+    for (int l = 0; l < LANES; l++) {
+        any |= (w[l] != 0.0);
+    }
+    return any;
+}
+
+/**
+ * @brief dst -= v * src on every lane.
+ */
+static inline void lanes_axpy(double *restrict dst, const double *restrict src,
+                              double v) {
+    for (int l = 0; l < LANES; l++) {
+        dst[l] -= v * src[l];
+    }
+}
+
+/**
+ * @brief w /= d on every lane.
+ */
+static inline void lanes_div(double *w, double d) {
+    for (int l = 0; l < LANES; l++) {
+        w[l] /= d;
+    }
+}
+
+/**
+ * @brief Check an eta before it is applied (same checks as ftran.c).
+ */
+static int eta_valid(const BasisState *basis, int e) {
+    int r = basis->eta_row[e];
+    double pivot = basis->eta_pivot[e];
+    return r >= 0 && r < basis->m && pivot != 0.0 && isfinite(pivot);
+}
+
+/**
+ * @brief Fold the density of every lane of a result into a running average.
+ */
+static void track_lanes(double *average, const double *x, int m, int lanes) {
+    for (int l = 0; l < lanes; l++) {
+        int nnz = 0;
+        for (int i = 0; i < m; i++) {
+            nnz += (STEP(x, i)[l] != 0.0);
+        }
+        cxf_lu_track_density(average, nnz, m);
+    }
+}
+
+/**
+ * @brief FTRAN of one block: x = E_t^(-1) ... E_1^(-1) * B_0^(-1) * x.
+ *
+ * @param x Interleaved block indexed by row on entry, by basis position
+ *          on return [m * LANES].
+ * @param w Interleaved workspace [m * LANES].
+ * @param lanes Lanes holding vectors (for density tracking).
+ */
+static int ftran_block(BasisState *basis, double *x, double *w, int lanes) {
+    int m = basis->m;
+    LUFactors *lu = basis->lu;
+
+    if (lu != NULL && lu->valid) {
+        /* w = P * x */
+        for (int k = 0; k < m; k++) {
+            memcpy(STEP(w, k), STEP(x, lu->perm_row[k]), LANES * sizeof(double));
+        }
+
+        /* L * w = w (column-wise scatter) */
+        for (int k = 0; k < m; k++) {
+            const double *wk = STEP(w, k);
+            if (!lanes_nonzero(wk)) continue;
+            for (int64_t p = lu->L_col_ptr[k]; p < lu->L_col_ptr[k + 1]; p++) {
+                lanes_axpy(STEP(w, lu->L_row_idx[p]), wk, lu->L_values[p]);
+            }
+        }
+
+        /* Forrest-Tomlin row etas (oldest to newest) */
+        for (int r = 0; r < lu->R_count; r++) {
+            double *wt = STEP(w, lu->R_pivot[r]);
+            for (int64_t p = lu->R_start[r]; p < lu->R_start[r + 1]; p++) {
+                lanes_axpy(wt, STEP(w, lu->R_idx[p]), lu->R_val[p]);
+            }
+        }
+
+        /* U * w = w (column-wise scatter in reverse pivot order) */
+        for (int pos = m - 1; pos >= 0; pos--) {
+            int k = lu->U_seq[pos];
+            double *wk = STEP(w, k);
+            if (!lanes_nonzero(wk)) continue;
+            lanes_div(wk, lu->U_diag[k]);
+            int64_t end = lu->U_col_ptr[k] + lu->U_col_len[k];
+            for (int64_t p = lu->U_col_ptr[k]; p < end; p++) {
+                lanes_axpy(STEP(w, lu->U_row_idx[p]), wk, lu->U_values[p]);
+            }
+        }
+
+        /* x = Q^T * w */
+        for (int k = 0; k < m; k++) {
+            memcpy(STEP(x, lu->perm_col[k]), STEP(w, k), LANES * sizeof(double));
+        }
+        track_lanes(&lu->ftran_density, x, m, lanes);
+    } else if (basis->diag_coeff != NULL) {
+        for (int i = 0; i < m; i++) {
+            double *xi = STEP(x, i);
+            for (int l = 0; l < LANES; l++) {
+                xi[l] *= basis->diag_coeff[i];
+            }
+        }
+    }
+
+    /* PFI etas (oldest to newest) */
+    for (int e = 0; e < basis->eta_count; e++) {
+        if (!eta_valid(basis, e)) {
+            return CXF_ERROR_INVALID_ARGUMENT;
+        }
+        int r = basis->eta_row[e];
+        double *xr = STEP(x, r);
+        if (!lanes_nonzero(xr)) continue;
+        lanes_div(xr, basis->eta_pivot[e]);
+        for (int64_t p = basis->eta_start[e]; p < basis->eta_start[e + 1]; p++) {
+            int j = basis->eta_idx[p];
+            if (j < 0 || j >= m || j == r) continue;
+            lanes_axpy(STEP(x, j), xr, basis->eta_val[p]);
+        }
+    }
+    return CXF_OK;
+}
+
+/**
+ * @brief U^T and L^T solves of a BTRAN block by rows (scatter, skips
+ *        steps that are zero on every lane).
+ */
+static void btran_block_rows(const LUFactors *lu, int m, double *w) {
+    for (int pos = 0; pos < m; pos++) {
+        int k = lu->U_seq[pos];
+        double *wk = STEP(w, k);
+        if (!lanes_nonzero(wk)) continue;
+        lanes_div(wk, lu->U_diag[k]);
+        int64_t end = lu->Ur_start[k] + lu->Ur_len[k];
+        for (int64_t p = lu->Ur_start[k]; p < end; p++) {
+            lanes_axpy(STEP(w, lu->Ur_idx[p]), wk, lu->Ur_val[p]);
+        }
+    }
+
+    /* Transposed Forrest-Tomlin row etas (newest to oldest) */
+    for (int r = lu->R_count - 1; r >= 0; r--) {
+        const double *wt = STEP(w, lu->R_pivot[r]);
+        if (!lanes_nonzero(wt)) continue;
+        for (int64_t p = lu->R_start[r]; p < lu->R_start[r + 1]; p++) {
+            lanes_axpy(STEP(w, lu->R_idx[p]), wt, lu->R_val[p]);
+        }
+    }
+
+    for (int k = m - 1; k >= 0; k--) {
+        const double *wk = STEP(w, k);
+        if (!lanes_nonzero(wk)) continue;
+        for (int64_t p = lu->Lr_ptr[k]; p < lu->Lr_ptr[k + 1]; p++) {
+            lanes_axpy(STEP(w, lu->Lr_idx[p]), wk, lu->Lr_val[p]);
+        }
+    }
+}
+
+/**
+ * @brief U^T and L^T solves of a BTRAN block by columns (gather).
+ */
+static void btran_block_cols(const LUFactors *lu, int m, double *w) {
+    for (int pos = 0; pos < m; pos++) {
+        int k = lu->U_seq[pos];
+        double *wk = STEP(w, k);
+        int64_t end = lu->U_col_ptr[k] + lu->U_col_len[k];
+        for (int64_t p = lu->U_col_ptr[k]; p < end; p++) {
+            lanes_axpy(wk, STEP(w, lu->U_row_idx[p]), lu->U_values[p]);
+        }
+        lanes_div(wk, lu->U_diag[k]);
+    }
+
+    /* Transposed Forrest-Tomlin row etas (newest to oldest) */
+    for (int r = lu->R_count - 1; r >= 0; r--) {
+        const double *wt = STEP(w, lu->R_pivot[r]);
+        if (!lanes_nonzero(wt)) continue;
+        for (int64_t p = lu->R_start[r]; p < lu->R_start[r + 1]; p++) {
+            lanes_axpy(STEP(w, lu->R_idx[p]), wt, lu->R_val[p]);
+        }
+    }
+
+    for (int k = m - 1; k >= 0; k--) {
+        double *wk = STEP(w, k);
+        for (int64_t p = lu->L_col_ptr[k]; p < lu->L_col_ptr[k + 1]; p++) {
+            lanes_axpy(wk, STEP(w, lu->L_row_idx[p]), lu->L_values[p]);
+        }
+    }
+}
+
+/**
+ * @brief BTRAN of one block: y = B_0^(-T) * E_1^(-T) ... E_t^(-T) * y.
+ *
+ * Sweeps the row-wise factors when the factors carry them.
+ *
+ * @param y Interleaved block indexed by basis position on entry, by row
+ *          on return [m * LANES].
+ * @param w Interleaved workspace [m * LANES].
+ * @param lanes Lanes holding vectors (for density tracking).
+ */
+static int btran_block(BasisState *basis, double *y, double *w, int lanes) {
+    int m = basis->m;
+    LUFactors *lu = basis->lu;
+
+    /* Transposed PFI etas (newest to oldest) */
+    for (int e = basis->eta_count - 1; e >= 0; e--) {
+        if (!eta_valid(basis, e)) {
+            return CXF_ERROR_INVALID_ARGUMENT;
+        }
+        int r = basis->eta_row[e];
+        double *yr = STEP(y, r);
+        for (int64_t p = basis->eta_start[e]; p < basis->eta_start[e + 1]; p++) {
+            int j = basis->eta_idx[p];
+            if (j < 0 || j >= m || j == r) continue;
+            lanes_axpy(yr, STEP(y, j), basis->eta_val[p]);
+        }
+        lanes_div(yr, basis->eta_pivot[e]);
+    }
+
+    if (lu != NULL && lu->valid) {
+        /* w = Q * y */
+        for (int k = 0; k < m; k++) {
+            memcpy(STEP(w, k), STEP(y, lu->perm_col[k]), LANES * sizeof(double));
+        }
+
+        if (lu->rowwise) {
+            btran_block_rows(lu, m, w);
+        } else {
+            btran_block_cols(lu, m, w);
+        }
+
+        /* y = P^T * w */
+        for (int k = 0; k < m; k++) {
+            memcpy(STEP(y, lu->perm_row[k]), STEP(w, k), LANES * sizeof(double));
+        }
+        track_lanes(&lu->btran_density, y, m, lanes);
+    } else if (basis->diag_coeff != NULL) {
+        for (int i = 0; i < m; i++) {
+            double *yi = STEP(y, i);
+            for (int l = 0; l < LANES; l++) {
+                yi[l] *= basis->diag_coeff[i];
+            }
+        }
+    }
+    return CXF_OK;
+}
+
+/**
+ * @brief Whether the vectors should be solved one by one.
+ */
+static int solve_singly(const BasisState *basis, int k, int transposed) {
+    const LUFactors *lu = basis->lu;
+    if (k == 1) {
+        return 1;
+    }
+    if (lu == NULL || !lu->valid) {
+        return 0;
+    }
+    double average = transposed ? lu->btran_density : lu->ftran_density;
+    return average <= lu->hyper_threshold;
+}
+
+/**
+ * @brief Shared driver: interleave each block, solve, de-interleave.
+ */
+static int solve_multi(BasisState *basis, int k, const double *input,
+                       double *result, int transposed) {
+    if (basis == NULL || (k > 0 && (input == NULL || result == NULL))) {
+        return CXF_ERROR_NULL_ARGUMENT;
+    }
+    if (k < 0) {
+        return CXF_ERROR_INVALID_ARGUMENT;
+    }
+
+    int m = basis->m;
+    if (m == 0 || k == 0) {
+        return CXF_OK;
+    }
+
+    if (solve_singly(basis, k, transposed)) {
+        for (int j = 0; j < k; j++) {
+            const double *in = input + (ptrdiff_t)j * m;
+            double *out = result + (ptrdiff_t)j * m;
+            int rc = transposed ? cxf_btran_vec(basis, in, out)
+                                : cxf_ftran(basis, in, out);
+            if (rc != CXF_OK) return rc;
+        }
+        return CXF_OK;
+    }
+
+    size_t bytes = (size_t)m * LANES * sizeof(double);
+    ScratchMark mark = {NULL, 0};
+    double *x;
+    double *w;
+    if (basis->scratch != NULL) {
+        mark = cxf_scratch_mark(basis->scratch);
+        x = (double *)cxf_scratch_alloc(basis->scratch, bytes);
+        w = (double *)cxf_scratch_alloc(basis->scratch, bytes);
+    } else {
+        x = (double *)malloc(bytes);
+        w = (double *)malloc(bytes);
+    }
+
+    int rc = CXF_OK;
+    if (x == NULL || w == NULL) {
+        rc = CXF_ERROR_OUT_OF_MEMORY;
+    }
+
+    for (int first = 0; rc == CXF_OK && first < k; first += LANES) {
+        int lanes = (k - first < LANES) ? k - first : LANES;
+        const double *in = input + (ptrdiff_t)first * m;
+        double *out = result + (ptrdiff_t)first * m;
+
+        for (int i = 0; i < m; i++) {
+            double *xi = STEP(x, i);
+            for (int l = 0; l < lanes; l++) {
+                xi[l] = in[(ptrdiff_t)l * m + i];
+            }
+            for (int l = lanes; l < LANES; l++) {
+                xi[l] = 0.0;
+            }
+        }
+
+        rc = transposed ? btran_block(basis, x, w, lanes)
+                        : ftran_block(basis, x, w, lanes);
+
+        for (int i = 0; i < m; i++) {
+            const double *xi = STEP(x, i);
+            for (int l = 0; l < lanes; l++) {
+                out[(ptrdiff_t)l * m + i] = xi[l];
+            }
+        }
+    }
+
+    if (basis->scratch != NULL) {
+        cxf_scratch_release(basis->scratch, mark);
+    } else {
+        free(x);
+        free(w);
+    }
+    return rc;
+}
+
+/**
+ * @brief Forward transformation of k vectors: X = B^(-1) * A.
+ *
+ * @param basis BasisState containing the factorization.
+ * @param k Number of vectors.
+ * @param columns Input vectors, vector j at columns[j * m] [k * m].
+ * @param result Output vectors in the same layout [k * m]; may alias columns.
+ * @return CXF_OK on success, error code on failure.
+ */
+int cxf_ftran_multi(BasisState *basis, int k, const double *columns, double *result) {
+    return solve_multi(basis, k, columns, result, 0);
+}
+
+/**
+ * @brief Backward transformation of k vectors: Y = B^(-T) * C.
+ *
+ * @param basis BasisState containing the factorization.
+ * @param k Number of vectors.
+ * @param input Input vectors, vector j at input[j * m] [k * m].
+ * @param result Output vectors in the same layout [k * m]; may alias input.
+ * @return CXF_OK on success, error code on failure.
+ */
+int cxf_btran_multi(BasisState *basis, int k, const double *input, double *result) {
+    return solve_multi(basis, k, input, result, 1);
+}
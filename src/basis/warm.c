@@ -34,22 +34,13 @@
 #define CXF_CHECK_ALL         0xFF
 
 /*******************************************************************************
- * Internal helper: clear eta list
+ * Internal helper: clear eta file
  ******************************************************************************/
 
 /**
- * @brief Free all eta factors in the linked list.
+ * @brief Empty the eta file; its packed arrays are kept for reuse.
  */
-static void clear_eta_list(BasisState *basis) {
-    EtaFactors *eta = basis->eta_head;
-    while (eta != NULL) {
-        EtaFactors *next = eta->next;
-        free(eta->indices);
-        free(eta->values);
-        free(eta);
-        eta = next;
-    }
-    basis->eta_head = NULL;
+static void clear_eta_file(BasisState *basis) {
     basis->eta_count = 0;
     basis->pivots_since_refactor = 0;
 }
@@ -189,7 +180,7 @@ int cxf_basis_validate_ex(BasisState *basis, int flags) {
 /**
  * @brief Warm start from saved basic variable indices.
  *
- * Copies the basic variable indices and clears the eta list,
+ * Copies the basic variable indices and clears the eta file,
  * preparing for a fresh factorization.
  *
  * @param basis BasisState to initialize.
@@ -208,8 +199,8 @@ int cxf_basis_warm(BasisState *basis, const int *basic_vars, int m) {
     /* Copy basic variables */
     memcpy(basis->basic_vars, basic_vars, (size_t)m * sizeof(int));
 
-    /* Clear eta list (refactorization will be needed) */
-    clear_eta_list(basis);
+    /* Clear eta file (refactorization will be needed) */
+    clear_eta_file(basis);
 
     return CXF_OK;
 }
@@ -251,8 +242,8 @@ int cxf_basis_warm_snapshot(BasisState *basis, const BasisSnapshot *snapshot) {
                (size_t)basis->n * sizeof(int));
     }
 
-    /* Clear eta list (refactorization will be needed) */
-    clear_eta_list(basis);
+    /* Clear eta file (refactorization will be needed) */
+    clear_eta_file(basis);
 
     return CXF_OK;
 }
@@ -0,0 +1,241 @@
+/**
+ * @file avx2.c
+ * @brief AVX2 pricing and ratio-test kernels (4 doubles per vector).
+ *
+ * Compiled with -mavx2 and called only on CPUs that support it (see
+ * dispatch.c). Each lane keeps its own best entry with the tie rule of
+ * the scalar kernels; the lanes are reduced at the end and the remainder
+ * goes through the scalar tail, so the results equal those of scalar.c.
+ *
+ * The status of a variable is widened from int32 to one 64-bit mask lane
+ * per double, so the attractiveness test of four variables is three
+ * compares and no branch.
+ */
+
+#include <immintrin.h>
+#include <stddef.h>
+#include <math.h>
+#include "convexfeld/cxf_kernels.h"
+
+#define LANES 4
+
+/* Minimum acceptable weight (as in cxf_pricing_steepest) */
+#define MIN_WEIGHT 1e-10
+
+extern int cxf_kernel_price_tail(const double *dj, const double *weights,
+                                 const int *status, int from, int n, double tol,
+                                 int best, double *best_score, int *nonbasic);
+extern int cxf_kernel_ratio_min_tail(const CxfRatioScan *scan, int from,
+                                     double pivot_tol, double feas_tol,
+                                     int min_row, double *min_ratio);
+extern int cxf_kernel_ratio_pivot_tail(const CxfRatioScan *scan, int from,
+                                       double pivot_tol, double threshold,
+                                       int best_row, double *best_mag);
+
+/**
+ * @brief Pricing scan, see CxfPriceKernel.
+ */
+int cxf_kernel_price_avx2(const double *dj, const double *weights,
+                          const int *status, int n, double tol,
+                          int *scanned) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d vtol = _mm256_set1_pd(tol);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d min_weight = _mm256_set1_pd(MIN_WEIGHT);
+    const __m256i at_lower = _mm256_set1_epi64x(-1);
+    const __m256i at_upper = _mm256_set1_epi64x(-2);
+    const __m256i is_free = _mm256_set1_epi64x(-3);
+    const __m256i step = _mm256_set1_epi64x(LANES);
+
+    __m256d best = _mm256_setzero_pd();
+    __m256i best_idx = _mm256_set1_epi64x(-1);
+    __m256i idx = _mm256_setr_epi64x(0, 1, 2, 3);
+    int nonbasic = 0;
+
+    int j = 0;
+    for (; j + LANES <= n; j += LANES) {
+        __m128i st32 = _mm_loadu_si128((const __m128i *)(status + j));
+        nonbasic += __builtin_popcount((unsigned)_mm_movemask_ps(_mm_castsi128_ps(st32)));
+        __m256i st = _mm256_cvtepi32_epi64(st32);
+
+        __m256d d = _mm256_loadu_pd(dj + j);
+        __m256d lower = _mm256_castsi256_pd(_mm256_cmpeq_epi64(st, at_lower));
+        __m256d upper = _mm256_castsi256_pd(_mm256_cmpeq_epi64(st, at_upper));
+        __m256d free_ = _mm256_castsi256_pd(_mm256_cmpeq_epi64(st, is_free));
+
+        /* Improvement per unit: -d at lower, d at upper, |d| if free */
+        __m256d score = _mm256_and_pd(upper, d);
+        score = _mm256_or_pd(score, _mm256_and_pd(lower, _mm256_xor_pd(d, sign)));
+        score = _mm256_or_pd(score, _mm256_and_pd(free_, _mm256_andnot_pd(sign, d)));
+        __m256d ok = _mm256_and_pd(_mm256_or_pd(_mm256_or_pd(lower, upper), free_),
+                                   _mm256_cmp_pd(score, vtol, _CMP_GT_OQ));
+        if (_mm256_movemask_pd(ok) != 0) {
+            if (weights != NULL) {
+                __m256d w = _mm256_loadu_pd(weights + j);
+                w = _mm256_blendv_pd(w, one, _mm256_cmp_pd(w, min_weight, _CMP_LT_OQ));
+                score = _mm256_div_pd(score, _mm256_sqrt_pd(w));
+            }
+            __m256d take = _mm256_and_pd(ok, _mm256_cmp_pd(score, best, _CMP_GT_OQ));
+            best = _mm256_blendv_pd(best, score, take);
+            best_idx = _mm256_castpd_si256(_mm256_blendv_pd(_mm256_castsi256_pd(best_idx),
+                                                            _mm256_castsi256_pd(idx), take));
+        }
+        idx = _mm256_add_epi64(idx, step);
+    }
+
+    /* Lanes: largest score, ties to the smaller index */
+    double lane_best[LANES];
+    long long lane_idx[LANES];
+    _mm256_storeu_pd(lane_best, best);
+    _mm256_storeu_si256((__m256i *)lane_idx, best_idx);
+    int best_var = -1;
+    double best_score = 0.0;
+    for (int l = 0; l < LANES; l++) {
+        if (lane_idx[l] < 0) continue;
+        if (lane_best[l] > best_score ||
+            (lane_best[l] == best_score && (int)lane_idx[l] < best_var)) {
+            best_score = lane_best[l];
+            best_var = (int)lane_idx[l];
+        }
+    }
+
+    best_var = cxf_kernel_price_tail(dj, weights, status, j, n, tol,
+                                     best_var, &best_score, &nonbasic);
+    if (scanned != NULL) {
+        *scanned = nonbasic;
+    }
+    return best_var;
+}
+
+/**
+ * @brief Rows k..k+3 of a ratio test: the row indices, |alpha_i| and the
+ *        ratios, with the mask of the rows that can block.
+ */
+static __m256d ratio_lanes(const CxfRatioScan *scan, int k, double pivot_tol,
+                           __m256i *rows_out, __m256d *mag_out, __m256d *ratio_out) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256d zero = _mm256_setzero_pd();
+
+    __m128i rows;
+    __m256d a;
+    __m128i var;
+    if (scan->rows != NULL) {
+        rows = _mm_loadu_si128((const __m128i *)(scan->rows + k));
+        a = _mm256_i32gather_pd(scan->alpha, rows, 8);
+        var = _mm_i32gather_epi32(scan->basic_vars, rows, 4);
+    } else {
+        rows = _mm_add_epi32(_mm_set1_epi32(k), _mm_setr_epi32(0, 1, 2, 3));
+        a = _mm256_loadu_pd(scan->alpha + k);
+        var = _mm_loadu_si128((const __m128i *)(scan->basic_vars + k));
+    }
+    __m256d mag = _mm256_andnot_pd(sign, a);
+
+    __m128i valid32 = _mm_and_si128(_mm_cmpgt_epi32(var, _mm_set1_epi32(-1)),
+                                    _mm_cmplt_epi32(var, _mm_set1_epi32(scan->total_vars)));
+    __m256d valid = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(valid32));
+    __m256d live = _mm256_and_pd(valid, _mm256_cmp_pd(mag, _mm256_set1_pd(pivot_tol),
+                                                      _CMP_GT_OQ));
+    __m256d pos = _mm256_cmp_pd(a, zero, _CMP_GT_OQ);
+
+    /* Only rows that can block are gathered, so invalid variables are
+     * never read */
+    __m256d x = _mm256_mask_i32gather_pd(zero, scan->x, var, live, 8);
+    __m256d lb = _mm256_mask_i32gather_pd(zero, scan->lb, var, _mm256_and_pd(live, pos), 8);
+    __m256d ub = _mm256_mask_i32gather_pd(zero, scan->ub, var, _mm256_andnot_pd(pos, live), 8);
+
+    __m256d inf = _mm256_set1_pd(scan->infinity);
+    __m256d lb_finite = _mm256_cmp_pd(lb, _mm256_xor_pd(inf, sign), _CMP_NLE_UQ);
+    __m256d ub_finite = _mm256_cmp_pd(ub, inf, _CMP_NGE_UQ);
+    __m256d finite = _mm256_blendv_pd(ub_finite, lb_finite, pos);
+    __m256d bound = _mm256_blendv_pd(ub, lb, pos);
+
+    *rows_out = _mm256_cvtepi32_epi64(rows);
+    *mag_out = mag;
+    *ratio_out = _mm256_div_pd(_mm256_sub_pd(x, bound), a);
+    return _mm256_and_pd(live, finite);
+}
+
+/**
+ * @brief First Harris pass, see CxfRatioMinKernel.
+ */
+int cxf_kernel_ratio_min_avx2(const CxfRatioScan *scan, double pivot_tol,
+                              double feas_tol, double *min_ratio) {
+    const __m256d least = _mm256_set1_pd(-feas_tol);
+    __m256d best = _mm256_set1_pd(scan->infinity);
+    __m256i best_row = _mm256_set1_epi64x(-1);
+
+    int k = 0;
+    for (; k + LANES <= scan->count; k += LANES) {
+        __m256i rows;
+        __m256d mag, ratio;
+        __m256d ok = ratio_lanes(scan, k, pivot_tol, &rows, &mag, &ratio);
+        ok = _mm256_and_pd(ok, _mm256_cmp_pd(ratio, least, _CMP_GE_OQ));
+        __m256d less = _mm256_cmp_pd(ratio, best, _CMP_LT_OQ);
+        __m256d tie = _mm256_and_pd(_mm256_cmp_pd(ratio, best, _CMP_EQ_OQ),
+                                    _mm256_castsi256_pd(_mm256_cmpgt_epi64(best_row, rows)));
+        __m256d take = _mm256_and_pd(ok, _mm256_or_pd(less, tie));
+        best = _mm256_blendv_pd(best, ratio, take);
+        best_row = _mm256_castpd_si256(_mm256_blendv_pd(_mm256_castsi256_pd(best_row),
+                                                        _mm256_castsi256_pd(rows), take));
+    }
+
+    double lane_best[LANES];
+    long long lane_row[LANES];
+    _mm256_storeu_pd(lane_best, best);
+    _mm256_storeu_si256((__m256i *)lane_row, best_row);
+    int row = -1;
+    double ratio = scan->infinity;
+    for (int l = 0; l < LANES; l++) {
+        if (lane_row[l] < 0) continue;
+        if (row < 0 || lane_best[l] < ratio ||
+            (lane_best[l] == ratio && (int)lane_row[l] < row)) {
+            ratio = lane_best[l];
+            row = (int)lane_row[l];
+        }
+    }
+
+    *min_ratio = ratio;
+    return cxf_kernel_ratio_min_tail(scan, k, pivot_tol, feas_tol, row, min_ratio);
+}
+
+/**
+ * @brief Second Harris pass, see CxfRatioPivotKernel.
+ */
+int cxf_kernel_ratio_pivot_avx2(const CxfRatioScan *scan, double pivot_tol,
+                                double threshold, int min_row) {
+    const __m256d limit = _mm256_set1_pd(threshold);
+    __m256d best = _mm256_set1_pd(-1.0);
+    __m256i best_row = _mm256_set1_epi64x(-1);
+
+    int k = 0;
+    for (; k + LANES <= scan->count; k += LANES) {
+        __m256i rows;
+        __m256d mag, ratio;
+        __m256d ok = ratio_lanes(scan, k, pivot_tol, &rows, &mag, &ratio);
+        ok = _mm256_and_pd(ok, _mm256_cmp_pd(ratio, limit, _CMP_NGT_UQ));
+        __m256d more = _mm256_cmp_pd(mag, best, _CMP_GT_OQ);
+        __m256d tie = _mm256_and_pd(_mm256_cmp_pd(mag, best, _CMP_EQ_OQ),
+                                    _mm256_castsi256_pd(_mm256_cmpgt_epi64(best_row, rows)));
+        __m256d take = _mm256_and_pd(ok, _mm256_or_pd(more, tie));
+        best = _mm256_blendv_pd(best, mag, take);
+        best_row = _mm256_castpd_si256(_mm256_blendv_pd(_mm256_castsi256_pd(best_row),
+                                                        _mm256_castsi256_pd(rows), take));
+    }
+
+    double lane_best[LANES];
+    long long lane_row[LANES];
+    _mm256_storeu_pd(lane_best, best);
+    _mm256_storeu_si256((__m256i *)lane_row, best_row);
+    int row = -1;
+    double mag = -1.0;
+    for (int l = 0; l < LANES; l++) {
+        if (lane_row[l] < 0) continue;
+        if (lane_best[l] > mag || (lane_best[l] == mag && (int)lane_row[l] < row)) {
+            mag = lane_best[l];
+            row = (int)lane_row[l];
+        }
+    }
+
+    row = cxf_kernel_ratio_pivot_tail(scan, k, pivot_tol, threshold, row, &mag);
+    return (mag > fabs(scan->alpha[min_row])) ? row : min_row;
+}
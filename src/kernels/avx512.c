@@ -0,0 +1,232 @@
+/**
+ * @file avx512.c
+ * @brief AVX-512 pricing and ratio-test kernels (8 doubles per vector).
+ *
+ * Compiled with -mavx512f and called only on CPUs that support it (see
+ * dispatch.c). Same scheme as avx2.c, with the lane masks held in mask
+ * registers: each lane keeps its own best entry, the lanes are reduced at
+ * the end and the remainder goes through the scalar tail.
+ */
+
+#include <immintrin.h>
+#include <stddef.h>
+#include <math.h>
+#include "convexfeld/cxf_kernels.h"
+
+#define LANES 8
+
+/* Minimum acceptable weight (as in cxf_pricing_steepest) */
+#define MIN_WEIGHT 1e-10
+
+extern int cxf_kernel_price_tail(const double *dj, const double *weights,
+                                 const int *status, int from, int n, double tol,
+                                 int best, double *best_score, int *nonbasic);
+extern int cxf_kernel_ratio_min_tail(const CxfRatioScan *scan, int from,
+                                     double pivot_tol, double feas_tol,
+                                     int min_row, double *min_ratio);
+extern int cxf_kernel_ratio_pivot_tail(const CxfRatioScan *scan, int from,
+                                       double pivot_tol, double threshold,
+                                       int best_row, double *best_mag);
+
+/**
+ * @brief Pricing scan, see CxfPriceKernel.
+ */
+int cxf_kernel_price_avx512(const double *dj, const double *weights,
+                            const int *status, int n, double tol,
+                            int *scanned) {
+    const __m512i sign = _mm512_set1_epi64((long long)0x8000000000000000ULL);
+    const __m512d vtol = _mm512_set1_pd(tol);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d min_weight = _mm512_set1_pd(MIN_WEIGHT);
+    const __m512i at_lower = _mm512_set1_epi64(-1);
+    const __m512i at_upper = _mm512_set1_epi64(-2);
+    const __m512i is_free = _mm512_set1_epi64(-3);
+    const __m512i step = _mm512_set1_epi64(LANES);
+
+    __m512d best = _mm512_setzero_pd();
+    __m512i best_idx = _mm512_set1_epi64(-1);
+    __m512i idx = _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7);
+    int nonbasic = 0;
+
+    int j = 0;
+    for (; j + LANES <= n; j += LANES) {
+        __m256i st32 = _mm256_loadu_si256((const __m256i *)(status + j));
+        nonbasic += __builtin_popcount((unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(st32)));
+        __m512i st = _mm512_cvtepi32_epi64(st32);
+
+        __m512d d = _mm512_loadu_pd(dj + j);
+        __mmask8 lower = _mm512_cmpeq_epi64_mask(st, at_lower);
+        __mmask8 upper = _mm512_cmpeq_epi64_mask(st, at_upper);
+        __mmask8 free_ = _mm512_cmpeq_epi64_mask(st, is_free);
+
+        /* Improvement per unit: -d at lower, d at upper, |d| if free */
+        __m512d neg = _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(d), sign));
+        __m512d score = _mm512_maskz_mov_pd(upper, d);
+        score = _mm512_mask_mov_pd(score, lower, neg);
+        score = _mm512_mask_mov_pd(score, free_, _mm512_abs_pd(d));
+        __mmask8 ok = (__mmask8)((lower | upper | free_) &
+                                 _mm512_cmp_pd_mask(score, vtol, _CMP_GT_OQ));
+        if (ok != 0) {
+            if (weights != NULL) {
+                __m512d w = _mm512_loadu_pd(weights + j);
+                w = _mm512_mask_mov_pd(w, _mm512_cmp_pd_mask(w, min_weight, _CMP_LT_OQ), one);
+                score = _mm512_div_pd(score, _mm512_sqrt_pd(w));
+            }
+            __mmask8 take = _mm512_mask_cmp_pd_mask(ok, score, best, _CMP_GT_OQ);
+            best = _mm512_mask_mov_pd(best, take, score);
+            best_idx = _mm512_mask_mov_epi64(best_idx, take, idx);
+        }
+        idx = _mm512_add_epi64(idx, step);
+    }
+
+    /* Lanes: largest score, ties to the smaller index */
+    double lane_best[LANES];
+    long long lane_idx[LANES];
+    _mm512_storeu_pd(lane_best, best);
+    _mm512_storeu_si512(lane_idx, best_idx);
+    int best_var = -1;
+    double best_score = 0.0;
+    for (int l = 0; l < LANES; l++) {
+        if (lane_idx[l] < 0) continue;
+        if (lane_best[l] > best_score ||
+            (lane_best[l] == best_score && (int)lane_idx[l] < best_var)) {
+            best_score = lane_best[l];
+            best_var = (int)lane_idx[l];
+        }
+    }
+
+    best_var = cxf_kernel_price_tail(dj, weights, status, j, n, tol,
+                                     best_var, &best_score, &nonbasic);
+    if (scanned != NULL) {
+        *scanned = nonbasic;
+    }
+    return best_var;
+}
+
+/**
+ * @brief Rows k..k+7 of a ratio test: the row indices, |alpha_i| and the
+ *        ratios, with the mask of the rows that can block.
+ */
+static __mmask8 ratio_lanes(const CxfRatioScan *scan, int k, double pivot_tol,
+                            __m512i *rows_out, __m512d *mag_out, __m512d *ratio_out) {
+    const __m512d zero = _mm512_setzero_pd();
+
+    __m256i rows;
+    __m512d a;
+    __m256i var;
+    if (scan->rows != NULL) {
+        rows = _mm256_loadu_si256((const __m256i *)(scan->rows + k));
+        a = _mm512_i32gather_pd(rows, scan->alpha, 8);
+        var = _mm256_i32gather_epi32(scan->basic_vars, rows, 4);
+    } else {
+        rows = _mm256_add_epi32(_mm256_set1_epi32(k), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        a = _mm512_loadu_pd(scan->alpha + k);
+        var = _mm256_loadu_si256((const __m256i *)(scan->basic_vars + k));
+    }
+    __m512d mag = _mm512_abs_pd(a);
+
+    __m512i var64 = _mm512_cvtepi32_epi64(var);
+    __mmask8 valid = (__mmask8)(_mm512_cmpge_epi64_mask(var64, _mm512_setzero_si512()) &
+                                _mm512_cmplt_epi64_mask(var64, _mm512_set1_epi64(scan->total_vars)));
+    __mmask8 live = _mm512_mask_cmp_pd_mask(valid, mag, _mm512_set1_pd(pivot_tol), _CMP_GT_OQ);
+    __mmask8 pos = _mm512_cmp_pd_mask(a, zero, _CMP_GT_OQ);
+
+    /* Only rows that can block are gathered, so invalid variables are
+     * never read */
+    __m512d x = _mm512_mask_i32gather_pd(zero, live, var, scan->x, 8);
+    __m512d lb = _mm512_mask_i32gather_pd(zero, (__mmask8)(live & pos), var, scan->lb, 8);
+    __m512d ub = _mm512_mask_i32gather_pd(zero, (__mmask8)(live & ~pos), var, scan->ub, 8);
+
+    __mmask8 lb_finite = _mm512_cmp_pd_mask(lb, _mm512_set1_pd(-scan->infinity), _CMP_NLE_UQ);
+    __mmask8 ub_finite = _mm512_cmp_pd_mask(ub, _mm512_set1_pd(scan->infinity), _CMP_NGE_UQ);
+    __mmask8 finite = (__mmask8)((pos & lb_finite) | (~pos & ub_finite));
+    __m512d bound = _mm512_mask_mov_pd(ub, pos, lb);
+
+    *rows_out = _mm512_cvtepi32_epi64(rows);
+    *mag_out = mag;
+    *ratio_out = _mm512_div_pd(_mm512_sub_pd(x, bound), a);
+    return (__mmask8)(live & finite);
+}
+
+/**
+ * @brief First Harris pass, see CxfRatioMinKernel.
+ */
+int cxf_kernel_ratio_min_avx512(const CxfRatioScan *scan, double pivot_tol,
+                                double feas_tol, double *min_ratio) {
+    const __m512d least = _mm512_set1_pd(-feas_tol);
+    __m512d best = _mm512_set1_pd(scan->infinity);
+    __m512i best_row = _mm512_set1_epi64(-1);
+
+    int k = 0;
+    for (; k + LANES <= scan->count; k += LANES) {
+        __m512i rows;
+        __m512d mag, ratio;
+        __mmask8 ok = ratio_lanes(scan, k, pivot_tol, &rows, &mag, &ratio);
+        ok = _mm512_mask_cmp_pd_mask(ok, ratio, least, _CMP_GE_OQ);
+        __mmask8 less = _mm512_cmp_pd_mask(ratio, best, _CMP_LT_OQ);
+        __mmask8 tie = (__mmask8)(_mm512_cmp_pd_mask(ratio, best, _CMP_EQ_OQ) &
+                                  _mm512_cmpgt_epi64_mask(best_row, rows));
+        __mmask8 take = (__mmask8)(ok & (less | tie));
+        best = _mm512_mask_mov_pd(best, take, ratio);
+        best_row = _mm512_mask_mov_epi64(best_row, take, rows);
+    }
+
+    double lane_best[LANES];
+    long long lane_row[LANES];
+    _mm512_storeu_pd(lane_best, best);
+    _mm512_storeu_si512(lane_row, best_row);
+    int row = -1;
+    double ratio = scan->infinity;
+    for (int l = 0; l < LANES; l++) {
+        if (lane_row[l] < 0) continue;
+        if (row < 0 || lane_best[l] < ratio ||
+            (lane_best[l] == ratio && (int)lane_row[l] < row)) {
+            ratio = lane_best[l];
+            row = (int)lane_row[l];
+        }
+    }
+
+    *min_ratio = ratio;
+    return cxf_kernel_ratio_min_tail(scan, k, pivot_tol, feas_tol, row, min_ratio);
+}
+
+/**
+ * @brief Second Harris pass, see CxfRatioPivotKernel.
+ */
+int cxf_kernel_ratio_pivot_avx512(const CxfRatioScan *scan, double pivot_tol,
+                                  double threshold, int min_row) {
+    const __m512d limit = _mm512_set1_pd(threshold);
+    __m512d best = _mm512_set1_pd(-1.0);
+    __m512i best_row = _mm512_set1_epi64(-1);
+
+    int k = 0;
+    for (; k + LANES <= scan->count; k += LANES) {
+        __m512i rows;
+        __m512d mag, ratio;
+        __mmask8 ok = ratio_lanes(scan, k, pivot_tol, &rows, &mag, &ratio);
+        ok = _mm512_mask_cmp_pd_mask(ok, ratio, limit, _CMP_NGT_UQ);
+        __mmask8 more = _mm512_cmp_pd_mask(mag, best, _CMP_GT_OQ);
+        __mmask8 tie = (__mmask8)(_mm512_cmp_pd_mask(mag, best, _CMP_EQ_OQ) &
+                                  _mm512_cmpgt_epi64_mask(best_row, rows));
+        __mmask8 take = (__mmask8)(ok & (more | tie));
+        best = _mm512_mask_mov_pd(best, take, mag);
+        best_row = _mm512_mask_mov_epi64(best_row, take, rows);
+    }
+
+    double lane_best[LANES];
+    long long lane_row[LANES];
+    _mm512_storeu_pd(lane_best, best);
+    _mm512_storeu_si512(lane_row, best_row);
+    int row = -1;
+    double mag = -1.0;
+    for (int l = 0; l < LANES; l++) {
+        if (lane_row[l] < 0) continue;
+        if (lane_best[l] > mag || (lane_best[l] == mag && (int)lane_row[l] < row)) {
+            mag = lane_best[l];
+            row = (int)lane_row[l];
+        }
+    }
+
+    row = cxf_kernel_ratio_pivot_tail(scan, k, pivot_tol, threshold, row, &mag);
+    return (mag > fabs(scan->alpha[min_row])) ? row : min_row;
+}
@@ -0,0 +1,161 @@
+/**
+ * @file dispatch.c
+ * @brief Choice of the pricing and ratio-test kernels.
+ *
+ * The vector kernels are compiled only when the compiler accepts the
+ * instruction set flags (CXF_HAVE_AVX2, CXF_HAVE_AVX512, see
+ * CMakeLists.txt). At run time the first call to cxf_kernels asks the CPU
+ * (cpuid, through the compiler builtin that also checks the OS saves the
+ * wide registers) for the widest supported level.
+ *
+ * The pool workers call cxf_kernels concurrently, so the first choice goes
+ * through pthread_once. cxf_kernel_select is meant for setup code and must
+ * not run while a solve is in progress.
+ */
+
+#include <stddef.h>
+#ifdef CXF_HAVE_PTHREADS
+#include <pthread.h>
+#endif
+#include "convexfeld/cxf_kernels.h"
+
+extern int cxf_kernel_price_scalar(const double *dj, const double *weights,
+                                   const int *status, int n, double tol,
+                                   int *scanned);
+extern int cxf_kernel_ratio_min_scalar(const CxfRatioScan *scan, double pivot_tol,
+                                       double feas_tol, double *min_ratio);
+extern int cxf_kernel_ratio_pivot_scalar(const CxfRatioScan *scan, double pivot_tol,
+                                         double threshold, int min_row);
+
+#ifdef CXF_HAVE_AVX2
+extern int cxf_kernel_price_avx2(const double *dj, const double *weights,
+                                 const int *status, int n, double tol,
+                                 int *scanned);
+extern int cxf_kernel_ratio_min_avx2(const CxfRatioScan *scan, double pivot_tol,
+                                     double feas_tol, double *min_ratio);
+extern int cxf_kernel_ratio_pivot_avx2(const CxfRatioScan *scan, double pivot_tol,
+                                       double threshold, int min_row);
+#endif
+
+#ifdef CXF_HAVE_AVX512
+extern int cxf_kernel_price_avx512(const double *dj, const double *weights,
+                                   const int *status, int n, double tol,
+                                   int *scanned);
+extern int cxf_kernel_ratio_min_avx512(const CxfRatioScan *scan, double pivot_tol,
+                                       double feas_tol, double *min_ratio);
+extern int cxf_kernel_ratio_pivot_avx512(const CxfRatioScan *scan, double pivot_tol,
+                                         double threshold, int min_row);
+#endif
+
+static const CxfKernels kernel_table[] = {
+    {CXF_KERNEL_SCALAR, cxf_kernel_price_scalar,
+     cxf_kernel_ratio_min_scalar, cxf_kernel_ratio_pivot_scalar},
+#ifdef CXF_HAVE_AVX2
+    {CXF_KERNEL_AVX2, cxf_kernel_price_avx2,
+     cxf_kernel_ratio_min_avx2, cxf_kernel_ratio_pivot_avx2},
+#endif
+#ifdef CXF_HAVE_AVX512
+    {CXF_KERNEL_AVX512, cxf_kernel_price_avx512,
+     cxf_kernel_ratio_min_avx512, cxf_kernel_ratio_pivot_avx512},
+#endif
+};
+
+#define NUM_KERNELS ((int)(sizeof(kernel_table) / sizeof(kernel_table[0])))
+
+/* Kernels in use; NULL until choose_default_kernels has run */
+static const CxfKernels *active_kernels = NULL;
+
+#ifdef CXF_HAVE_PTHREADS
+static pthread_once_t default_once = PTHREAD_ONCE_INIT;
+#else
+/* Without pthreads the pool runs its tasks on the calling thread */
+static int default_done = 0;
+#endif
+
+/**
+ * @brief Widest kernel level the build and the CPU support.
+ *
+ * @return CXF_KERNEL_SCALAR, CXF_KERNEL_AVX2 or CXF_KERNEL_AVX512
+ */
+int cxf_kernel_level(void) {
+    int level = CXF_KERNEL_SCALAR;
+#if defined(CXF_HAVE_AVX2) || defined(CXF_HAVE_AVX512)
+    __builtin_cpu_init();
+#endif
+#ifdef CXF_HAVE_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        level = CXF_KERNEL_AVX2;
+    }
+#endif
+#ifdef CXF_HAVE_AVX512
+    if (__builtin_cpu_supports("avx512f")) {
+        level = CXF_KERNEL_AVX512;
+    }
+#endif
+    return level;
+}
+
+/**
+ * @brief Table entry for a level, capped at cxf_kernel_level.
+ *
+ * @param level CXF_KERNEL_*
+ * @return Kernel table (never NULL)
+ */
+static const CxfKernels *find_kernels(int level) {
+    int supported = cxf_kernel_level();
+    if (level > supported) {
+        level = supported;
+    }
+    /* A level left out of the build falls back to the next narrower one */
+    const CxfKernels *chosen = &kernel_table[0];
+    for (int k = 0; k < NUM_KERNELS; k++) {
+        if (kernel_table[k].level <= level) {
+            chosen = &kernel_table[k];
+        }
+    }
+    return chosen;
+}
+
+static void choose_default_kernels(void) {
+    active_kernels = find_kernels(CXF_KERNEL_AVX512);
+}
+
+/**
+ * @brief Run choose_default_kernels exactly once.
+ */
+static void ensure_default_kernels(void) {
+#ifdef CXF_HAVE_PTHREADS
+    pthread_once(&default_once, choose_default_kernels);
+#else
+    if (!default_done) {
+        choose_default_kernels();
+        default_done = 1;
+    }
+#endif
+}
+
+/**
+ * @brief Use the kernels of a given level, capped at cxf_kernel_level.
+ *
+ * Not thread-safe: call it before a solve, not from a callback or a
+ * pool worker.
+ *
+ * @param level CXF_KERNEL_*
+ * @return The level now in use
+ */
+int cxf_kernel_select(int level) {
+    /* Run the default choice first so a later cxf_kernels cannot undo this */
+    ensure_default_kernels();
+    active_kernels = find_kernels(level);
+    return active_kernels->level;
+}
+
+/**
+ * @brief The kernels in use.
+ *
+ * @return Kernel table (never NULL)
+ */
+const CxfKernels *cxf_kernels(void) {
+    ensure_default_kernels();
+    return active_kernels;
+}
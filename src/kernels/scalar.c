@@ -0,0 +1,175 @@
+/**
+ * @file scalar.c
+ * @brief Portable pricing and ratio-test kernels.
+ *
+ * The reference for the vector kernels (avx2.c, avx512.c), which must
+ * return the same results. Also used for the remainder of a vector scan
+ * and on CPUs without AVX2.
+ */
+
+#include <stddef.h>
+#include <math.h>
+#include "convexfeld/cxf_kernels.h"
+
+/* Variable status codes */
+#define VAR_AT_LOWER    -1
+#define VAR_AT_UPPER    -2
+#define VAR_FREE        -3
+
+/* Minimum acceptable weight (as in cxf_pricing_steepest) */
+#define MIN_WEIGHT 1e-10
+
+/**
+ * @brief Pricing scan over [from, n), starting from the best so far.
+ *
+ * @param best Best variable so far, or -1
+ * @param best_score Its score (in/out, 0 for none)
+ * @param nonbasic Nonbasic variables counted (in/out)
+ * @return Best variable
+ */
+int cxf_kernel_price_tail(const double *dj, const double *weights,
+                          const int *status, int from, int n, double tol,
+                          int best, double *best_score, int *nonbasic) {
+    for (int j = from; j < n; j++) {
+        int st = status[j];
+        if (st >= 0) {
+            continue;
+        }
+        (*nonbasic)++;
+
+        double d = dj[j];
+        double score;
+        if (st == VAR_AT_LOWER) {
+            score = -d;
+        } else if (st == VAR_AT_UPPER) {
+            score = d;
+        } else if (st == VAR_FREE) {
+            score = fabs(d);
+        } else {
+            continue;
+        }
+        if (!(score > tol)) {
+            continue;
+        }
+        if (weights != NULL) {
+            double w = weights[j];
+            score /= sqrt((w < MIN_WEIGHT) ? 1.0 : w);
+        }
+        if (score > *best_score) {
+            *best_score = score;
+            best = j;
+        }
+    }
+    return best;
+}
+
+int cxf_kernel_price_scalar(const double *dj, const double *weights,
+                            const int *status, int n, double tol,
+                            int *scanned) {
+    double best_score = 0.0;
+    int nonbasic = 0;
+    int best = cxf_kernel_price_tail(dj, weights, status, 0, n, tol,
+                                     -1, &best_score, &nonbasic);
+    if (scanned != NULL) {
+        *scanned = nonbasic;
+    }
+    return best;
+}
+
+/**
+ * @brief Ratio of row i, or -1 if it cannot block.
+ */
+static int row_ratio(const CxfRatioScan *scan, double pivot_tol, int i,
+                     double *ratio) {
+    double a = scan->alpha[i];
+    if (fabs(a) <= pivot_tol) {
+        return -1;
+    }
+    int var = scan->basic_vars[i];
+    if (var < 0 || var >= scan->total_vars) {
+        return -1;
+    }
+    if (a > 0.0) {
+        double lb = scan->lb[var];
+        if (lb <= -scan->infinity) {
+            return -1;
+        }
+        *ratio = (scan->x[var] - lb) / a;
+    } else {
+        double ub = scan->ub[var];
+        if (ub >= scan->infinity) {
+            return -1;
+        }
+        *ratio = (scan->x[var] - ub) / a;
+    }
+    return 0;
+}
+
+/**
+ * @brief First Harris pass over rows [from, scan->count), starting from
+ *        the best row so far (see CxfRatioMinKernel).
+ *
+ * @param min_row Best row so far, or -1
+ * @param min_ratio Its ratio (in/out, infinity for none)
+ * @return Best row
+ */
+int cxf_kernel_ratio_min_tail(const CxfRatioScan *scan, int from,
+                              double pivot_tol, double feas_tol,
+                              int min_row, double *min_ratio) {
+    double best = *min_ratio;
+    double ratio;
+
+    for (int k = from; k < scan->count; k++) {
+        int i = (scan->rows != NULL) ? scan->rows[k] : k;
+        if (row_ratio(scan, pivot_tol, i, &ratio) != 0) {
+            continue;
+        }
+        if (ratio >= -feas_tol &&
+            (ratio < best || (ratio == best && i < min_row))) {
+            best = ratio;
+            min_row = i;
+        }
+    }
+    *min_ratio = best;
+    return min_row;
+}
+
+int cxf_kernel_ratio_min_scalar(const CxfRatioScan *scan, double pivot_tol,
+                                double feas_tol, double *min_ratio) {
+    *min_ratio = scan->infinity;
+    return cxf_kernel_ratio_min_tail(scan, 0, pivot_tol, feas_tol, -1, min_ratio);
+}
+
+/**
+ * @brief Second Harris pass over rows [from, scan->count): largest
+ *        |alpha_i| with ratio <= threshold, ties to the smaller row.
+ *
+ * @param best_row Best row so far, or -1
+ * @param best_mag Its |alpha_i| (in/out)
+ * @return Best row
+ */
+int cxf_kernel_ratio_pivot_tail(const CxfRatioScan *scan, int from,
+                                double pivot_tol, double threshold,
+                                int best_row, double *best_mag) {
+    double ratio;
+
+    for (int k = from; k < scan->count; k++) {
+        int i = (scan->rows != NULL) ? scan->rows[k] : k;
+        if (row_ratio(scan, pivot_tol, i, &ratio) != 0 || ratio > threshold) {
+            continue;
+        }
+        double mag = fabs(scan->alpha[i]);
+        if (mag > *best_mag || (mag == *best_mag && i < best_row)) {
+            *best_mag = mag;
+            best_row = i;
+        }
+    }
+    return best_row;
+}
+
+int cxf_kernel_ratio_pivot_scalar(const CxfRatioScan *scan, double pivot_tol,
+                                  double threshold, int min_row) {
+    double mag = -1.0;
+    int row = cxf_kernel_ratio_pivot_tail(scan, 0, pivot_tol, threshold, -1, &mag);
+    return (mag > fabs(scan->alpha[min_row])) ? row : min_row;
+}
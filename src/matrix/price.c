@@ -0,0 +1,404 @@
+/**
+ * @file price.c
+ * @brief Pivot row PRICE: alpha_r = rho^T [A I] over the nonbasic variables.
+ *
+ * A column-wise PRICE costs O(nnz(A)) however sparse rho = B^(-T) e_r is.
+ * Keeping a row-wise copy of A next to the CSC lets the PRICE touch only
+ * the rows where rho is nonzero. cxf_price_row picks the kernel per call
+ * from the density of rho:
+ *
+ * - column-wise over the nonbasic columns when rho is dense;
+ * - row-wise with a dense accumulator when rho is sparse but the result
+ *   is not;
+ * - row-wise with an index list (hyper-sparse) when the estimated result
+ *   is sparse too, so that nothing of length n is scanned.
+ *
+ * The row-wise copy keeps the entries of basic columns at the end of each
+ * row; cxf_price_rows_set_basic moves a column's entries across the
+ * boundary on each basis change, and cxf_price_rows_sync catches up with
+ * any other change of the basis.
+ *
+ * With a worker pool (rows->pool, see threading/pool.c) the column-wise
+ * kernel runs over contiguous blocks of PRICE_BLOCK_COLS columns. Each
+ * block lists its nonzeros at its own offset of the index list, and the
+ * lists are then moved together in block order: the result, index order
+ * included, is the one of the sequential loop for any thread count.
+ */
+
+#include "convexfeld/cxf_matrix.h"
+#include "convexfeld/cxf_types.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Sparse accumulator (memory/vectors.c) */
+extern void cxf_vector_clear(VectorContainer *vec);
+extern void cxf_vector_reindex(VectorContainer *vec);
+
+/* Worker pool (threading/pool.c) */
+extern void cxf_pool_run(CxfThreadPool *pool, int tasks,
+                         void (*fn)(void *arg, int task), void *arg);
+
+/* rho denser than this is priced column-wise */
+#define PRICE_COLUMN_DENSITY 0.1
+
+/* Estimated result denser than this is accumulated densely */
+#define PRICE_HYPER_DENSITY 0.1
+
+/* Columns per task of the parallel column-wise PRICE: the block's column
+ * pointers, status and results stay in L2 while rho is shared */
+#define PRICE_BLOCK_COLS 4096
+
+/**
+ * @brief Free a row-wise PRICE copy.
+ *
+ * @param rows Copy to free (NULL is safe)
+ */
+void cxf_price_rows_free(PriceRows *rows) {
+    if (rows == NULL) {
+        return;
+    }
+    free(rows->row_start);
+    free(rows->nonbasic_end);
+    free(rows->col_idx);
+    free(rows->values);
+    free(rows->entry_pos);
+    free(rows->entry_src);
+    free(rows->basic);
+    free(rows->rho_rows);
+    free(rows->block_count);
+    free(rows);
+}
+
+/**
+ * @brief Build the row-wise PRICE copy of a CSC matrix.
+ *
+ * All columns start in the nonbasic part; cxf_price_rows_sync moves the
+ * basic ones.
+ *
+ * @param matrix Matrix with valid CSC arrays (kept by reference)
+ * @return New copy, or NULL on allocation failure
+ */
+PriceRows *cxf_price_rows_create(const SparseMatrix *matrix) {
+    if (matrix == NULL || matrix->col_ptr == NULL) {
+        return NULL;
+    }
+
+    int m = matrix->num_rows;
+    int n = matrix->num_cols;
+    int64_t nnz = matrix->col_ptr[n];
+    size_t nz = (nnz > 0) ? (size_t)nnz : 1;
+
+    PriceRows *rows = (PriceRows *)calloc(1, sizeof(PriceRows));
+    if (rows == NULL) {
+        return NULL;
+    }
+    rows->matrix = matrix;
+    rows->num_rows = m;
+    rows->num_cols = n;
+    rows->row_start = (int64_t *)calloc((size_t)m + 1, sizeof(int64_t));
+    rows->nonbasic_end = (int64_t *)malloc(((size_t)m + 1) * sizeof(int64_t));
+    rows->col_idx = (int *)malloc(nz * sizeof(int));
+    rows->values = (double *)malloc(nz * sizeof(double));
+    rows->entry_pos = (int64_t *)malloc(nz * sizeof(int64_t));
+    rows->entry_src = (int64_t *)malloc(nz * sizeof(int64_t));
+    rows->basic = (char *)calloc((size_t)n + 1, sizeof(char));
+    rows->rho_rows = (int *)malloc(((size_t)m + 1) * sizeof(int));
+    rows->block_count = (int *)malloc(((size_t)n / PRICE_BLOCK_COLS + 1) * sizeof(int));
+    if (rows->row_start == NULL || rows->nonbasic_end == NULL ||
+        rows->col_idx == NULL || rows->values == NULL ||
+        rows->entry_pos == NULL || rows->entry_src == NULL ||
+        rows->basic == NULL || rows->rho_rows == NULL ||
+        rows->block_count == NULL) {
+        cxf_price_rows_free(rows);
+        return NULL;
+    }
+
+    /* Transpose; nonbasic_end doubles as the fill pointer */
+    for (int64_t p = 0; p < nnz; p++) {
+        rows->row_start[matrix->row_idx[p] + 1]++;
+    }
+    for (int i = 0; i < m; i++) {
+        rows->row_start[i + 1] += rows->row_start[i];
+        rows->nonbasic_end[i] = rows->row_start[i];
+    }
+    for (int j = 0; j < n; j++) {
+        for (int64_t p = matrix->col_ptr[j]; p < matrix->col_ptr[j + 1]; p++) {
+            int64_t k = rows->nonbasic_end[matrix->row_idx[p]]++;
+            rows->col_idx[k] = j;
+            rows->values[k] = matrix->values[p];
+            rows->entry_pos[p] = k;
+            rows->entry_src[k] = p;
+        }
+    }
+    return rows;
+}
+
+/**
+ * @brief Swap two positions of the row-wise copy, keeping the maps.
+ */
+static void swap_entries(PriceRows *rows, int64_t a, int64_t b) {
+    if (a == b) return;
+    int col = rows->col_idx[a];
+    double val = rows->values[a];
+    int64_t src = rows->entry_src[a];
+
+    rows->col_idx[a] = rows->col_idx[b];
+    rows->values[a] = rows->values[b];
+    rows->entry_src[a] = rows->entry_src[b];
+    rows->entry_pos[rows->entry_src[a]] = a;
+
+    rows->col_idx[b] = col;
+    rows->values[b] = val;
+    rows->entry_src[b] = src;
+    rows->entry_pos[src] = b;
+}
+
+/**
+ * @brief Move a column into the basic or the nonbasic part of its rows.
+ *
+ * O(entries of the column). Slacks and out-of-range indices are ignored.
+ *
+ * @param rows Row-wise PRICE copy
+ * @param var Variable index
+ * @param basic 1 if var is now basic, 0 if nonbasic
+ */
+void cxf_price_rows_set_basic(PriceRows *rows, int var, int basic) {
+    if (rows == NULL || var < 0 || var >= rows->num_cols) {
+        return;
+    }
+    basic = (basic != 0);
+    if (rows->basic[var] == basic) {
+        return;
+    }
+
+    const SparseMatrix *A = rows->matrix;
+    for (int64_t p = A->col_ptr[var]; p < A->col_ptr[var + 1]; p++) {
+        int i = A->row_idx[p];
+        if (basic) {
+            /* Last nonbasic slot becomes the first basic one */
+            int64_t last = --rows->nonbasic_end[i];
+            swap_entries(rows, rows->entry_pos[p], last);
+        } else {
+            int64_t first = rows->nonbasic_end[i]++;
+            swap_entries(rows, rows->entry_pos[p], first);
+        }
+    }
+    rows->basic[var] = (char)basic;
+}
+
+/**
+ * @brief Bring the partition in line with the basis.
+ *
+ * O(n) plus the entries of the columns that moved. Called whenever the
+ * basis may have changed by other means than a pivot, e.g. after a
+ * refactorization that repaired the basis.
+ *
+ * @param rows Row-wise PRICE copy
+ * @param var_status Basis status of the variables (>= 0: basic)
+ */
+void cxf_price_rows_sync(PriceRows *rows, const int *var_status) {
+    if (rows == NULL || var_status == NULL) {
+        return;
+    }
+    for (int j = 0; j < rows->num_cols; j++) {
+        int basic = (var_status[j] >= 0);
+        if (rows->basic[j] != basic) {
+            cxf_price_rows_set_basic(rows, j, basic);
+        }
+    }
+}
+
+/**
+ * @brief Column-wise PRICE over the nonbasic columns c0..c1-1.
+ *
+ * @param values Dense result (entries of the range written)
+ * @param indices Output: the nonzero columns, in order
+ * @return Number of nonzero columns
+ */
+static int price_column_range(const SparseMatrix *A, const int *var_status,
+                              const double *rho, double *values, int *indices,
+                              int c0, int c1) {
+    int count = 0;
+    for (int j = c0; j < c1; j++) {
+        if (var_status[j] >= 0) continue;
+        double a = 0.0;
+        for (int64_t p = A->col_ptr[j]; p < A->col_ptr[j + 1]; p++) {
+            a += rho[A->row_idx[p]] * A->values[p];
+        }
+        if (a != 0.0) {
+            values[j] = a;
+            indices[count++] = j;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief One block of a parallel column-wise PRICE.
+ */
+typedef struct {
+    const SparseMatrix *A;
+    const int *var_status;
+    const double *rho;
+    VectorContainer *alpha;
+    int *block_count;         /**< Nonzeros found per block */
+} PriceColumnsTask;
+
+static void price_columns_task(void *arg, int block) {
+    PriceColumnsTask *task = (PriceColumnsTask *)arg;
+    int n = task->A->num_cols;
+    int c0 = block * PRICE_BLOCK_COLS;
+    int c1 = (n - c0 > PRICE_BLOCK_COLS) ? c0 + PRICE_BLOCK_COLS : n;
+    /* A block has at most c1 - c0 nonzeros, so the slots from c0 on are
+     * its own */
+    task->block_count[block] =
+        price_column_range(task->A, task->var_status, task->rho,
+                           task->alpha->values, task->alpha->indices + c0, c0, c1);
+}
+
+/**
+ * @brief Column-wise PRICE over the nonbasic structural columns.
+ *
+ * alpha is empty on entry. Split over the pool of rows when there is
+ * more than one block.
+ */
+static void price_columns(const PriceRows *rows, const SparseMatrix *A,
+                          const int *var_status, const double *rho,
+                          VectorContainer *alpha) {
+    int n = A->num_cols;
+    int blocks = (n + PRICE_BLOCK_COLS - 1) / PRICE_BLOCK_COLS;
+    if (rows == NULL || rows->pool == NULL || blocks < 2) {
+        alpha->size = price_column_range(A, var_status, rho, alpha->values,
+                                         alpha->indices, 0, n);
+        return;
+    }
+
+    PriceColumnsTask task = {A, var_status, rho, alpha, rows->block_count};
+    cxf_pool_run(rows->pool, blocks, price_columns_task, &task);
+
+    /* Blocks in order; each list moves towards the front */
+    int size = 0;
+    for (int b = 0; b < blocks; b++) {
+        int count = rows->block_count[b];
+        int *from = alpha->indices + (size_t)b * PRICE_BLOCK_COLS;
+        if (from != alpha->indices + size) {
+            memmove(alpha->indices + size, from, (size_t)count * sizeof(int));
+        }
+        size += count;
+    }
+    alpha->size = size;
+}
+
+/**
+ * @brief Row-wise PRICE into a dense accumulator.
+ */
+static void price_rows_dense(const PriceRows *rows, const double *rho,
+                             int nrho, double *alpha) {
+    for (int t = 0; t < nrho; t++) {
+        int i = rows->rho_rows[t];
+        double r = rho[i];
+        for (int64_t k = rows->row_start[i]; k < rows->nonbasic_end[i]; k++) {
+            alpha[rows->col_idx[k]] += r * rows->values[k];
+        }
+    }
+}
+
+/**
+ * @brief Row-wise PRICE keeping the index list of the result.
+ */
+static void price_rows_hyper(const PriceRows *rows, const double *rho,
+                             int nrho, VectorContainer *alpha) {
+    double *x = alpha->values;
+    for (int t = 0; t < nrho; t++) {
+        int i = rows->rho_rows[t];
+        double r = rho[i];
+        for (int64_t k = rows->row_start[i]; k < rows->nonbasic_end[i]; k++) {
+            int j = rows->col_idx[k];
+            if (x[j] == 0.0) {
+                alpha->indices[alpha->size++] = j;
+                x[j] = r * rows->values[k];
+            } else {
+                x[j] += r * rows->values[k];
+            }
+            if (x[j] == 0.0) {
+                x[j] = CXF_TINY_VALUE;  /* Keep the index list exact */
+            }
+        }
+    }
+}
+
+/**
+ * @brief Pivot row alpha_r = rho^T [A I] over the nonbasic variables.
+ *
+ * Chooses the kernel from the density of rho (see the file comment).
+ * Entries of basic variables are left zero. The slack of row i has the
+ * column slack_coeff[i] * e_i, or e_i when slack_coeff is NULL.
+ *
+ * @param rows Row-wise PRICE copy in line with var_status, or NULL to
+ *             always price column-wise
+ * @param matrix Constraint matrix (CSC)
+ * @param var_status Basis status [n + m] (>= 0: basic)
+ * @param slack_coeff Slack column coefficients [m], or NULL
+ * @param rho Row r of B^(-1) [m]
+ * @param alpha Output: sparse accumulator of dimension n + m, cleared
+ *              here from its previous contents
+ * @return The CXF_PRICE_* kernel used
+ */
+int cxf_price_row(PriceRows *rows, const SparseMatrix *matrix,
+                  const int *var_status, const double *slack_coeff,
+                  const double *rho, VectorContainer *alpha) {
+    int m = matrix->num_rows;
+    int n = matrix->num_cols;
+
+    cxf_vector_clear(alpha);
+
+    int mode = CXF_PRICE_COLUMN;
+    int nrho = 0;
+    if (rows != NULL) {
+        for (int i = 0; i < m; i++) {
+            if (rho[i] != 0.0) {
+                rows->rho_rows[nrho++] = i;
+            }
+        }
+        if (nrho <= PRICE_COLUMN_DENSITY * m) {
+            int64_t work = 0;
+            for (int t = 0; t < nrho; t++) {
+                int i = rows->rho_rows[t];
+                work += rows->nonbasic_end[i] - rows->row_start[i];
+            }
+            mode = (work < PRICE_HYPER_DENSITY * n) ? CXF_PRICE_HYPER : CXF_PRICE_ROW;
+        }
+        rows->mode_count[mode]++;
+    }
+
+    if (mode == CXF_PRICE_ROW) {
+        price_rows_dense(rows, rho, nrho, alpha->values);
+        for (int t = 0; t < nrho; t++) {
+            int i = rows->rho_rows[t];
+            if (var_status[n + i] < 0) {
+                alpha->values[n + i] = rho[i] * (slack_coeff ? slack_coeff[i] : 1.0);
+            }
+        }
+        cxf_vector_reindex(alpha);
+        return mode;
+    }
+
+    if (mode == CXF_PRICE_HYPER) {
+        price_rows_hyper(rows, rho, nrho, alpha);
+    } else {
+        price_columns(rows, matrix, var_status, rho, alpha);
+    }
+
+    /* Slacks: alpha_{n+i} = rho_i * coeff_i */
+    int count = (rows != NULL) ? nrho : m;
+    for (int t = 0; t < count; t++) {
+        int i = (rows != NULL) ? rows->rho_rows[t] : t;
+        if (var_status[n + i] >= 0) continue;
+        double a = rho[i] * (slack_coeff ? slack_coeff[i] : 1.0);
+        if (a != 0.0) {
+            alpha->values[n + i] = a;
+            alpha->indices[alpha->size++] = n + i;
+        }
+    }
+    return mode;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file scratch.c
+ * @brief Stack-style scratch arena for kernel temporaries.
+ *
+ * Provides cxf_scratch_init, cxf_scratch_free, cxf_scratch_mark,
+ * cxf_scratch_alloc and cxf_scratch_release. The solver owns one arena
+ * per solve; FTRAN/BTRAN and the iteration take their work arrays from
+ * it instead of the heap. Blocks are chained like the eta buffer chunks
+ * and are never returned to the heap before cxf_scratch_free.
+ */
+
+#include <stdlib.h>
+#include "convexfeld/cxf_types.h"
+
+/* External declarations for core memory functions */
+void *cxf_malloc(size_t size);
+void cxf_free(void *ptr);
+
+/** Alignment of every scratch allocation (covers double and int64_t) */
+#define SCRATCH_ALIGN 16
+
+/** Header size rounded up so block data is aligned */
+#define SCRATCH_HEADER \
+    ((sizeof(ScratchBlock) + SCRATCH_ALIGN - 1) & ~(size_t)(SCRATCH_ALIGN - 1))
+
+/**
+ * @brief Get the data area of a block.
+ */
+static char *block_data(ScratchBlock *block) {
+    return (char *)block + SCRATCH_HEADER;
+}
+
+/**
+ * @brief Allocate a block from the heap.
+ */
+static ScratchBlock *block_new(ScratchArena *arena, size_t capacity) {
+    ScratchBlock *block = cxf_malloc(SCRATCH_HEADER + capacity);
+    if (block == NULL) {
+        return NULL;
+    }
+    block->next = NULL;
+    block->capacity = capacity;
+    block->used = 0;
+    arena->heapAllocs++;
+    return block;
+}
+
+/**
+ * @brief Initialize a scratch arena.
+ *
+ * @param arena Arena to initialize
+ * @param initial_size Size of the first block in bytes (0 defers it)
+ * @return CXF_OK on success, CXF_ERROR_OUT_OF_MEMORY on failure
+ */
+int cxf_scratch_init(ScratchArena *arena, size_t initial_size) {
+    if (arena == NULL) {
+        return CXF_ERROR_NULL_ARGUMENT;
+    }
+
+    arena->first = NULL;
+    arena->active = NULL;
+    arena->minBlockSize = CXF_MIN_CHUNK_SIZE;
+    arena->heapAllocs = 0;
+
+    if (initial_size > 0) {
+        if (initial_size < arena->minBlockSize) {
+            initial_size = arena->minBlockSize;
+        }
+        arena->first = block_new(arena, initial_size);
+        if (arena->first == NULL) {
+            return CXF_ERROR_OUT_OF_MEMORY;
+        }
+        arena->active = arena->first;
+    }
+    return CXF_OK;
+}
+
+/**
+ * @brief Free all blocks of a scratch arena.
+ *
+ * @param arena Arena to free (NULL is safe)
+ */
+void cxf_scratch_free(ScratchArena *arena) {
+    if (arena == NULL) {
+        return;
+    }
+
+    ScratchBlock *block = arena->first;
+    while (block != NULL) {
+        ScratchBlock *next = block->next;
+        cxf_free(block);
+        block = next;
+    }
+    arena->first = NULL;
+    arena->active = NULL;
+}
+
+/**
+ * @brief Record the current top of the arena.
+ *
+ * @param arena Scratch arena
+ * @return Mark to pass to cxf_scratch_release
+ */
+ScratchMark cxf_scratch_mark(const ScratchArena *arena) {
+    ScratchMark mark;
+    mark.block = arena->active;
+    mark.used = (arena->active != NULL) ? arena->active->used : 0;
+    return mark;
+}
+
+/**
+ * @brief Allocate an aligned array from the arena.
+ *
+ * Fast path: bump the active block. Slow path: move on to the next
+ * retained block, or link a new one (twice the active size) in front
+ * of it when the retained block is too small.
+ *
+ * @param arena Scratch arena
+ * @param size Number of bytes (> 0)
+ * @return Pointer valid until the enclosing mark is released, or NULL
+ */
+void *cxf_scratch_alloc(ScratchArena *arena, size_t size) {
+    if (arena == NULL || size == 0) {
+        return NULL;
+    }
+
+    size = (size + SCRATCH_ALIGN - 1) & ~(size_t)(SCRATCH_ALIGN - 1);
+
+    ScratchBlock *active = arena->active;
+    if (active != NULL && size <= active->capacity - active->used) {
+        void *ptr = block_data(active) + active->used;
+        active->used += size;
+        return ptr;
+    }
+
+    ScratchBlock *next = (active != NULL) ? active->next : arena->first;
+    if (next == NULL || next->capacity < size) {
+        size_t capacity = (active != NULL) ? 2 * active->capacity : arena->minBlockSize;
+        if (capacity < size) {
+            capacity = size;
+        }
+        ScratchBlock *block = block_new(arena, capacity);
+        if (block == NULL) {
+            return NULL;
+        }
+        block->next = next;
+        if (active != NULL) {
+            active->next = block;
+        } else {
+            arena->first = block;
+        }
+        next = block;
+    }
+
+    next->used = size;
+    arena->active = next;
+    return block_data(next);
+}
+
+/**
+ * @brief Release everything allocated since a mark.
+ *
+ * @param arena Scratch arena
+ * @param mark Value returned by cxf_scratch_mark
+ */
+void cxf_scratch_release(ScratchArena *arena, ScratchMark mark) {
+    if (arena == NULL) {
+        return;
+    }
+
+    if (mark.block == NULL) {
+        arena->active = arena->first;
+        if (arena->active != NULL) {
+            arena->active->used = 0;
+        }
+        return;
+    }
+    arena->active = mark.block;
+    mark.block->used = mark.used;
+}
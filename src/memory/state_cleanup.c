@@ -19,6 +19,7 @@
 /* Forward declarations for module-specific free functions */
 extern void cxf_basis_free(BasisState *basis);
 extern void cxf_pricing_free(PricingContext *ctx);
+extern void cxf_scratch_free(ScratchArena *arena);
 
 /*============================================================================
  * cxf_free_solver_state - SolverContext Cleanup
@@ -31,6 +32,7 @@ extern void cxf_pricing_free(PricingContext *ctx);
  * - All working arrays (work_lb, work_ub, work_obj, work_x, work_pi, work_dj)
  * - BasisState subcomponent (via cxf_basis_free)
  * - PricingContext subcomponent (via cxf_pricing_free)
+ * - The scratch arena (after the basis that borrows it)
  * - The SolverContext structure itself
  *
  * Does NOT free the model_ref (owned by caller).
@@ -53,6 +55,7 @@ void cxf_free_solver_state(SolverContext *ctx) {
     /* Free subcomponents */
     cxf_basis_free(ctx->basis);
     cxf_pricing_free(ctx->pricing);
+    cxf_scratch_free(&ctx->scratch);
 
     /* Clear pointers before freeing */
     ctx->model_ref = NULL;
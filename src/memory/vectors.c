@@ -2,14 +2,17 @@
  * @file vectors.c
  * @brief Vector memory management and eta buffer arena allocator.
  *
- * Provides cxf_vector_free for deallocating VectorContainer structures,
- * and cxf_alloc_eta for arena-based allocation of eta vectors.
+ * Provides the VectorContainer sparse accumulator lifecycle
+ * (cxf_vector_create, cxf_vector_clear, cxf_vector_reindex,
+ * cxf_vector_free), and cxf_alloc_eta for arena-based allocation of
+ * eta vectors.
  *
  * @see docs/specs/functions/memory/cxf_vector_free.md
  * @see docs/specs/functions/memory/cxf_alloc_eta.md
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include "convexfeld/cxf_types.h"
 
 /* External declarations for core memory functions */
@@ -17,6 +20,76 @@ void *cxf_malloc(size_t size);
 void *cxf_calloc(size_t count, size_t size);
 void cxf_free(void *ptr);
 
+void cxf_vector_free(VectorContainer *vec);
+
+/**
+ * @brief Create an empty sparse accumulator of dimension dim.
+ *
+ * @param dim Vector dimension (> 0)
+ * @return New container with all values zero, or NULL on failure
+ */
+VectorContainer *cxf_vector_create(int dim) {
+    if (dim <= 0) {
+        return NULL;
+    }
+
+    VectorContainer *vec = cxf_calloc(1, sizeof(VectorContainer));
+    if (vec == NULL) {
+        return NULL;
+    }
+    vec->indices = cxf_malloc((size_t)dim * sizeof(int));
+    vec->values = cxf_calloc((size_t)dim, sizeof(double));
+    if (vec->indices == NULL || vec->values == NULL) {
+        cxf_vector_free(vec);
+        return NULL;
+    }
+    vec->capacity = dim;
+    vec->size = 0;
+    return vec;
+}
+
+/**
+ * @brief Zero a sparse accumulator.
+ *
+ * Touches only the listed entries unless most of the vector is filled,
+ * in which case one memset is cheaper.
+ *
+ * @param vec Sparse accumulator (NULL is safe)
+ */
+void cxf_vector_clear(VectorContainer *vec) {
+    if (vec == NULL) {
+        return;
+    }
+
+    if (vec->size > vec->capacity / 4) {
+        memset(vec->values, 0, (size_t)vec->capacity * sizeof(double));
+    } else {
+        for (int k = 0; k < vec->size; k++) {
+            vec->values[vec->indices[k]] = 0.0;
+        }
+    }
+    vec->size = 0;
+}
+
+/**
+ * @brief Rebuild the index list after the values were written densely.
+ *
+ * @param vec Sparse accumulator (NULL is safe)
+ */
+void cxf_vector_reindex(VectorContainer *vec) {
+    if (vec == NULL) {
+        return;
+    }
+
+    int size = 0;
+    for (int i = 0; i < vec->capacity; i++) {
+        if (vec->values[i] != 0.0) {
+            vec->indices[size++] = i;
+        }
+    }
+    vec->size = size;
+}
+
 /**
  * @brief Deallocate a vector container and all its arrays.
  *
@@ -108,6 +181,7 @@ void cxf_eta_buffer_reset(EtaBuffer *buffer) {
  * @brief Allocate memory from the eta buffer arena.
  *
  * Fast path: bump pointer in active chunk if space available.
+ * Next, reuse the following chunk if one was retained by a reset.
  * Slow path: allocate new chunk, link to chain, update growth.
  *
  * @param env Environment pointer (unused, for future compatibility)
@@ -131,6 +205,14 @@ void *cxf_alloc_eta(CxfEnv *env, EtaBuffer *buffer, size_t size) {
         return ptr;
     }
 
+    /* Chunks retained by cxf_eta_buffer_reset are reused in order */
+    EtaChunk *next = (active != NULL) ? active->next : buffer->firstChunk;
+    if (next != NULL && size <= next->capacity) {
+        buffer->activeChunk = next;
+        buffer->bytesUsed = size;
+        return next->data;
+    }
+
     /* Slow path: need a new chunk */
 
     /* Determine chunk size: at least size, at least currentChunkSize */
@@ -153,7 +235,7 @@ void *cxf_alloc_eta(CxfEnv *env, EtaBuffer *buffer, size_t size) {
     }
 
     new_chunk->capacity = chunk_size;
-    new_chunk->next = NULL;
+    new_chunk->next = next;  /* Keep any retained (too small) chunks */
 
     /* Link to chain */
     if (active != NULL) {
@@ -3,7 +3,15 @@
  * @brief Full cxf_pricing_candidates implementation (M6.1.4)
  *
  * Select candidate entering variables based on reduced cost violations.
- * Supports partial pricing (section cycling) and sorting by attractiveness.
+ * Supports partial pricing (section cycling) and sorting by attractiveness,
+ * |d_j| or, with steepest-edge/Devex weights, |d_j| / sqrt(w_j).
+ *
+ * The candidates are the most attractive ones, ties going to the smaller
+ * index, so they do not depend on the scan order. With a worker pool
+ * (ctx->pool) a large scan range is split into blocks of
+ * CANDIDATE_BLOCK variables that keep their own best candidates, in the
+ * block lists of the context; merging them gives the candidates of a
+ * sequential scan.
  *
  * Spec: docs/specs/functions/pricing/cxf_pricing_candidates.md
  */
@@ -15,6 +23,10 @@
 #include "convexfeld/cxf_types.h"
 #include "convexfeld/cxf_pricing.h"
 
+/* Worker pool (threading/pool.c) */
+extern void cxf_pool_run(CxfThreadPool *pool, int tasks,
+                         void (*fn)(void *arg, int task), void *arg);
+
 /* Variable status codes */
 #define VAR_AT_LOWER   -1
 #define VAR_AT_UPPER   -2
@@ -26,31 +38,174 @@
 /* Default number of sections for partial pricing */
 #define DEFAULT_NUM_SECTIONS   10
 
+/* Pooled scan: variables per block (doubled while there are more than
+ * CXF_CANDIDATE_BLOCKS blocks) */
+#define CANDIDATE_BLOCK        8192
+
 /*============================================================================
- * Helper: Comparison for sorting by |reduced_cost| descending
+ * Helper: Attractiveness and comparison for sorting, descending
  *===========================================================================*/
 
+/** @brief Reduced costs and optional weights of a candidate scan. */
+typedef struct {
+    const double *reduced_costs;
+    const double *weights;    /**< Pricing weights, or NULL for |RC| */
+} CandidateScore;
+
+/**
+ * @brief Attractiveness of variable j: |d_j|, or |d_j| / sqrt(w_j).
+ */
+static double candidate_score(const CandidateScore *s, int j) {
+    double abs_rc = fabs(s->reduced_costs[j]);
+    if (s->weights != NULL && s->weights[j] > 0.0) {
+        return abs_rc / sqrt(s->weights[j]);
+    }
+    return abs_rc;
+}
+
+/**
+ * @brief 1 if variable i ranks before variable j: more attractive, or as
+ *        attractive with a smaller index.
+ */
+static int ranks_before(const CandidateScore *s, int i, int j) {
+    double score_i = candidate_score(s, i);
+    double score_j = candidate_score(s, j);
+    return score_i > score_j || (score_i == score_j && i < j);
+}
+
 /**
- * @brief Compare two candidate indices by |reduced_cost| descending.
+ * @brief Compare two candidate indices by attractiveness descending.
  * @param a First candidate index pointer
  * @param b Second candidate index pointer
- * @param context Pointer to reduced_costs array
+ * @param context Pointer to the CandidateScore of the scan
+ */
+static int compare_by_score_desc(const void *a, const void *b, void *context) {
+    const CandidateScore *s = (const CandidateScore *)context;
+    int i = *(const int *)a;
+    int j = *(const int *)b;
+
+    /* Sort descending: more attractive first, ties by index */
+    if (i == j) {
+        return 0;
+    }
+    return ranks_before(s, i, j) ? -1 : 1;
+}
+
+/**
+ * @brief Offer variable j to a candidate list of at most max entries.
+ *
+ * A full list replaces its lowest-ranked entry if j ranks before it.
+ *
+ * @return New list length
+ */
+static int offer_candidate(const CandidateScore *s, int j, int *list,
+                           int count, int max) {
+    if (count < max) {
+        list[count] = j;
+        return count + 1;
+    }
+    int worst = 0;
+    for (int k = 1; k < count; k++) {
+        if (ranks_before(s, list[worst], list[k])) {
+            worst = k;
+        }
+    }
+    if (ranks_before(s, j, list[worst])) {
+        list[worst] = j;
+    }
+    return count;
+}
+
+/**
+ * @brief Scan variables j0..j1-1 for attractive ones.
+ *
+ * - At lower bound: attractive if RC < -tolerance
+ * - At upper bound: attractive if RC > tolerance
+ * - Free variable: attractive if |RC| > tolerance
+ *
+ * @return Length of the candidate list (at most max)
+ */
+static int scan_range(const CandidateScore *s, const int *var_status,
+                      double tolerance, int j0, int j1, int *list, int max) {
+    const double *reduced_costs = s->reduced_costs;
+    int count = 0;
+
+    for (int j = j0; j < j1; j++) {
+        /* Skip basic variables (status >= 0 means row index in basis) */
+        if (var_status[j] >= 0) {
+            continue;
+        }
+
+        double rc = reduced_costs[j];
+        int attractive = 0;
+
+        if (var_status[j] == VAR_AT_LOWER && rc < -tolerance) {
+            attractive = 1;  /* At lower, negative RC -> can improve */
+        } else if (var_status[j] == VAR_AT_UPPER && rc > tolerance) {
+            attractive = 1;  /* At upper, positive RC -> can improve */
+        } else if (var_status[j] == VAR_FREE && fabs(rc) > tolerance) {
+            attractive = 1;  /* Free variable with nonzero RC */
+        }
+
+        if (attractive) {
+            count = offer_candidate(s, j, list, count, max);
+        }
+    }
+    return count;
+}
+
+/** @brief A pooled candidate scan: one list of max entries per block. */
+typedef struct {
+    const CandidateScore *score;
+    const int *var_status;
+    double tolerance;
+    int start, end, block_size, max;
+    int *lists;               /**< [blocks * max] */
+    int *counts;              /**< [blocks] */
+} CandidateScan;
+
+static void candidate_scan_task(void *arg, int block) {
+    CandidateScan *scan = (CandidateScan *)arg;
+    int j0 = scan->start + block * scan->block_size;
+    int j1 = (scan->end - j0 > scan->block_size) ? j0 + scan->block_size : scan->end;
+    scan->counts[block] = scan_range(scan->score, scan->var_status, scan->tolerance,
+                                     j0, j1, scan->lists + (size_t)block * (size_t)scan->max,
+                                     scan->max);
+}
+
+/**
+ * @brief Candidate scan of start..end-1 over the pool of the context,
+ *        with max at most CXF_CANDIDATE_LIST.
  */
-static int compare_by_abs_rc_desc(const void *a, const void *b, void *context) {
-    const double *reduced_costs = (const double *)context;
-    int idx_a = *(const int *)a;
-    int idx_b = *(const int *)b;
-
-    double abs_rc_a = fabs(reduced_costs[idx_a]);
-    double abs_rc_b = fabs(reduced_costs[idx_b]);
-
-    /* Sort descending: larger |RC| first */
-    if (abs_rc_a > abs_rc_b) {
-        return -1;
-    } else if (abs_rc_a < abs_rc_b) {
-        return 1;
+static int scan_parallel(PricingContext *ctx, const CandidateScore *s,
+                         const int *var_status, double tolerance, int start,
+                         int end, int *candidates, int max) {
+    CandidateScan scan;
+    scan.score = s;
+    scan.var_status = var_status;
+    scan.tolerance = tolerance;
+    scan.start = start;
+    scan.end = end;
+    scan.max = max;
+    scan.block_size = CANDIDATE_BLOCK;
+    while ((end - start + scan.block_size - 1) / scan.block_size > CXF_CANDIDATE_BLOCKS) {
+        scan.block_size *= 2;
     }
-    return 0;
+    int blocks = (end - start + scan.block_size - 1) / scan.block_size;
+    scan.lists = ctx->block_lists;
+    scan.counts = ctx->block_counts;
+
+    cxf_pool_run(ctx->pool, blocks, candidate_scan_task, &scan);
+
+    /* The best of all blocks are among the best of each block */
+    int count = 0;
+    for (int b = 0; b < blocks; b++) {
+        const int *list = scan.lists + (size_t)b * (size_t)max;
+        for (int k = 0; k < scan.counts[b]; k++) {
+            count = offer_candidate(s, list[k], candidates, count, max);
+        }
+    }
+    return count;
 }
 
 /*============================================================================
@@ -67,7 +222,8 @@ static int compare_by_abs_rc_desc(const void *a, const void *b, void *context) {
  *
  * For partial pricing, scans only a section of variables and advances
  * the section counter for next call. Candidates are sorted by |RC|
- * descending (most attractive first).
+ * descending (most attractive first, ties by index), scaled by
+ * 1 / sqrt(weight) when the context keeps steepest-edge or Devex weights.
  *
  * @param ctx Pricing context
  * @param reduced_costs Reduced costs array [num_vars]
@@ -109,60 +265,31 @@ int cxf_pricing_candidates(PricingContext *ctx, const double *reduced_costs,
         }
     }
 
-    /* Scan for attractive nonbasic variables */
-    int count = 0;
-    int64_t scanned = 0;
-
-    for (int j = start_idx; j < end_idx; j++) {
-        scanned++;
-
-        /* Skip basic variables (status >= 0 means row index in basis) */
-        if (var_status[j] >= 0) {
-            continue;
-        }
-
-        double rc = reduced_costs[j];
-        int attractive = 0;
-
-        if (var_status[j] == VAR_AT_LOWER && rc < -tolerance) {
-            attractive = 1;  /* At lower, negative RC -> can improve */
-        } else if (var_status[j] == VAR_AT_UPPER && rc > tolerance) {
-            attractive = 1;  /* At upper, positive RC -> can improve */
-        } else if (var_status[j] == VAR_FREE && fabs(rc) > tolerance) {
-            attractive = 1;  /* Free variable with nonzero RC */
-        }
+    /* Weights cover the context's variables only */
+    CandidateScore score = {reduced_costs, NULL};
+    if (ctx->weights != NULL && num_vars <= ctx->num_vars) {
+        score.weights = ctx->weights;
+    }
 
-        if (attractive) {
-            if (count < max_candidates) {
-                candidates[count++] = j;
-            } else {
-                /* Array full - find and replace least attractive if better */
-                double new_abs_rc = fabs(rc);
-                int min_idx = 0;
-                double min_abs_rc = fabs(reduced_costs[candidates[0]]);
-
-                for (int k = 1; k < count; k++) {
-                    double abs_rc_k = fabs(reduced_costs[candidates[k]]);
-                    if (abs_rc_k < min_abs_rc) {
-                        min_abs_rc = abs_rc_k;
-                        min_idx = k;
-                    }
-                }
-
-                if (new_abs_rc > min_abs_rc) {
-                    candidates[min_idx] = j;
-                }
-            }
-        }
+    /* Scan for attractive nonbasic variables */
+    int count;
+    if (ctx->pool != NULL && ctx->block_lists != NULL &&
+        max_candidates <= CXF_CANDIDATE_LIST && end_idx - start_idx > CANDIDATE_BLOCK) {
+        count = scan_parallel(ctx, &score, var_status, tolerance,
+                              start_idx, end_idx, candidates, max_candidates);
+    } else {
+        count = scan_range(&score, var_status, tolerance, start_idx, end_idx,
+                           candidates, max_candidates);
     }
+    int64_t scanned = end_idx - start_idx;
 
     /* Update statistics */
     ctx->total_candidates_scanned += scanned;
 
-    /* Sort candidates by |reduced_cost| descending */
+    /* Sort candidates by attractiveness descending */
     if (count > 1) {
         qsort_r(candidates, (size_t)count, sizeof(int),
-                compare_by_abs_rc_desc, (void *)reduced_costs);
+                compare_by_score_desc, &score);
     }
 
     return count;
@@ -46,8 +46,15 @@ PricingContext *cxf_pricing_create(int num_vars, int max_levels) {
     ctx->candidate_sizes = (int *)calloc((size_t)max_levels, sizeof(int));
     ctx->cached_counts = (int *)calloc((size_t)max_levels, sizeof(int));
 
+    /* Block lists of the pooled candidate scan, sized once so that the
+     * scan does not allocate */
+    ctx->block_lists = (int *)malloc((size_t)CXF_CANDIDATE_BLOCKS *
+                                     CXF_CANDIDATE_LIST * sizeof(int));
+    ctx->block_counts = (int *)malloc((size_t)CXF_CANDIDATE_BLOCKS * sizeof(int));
+
     if (ctx->candidate_counts == NULL || ctx->candidate_arrays == NULL ||
-        ctx->candidate_sizes == NULL || ctx->cached_counts == NULL) {
+        ctx->candidate_sizes == NULL || ctx->cached_counts == NULL ||
+        ctx->block_lists == NULL || ctx->block_counts == NULL) {
         cxf_pricing_free(ctx);
         return NULL;
     }
@@ -56,6 +63,11 @@ PricingContext *cxf_pricing_create(int num_vars, int max_levels) {
     ctx->num_vars = 0;
     ctx->strategy = 0;
     ctx->weights = NULL;
+    ctx->reference = NULL;
+    ctx->heap = NULL;
+    ctx->heap_pos = NULL;
+    ctx->heap_key = NULL;
+    ctx->pool = NULL;
 
     /* Initialize cached counts to -1 (invalid) */
     for (int i = 0; i < max_levels; i++) {
@@ -86,8 +98,14 @@ void cxf_pricing_free(PricingContext *ctx) {
         return;
     }
 
-    /* Free steepest edge weights */
+    /* Free steepest edge / Devex weights */
     free(ctx->weights);
+    free(ctx->reference);
+    free(ctx->heap);
+    free(ctx->heap_pos);
+    free(ctx->heap_key);
+    free(ctx->block_lists);
+    free(ctx->block_counts);
 
     /* Free candidate arrays per level */
     if (ctx->candidate_arrays != NULL) {
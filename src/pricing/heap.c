@@ -0,0 +1,182 @@
+/**
+ * @file heap.c
+ * @brief Indexed max-heap of the attractive nonbasic variables.
+ *
+ * Steepest-edge and Devex pricing pick the nonbasic variable with the
+ * largest d_j^2 / w_j. The reduced costs and weights only change over the
+ * pivot row of each iteration, so instead of scanning all variables the
+ * attractive ones are kept in a binary max-heap keyed by d_j^2 / w_j. The
+ * solver touches the entries the pivot changed (O(log n) each); a full
+ * recomputation of the reduced costs or weights rebuilds the heap in O(n).
+ *
+ * Ties go to the smaller index, so the heap selects the variable
+ * cxf_pricing_steepest would (up to rounding in the ratio).
+ */
+
+#include <stdlib.h>
+#include "convexfeld/cxf_types.h"
+#include "convexfeld/cxf_pricing.h"
+
+/* Variable status codes */
+#define VAR_AT_LOWER    -1
+#define VAR_AT_UPPER    -2
+#define VAR_FREE        -3
+
+/* Weights below this count as 1 (as in cxf_pricing_steepest) */
+#define MIN_WEIGHT 1e-10
+
+/**
+ * @brief Heap key of variable j, or -1 if it is not attractive.
+ *
+ * Frozen weights (>= CXF_INFINITY) keep a variable out of the heap.
+ */
+static double heap_key(const PricingContext *ctx, int j, const double *dj,
+                       const int *status) {
+    int st = status[j];
+    double d = dj[j];
+    double tol = ctx->heap_tol;
+    int attractive = (st == VAR_AT_LOWER && d < -tol) ||
+                     (st == VAR_AT_UPPER && d > tol) ||
+                     (st == VAR_FREE && (d < -tol || d > tol));
+    if (!attractive) {
+        return -1.0;
+    }
+    double w = ctx->weights[j];
+    if (w >= CXF_INFINITY) {
+        return -1.0;
+    }
+    if (w < MIN_WEIGHT) {
+        w = 1.0;
+    }
+    return d * d / w;
+}
+
+/** Whether heap entry a ranks above entry b */
+static int ranks_above(const PricingContext *ctx, int a, int b) {
+    double ka = ctx->heap_key[a];
+    double kb = ctx->heap_key[b];
+    return ka > kb || (ka == kb && a < b);
+}
+
+static void heap_place(PricingContext *ctx, int pos, int j) {
+    ctx->heap[pos] = j;
+    ctx->heap_pos[j] = pos;
+}
+
+static void sift_up(PricingContext *ctx, int pos) {
+    int j = ctx->heap[pos];
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!ranks_above(ctx, j, ctx->heap[parent])) break;
+        heap_place(ctx, pos, ctx->heap[parent]);
+        pos = parent;
+    }
+    heap_place(ctx, pos, j);
+}
+
+static void sift_down(PricingContext *ctx, int pos) {
+    int j = ctx->heap[pos];
+    int size = ctx->heap_size;
+    for (;;) {
+        int child = 2 * pos + 1;
+        if (child >= size) break;
+        if (child + 1 < size && ranks_above(ctx, ctx->heap[child + 1], ctx->heap[child])) {
+            child++;
+        }
+        if (!ranks_above(ctx, ctx->heap[child], j)) break;
+        heap_place(ctx, pos, ctx->heap[child]);
+        pos = child;
+    }
+    heap_place(ctx, pos, j);
+}
+
+/**
+ * @brief Rebuild the heap from all reduced costs and weights.
+ *
+ * O(num_vars). Marks the heap ready.
+ *
+ * @param ctx Pricing context with weights and heap arrays
+ * @param dj Reduced costs [num_vars]
+ * @param status Variable status [num_vars]
+ * @param tolerance Optimality tolerance
+ */
+void cxf_pricing_heap_build(PricingContext *ctx, const double *dj,
+                            const int *status, double tolerance) {
+    if (ctx == NULL || ctx->heap == NULL) {
+        return;
+    }
+    ctx->heap_tol = tolerance;
+    ctx->heap_size = 0;
+    for (int j = 0; j < ctx->num_vars; j++) {
+        double key = (status[j] < 0) ? heap_key(ctx, j, dj, status) : -1.0;
+        ctx->heap_key[j] = key;
+        ctx->heap_pos[j] = -1;
+        if (key >= 0.0) {
+            heap_place(ctx, ctx->heap_size++, j);
+        }
+    }
+    for (int pos = ctx->heap_size / 2 - 1; pos >= 0; pos--) {
+        sift_down(ctx, pos);
+    }
+    ctx->heap_ready = 1;
+}
+
+/**
+ * @brief Bring the heap entry of variable j in line with its reduced
+ *        cost, weight and status.
+ *
+ * Inserts, moves or removes j as needed; O(log n). Does nothing while
+ * the heap is not ready.
+ *
+ * @param ctx Pricing context
+ * @param j Variable whose data changed
+ * @param dj Reduced costs
+ * @param status Variable status
+ */
+void cxf_pricing_heap_touch(PricingContext *ctx, int j, const double *dj,
+                            const int *status) {
+    if (ctx == NULL || !ctx->heap_ready || j < 0 || j >= ctx->num_vars) {
+        return;
+    }
+    double key = (status[j] < 0) ? heap_key(ctx, j, dj, status) : -1.0;
+    double old = ctx->heap_key[j];
+    int pos = ctx->heap_pos[j];
+    ctx->heap_key[j] = key;
+
+    if (pos < 0) {
+        if (key >= 0.0) {
+            heap_place(ctx, ctx->heap_size++, j);
+            sift_up(ctx, ctx->heap_size - 1);
+        }
+        return;
+    }
+    if (key < 0.0) {
+        /* Remove: the last entry takes j's place */
+        int last = ctx->heap[--ctx->heap_size];
+        ctx->heap_pos[j] = -1;
+        if (last != j) {
+            heap_place(ctx, pos, last);
+            sift_up(ctx, pos);
+            sift_down(ctx, ctx->heap_pos[last]);
+        }
+        return;
+    }
+    if (key > old) {
+        sift_up(ctx, pos);
+    } else if (key < old) {
+        sift_down(ctx, pos);
+    }
+}
+
+/**
+ * @brief The most attractive variable, or -1 if none is.
+ *
+ * @param ctx Pricing context with a ready heap
+ * @return Variable with the largest d_j^2 / w_j
+ */
+int cxf_pricing_heap_top(const PricingContext *ctx) {
+    if (ctx == NULL || !ctx->heap_ready || ctx->heap_size == 0) {
+        return -1;
+    }
+    return ctx->heap[0];
+}
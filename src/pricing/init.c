@@ -71,6 +71,18 @@ static int compute_level_size(int num_vars, int level, int strategy) {
     return size;
 }
 
+/**
+ * @brief Free the heap arrays of weighted pricing.
+ */
+static void free_heap(PricingContext *ctx) {
+    free(ctx->heap);
+    free(ctx->heap_pos);
+    free(ctx->heap_key);
+    ctx->heap = NULL;
+    ctx->heap_pos = NULL;
+    ctx->heap_key = NULL;
+}
+
 /*============================================================================
  * cxf_pricing_init - Full Implementation
  *===========================================================================*/
@@ -79,7 +91,8 @@ static int compute_level_size(int num_vars, int level, int strategy) {
  * @brief Initialize or reinitialize a pricing context for a new solve.
  *
  * Allocates candidate arrays based on strategy and problem size.
- * For steepest edge or Devex, allocates and initializes weight array.
+ * For steepest edge or Devex, allocates and initializes weight array,
+ * and for Devex the reference framework.
  *
  * @param ctx Pricing context (must be created with cxf_pricing_create)
  * @param num_vars Number of variables in the problem
@@ -118,6 +131,13 @@ int cxf_pricing_init(PricingContext *ctx, int num_vars, int strategy) {
     ctx->total_candidates_scanned = 0;
     ctx->level_escalations = 0;
     ctx->last_pivot_iteration = 0;
+    ctx->weights_ready = 0;
+    ctx->weight_pivots = 0;
+    ctx->weight_error = 0.0;
+    ctx->weight_resets = 0;
+    ctx->heap_size = 0;
+    ctx->heap_ready = 0;
+    ctx->heap_active = 1;
 
     /* Mark all caches as invalid */
     for (int i = 0; i < ctx->max_levels; i++) {
@@ -153,6 +173,9 @@ int cxf_pricing_init(PricingContext *ctx, int num_vars, int strategy) {
     /* Handle steepest edge / Devex weights */
     free(ctx->weights);
     ctx->weights = NULL;
+    free(ctx->reference);
+    ctx->reference = NULL;
+    free_heap(ctx);
 
     if (effective_strategy == STRATEGY_STEEPEST_EDGE ||
         effective_strategy == STRATEGY_DEVEX) {
@@ -168,12 +191,48 @@ int cxf_pricing_init(PricingContext *ctx, int num_vars, int strategy) {
                 return CXF_ERROR_OUT_OF_MEMORY;
             }
 
-            /* Initialize weights to 1.0 (unit reference frame) */
+            /* Unit reference frame until the solver sets them for the
+             * starting basis (weights_ready) */
             for (int j = 0; j < num_vars; j++) {
                 ctx->weights[j] = 1.0;
             }
         }
     }
 
+    /* Devex reference framework, set with the weights */
+    if (effective_strategy == STRATEGY_DEVEX && num_vars > 0) {
+        ctx->reference = (unsigned char *)calloc((size_t)num_vars, 1);
+        if (ctx->reference == NULL) {
+            free(ctx->weights);
+            ctx->weights = NULL;
+            for (int i = 0; i < ctx->max_levels; i++) {
+                free(ctx->candidate_arrays[i]);
+                ctx->candidate_arrays[i] = NULL;
+                ctx->candidate_sizes[i] = 0;
+            }
+            return CXF_ERROR_OUT_OF_MEMORY;
+        }
+    }
+
+    /* Heap of the attractive variables for weighted pricing */
+    if (ctx->weights != NULL) {
+        ctx->heap = (int *)malloc((size_t)num_vars * sizeof(int));
+        ctx->heap_pos = (int *)malloc((size_t)num_vars * sizeof(int));
+        ctx->heap_key = (double *)malloc((size_t)num_vars * sizeof(double));
+        if (ctx->heap == NULL || ctx->heap_pos == NULL || ctx->heap_key == NULL) {
+            free_heap(ctx);
+            free(ctx->weights);
+            ctx->weights = NULL;
+            free(ctx->reference);
+            ctx->reference = NULL;
+            for (int i = 0; i < ctx->max_levels; i++) {
+                free(ctx->candidate_arrays[i]);
+                ctx->candidate_arrays[i] = NULL;
+                ctx->candidate_sizes[i] = 0;
+            }
+            return CXF_ERROR_OUT_OF_MEMORY;
+        }
+    }
+
     return CXF_OK;
 }
@@ -10,12 +10,7 @@
 #include <math.h>
 #include "convexfeld/cxf_types.h"
 #include "convexfeld/cxf_pricing.h"
-
-/* Variable status codes */
-#define VAR_BASIC        0   /* Basic variable */
-#define VAR_AT_LOWER    -1   /* Nonbasic at lower bound */
-#define VAR_AT_UPPER    -2   /* Nonbasic at upper bound */
-#define VAR_FREE        -3   /* Free (superbasic) */
+#include "convexfeld/cxf_kernels.h"
 
 /**
  * @brief Full scan for any attractive variable (phase 2 / fallback).
@@ -40,41 +35,10 @@ int cxf_pricing_step2(PricingContext *ctx, const double *reduced_costs,
         return -1;
     }
 
-    /* Full scan of all nonbasic variables */
-    double best_violation = 0.0;
-    int best_var = -1;
-
-    for (int j = 0; j < num_vars; j++) {
-        /* Skip basic variables */
-        if (var_status[j] >= 0) {
-            continue;
-        }
-
-        double rc = reduced_costs[j];
-
-        /* Check attractiveness based on bound status */
-        if (var_status[j] == VAR_AT_LOWER && rc < -tolerance) {
-            /* At lower bound with negative RC: can increase */
-            double violation = -rc;
-            if (violation > best_violation) {
-                best_violation = violation;
-                best_var = j;
-            }
-        } else if (var_status[j] == VAR_AT_UPPER && rc > tolerance) {
-            /* At upper bound with positive RC: can decrease */
-            if (rc > best_violation) {
-                best_violation = rc;
-                best_var = j;
-            }
-        } else if (var_status[j] == VAR_FREE) {
-            /* Free variable: attractive if |RC| > tolerance */
-            double abs_rc = (rc < 0) ? -rc : rc;
-            if (abs_rc > tolerance && abs_rc > best_violation) {
-                best_violation = abs_rc;
-                best_var = j;
-            }
-        }
-    }
+    /* Full scan of all nonbasic variables (vector kernel where the CPU
+     * has one, see src/kernels) */
+    int best_var = cxf_kernels()->price(reduced_costs, NULL, var_status,
+                                        num_vars, tolerance, NULL);
 
     /* Update statistics */
     if (ctx->total_candidates_scanned >= 0) {
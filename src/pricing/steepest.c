@@ -6,6 +6,12 @@
  * the steepest edge criterion. The SE ratio is |d_j| / sqrt(gamma_j) where
  * d_j is the reduced cost and gamma_j is the SE weight.
  *
+ * With a worker pool (ctx->pool) the scan is split into contiguous
+ * blocks of PRICE_SCAN_BLOCK variables. Each block keeps its best
+ * variable, and the blocks are reduced in order with the same score and
+ * a strict comparison, so ties still go to the smaller index and the
+ * choice is that of the sequential scan for any thread count.
+ *
  * Spec: docs/specs/functions/pricing/cxf_pricing_steepest.md
  */
 
@@ -13,16 +19,123 @@
 #include <math.h>
 #include "convexfeld/cxf_types.h"
 #include "convexfeld/cxf_pricing.h"
+#include "convexfeld/cxf_kernels.h"
+
+/* Worker pool (threading/pool.c) */
+extern void cxf_pool_run(CxfThreadPool *pool, int tasks,
+                         void (*fn)(void *arg, int task), void *arg);
 
-/* Variable status codes */
-#define VAR_BASIC        0   /* Basic variable (>= 0 indicates row) */
-#define VAR_AT_LOWER    -1   /* Nonbasic at lower bound */
-#define VAR_AT_UPPER    -2   /* Nonbasic at upper bound */
-#define VAR_FREE        -3   /* Free (superbasic) variable */
+/* Variables per task of a parallel scan (d_j, w_j and status of a block
+ * take 160 KB, about an L2) */
+#define PRICE_SCAN_BLOCK 8192
 
-/* Minimum acceptable weight to avoid division by zero */
+/* Most blocks of a parallel scan; larger problems use larger blocks */
+#define PRICE_SCAN_MAX_BLOCKS 256
+
+/* Minimum acceptable weight (as in the kernels) */
 #define MIN_WEIGHT 1e-10
 
+/**
+ * @brief One parallel pricing scan, split into blocks.
+ */
+typedef struct {
+    const double *dj;
+    const double *weights;
+    const int *status;
+    int num_vars;
+    int block_size;
+    double tol;
+    int best[PRICE_SCAN_MAX_BLOCKS];    /**< Best variable per block, -1 for none */
+    int scanned[PRICE_SCAN_MAX_BLOCKS]; /**< Nonbasic variables per block */
+} PriceScan;
+
+static void price_scan_task(void *arg, int block) {
+    PriceScan *scan = (PriceScan *)arg;
+    int j0 = block * scan->block_size;
+    int count = (scan->num_vars - j0 > scan->block_size) ?
+                scan->block_size : scan->num_vars - j0;
+    int best = cxf_kernels()->price(scan->dj + j0,
+                                    scan->weights ? scan->weights + j0 : NULL,
+                                    scan->status + j0, count, scan->tol,
+                                    &scan->scanned[block]);
+    scan->best[block] = (best >= 0) ? j0 + best : -1;
+}
+
+/**
+ * @brief Score of an attractive variable, as computed by the kernels.
+ */
+static double price_score(const double *dj, const double *weights,
+                          const int *status, int j) {
+    double d = dj[j];
+    double score = (status[j] == -1) ? -d : (status[j] == -2) ? d : fabs(d);
+    if (weights != NULL) {
+        double w = weights[j];
+        score /= sqrt((w < MIN_WEIGHT) ? 1.0 : w);
+    }
+    return score;
+}
+
+/**
+ * @brief Pricing scan over the pool: the kernel per block, then the
+ *        block winners in order.
+ */
+static int price_parallel(CxfThreadPool *pool, const double *dj,
+                          const double *weights, const int *status,
+                          int num_vars, double tol, int *scanned) {
+    PriceScan scan;
+    scan.dj = dj;
+    scan.weights = weights;
+    scan.status = status;
+    scan.num_vars = num_vars;
+    scan.tol = tol;
+    scan.block_size = PRICE_SCAN_BLOCK;
+    while ((num_vars + scan.block_size - 1) / scan.block_size > PRICE_SCAN_MAX_BLOCKS) {
+        scan.block_size *= 2;
+    }
+    int blocks = (num_vars + scan.block_size - 1) / scan.block_size;
+
+    cxf_pool_run(pool, blocks, price_scan_task, &scan);
+
+    int best_var = -1;
+    double best_score = 0.0;
+    *scanned = 0;
+    for (int b = 0; b < blocks; b++) {
+        *scanned += scan.scanned[b];
+        int j = scan.best[b];
+        if (j < 0) continue;
+        double score = price_score(dj, weights, status, j);
+        if (score > best_score) {
+            best_score = score;
+            best_var = j;
+        }
+    }
+    return best_var;
+}
+
+/**
+ * @brief Pricing scan, split over ctx->pool when it has several blocks.
+ */
+static int pricing_scan(PricingContext *ctx, const double *reduced_costs,
+                        const double *weights, const int *var_status,
+                        int num_vars, double tolerance) {
+    int candidates_scanned = 0;
+    int best_var;
+    if (ctx->pool != NULL && num_vars > PRICE_SCAN_BLOCK) {
+        best_var = price_parallel(ctx->pool, reduced_costs, weights, var_status,
+                                  num_vars, tolerance, &candidates_scanned);
+    } else {
+        /* Vector scan where the CPU has one (src/kernels) */
+        best_var = cxf_kernels()->price(reduced_costs, weights, var_status,
+                                        num_vars, tolerance, &candidates_scanned);
+    }
+
+    /* Update statistics if context tracking is enabled */
+    if (ctx->total_candidates_scanned >= 0) {
+        ctx->total_candidates_scanned += candidates_scanned;
+    }
+    return best_var;
+}
+
 /**
  * @brief Select entering variable using steepest edge pricing.
  *
@@ -56,64 +169,8 @@ int cxf_pricing_steepest(PricingContext *ctx, const double *reduced_costs,
         return -1;
     }
 
-    int best_var = -1;
-    double best_ratio = 0.0;
-    int candidates_scanned = 0;
-
-    for (int j = 0; j < num_vars; j++) {
-        int status = var_status[j];
-
-        /* Skip basic variables */
-        if (status >= 0) {
-            continue;
-        }
-
-        candidates_scanned++;
-        double rc = reduced_costs[j];
-        double abs_rc = (rc < 0) ? -rc : rc;
-
-        /* Check if variable is attractive based on status */
-        int attractive = 0;
-        if (status == VAR_AT_LOWER) {
-            /* At lower bound: attractive if RC < -tolerance (can increase) */
-            if (rc < -tolerance) {
-                attractive = 1;
-            }
-        } else if (status == VAR_AT_UPPER) {
-            /* At upper bound: attractive if RC > tolerance (can decrease) */
-            if (rc > tolerance) {
-                attractive = 1;
-            }
-        } else if (status == VAR_FREE) {
-            /* Free variable: attractive if |RC| > tolerance (can move either way) */
-            if (abs_rc > tolerance) {
-                attractive = 1;
-            }
-        }
-
-        if (attractive) {
-            /* Get weight, using safeguard for zero/negative weights */
-            double weight = weights[j];
-            if (weight < MIN_WEIGHT) {
-                weight = 1.0;  /* Default weight assumption */
-            }
-
-            /* Compute SE ratio: |reduced_cost| / sqrt(weight) */
-            double ratio = abs_rc / sqrt(weight);
-
-            if (ratio > best_ratio) {
-                best_ratio = ratio;
-                best_var = j;
-            }
-        }
-    }
-
-    /* Update statistics if context tracking is enabled */
-    if (ctx->total_candidates_scanned >= 0) {
-        ctx->total_candidates_scanned += candidates_scanned;
-    }
-
-    return best_var;
+    return pricing_scan(ctx, reduced_costs, weights, var_status,
+                        num_vars, tolerance);
 }
 
 /**
@@ -17,60 +17,114 @@
 #define CXF_INVALID_WEIGHTS        0x04
 #define CXF_INVALID_ALL            0xFF
 
-/* Minimum weight to prevent division by zero */
-#define MIN_WEIGHT 1e-10
+/* Pricing strategy constants */
+#define STRATEGY_STEEPEST_EDGE 2
+#define STRATEGY_DEVEX         3
+
+/* Weights at or above this are frozen (see cxf_pricing_update) */
+#define FROZEN_WEIGHT CXF_INFINITY
+
+/**
+ * @brief Record how far the updated weight of q is from its exact value.
+ *
+ * weight_error keeps the largest max(w / exact, exact / w) - 1.
+ */
+static void track_weight_error(PricingContext *ctx, double updated, double exact) {
+    if (updated >= FROZEN_WEIGHT || updated <= 0.0) {
+        return;
+    }
+    double ratio = (updated > exact) ? updated / exact : exact / updated;
+    if (ratio - 1.0 > ctx->weight_error) {
+        ctx->weight_error = ratio - 1.0;
+    }
+}
 
 /**
  * @brief Update pricing context after a pivot operation.
  *
- * Updates steepest edge weights if SE pricing is active.
- * Invalidates cached candidate lists.
+ * For steepest edge the weights gamma_j = 1 + ||B^(-1) a_j||^2 follow the
+ * Goldfarb-Reid recurrence. With alpha_j = alpha_rj / alpha_rq from the
+ * pivot row and the old basis B,
+ *
+ *   gamma_j <- max(gamma_j - 2 alpha_j a_j^T B^(-T) alpha_q
+ *                  + alpha_j^2 gamma_q, 1 + alpha_j^2)
+ *   gamma_p <- max(gamma_q / alpha_rq^2, 1)
+ *
+ * for the nonbasic j and the leaving variable p. The products
+ * a_j^T B^(-T) alpha_q cost the caller one extra BTRAN of the pivot
+ * column. The exact gamma_q is known from the FTRAN'd column; its
+ * distance to the updated weight is kept in weight_error as the drift
+ * measure that triggers an exact recomputation.
+ *
+ * Devex (Forrest-Goldfarb) measures the edges only in a reference
+ * framework of variables, and needs the pivot row alone:
  *
- * Full reduced cost update requires solver state access, which is
- * deferred until SolverContext integration.
+ *   w_j <- max(w_j, alpha_j^2 w_q)
+ *   w_p <- max(w_q / alpha_rq^2, 1)
+ *
+ * Here gamma_entering is the exact reference weight of q, computed by
+ * the caller from the pivot column; weight_error against it tells the
+ * caller when to reset the framework.
+ *
+ * Weights of at least CXF_INFINITY are frozen: the caller uses them to
+ * keep fixed nonbasic variables out of the selection.
+ *
+ * Cached candidate lists are invalidated and the pivot counter advances
+ * for every strategy.
  *
  * @param ctx Pricing context
- * @param entering_var Index of entering variable
- * @param leaving_row Leaving row index
- * @param pivot_column FTRAN result for entering column [num_rows]
- * @param pivot_row BTRAN result for leaving row (unused currently)
- * @param num_rows Number of rows in basis
+ * @param entering_var Entering variable q
+ * @param leaving_var Leaving variable p
+ * @param pivot_elem Pivot element alpha_rq
+ * @param gamma_entering Exact weight of q (1 + ||alpha_q||^2, or for
+ *                       Devex its reference weight), or <= 0 to use the
+ *                       stored weight of q
+ * @param pivot_row Row alpha_r over the nonbasic variables of the old
+ *                  basis (sparse accumulator), or NULL
+ * @param edge_dots a_j^T B^(-T) alpha_q at the indices of pivot_row
+ *                  (steepest edge only), or NULL
  * @return CXF_OK on success, error code on failure
  */
-int cxf_pricing_update(PricingContext *ctx, int entering_var, int leaving_row,
-                       const double *pivot_column, const double *pivot_row,
-                       int num_rows) {
+int cxf_pricing_update(PricingContext *ctx, int entering_var, int leaving_var,
+                       double pivot_elem, double gamma_entering,
+                       const VectorContainer *pivot_row,
+                       const VectorContainer *edge_dots) {
     if (ctx == NULL) {
         return CXF_ERROR_NULL_ARGUMENT;
     }
 
-    /* Get pivot element */
-    double pivot_elem = 1.0;
-    if (pivot_column != NULL && leaving_row >= 0 && leaving_row < num_rows) {
-        pivot_elem = pivot_column[leaving_row];
-    }
-
-    /* Update steepest edge weights if using SE strategy */
-    if (ctx->strategy == 2 && ctx->weights != NULL && pivot_column != NULL) {
-        /* SE weight for entering variable (now basic) */
-        double gamma_entering = ctx->weights[entering_var];
-        double pivot_sq = pivot_elem * pivot_elem;
-
-        /* Avoid division by zero */
-        if (pivot_sq < MIN_WEIGHT) {
-            pivot_sq = MIN_WEIGHT;
+    int weighted = (ctx->weights != NULL && pivot_row != NULL && pivot_elem != 0.0 &&
+                    entering_var >= 0 && entering_var < ctx->num_vars &&
+                    leaving_var >= 0 && leaving_var < ctx->num_vars);
+    int steepest = weighted && ctx->strategy == STRATEGY_STEEPEST_EDGE && edge_dots != NULL;
+    int devex = weighted && ctx->strategy == STRATEGY_DEVEX;
+
+    if (steepest || devex) {
+        double *w = ctx->weights;
+        double gamma_q = w[entering_var];
+        if (gamma_entering > 0.0) {
+            track_weight_error(ctx, gamma_q, gamma_entering);
+            gamma_q = gamma_entering;
         }
 
-        /* tau = gamma_entering / pivot_sq would be used in full SE update */
-        (void)gamma_entering;  /* Suppress warning until full SE update */
-
-        /* Update weights for nonbasic variables */
-        /* Note: Full update requires alpha_j for each variable j,
-         * which needs matrix access. For now, we just ensure
-         * the entering variable's weight is handled. */
+        for (int k = 0; k < pivot_row->size; k++) {
+            int j = pivot_row->indices[k];
+            if (j == entering_var || w[j] >= FROZEN_WEIGHT) continue;
+            double a = pivot_row->values[j] / pivot_elem;
+            if (devex) {
+                double t = a * a * gamma_q;
+                if (t > w[j]) w[j] = t;
+                continue;
+            }
+            double gamma = w[j] - 2.0 * a * edge_dots->values[j] + a * a * gamma_q;
+            double floor = 1.0 + a * a;
+            w[j] = (gamma > floor) ? gamma : floor;
+        }
 
-        /* Weight for entering variable is no longer needed (now basic) */
-        ctx->weights[entering_var] = 1.0;  /* Reset for when it leaves basis */
+        double gamma_p = gamma_q / (pivot_elem * pivot_elem);
+        w[leaving_var] = (gamma_p > 1.0) ? gamma_p : 1.0;
+        w[entering_var] = 1.0;  /* Basic; set again when it leaves */
+        ctx->weight_pivots++;
     }
 
     /* Invalidate all cached candidate counts */
@@ -81,9 +135,6 @@ int cxf_pricing_update(PricingContext *ctx, int entering_var, int leaving_row,
     /* Update iteration counter */
     ctx->last_pivot_iteration++;
 
-    /* Suppress unused parameter warnings */
-    (void)pivot_row;
-
     return CXF_OK;
 }
 
@@ -111,14 +162,20 @@ void cxf_pricing_invalidate(PricingContext *ctx, int flags) {
 
     /* Invalidate weights - mark for full recomputation */
     if (flags & CXF_INVALID_WEIGHTS) {
-        /* Full weight recomputation will happen on next SE pricing call.
-         * For now, weights array remains allocated but values are stale. */
+        /* The solver recomputes the weights before the next SE pricing
+         * call; until then 1.0 is the safe default. */
         if (ctx->weights != NULL && ctx->num_vars > 0) {
             /* Reset to 1.0 as safe default */
             for (int i = 0; i < ctx->num_vars; i++) {
                 ctx->weights[i] = 1.0;
             }
         }
+        ctx->weights_ready = 0;
+    }
+
+    /* The heap is keyed by the reduced costs and weights */
+    if (flags & (CXF_INVALID_REDUCED_COSTS | CXF_INVALID_WEIGHTS)) {
+        ctx->heap_ready = 0;
     }
 
     /* Handle CXF_INVALID_ALL - invalidate everything */
@@ -132,5 +189,6 @@ void cxf_pricing_invalidate(PricingContext *ctx, int flags) {
                 ctx->weights[i] = 1.0;
             }
         }
+        ctx->weights_ready = 0;
     }
 }
@@ -8,6 +8,7 @@
 #include "convexfeld/cxf_solver.h"
 #include "convexfeld/cxf_model.h"
 #include "convexfeld/cxf_basis.h"
+#include "convexfeld/cxf_matrix.h"
 #include "convexfeld/cxf_pricing.h"
 #include "convexfeld/cxf_types.h"
 #include "convexfeld/cxf_env.h"
@@ -20,10 +21,42 @@
 /* Default optimality tolerance */
 #define DEFAULT_TOLERANCE 1e-6
 
+/* Fewest variables (n + m) for which the parallel kernels get a worker
+ * pool: below two blocks of theirs they run sequentially anyway */
+#define POOL_MIN_VARS 8192
+
 /* Forward declare basis creation */
 extern BasisState *cxf_basis_create(int m, int n);
 extern void cxf_basis_free(BasisState *basis);
 
+/* Sparse accumulator lifecycle (memory/vectors.c) */
+extern VectorContainer *cxf_vector_create(int dim);
+extern void cxf_vector_free(VectorContainer *vec);
+
+/* Row-major copy of the matrix (matrix/row_major.c) */
+extern int cxf_prepare_row_data(SparseMatrix *mat);
+extern int cxf_build_row_major(SparseMatrix *mat);
+extern void cxf_sparse_free_csr(SparseMatrix *mat);
+
+/* Row-wise PRICE copy (matrix/price.c) */
+extern PriceRows *cxf_price_rows_create(const SparseMatrix *matrix);
+extern void cxf_price_rows_free(PriceRows *rows);
+
+/* Pricing context lifecycle (pricing/context.c, pricing/init.c) */
+extern PricingContext *cxf_pricing_create(int num_vars, int max_levels);
+extern int cxf_pricing_init(PricingContext *ctx, int num_vars, int strategy);
+extern void cxf_pricing_free(PricingContext *ctx);
+
+/* Worker pool (threading/pool.c, threading/config.c) */
+extern CxfThreadPool *cxf_pool_create(int threads);
+extern void cxf_pool_free(CxfThreadPool *pool);
+extern int cxf_get_threads(CxfEnv *env);
+extern int cxf_get_physical_cores(void);
+
+/* Scratch arena lifecycle (memory/scratch.c) */
+extern int cxf_scratch_init(ScratchArena *arena, size_t initial_size);
+extern void cxf_scratch_free(ScratchArena *arena);
+
 /**
  * @brief Create and initialize solver context.
  *
@@ -57,7 +90,7 @@ int cxf_simplex_init(CxfModel *model, SolverContext **stateP) {
 
     /* Initialize state */
     ctx->phase = 0;
-    ctx->solve_mode = 0;  /* Primal simplex */
+    ctx->solve_mode = (model->env != NULL) ? model->env->method : 0;
     ctx->max_iterations = DEFAULT_MAX_ITERATIONS;
     ctx->tolerance = DEFAULT_TOLERANCE;
     ctx->obj_value = 0.0;
@@ -110,9 +143,12 @@ int cxf_simplex_init(CxfModel *model, SolverContext **stateP) {
         }
 
         /* Allocate iteration work arrays (preallocated to avoid malloc per iter) */
-        ctx->work_column = (double *)malloc((size_t)m * sizeof(double));
+        ctx->work_column = cxf_vector_create(m);
         ctx->work_cB = (double *)malloc((size_t)m * sizeof(double));
-        if (ctx->work_column == NULL || ctx->work_cB == NULL) {
+        ctx->work_rho = (double *)malloc((size_t)m * sizeof(double));
+        ctx->work_alpha = cxf_vector_create(total_vars);
+        if (ctx->work_column == NULL || ctx->work_cB == NULL ||
+            ctx->work_rho == NULL || ctx->work_alpha == NULL) {
             cxf_simplex_final(ctx);
             return CXF_ERROR_OUT_OF_MEMORY;
         }
@@ -125,8 +161,91 @@ int cxf_simplex_init(CxfModel *model, SolverContext **stateP) {
         return CXF_ERROR_OUT_OF_MEMORY;
     }
 
-    /* Pricing context created on demand */
+    if (ctx->basis != NULL && model->env != NULL) {
+        ctx->basis->update_method = model->env->basis_update;
+        ctx->basis->rowwise_factors = model->env->rowwise_factors;
+        ctx->basis->mixed_precision = model->env->mixed_precision;
+    }
+
+    /* Scratch arena sized for a few m-vectors; it grows on first demand */
+    if (cxf_scratch_init(&ctx->scratch, (size_t)m * 4 * sizeof(double)) != CXF_OK) {
+        cxf_simplex_final(ctx);
+        return CXF_ERROR_OUT_OF_MEMORY;
+    }
+    if (ctx->basis != NULL) {
+        ctx->basis->scratch = &ctx->scratch;
+    }
+
+    /* Pricing context for SimplexPricing (strategy = SimplexPricing + 1,
+     * auto runs Devex). Steepest edge needs two more work vectors. */
     ctx->pricing = NULL;
+    if (model->env != NULL && m > 0 && total_vars > 0) {
+        int strategy = (model->env->simplex_pricing >= 0) ?
+                       model->env->simplex_pricing + 1 : 3;
+        ctx->pricing = cxf_pricing_create(total_vars, 3);
+        if (ctx->pricing == NULL ||
+            cxf_pricing_init(ctx->pricing, total_vars, strategy) != CXF_OK) {
+            cxf_simplex_final(ctx);
+            return CXF_ERROR_OUT_OF_MEMORY;
+        }
+        if (ctx->pricing->strategy == 2) {
+            ctx->work_tau = (double *)malloc((size_t)m * sizeof(double));
+            ctx->work_edge = cxf_vector_create(total_vars);
+            if (ctx->work_tau == NULL || ctx->work_edge == NULL) {
+                cxf_simplex_final(ctx);
+                return CXF_ERROR_OUT_OF_MEMORY;
+            }
+        }
+        /* Partial pricing runs multiple pricing (multi_price.c) */
+        if (ctx->pricing->strategy == 1) {
+            ctx->minor_cols = (double *)malloc((size_t)CXF_MULTI_PRICE * (size_t)m * sizeof(double));
+            if (ctx->minor_cols == NULL) {
+                cxf_simplex_final(ctx);
+                return CXF_ERROR_OUT_OF_MEMORY;
+            }
+        }
+    }
+
+    /* Row-wise copies of A, rebuilt since the model may have changed after
+     * an earlier solve: the CSR of the matrix, and the copy partitioned by
+     * basis status for the pivot row PRICE. Without the latter PRICE falls
+     * back to the columns. */
+    SparseMatrix *A = model->matrix;
+    if (m > 0 && A != NULL && A->col_ptr != NULL) {
+        if (cxf_prepare_row_data(A) == CXF_OK &&
+            cxf_build_row_major(A) != CXF_OK) {
+            cxf_sparse_free_csr(A);
+        }
+        ctx->price_rows = cxf_price_rows_create(A);
+        if (ctx->price_rows == NULL) {
+            cxf_simplex_final(ctx);
+            return CXF_ERROR_OUT_OF_MEMORY;
+        }
+    }
+
+    /* Workers for PRICE, the reduced cost updates and the pricing scan:
+     * the thread count set (cxf_set_thread_count), or in auto mode one
+     * per physical core. The results do not depend on the count. */
+    int threads = cxf_get_threads(model->env);
+    if (threads == 0) {
+        threads = cxf_get_physical_cores();
+    }
+    if (threads > 1 && total_vars >= POOL_MIN_VARS) {
+        ctx->pool = cxf_pool_create(threads);
+        if (ctx->price_rows != NULL) {
+            ctx->price_rows->pool = ctx->pool;
+        }
+        if (ctx->pricing != NULL) {
+            ctx->pricing->pool = ctx->pool;
+        }
+    }
+
+    /* Timing statistics, including the refactorization decisions */
+    ctx->timing = (TimingState *)calloc(1, sizeof(TimingState));
+    if (ctx->timing == NULL) {
+        cxf_simplex_final(ctx);
+        return CXF_ERROR_OUT_OF_MEMORY;
+    }
 
     /* Initialize tracking fields */
     ctx->eta_count = 0;
@@ -134,6 +253,10 @@ int cxf_simplex_init(CxfModel *model, SolverContext **stateP) {
     ctx->total_ftran_time = 0.0;
     ctx->ftran_count = 0;
     ctx->baseline_ftran = 0.0;
+    ctx->refactor_cost = 0.0;
+    ctx->pivot_residual = 0.0;
+    ctx->basis_cond = 0.0;
+    ctx->pivot_tol = 0.0;
 
     *stateP = ctx;
     return CXF_OK;
@@ -157,14 +280,22 @@ void cxf_simplex_final(SolverContext *state) {
     free(state->work_pi);
     free(state->work_dj);
     free(state->work_counter);
-    free(state->work_column);
+    cxf_vector_free(state->work_column);
     free(state->work_cB);
+    free(state->work_rho);
+    cxf_vector_free(state->work_alpha);
+    cxf_price_rows_free(state->price_rows);
 
-    /* Free basis */
+    /* Free basis, then the scratch arena it borrowed */
     cxf_basis_free(state->basis);
-
-    /* Free pricing context if allocated */
-    /* Note: pricing context free not implemented yet */
+    cxf_scratch_free(&state->scratch);
+
+    /* Free pricing context and its work vectors */
+    cxf_pricing_free(state->pricing);
+    free(state->work_tau);
+    cxf_vector_free(state->work_edge);
+    free(state->minor_cols);
+    cxf_pool_free(state->pool);
 
     /* Free timing if allocated */
     free(state->timing);
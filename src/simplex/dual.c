@@ -0,0 +1,834 @@
+/**
+ * @file dual.c
+ * @brief Bounded dual simplex (solve_mode 1, parameter Method = 1).
+ *
+ * The dual simplex keeps the reduced costs dual feasible and drives the
+ * primal infeasibilities of the basic variables out one row at a time:
+ *
+ * - CHUZR picks the leaving row by dual steepest edge, infeasibility^2
+ *   over ||e_r^T B^(-1)||^2, with the weights updated each pivot from one
+ *   extra FTRAN (Forrest-Goldfarb).
+ * - The pivot row alpha_r = e_r^T B^(-1) A_N comes from one BTRAN and
+ *   the PRICE kernel of matrix/price.c, which works row-wise while
+ *   e_r^T B^(-1) is sparse.
+ * - The ratio test is the bound-flipping (long-step) test: boxed
+ *   variables whose breakpoint is passed while the dual objective still
+ *   improves are flipped to their opposite bound instead of entering, and
+ *   a Harris pass picks the largest pivot among the remaining ties.
+ * - Dual Phase I solves the auxiliary problem min c^T x, A x = 0 with
+ *   every variable boxed (free in [-1000, 1000], one-sided in [0, 1] or
+ *   [-1, 0], boxed in [0, 0]) by the same Phase II loop; its optimal basis
+ *   is dual feasible for the original problem unless the problem itself
+ *   is dual infeasible.
+ *
+ * Slacks enter as A x + s = b with s in [0, inf) for <= rows, (-inf, 0]
+ * for >= rows and [0, 0] for equality rows, so every slack column is +e_i.
+ * The costs are perturbed against dual degeneracy; after the perturbation
+ * is removed, boxed variables that lost dual feasibility are flipped and
+ * the dual loop resumes. A run that cannot finish cleanly (dual infeasible
+ * problem, persistent numerical trouble) reports CXF_INF_OR_UNBD or
+ * CXF_NUMERIC and cxf_solve_lp falls back to the primal simplex.
+ *
+ * The basis, factors, FTRAN/BTRAN, basis updates and the refactorization
+ * schedule are those of the primal simplex.
+ */
+
+#include "convexfeld/cxf_solver.h"
+#include "convexfeld/cxf_basis.h"
+#include "convexfeld/cxf_env.h"
+#include "convexfeld/cxf_model.h"
+#include "convexfeld/cxf_matrix.h"
+#include "convexfeld/cxf_timing.h"
+#include "convexfeld/cxf_types.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* Smallest |alpha_rj| a ratio test candidate may have */
+#define DUAL_PIVOT_TOL 1e-7
+
+/* Half-width of the box for free variables in the dual Phase I problem */
+#define DUAL_FREE_BOX 1000.0
+
+/* Smallest dual steepest-edge weight */
+#define DSE_MIN_WEIGHT 1e-6
+
+/* Relative size of the cost perturbation */
+#define DUAL_PERTURB 5e-7
+
+/* Relative pivot residual above which the factors are renewed first */
+#define DUAL_PIVOT_RESIDUAL 1e-6
+
+/* Dual loops after removing the perturbation before giving up */
+#define DUAL_MAX_ROUNDS 3
+
+/* External declarations */
+extern int cxf_ftran(BasisState *basis, const double *column, double *result);
+extern int cxf_ftran_sparse(BasisState *basis, VectorContainer *x);
+extern int cxf_btran(BasisState *basis, int row, double *result);
+extern int cxf_btran_vec(BasisState *basis, const double *input, double *result);
+extern void cxf_vector_clear(VectorContainer *vec);
+extern int cxf_pivot_with_eta_sparse(BasisState *basis, int pivotRow,
+                                     const VectorContainer *pivotCol,
+                                     int enteringVar, int leavingVar);
+extern int cxf_simplex_refactor(SolverContext *state, CxfEnv *env, int cause);
+extern int cxf_price_row(PriceRows *rows, const SparseMatrix *matrix,
+                         const int *var_status, const double *slack_coeff,
+                         const double *rho, VectorContainer *alpha);
+extern void cxf_price_rows_set_basic(PriceRows *rows, int var, int basic);
+extern void cxf_price_rows_sync(PriceRows *rows, const int *var_status);
+extern int cxf_timing_refactor_cause(SolverContext *state, CxfEnv *env);
+extern void cxf_timing_basis_update(SolverContext *state);
+
+/**
+ * @brief Ratio test candidate.
+ */
+typedef struct {
+    double ratio;   /**< Dual step at which d_j reaches zero */
+    double alpha;   /**< |alpha_rj| */
+    int j;          /**< Variable */
+} DualCandidate;
+
+/**
+ * @brief Dual simplex workspace.
+ */
+typedef struct {
+    SolverContext *state;
+    CxfEnv *env;
+    const SparseMatrix *A;
+    int n;                    /**< Structural variables */
+    int m;                    /**< Rows */
+    int total;                /**< n + m */
+    double *cost;             /**< Unperturbed costs [total] */
+    double *weight;           /**< DSE weights by basis position [m] */
+    double *rho;              /**< Row r of B^(-1) [m] */
+    double *tau;              /**< B^(-1) rho [m] */
+    double *flip;             /**< Bound flip column, then its FTRAN [m] */
+    double *flip_x;           /**< FTRAN result of the flip column [m] */
+    VectorContainer *alpha;   /**< Pivot row over the nonbasic variables (state->work_alpha) */
+    double *save_lb;          /**< Original bounds during dual Phase I [total] */
+    double *save_ub;          /**< [total] */
+    DualCandidate *cand;      /**< Ratio test candidates [total] */
+} DualWork;
+
+static int is_fixed(const SolverContext *state, int j) {
+    return state->work_ub[j] - state->work_lb[j] <= CXF_ZERO_TOL;
+}
+
+/**
+ * @brief Slack basis with +e_i slack columns and sense-dependent bounds.
+ */
+static void set_slack_basis(DualWork *w) {
+    SolverContext *state = w->state;
+    BasisState *basis = state->basis;
+    int n = w->n;
+
+    for (int i = 0; i < w->m; i++) {
+        int s = n + i;
+        char sense = (w->A->sense != NULL) ? w->A->sense[i] : '<';
+        if (sense == '>' || sense == 'G') {
+            state->work_lb[s] = -CXF_INFINITY;
+            state->work_ub[s] = 0.0;
+        } else if (sense == '<' || sense == 'L') {
+            state->work_lb[s] = 0.0;
+            state->work_ub[s] = CXF_INFINITY;
+        } else {
+            state->work_lb[s] = 0.0;
+            state->work_ub[s] = 0.0;
+        }
+        basis->diag_coeff[i] = 1.0;
+        basis->basic_vars[i] = s;
+        basis->var_status[s] = i;
+        w->weight[i] = 1.0;  /* Exact for B = I */
+    }
+    for (int j = 0; j < n; j++) {
+        basis->var_status[j] = -1;
+    }
+    state->num_artificials = 0;
+}
+
+/**
+ * @brief Put each nonbasic variable at the bound its reduced cost prefers.
+ *
+ * Free variables sit at zero.
+ */
+static void place_nonbasic(DualWork *w) {
+    SolverContext *state = w->state;
+    int *status = state->basis->var_status;
+
+    for (int j = 0; j < w->total; j++) {
+        if (status[j] >= 0) continue;
+        double lb = state->work_lb[j];
+        double ub = state->work_ub[j];
+        if (lb > -CXF_INFINITY && (state->work_dj[j] >= 0.0 || ub >= CXF_INFINITY)) {
+            status[j] = -1;
+            state->work_x[j] = lb;
+        } else if (ub < CXF_INFINITY) {
+            status[j] = -2;
+            state->work_x[j] = ub;
+        } else {
+            status[j] = -1;
+            state->work_x[j] = 0.0;
+        }
+    }
+}
+
+/**
+ * @brief pi = B^(-T) c_B and d_j = c_j - pi^T a_j for the nonbasic j.
+ */
+static int compute_duals(DualWork *w) {
+    SolverContext *state = w->state;
+    BasisState *basis = state->basis;
+    const SparseMatrix *A = w->A;
+    int n = w->n;
+
+    for (int i = 0; i < w->m; i++) {
+        state->work_cB[i] = state->work_obj[basis->basic_vars[i]];
+    }
+    int rc = cxf_btran_vec(basis, state->work_cB, state->work_pi);
+    if (rc != CXF_OK) return rc;
+
+    for (int j = 0; j < w->total; j++) {
+        if (basis->var_status[j] >= 0) {
+            state->work_dj[j] = 0.0;
+            continue;
+        }
+        double dj = state->work_obj[j];
+        if (j < n) {
+            for (int64_t k = A->col_ptr[j]; k < A->col_ptr[j + 1]; k++) {
+                dj -= state->work_pi[A->row_idx[k]] * A->values[k];
+            }
+        } else {
+            dj -= state->work_pi[j - n];
+        }
+        state->work_dj[j] = dj;
+    }
+    return CXF_OK;
+}
+
+/**
+ * @brief x_B = B^(-1) (b - N x_N), with b = 0 for the Phase I problem.
+ */
+static int compute_primal(DualWork *w, int with_rhs) {
+    SolverContext *state = w->state;
+    BasisState *basis = state->basis;
+    const SparseMatrix *A = w->A;
+    int n = w->n;
+    double *rhs = w->flip;
+
+    for (int i = 0; i < w->m; i++) {
+        rhs[i] = (with_rhs && A->rhs != NULL) ? A->rhs[i] : 0.0;
+    }
+    for (int j = 0; j < w->total; j++) {
+        double xj = state->work_x[j];
+        if (basis->var_status[j] >= 0 || xj == 0.0) continue;
+        if (j < n) {
+            for (int64_t k = A->col_ptr[j]; k < A->col_ptr[j + 1]; k++) {
+                rhs[A->row_idx[k]] -= A->values[k] * xj;
+            }
+        } else {
+            rhs[j - n] -= xj;
+        }
+    }
+
+    int rc = cxf_ftran(basis, rhs, w->flip_x);
+    if (rc != CXF_OK) return rc;
+    for (int i = 0; i < w->m; i++) {
+        state->work_x[basis->basic_vars[i]] = w->flip_x[i];
+        rhs[i] = 0.0;
+    }
+    return CXF_OK;
+}
+
+/**
+ * @brief Restore dual feasibility where a bound flip can.
+ *
+ * A nonbasic variable whose reduced cost has the wrong sign for its bound
+ * moves to the other bound if it has one. With shift set, the cost of
+ * every other dual infeasible variable is shifted so that d_j = 0.
+ *
+ * @param flipped Output: number of variables moved to the other bound.
+ * @return Number of dual infeasibilities left (0 with shift set).
+ */
+static int repair_duals(DualWork *w, int shift, int *flipped) {
+    SolverContext *state = w->state;
+    const int *status = state->basis->var_status;
+    double tol = w->env->optimality_tol;
+    int left = 0;
+
+    *flipped = 0;
+    for (int j = 0; j < w->total; j++) {
+        if (status[j] >= 0 || is_fixed(state, j)) continue;
+        double dj = state->work_dj[j];
+        double lb = state->work_lb[j];
+        double ub = state->work_ub[j];
+        int at_lb = (status[j] == -1 && lb > -CXF_INFINITY);
+        int at_ub = (status[j] == -2);
+        int bad = (at_lb && dj < -tol) || (at_ub && dj > tol) ||
+                  (!at_lb && !at_ub && fabs(dj) > tol);
+        if (!bad) continue;
+
+        if (at_lb && ub < CXF_INFINITY) {
+            state->basis->var_status[j] = -2;
+            state->work_x[j] = ub;
+            (*flipped)++;
+        } else if (at_ub && lb > -CXF_INFINITY) {
+            state->basis->var_status[j] = -1;
+            state->work_x[j] = lb;
+            (*flipped)++;
+        } else if (shift) {
+            state->work_obj[j] -= dj;
+            state->work_dj[j] = 0.0;
+        } else {
+            left++;
+        }
+    }
+    return left;
+}
+
+/**
+ * @brief Perturb the costs of the nonbasic variables away from zero
+ *        reduced cost, in the direction that keeps them dual feasible.
+ */
+static void perturb_costs(DualWork *w) {
+    SolverContext *state = w->state;
+    const int *status = state->basis->var_status;
+    uint32_t seed = 0x9e3779b9u;
+
+    for (int j = 0; j < w->n; j++) {
+        seed = seed * 1664525u + 1013904223u;
+        if (status[j] >= 0 || is_fixed(state, j)) continue;
+        double r = 1.0 + (double)(seed >> 8) / (double)(1u << 24);
+        double delta = DUAL_PERTURB * (1.0 + fabs(w->cost[j])) * r;
+        if (status[j] == -1 && state->work_lb[j] > -CXF_INFINITY) {
+            state->work_obj[j] += delta;
+            state->work_dj[j] += delta;
+        } else if (status[j] == -2) {
+            state->work_obj[j] -= delta;
+            state->work_dj[j] -= delta;
+        }
+    }
+}
+
+/**
+ * @brief Refactor, then recompute x_B and d from scratch.
+ *
+ * Dual infeasibilities that drift or a basis repair introduced are
+ * removed by bound flips or, failing that, cost shifts.
+ */
+static int refactor(DualWork *w, int cause, int with_rhs) {
+    int rc = cxf_simplex_refactor(w->state, w->env, cause);
+    if (rc < 0 || rc == CXF_NUMERIC) return rc;
+
+    rc = compute_duals(w);
+    if (rc != CXF_OK) return rc;
+    int flipped;
+    repair_duals(w, 1, &flipped);
+    return compute_primal(w, with_rhs);
+}
+
+/**
+ * @brief CHUZR: basis position with the largest infeasibility^2 / weight.
+ *
+ * @param delta Output: x_B[r] minus the violated bound (< 0 below lb).
+ * @return Position, or -1 if the basis is primal feasible.
+ */
+static int choose_row(DualWork *w, double *delta) {
+    SolverContext *state = w->state;
+    const int *basic = state->basis->basic_vars;
+    double tol = w->env->feasibility_tol;
+    double best = 0.0;
+    int r = -1;
+
+    for (int i = 0; i < w->m; i++) {
+        int var = basic[i];
+        double x = state->work_x[var];
+        double infeas;
+        if (x < state->work_lb[var] - tol) {
+            infeas = x - state->work_lb[var];
+        } else if (x > state->work_ub[var] + tol) {
+            infeas = x - state->work_ub[var];
+        } else {
+            continue;
+        }
+        double score = infeas * infeas / w->weight[i];
+        if (score > best) {
+            best = score;
+            r = i;
+            *delta = infeas;
+        }
+    }
+    return r;
+}
+
+/**
+ * @brief Pivot row alpha_j = rho^T a_j over the nonbasic variables.
+ */
+static void compute_pivot_row(DualWork *w) {
+    SolverContext *state = w->state;
+    BasisState *basis = state->basis;
+
+    if (basis->pivots_since_refactor == 0) {
+        cxf_price_rows_sync(state->price_rows, basis->var_status);
+    }
+    cxf_price_row(state->price_rows, w->A, basis->var_status, NULL, w->rho,
+                  w->alpha);
+}
+
+static int compare_candidates(const void *a, const void *b) {
+    const DualCandidate *x = (const DualCandidate *)a;
+    const DualCandidate *y = (const DualCandidate *)b;
+    if (x->ratio < y->ratio) return -1;
+    if (x->ratio > y->ratio) return 1;
+    return (x->j > y->j) - (x->j < y->j);
+}
+
+/**
+ * @brief Bound-flipping dual ratio test.
+ *
+ * Candidates are the nonbasic variables whose reduced cost moves toward
+ * zero as the dual step grows. Walking them by ratio, each breakpoint
+ * lowers the slope of the dual objective by |alpha_j| (u_j - l_j); boxed
+ * variables are passed (and flipped) while the slope stays positive.
+ * Among the candidates from the stopping point on, a Harris pass with
+ * the optimality tolerance picks the largest |alpha_j|.
+ *
+ * @param delta Infeasibility of the leaving variable (see choose_row).
+ * @param nflip Output: the first nflip entries of w->cand are flipped.
+ * @return Entering variable, or -1 if the dual is unbounded.
+ */
+static int ratio_test(DualWork *w, double delta, int *nflip) {
+    SolverContext *state = w->state;
+    const int *status = state->basis->var_status;
+    double tol = w->env->optimality_tol;
+    double sign = (delta < 0.0) ? -1.0 : 1.0;
+    int count = 0;
+
+    *nflip = 0;
+    for (int k = 0; k < w->alpha->size; k++) {
+        int j = w->alpha->indices[k];
+        if (status[j] >= 0 || is_fixed(state, j)) continue;
+        double a = sign * w->alpha->values[j];
+        if (fabs(a) < DUAL_PIVOT_TOL) continue;
+
+        int free_var = state->work_lb[j] <= -CXF_INFINITY &&
+                       state->work_ub[j] >= CXF_INFINITY;
+        double dd;
+        if (a > 0.0 && (status[j] == -1 || free_var)) {
+            dd = state->work_dj[j];
+        } else if (a < 0.0 && (status[j] == -2 || free_var)) {
+            dd = -state->work_dj[j];
+        } else {
+            continue;
+        }
+        w->cand[count].ratio = (dd > 0.0 ? dd : 0.0) / fabs(a);
+        w->cand[count].alpha = fabs(a);
+        w->cand[count].j = j;
+        count++;
+    }
+    if (count == 0) return -1;
+    qsort(w->cand, (size_t)count, sizeof(DualCandidate), compare_candidates);
+
+    /* Pass breakpoints while the dual objective still improves */
+    double slope = fabs(delta);
+    int s = 0;
+    for (; s < count; s++) {
+        int j = w->cand[s].j;
+        double range = state->work_ub[j] - state->work_lb[j];
+        if (range >= CXF_INFINITY) break;
+        double next = slope - w->cand[s].alpha * range;
+        if (next <= 0.0) break;
+        slope = next;
+    }
+    if (s == count) {
+        return -1;  /* Every breakpoint passed: dual unbounded */
+    }
+
+    /* Harris pass over the candidates not flipped */
+    double bound = CXF_INFINITY;
+    for (int k = s; k < count; k++) {
+        double dd = w->cand[k].ratio * w->cand[k].alpha;
+        double t = (dd + tol) / w->cand[k].alpha;
+        if (t < bound) bound = t;
+    }
+    int best = s;
+    for (int k = s; k < count && w->cand[k].ratio <= bound; k++) {
+        if (w->cand[k].alpha > w->cand[best].alpha) best = k;
+    }
+
+    /* Candidates before the chosen one that were not passed keep their
+     * bound; only the first s are flipped */
+    *nflip = s;
+    return w->cand[best].j;
+}
+
+/**
+ * @brief Move the flipped variables to their other bound and update x_B.
+ */
+static int apply_flips(DualWork *w, int nflip) {
+    SolverContext *state = w->state;
+    BasisState *basis = state->basis;
+    const SparseMatrix *A = w->A;
+    int n = w->n;
+
+    if (nflip == 0) return CXF_OK;
+    for (int k = 0; k < nflip; k++) {
+        int j = w->cand[k].j;
+        double to;
+        if (basis->var_status[j] == -1) {
+            to = state->work_ub[j];
+            basis->var_status[j] = -2;
+        } else {
+            to = state->work_lb[j];
+            basis->var_status[j] = -1;
+        }
+        double step = to - state->work_x[j];
+        state->work_x[j] = to;
+        if (j < n) {
+            for (int64_t p = A->col_ptr[j]; p < A->col_ptr[j + 1]; p++) {
+                w->flip[A->row_idx[p]] += A->values[p] * step;
+            }
+        } else {
+            w->flip[j - n] += step;
+        }
+    }
+
+    int rc = cxf_ftran(basis, w->flip, w->flip_x);
+    for (int i = 0; i < w->m; i++) {
+        if (rc == CXF_OK) {
+            state->work_x[basis->basic_vars[i]] -= w->flip_x[i];
+        }
+        w->flip[i] = 0.0;
+    }
+    return rc;
+}
+
+/**
+ * @brief Load column q into the work column and FTRAN it.
+ */
+static int ftran_column(DualWork *w, int q) {
+    VectorContainer *col = w->state->work_column;
+    const SparseMatrix *A = w->A;
+
+    cxf_vector_clear(col);
+    if (q < w->n) {
+        for (int64_t k = A->col_ptr[q]; k < A->col_ptr[q + 1]; k++) {
+            int row = A->row_idx[k];
+            if (A->values[k] == 0.0 || col->values[row] != 0.0) continue;
+            col->values[row] = A->values[k];
+            col->indices[col->size++] = row;
+        }
+    } else {
+        col->values[q - w->n] = 1.0;
+        col->indices[col->size++] = q - w->n;
+    }
+    return cxf_ftran_sparse(w->state->basis, col);
+}
+
+/**
+ * @brief Dual simplex iterations until primal feasible.
+ *
+ * @param with_rhs 0 for the dual Phase I problem (b = 0).
+ * @return CXF_OPTIMAL, CXF_INFEASIBLE (dual unbounded),
+ *         CXF_ITERATION_LIMIT, CXF_NUMERIC, or an error code.
+ */
+static int dual_loop(DualWork *w, int with_rhs) {
+    SolverContext *state = w->state;
+    CxfEnv *env = w->env;
+    BasisState *basis = state->basis;
+    int m = w->m;
+
+    for (;;) {
+        if (state->iteration >= state->max_iterations) {
+            return CXF_ITERATION_LIMIT;
+        }
+
+        int cause = cxf_timing_refactor_cause(state, env);
+        if (cause != CXF_REFACTOR_NONE) {
+            int rc = refactor(w, cause, with_rhs);
+            if (rc < 0 || rc == CXF_NUMERIC) return rc;
+        }
+
+        /* CHUZR */
+        double delta = 0.0;
+        int r = choose_row(w, &delta);
+        if (r < 0) {
+            return CXF_OPTIMAL;
+        }
+        int leaving = basis->basic_vars[r];
+        double target = (delta < 0.0) ? state->work_lb[leaving]
+                                      : state->work_ub[leaving];
+
+        /* BTRAN and pivot row; the exact weight of row r comes for free */
+        int rc = cxf_btran(basis, r, w->rho);
+        if (rc != CXF_OK) return rc;
+        double wr = 0.0;
+        for (int i = 0; i < m; i++) {
+            wr += w->rho[i] * w->rho[i];
+        }
+        w->weight[r] = wr;
+        compute_pivot_row(w);
+
+        /* Ratio test */
+        int nflip;
+        int q = ratio_test(w, delta, &nflip);
+        if (q < 0) {
+            if (basis->pivots_since_refactor > 0) {
+                rc = refactor(w, CXF_REFACTOR_ACCURACY, with_rhs);
+                if (rc < 0 || rc == CXF_NUMERIC) return rc;
+                continue;  /* Confirm with fresh factors */
+            }
+            return CXF_INFEASIBLE;
+        }
+
+        /* FTRAN the entering column and check it against the row */
+        rc = ftran_column(w, q);
+        if (rc != CXF_OK) return rc;
+        VectorContainer *col = state->work_column;
+        double alpha_rq = col->values[r];
+        double residual = (alpha_rq != 0.0) ?
+            fabs(alpha_rq - w->alpha->values[q]) / fabs(alpha_rq) : 1.0;
+        if (residual > DUAL_PIVOT_RESIDUAL || fabs(alpha_rq) < CXF_PIVOT_TOL) {
+            if (basis->pivots_since_refactor == 0) {
+                return CXF_NUMERIC;
+            }
+            rc = refactor(w, CXF_REFACTOR_ACCURACY, with_rhs);
+            if (rc < 0 || rc == CXF_NUMERIC) return rc;
+            continue;
+        }
+        state->pivot_residual = residual;
+
+        /* tau = B^(-1) rho for the weight update */
+        rc = cxf_ftran(basis, w->rho, w->tau);
+        if (rc != CXF_OK) return rc;
+
+        /* Dual update */
+        double dq = state->work_dj[q];
+        double theta_d = dq / alpha_rq;
+        if ((delta < 0.0 && theta_d > 0.0) || (delta > 0.0 && theta_d < 0.0)) {
+            theta_d = 0.0;  /* Slightly infeasible d_q (Harris) */
+        }
+        if (theta_d != 0.0) {
+            for (int k = 0; k < w->alpha->size; k++) {
+                int j = w->alpha->indices[k];
+                state->work_dj[j] -= theta_d * w->alpha->values[j];
+            }
+        }
+        state->work_dj[q] = 0.0;
+        state->work_dj[leaving] = -theta_d;
+
+        /* Primal update: bound flips, then the step to the violated bound */
+        rc = apply_flips(w, nflip);
+        if (rc != CXF_OK) return rc;
+        double theta_p = (state->work_x[leaving] - target) / alpha_rq;
+        for (int k = 0; k < col->size; k++) {
+            int i = col->indices[k];
+            state->work_x[basis->basic_vars[i]] -= theta_p * col->values[i];
+        }
+        state->work_x[q] += theta_p;
+        state->work_x[leaving] = target;
+
+        /* Dual steepest-edge weights */
+        for (int k = 0; k < col->size; k++) {
+            int i = col->indices[k];
+            if (i == r) continue;
+            double ratio = col->values[i] / alpha_rq;
+            double wi = w->weight[i] + ratio * (ratio * wr - 2.0 * w->tau[i]);
+            w->weight[i] = (wi > DSE_MIN_WEIGHT) ? wi : DSE_MIN_WEIGHT;
+        }
+        double wq = wr / (alpha_rq * alpha_rq);
+        w->weight[r] = (wq > DSE_MIN_WEIGHT) ? wq : DSE_MIN_WEIGHT;
+
+        /* Basis update */
+        rc = cxf_pivot_with_eta_sparse(basis, r, col, q, leaving);
+        if (rc != CXF_OK) {
+            if (rc != -1) return rc;
+            rc = refactor(w, CXF_REFACTOR_UNSTABLE, with_rhs);
+            if (rc < 0 || rc == CXF_NUMERIC) return rc;
+            continue;
+        }
+        basis->var_status[leaving] =
+            (target == state->work_ub[leaving] &&
+             target != state->work_lb[leaving]) ? -2 : -1;
+        cxf_price_rows_set_basic(state->price_rows, q, 1);
+        cxf_price_rows_set_basic(state->price_rows, leaving, 0);
+        cxf_timing_basis_update(state);
+        state->iteration++;
+    }
+}
+
+/**
+ * @brief Dual Phase I: optimize the boxed auxiliary problem.
+ *
+ * @return CXF_OK with a dual feasible basis for the original bounds,
+ *         CXF_INF_OR_UNBD if the problem is dual infeasible, or the
+ *         status of the loop.
+ */
+static int dual_phase_one(DualWork *w) {
+    SolverContext *state = w->state;
+    size_t bytes = (size_t)w->total * sizeof(double);
+    memcpy(w->save_lb, state->work_lb, bytes);
+    memcpy(w->save_ub, state->work_ub, bytes);
+
+    for (int j = 0; j < w->total; j++) {
+        int has_lb = w->save_lb[j] > -CXF_INFINITY;
+        int has_ub = w->save_ub[j] < CXF_INFINITY;
+        if (has_lb && has_ub) {
+            state->work_lb[j] = state->work_ub[j] = 0.0;
+        } else if (has_lb) {
+            state->work_lb[j] = 0.0;
+            state->work_ub[j] = 1.0;
+        } else if (has_ub) {
+            state->work_lb[j] = -1.0;
+            state->work_ub[j] = 0.0;
+        } else {
+            state->work_lb[j] = -DUAL_FREE_BOX;
+            state->work_ub[j] = DUAL_FREE_BOX;
+        }
+    }
+    place_nonbasic(w);
+    int rc = compute_primal(w, 0);
+    if (rc == CXF_OK) {
+        state->phase = 1;
+        rc = dual_loop(w, 0);
+    }
+
+    memcpy(state->work_lb, w->save_lb, bytes);
+    memcpy(state->work_ub, w->save_ub, bytes);
+    if (rc != CXF_OPTIMAL) {
+        return (rc == CXF_INFEASIBLE) ? CXF_NUMERIC : rc;
+    }
+
+    /* Undo any cost shifts of the loop, then check */
+    memcpy(state->work_obj, w->cost, bytes);
+    rc = compute_duals(w);
+    if (rc != CXF_OK) return rc;
+    place_nonbasic(w);
+    int flipped;
+    if (repair_duals(w, 0, &flipped) > 0) {
+        return CXF_INF_OR_UNBD;
+    }
+    return CXF_OK;
+}
+
+static void free_work(DualWork *w) {
+    free(w->cost);
+    free(w->weight);
+    free(w->rho);
+    free(w->tau);
+    free(w->flip);
+    free(w->flip_x);
+    free(w->save_lb);
+    free(w->save_ub);
+    free(w->cand);
+}
+
+/**
+ * @brief Solve the LP in the solver context with the dual simplex.
+ *
+ * Builds its own slack basis (see the file comment for the slack bounds),
+ * so the context must come straight from cxf_simplex_init. On
+ * CXF_OPTIMAL the context holds x, pi, d and the objective for the
+ * original costs, ready for cxf_extract_solution.
+ *
+ * @param state Solver context from cxf_simplex_init
+ * @param env Environment
+ * @return CXF_OPTIMAL, CXF_INFEASIBLE, CXF_ITERATION_LIMIT,
+ *         CXF_INF_OR_UNBD (dual infeasible: the primal decides),
+ *         CXF_NUMERIC, or an error code
+ */
+int cxf_dual_simplex(SolverContext *state, CxfEnv *env) {
+    if (state == NULL || env == NULL || state->model_ref == NULL ||
+        state->basis == NULL || state->basis->diag_coeff == NULL) {
+        return CXF_ERROR_NULL_ARGUMENT;
+    }
+
+    DualWork w;
+    memset(&w, 0, sizeof(w));
+    w.state = state;
+    w.env = env;
+    w.A = state->model_ref->matrix;
+    w.n = state->num_vars;
+    w.m = state->num_constrs;
+    w.total = w.n + w.m;
+    if (w.A == NULL || w.m == 0) {
+        return CXF_ERROR_INVALID_ARGUMENT;
+    }
+
+    size_t tbytes = (size_t)w.total * sizeof(double);
+    w.cost = (double *)malloc(tbytes);
+    w.weight = (double *)malloc((size_t)w.m * sizeof(double));
+    w.rho = (double *)malloc((size_t)w.m * sizeof(double));
+    w.tau = (double *)malloc((size_t)w.m * sizeof(double));
+    w.flip = (double *)calloc((size_t)w.m, sizeof(double));
+    w.flip_x = (double *)malloc((size_t)w.m * sizeof(double));
+    w.alpha = state->work_alpha;
+    w.save_lb = (double *)malloc(tbytes);
+    w.save_ub = (double *)malloc(tbytes);
+    w.cand = (DualCandidate *)malloc((size_t)w.total * sizeof(DualCandidate));
+    if (w.cost == NULL || w.weight == NULL || w.rho == NULL || w.tau == NULL ||
+        w.flip == NULL || w.flip_x == NULL || w.alpha == NULL ||
+        w.save_lb == NULL || w.save_ub == NULL || w.cand == NULL) {
+        free_work(&w);
+        return CXF_ERROR_OUT_OF_MEMORY;
+    }
+
+    /* Slack basis, original costs */
+    set_slack_basis(&w);
+    for (int j = 0; j < w.total; j++) {
+        state->work_obj[j] = (j < w.n) ? state->model_ref->obj_coeffs[j] : 0.0;
+        w.cost[j] = state->work_obj[j];
+    }
+    int rc = cxf_simplex_refactor(state, env, CXF_REFACTOR_INITIAL);
+    if (rc == CXF_OK) rc = compute_duals(&w);
+    if (rc != CXF_OK) {
+        free_work(&w);
+        return (rc > 0) ? CXF_NUMERIC : rc;
+    }
+    place_nonbasic(&w);
+
+    /* Dual Phase I if a nonbasic variable without the right bound has a
+     * reduced cost of the wrong sign */
+    int flipped;
+    if (repair_duals(&w, 0, &flipped) > 0) {
+        rc = dual_phase_one(&w);
+        if (rc != CXF_OK) {
+            free_work(&w);
+            return rc;
+        }
+    }
+
+    /* Dual Phase II on the perturbed costs, then on the true costs until
+     * removing the perturbation leaves the basis optimal */
+    state->phase = 2;
+    perturb_costs(&w);
+    rc = compute_primal(&w, 1);
+    int status = (rc == CXF_OK) ? CXF_NUMERIC : rc;
+    for (int round = 0; rc == CXF_OK && round < DUAL_MAX_ROUNDS; round++) {
+        status = dual_loop(&w, 1);
+        if (status != CXF_OPTIMAL) break;
+
+        memcpy(state->work_obj, w.cost, tbytes);
+        rc = compute_duals(&w);
+        if (rc != CXF_OK) {
+            status = rc;
+            break;
+        }
+        if (repair_duals(&w, 0, &flipped) > 0) {
+            status = CXF_NUMERIC;  /* Needs primal iterations */
+            break;
+        }
+        if (flipped == 0) break;
+        rc = compute_primal(&w, 1);
+        status = (rc == CXF_OK) ? CXF_NUMERIC : rc;
+    }
+
+    if (status == CXF_OPTIMAL) {
+        state->obj_value = 0.0;
+        for (int j = 0; j < w.n; j++) {
+            state->obj_value += w.cost[j] * state->work_x[j];
+        }
+    }
+    free_work(&w);
+    return status;
+}
@@ -0,0 +1,287 @@
+/**
+ * @file edge_weights.c
+ * @brief Primal steepest-edge and Devex weights for cxf_simplex_iterate.
+ *
+ * The steepest-edge weight of a nonbasic variable is
+ * gamma_j = 1 + ||B^(-1) a_j||^2, the squared length of its edge. The
+ * pricing module updates the weights across a pivot (cxf_pricing_update);
+ * this file supplies the basis side:
+ *
+ * - the exact weights of the current basis, used at the start and
+ *   whenever the updated weights have drifted;
+ * - per pivot, the exact gamma_q of the entering column and the products
+ *   a_j^T B^(-T) alpha_q over the pivot row, which cost one BTRAN.
+ *
+ * Devex measures the edges in a reference framework only: the nonbasic
+ * variables at the last reset, all with weight 1. Per pivot it needs just
+ * the reference weight of the entering column, read off the FTRAN'd
+ * column; when the updated weight has strayed from it by more than a
+ * factor of DEVEX_RESET_RATIO the framework is reset.
+ */
+
+#include "convexfeld/cxf_solver.h"
+#include "convexfeld/cxf_basis.h"
+#include "convexfeld/cxf_pricing.h"
+#include "convexfeld/cxf_model.h"
+#include "convexfeld/cxf_matrix.h"
+#include "convexfeld/cxf_types.h"
+#include <stdlib.h>
+
+/* Relative error of an updated entering weight that forces a recompute */
+#define EDGE_DRIFT_TOL 0.1
+
+/* Updates after which the weights are recomputed in any case */
+#define EDGE_RECOMPUTE_PIVOTS 2000
+
+/* Devex: factor between the updated and the reference weight of the
+ * entering variable that resets the framework */
+#define DEVEX_RESET_RATIO 3.0
+
+/* Pricing strategies with weights (PricingContext.strategy) */
+#define STRATEGY_STEEPEST_EDGE 2
+#define STRATEGY_DEVEX         3
+
+extern int cxf_ftran_sparse(BasisState *basis, VectorContainer *x);
+extern int cxf_btran_vec(BasisState *basis, const double *input, double *result);
+extern void cxf_vector_clear(VectorContainer *vec);
+
+static double slack_coeff(const BasisState *basis, int row) {
+    return (basis->diag_coeff != NULL) ? basis->diag_coeff[row] : 1.0;
+}
+
+/**
+ * @brief The weighted strategy in use, or 0 for none.
+ */
+static int weight_strategy(const SolverContext *state) {
+    const PricingContext *ctx = state->pricing;
+    if (ctx == NULL || ctx->weights == NULL) {
+        return 0;
+    }
+    if (ctx->strategy == STRATEGY_STEEPEST_EDGE &&
+        state->work_tau != NULL && state->work_edge != NULL) {
+        return STRATEGY_STEEPEST_EDGE;
+    }
+    if (ctx->strategy == STRATEGY_DEVEX && ctx->reference != NULL) {
+        return STRATEGY_DEVEX;
+    }
+    return 0;
+}
+
+/**
+ * @brief Reset the Devex reference framework to the current nonbasic set.
+ */
+static void devex_reset(SolverContext *state) {
+    PricingContext *ctx = state->pricing;
+    const int *status = state->basis->var_status;
+    int total = state->num_vars + state->num_constrs;
+
+    for (int j = 0; j < total; j++) {
+        ctx->weights[j] = 1.0;
+        ctx->reference[j] = (status[j] < 0);
+    }
+    ctx->weights_ready = 1;
+    ctx->weight_pivots = 0;
+    ctx->weight_error = 0.0;
+    ctx->weight_resets++;
+    ctx->heap_ready = 0;
+}
+
+/**
+ * @brief Set every weight to its exact value for the current basis.
+ *
+ * A basis of auxiliary columns only is diagonal, and gamma_j comes
+ * straight from the column of A; otherwise each nonbasic column costs a
+ * FTRAN (through work_column, which is free between iterations). For
+ * Devex this resets the reference framework instead.
+ *
+ * @param state Solver context with valid factors
+ * @return CXF_OK or the error of a FTRAN
+ */
+int cxf_simplex_edge_weights(SolverContext *state) {
+    int strategy = weight_strategy(state);
+    if (strategy == STRATEGY_DEVEX) {
+        devex_reset(state);
+        return CXF_OK;
+    }
+    if (strategy != STRATEGY_STEEPEST_EDGE) {
+        return CXF_OK;
+    }
+
+    BasisState *basis = state->basis;
+    const SparseMatrix *A = state->model_ref->matrix;
+    PricingContext *ctx = state->pricing;
+    int n = state->num_vars;
+    int m = state->num_constrs;
+    double *w = ctx->weights;
+
+    int diagonal = 1;
+    for (int i = 0; i < m && diagonal; i++) {
+        if (basis->basic_vars[i] < n) diagonal = 0;
+    }
+
+    for (int j = 0; j < n + m; j++) {
+        w[j] = 1.0;
+        if (basis->var_status[j] >= 0) continue;
+
+        if (j >= n) {
+            /* a_j = coeff e_i: only reached without a diagonal basis */
+            VectorContainer *col = state->work_column;
+            cxf_vector_clear(col);
+            col->values[j - n] = slack_coeff(basis, j - n);
+            col->indices[col->size++] = j - n;
+            int rc = cxf_ftran_sparse(basis, col);
+            if (rc != CXF_OK) return rc;
+            for (int k = 0; k < col->size; k++) {
+                double v = col->values[col->indices[k]];
+                w[j] += v * v;
+            }
+            continue;
+        }
+
+        if (diagonal) {
+            for (int64_t p = A->col_ptr[j]; p < A->col_ptr[j + 1]; p++) {
+                double v = A->values[p] / slack_coeff(basis, A->row_idx[p]);
+                w[j] += v * v;
+            }
+            continue;
+        }
+
+        VectorContainer *col = state->work_column;
+        cxf_vector_clear(col);
+        for (int64_t p = A->col_ptr[j]; p < A->col_ptr[j + 1]; p++) {
+            int row = A->row_idx[p];
+            if (A->values[p] == 0.0 || col->values[row] != 0.0) continue;
+            col->values[row] = A->values[p];
+            col->indices[col->size++] = row;
+        }
+        int rc = cxf_ftran_sparse(basis, col);
+        if (rc != CXF_OK) return rc;
+        for (int k = 0; k < col->size; k++) {
+            double v = col->values[col->indices[k]];
+            w[j] += v * v;
+        }
+    }
+
+    ctx->weights_ready = 1;
+    ctx->weight_pivots = 0;
+    ctx->weight_error = 0.0;
+    ctx->weight_resets++;
+    ctx->heap_ready = 0;
+    return CXF_OK;
+}
+
+/**
+ * @brief Recompute the weights if they are unset or have drifted.
+ *
+ * Steepest-edge drift is checked only while the factors are fresh, so
+ * the recompute runs on an accurate factorization. A Devex reset needs
+ * no factors and happens as soon as it is due.
+ *
+ * @param state Solver context
+ * @return CXF_OK or the error of cxf_simplex_edge_weights
+ */
+int cxf_simplex_edge_check(SolverContext *state) {
+    int strategy = weight_strategy(state);
+    if (strategy == 0) {
+        return CXF_OK;
+    }
+    const PricingContext *ctx = state->pricing;
+    if (strategy == STRATEGY_DEVEX) {
+        if (!ctx->weights_ready || ctx->weight_error > DEVEX_RESET_RATIO - 1.0) {
+            devex_reset(state);
+        }
+        return CXF_OK;
+    }
+    int fresh = (state->basis->pivots_since_refactor == 0);
+    if (!ctx->weights_ready ||
+        (fresh && (ctx->weight_error > EDGE_DRIFT_TOL ||
+                   ctx->weight_pivots >= EDGE_RECOMPUTE_PIVOTS))) {
+        return cxf_simplex_edge_weights(state);
+    }
+    return CXF_OK;
+}
+
+/**
+ * @brief Devex reference weight of the entering column alpha_q.
+ *
+ * delta_q + sum of alpha_iq^2 over the basic variables in the framework,
+ * with delta_q = 1 if q is in it; at least 1.
+ */
+static double devex_reference_weight(const SolverContext *state, int entering) {
+    const PricingContext *ctx = state->pricing;
+    const VectorContainer *col = state->work_column;
+    const int *basic_vars = state->basis->basic_vars;
+
+    double gamma = ctx->reference[entering] ? 1.0 : 0.0;
+    for (int k = 0; k < col->size; k++) {
+        int i = col->indices[k];
+        if (ctx->reference[basic_vars[i]]) {
+            double v = col->values[i];
+            gamma += v * v;
+        }
+    }
+    return (gamma > 1.0) ? gamma : 1.0;
+}
+
+/**
+ * @brief Pivot data for the weight update, taken before the pivot.
+ *
+ * With alpha_q in work_column and the pivot row in work_alpha (both for
+ * the current basis). Steepest edge: computes tau = B^(-T) alpha_q into
+ * work_tau and a_j^T tau at the indices of the pivot row into work_edge.
+ * Devex: only the reference weight of q.
+ *
+ * @param state Solver context
+ * @param entering Entering variable q
+ * @param gamma_q Output: exact weight of q, or 0 when inactive
+ * @return CXF_OK or the error of the BTRAN
+ */
+int cxf_simplex_edge_prepare(SolverContext *state, int entering, double *gamma_q) {
+    *gamma_q = 0.0;
+    int strategy = weight_strategy(state);
+    if (strategy == STRATEGY_DEVEX) {
+        *gamma_q = devex_reference_weight(state, entering);
+        return CXF_OK;
+    }
+    if (strategy != STRATEGY_STEEPEST_EDGE) {
+        return CXF_OK;
+    }
+
+    BasisState *basis = state->basis;
+    const SparseMatrix *A = state->model_ref->matrix;
+    const VectorContainer *col = state->work_column;
+    const VectorContainer *alpha = state->work_alpha;
+    VectorContainer *edge = state->work_edge;
+    double *tau = state->work_tau;
+    int n = state->num_vars;
+
+    double gamma = 1.0;
+    for (int k = 0; k < col->size; k++) {
+        double v = col->values[col->indices[k]];
+        gamma += v * v;
+    }
+
+    int rc = cxf_btran_vec(basis, col->values, tau);
+    if (rc != CXF_OK) {
+        return rc;
+    }
+
+    cxf_vector_clear(edge);
+    for (int k = 0; k < alpha->size; k++) {
+        int j = alpha->indices[k];
+        double dot;
+        if (j < n) {
+            dot = 0.0;
+            for (int64_t p = A->col_ptr[j]; p < A->col_ptr[j + 1]; p++) {
+                dot += A->values[p] * tau[A->row_idx[p]];
+            }
+        } else {
+            dot = slack_coeff(basis, j - n) * tau[j - n];
+        }
+        edge->values[j] = (dot != 0.0) ? dot : CXF_TINY_VALUE;
+        edge->indices[edge->size++] = j;
+    }
+
+    *gamma_q = gamma;
+    return CXF_OK;
+}
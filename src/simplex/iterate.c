@@ -3,7 +3,11 @@
  * @brief Full cxf_simplex_iterate implementation (M7.1.2)
  *
  * Performs a single iteration of the simplex algorithm:
- * pricing, FTRAN, ratio test, and basis update.
+ * pricing, FTRAN, ratio test, and basis update. With partial pricing the
+ * iterations are the minor iterations of multiple pricing (multi_price.c).
+ * The long-step ratio test lets a boxed entering variable flip to its
+ * opposite bound instead; such an iteration keeps the basis, the reduced
+ * costs and the pricing weights.
  *
  * Spec: docs/specs/functions/simplex/cxf_simplex_iterate.md
  */
@@ -15,6 +19,7 @@
 #include "convexfeld/cxf_model.h"
 #include "convexfeld/cxf_matrix.h"
 #include "convexfeld/cxf_types.h"
+#include "convexfeld/cxf_timing.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -26,23 +31,72 @@
 #define ITERATE_INFEASIBLE 2
 #define ITERATE_UNBOUNDED  3
 
-/* Refactorization threshold */
-/* TODO: Set back to 100 after implementing proper LU refactorization.
- * Currently disabled because refactorization resets diag_coeff to identity,
- * which breaks FTRAN when the basis has non-identity diagonal. */
-#define REFACTOR_INTERVAL  10000
+/* refactor_if_needed: the basis was repaired, pricing is stale */
+#define REFACTOR_REPAIRED  1
+
+/* Pivot tolerances for ill-conditioned bases, in units of the feasibility
+ * tolerance (the ratio test's own floor is 10): PIVOT_TOL_ILL above
+ * CXF_COND_ILL, PIVOT_TOL_SEVERE above CXF_COND_SEVERE */
+#define PIVOT_TOL_ILL      100.0
+#define PIVOT_TOL_SEVERE   1000.0
+
+/* The pricing heap is kept while the pivot row has at most this fraction
+ * (1/HEAP_ROW_DIVISOR) of the variables */
+#define HEAP_ROW_DIVISOR 16
+
+/* Variables (or pivot row entries) per task of the parallel d_j updates:
+ * contiguous blocks whose columns and results fit in L2. Fixed, so the
+ * split and the results do not depend on the thread count. */
+#define PAR_BLOCK_COLS 4096
 
 /* External function declarations */
 extern int cxf_pricing_candidates(PricingContext *ctx, const double *reduced_costs,
                                   const int *var_status, int num_vars, double tolerance,
                                   int *candidates, int max_candidates);
+extern int cxf_ftran_sparse(BasisState *basis, VectorContainer *x);
+extern int cxf_ratio_test_long(SolverContext *state, CxfEnv *env, int enteringVar,
+                               VectorContainer *pivotColumn,
+                               int *leavingRow_out, double *pivotElement_out);
+extern int cxf_simplex_flip_sparse(SolverContext *state, int entering,
+                                   const VectorContainer *pivotCol);
+extern int cxf_simplex_step_sparse(SolverContext *state, int entering, int leavingRow,
+                                   const VectorContainer *pivotCol, double stepSize);
+extern void cxf_vector_clear(VectorContainer *vec);
+extern int cxf_btran(BasisState *basis, int row, double *result);
+extern int cxf_btran_vec(BasisState *basis, const double *input, double *result);
 extern int cxf_ftran(BasisState *basis, const double *column, double *result);
-extern int cxf_ratio_test(SolverContext *state, CxfEnv *env, int enteringVar,
-                          const double *pivotColumn, int columnNZ,
-                          int *leavingRow_out, double *pivotElement_out);
-extern int cxf_simplex_step(SolverContext *state, int entering, int leavingRow,
-                            const double *pivotCol, double stepSize);
-extern int cxf_basis_refactor(BasisState *basis);
+extern int cxf_solver_refactor(SolverContext *ctx, CxfEnv *env);
+extern int cxf_timing_refactor_cause(SolverContext *state, CxfEnv *env);
+extern void cxf_timing_basis_update(SolverContext *state);
+extern void cxf_timing_refactor_done(SolverContext *state, int cause, int updates,
+                                     double seconds);
+extern int cxf_price_row(PriceRows *rows, const SparseMatrix *matrix,
+                         const int *var_status, const double *slack_coeff,
+                         const double *rho, VectorContainer *alpha);
+extern void cxf_price_rows_set_basic(PriceRows *rows, int var, int basic);
+extern void cxf_price_rows_sync(PriceRows *rows, const int *var_status);
+extern int cxf_pricing_steepest(PricingContext *ctx, const double *reduced_costs,
+                                const double *weights, const int *var_status,
+                                int num_vars, double tolerance);
+extern int cxf_pricing_update(PricingContext *ctx, int entering_var, int leaving_var,
+                              double pivot_elem, double gamma_entering,
+                              const VectorContainer *pivot_row,
+                              const VectorContainer *edge_dots);
+extern void cxf_pricing_heap_build(PricingContext *ctx, const double *dj,
+                                   const int *status, double tolerance);
+extern void cxf_pricing_heap_touch(PricingContext *ctx, int j, const double *dj,
+                                   const int *status);
+extern int cxf_pricing_heap_top(const PricingContext *ctx);
+extern void cxf_pool_run(CxfThreadPool *pool, int tasks,
+                         void (*fn)(void *arg, int task), void *arg);
+extern int cxf_simplex_edge_check(SolverContext *state);
+extern int cxf_simplex_edge_prepare(SolverContext *state, int entering, double *gamma_q);
+extern int cxf_simplex_minor_load(SolverContext *state, const int *candidates, int count);
+extern int cxf_simplex_minor_select(SolverContext *state, double tol);
+extern void cxf_simplex_minor_update(SolverContext *state, int slot, int row, int leaving);
+extern ScratchMark cxf_scratch_mark(const ScratchArena *arena);
+extern void *cxf_scratch_alloc(ScratchArena *arena, size_t size);
+extern void cxf_scratch_release(ScratchArena *arena, ScratchMark mark);
 
 /**
  * @brief Get the coefficient for slack/surplus/artificial variable.
@@ -74,7 +128,7 @@ static double get_auxiliary_coeff_fallback(const SparseMatrix *matrix, int row)
 }
 
 /**
- * @brief Extract a column into a dense array.
+ * @brief Extract a column into a sparse accumulator.
  *
  * For original variables (col < n): extracts from sparse matrix.
  * For auxiliary variables (col >= n): generates identity column
@@ -85,12 +139,13 @@ static double get_auxiliary_coeff_fallback(const SparseMatrix *matrix, int row)
  * @param col Column index (0 to n+m-1)
  * @param n Number of original variables
  * @param m Number of constraints (rows)
- * @param dense Output dense array (must be size m)
+ * @param out Output sparse accumulator of dimension m (cleared first)
  */
 static void extract_column_ext(const SparseMatrix *matrix, BasisState *basis,
-                               int col, int n, int m, double *dense) {
-    /* Clear the dense array */
-    memset(dense, 0, (size_t)m * sizeof(double));
+                               int col, int n, int m, VectorContainer *out) {
+    /* Clear only the entries left by the previous iteration */
+    cxf_vector_clear(out);
+    double *dense = out->values;
 
     if (col < n) {
         /* Original variable: extract from sparse matrix */
@@ -100,7 +155,9 @@ static void extract_column_ext(const SparseMatrix *matrix, BasisState *basis,
 
         for (int64_t k = start; k < end; k++) {
             int row = matrix->row_idx[k];
+            if (matrix->values[k] == 0.0 || dense[row] != 0.0) continue;
             dense[row] = matrix->values[k];
+            out->indices[out->size++] = row;
         }
     } else {
         /* Auxiliary variable: identity column with coefficient from diag_coeff */
@@ -110,69 +167,575 @@ static void extract_column_ext(const SparseMatrix *matrix, BasisState *basis,
                 basis->diag_coeff[row] :
                 get_auxiliary_coeff_fallback(matrix, row);
             dense[row] = coeff;
+            out->indices[out->size++] = row;
         }
     }
 }
 
 /**
- * @brief Perform one simplex iteration.
+ * @brief Reduced costs d_j = c_j - pi^T a_j of the variables j0..j1-1.
+ */
+static void reduced_cost_range(SolverContext *state, int j0, int j1) {
+    BasisState *basis = state->basis;
+    CxfModel *model = state->model_ref;
+    int m = state->num_constrs;
+    int n = state->num_vars;
+
+    for (int j = j0; j < j1; j++) {
+        if (basis->var_status[j] >= 0) {
+            /* Basic variable: reduced cost = 0 */
+            state->work_dj[j] = 0.0;
+        } else {
+            /* Nonbasic variable: dj = cj - pi^T * Aj */
+            double dj = state->work_obj[j];
+
+            if (j < n && model->matrix != NULL) {
+                /* Original variable: subtract pi^T * column_j */
+                int64_t start = model->matrix->col_ptr[j];
+                int64_t end = model->matrix->col_ptr[j + 1];
+                for (int64_t k = start; k < end; k++) {
+                    int row = model->matrix->row_idx[k];
+                    dj -= state->work_pi[row] * model->matrix->values[k];
+                }
+            } else if (j >= n) {
+                /* Auxiliary variable j corresponds to row (j - n) */
+                int row = j - n;
+                if (row >= 0 && row < m) {
+                    /* Use diag_coeff from basis if available */
+                    double coeff = (basis->diag_coeff != NULL) ?
+                        basis->diag_coeff[row] :
+                        get_auxiliary_coeff_fallback(model->matrix, row);
+                    dj -= state->work_pi[row] * coeff;
+                }
+            }
+
+            state->work_dj[j] = dj;
+        }
+    }
+}
+
+static void reduced_cost_task(void *arg, int block) {
+    SolverContext *state = (SolverContext *)arg;
+    int total_vars = state->num_vars + state->num_constrs;
+    int j0 = block * PAR_BLOCK_COLS;
+    int j1 = (total_vars - j0 > PAR_BLOCK_COLS) ? j0 + PAR_BLOCK_COLS : total_vars;
+    reduced_cost_range(state, j0, j1);
+}
+
+/**
+ * @brief Recompute the duals and all reduced costs.
+ *
+ * Use BTRAN to properly compute dual prices: π = B^(-T) * c_B, then
+ * dj = cj - π^T * Aj for every nonbasic variable, block by block over
+ * the worker pool when there is one.
  *
  * @param state Solver context
- * @param env Environment
- * @return ITERATE_CONTINUE (0) to continue, ITERATE_OPTIMAL (1) if optimal,
- *         ITERATE_UNBOUNDED (3) if unbounded, or error code
  */
-int cxf_simplex_iterate(SolverContext *state, CxfEnv *env) {
-    int rc;
-    int entering, leavingRow;
-    double pivotElement, stepSize;
-    int candidates[10];
-    int num_candidates;
+static void update_reduced_costs(SolverContext *state) {
+    BasisState *basis = state->basis;
+    int m = state->num_constrs;
+    int total_vars = state->num_vars + m;
 
-    if (state == NULL || env == NULL) {
-        return CXF_ERROR_NULL_ARGUMENT;
+    /* Build c_B vector using preallocated work array */
+    double *cB = state->work_cB;
+    for (int i = 0; i < m; i++) {
+        int basic_var = basis->basic_vars[i];
+        if (basic_var >= 0 && basic_var < total_vars) {
+            cB[i] = state->work_obj[basic_var];
+        } else {
+            cB[i] = 0.0;
+        }
+    }
+
+    /* Compute π = B^(-T) * c_B using BTRAN */
+    int btran_rc = cxf_btran_vec(basis, cB, state->work_pi);
+    if (btran_rc != CXF_OK) {
+        /* Fallback to simple approximation if BTRAN fails */
+        for (int i = 0; i < m; i++) {
+            state->work_pi[i] = cB[i];
+        }
     }
 
+    /* Compute reduced costs for all variables */
+    int blocks = (total_vars + PAR_BLOCK_COLS - 1) / PAR_BLOCK_COLS;
+    if (state->pool != NULL && blocks > 1) {
+        cxf_pool_run(state->pool, blocks, reduced_cost_task, state);
+    } else {
+        reduced_cost_range(state, 0, total_vars);
+    }
+
+    if (state->pricing != NULL) {
+        state->pricing->heap_ready = 0;
+    }
+}
+
+/**
+ * @brief Recompute x_B from b - N x_N with the current factors.
+ *
+ * The reduced costs are recomputed as well, and the objective moves by
+ * the change in c^T x (before is c^T x on entry to the caller).
+ *
+ * @param state Solver context
+ * @param before Objective c^T x to measure the change against
+ * @return CXF_OK or an error code from the solve
+ */
+static int recompute_solution(SolverContext *state, double before) {
     BasisState *basis = state->basis;
-    CxfModel *model = state->model_ref;
+    const SparseMatrix *A = state->model_ref->matrix;
+    int m = state->num_constrs;
+    int n = state->num_vars;
+    int total_vars = n + m;
 
-    if (model == NULL) {
-        return CXF_ERROR_NULL_ARGUMENT;
+    ScratchMark mark = cxf_scratch_mark(&state->scratch);
+    double *rhs = (double *)cxf_scratch_alloc(&state->scratch,
+                                              (size_t)m * sizeof(double));
+    double *xB = (double *)cxf_scratch_alloc(&state->scratch,
+                                             (size_t)m * sizeof(double));
+    if (rhs == NULL || xB == NULL) {
+        cxf_scratch_release(&state->scratch, mark);
+        return CXF_ERROR_OUT_OF_MEMORY;
     }
 
+    /* rhs = b - N x_N */
+    for (int i = 0; i < m; i++) {
+        rhs[i] = (A->rhs != NULL) ? A->rhs[i] : 0.0;
+    }
+    for (int j = 0; j < n; j++) {
+        if (basis->var_status[j] >= 0 || state->work_x[j] == 0.0) continue;
+        for (int64_t k = A->col_ptr[j]; k < A->col_ptr[j + 1]; k++) {
+            rhs[A->row_idx[k]] -= A->values[k] * state->work_x[j];
+        }
+    }
+    for (int i = 0; i < m; i++) {
+        if (basis->var_status[n + i] < 0) {
+            double coeff = (basis->diag_coeff != NULL) ?
+                basis->diag_coeff[i] : get_auxiliary_coeff_fallback(A, i);
+            rhs[i] -= coeff * state->work_x[n + i];
+        }
+    }
+
+    int rc = cxf_ftran(basis, rhs, xB);
+    if (rc == CXF_OK) {
+        for (int i = 0; i < m; i++) {
+            state->work_x[basis->basic_vars[i]] = xB[i];
+        }
+    }
+    cxf_scratch_release(&state->scratch, mark);
+    if (rc != CXF_OK) {
+        return rc;
+    }
+
+    update_reduced_costs(state);
+
+    double after = 0.0;
+    for (int j = 0; j < total_vars; j++) {
+        after += state->work_obj[j] * state->work_x[j];
+    }
+    state->obj_value += after - before;
+    return CXF_OK;
+}
+
+/**
+ * @brief Bring the solution in line with a basis that refactoring repaired.
+ *
+ * The variables that left the basis go to their nearest finite bound
+ * (free ones keep their value), x_B is recomputed from b - N x_N, and the
+ * reduced costs and the objective follow.
+ *
+ * @param state Solver context
+ * @return CXF_OK or CXF_ERROR_OUT_OF_MEMORY
+ */
+static int resync_after_repair(SolverContext *state) {
+    BasisState *basis = state->basis;
+    const LUFactors *lu = basis->lu;
     int m = state->num_constrs;
     int n = state->num_vars;
+    int total_vars = n + m;
 
-    /* For unconstrained LP (m=0), immediately optimal at bounds */
-    if (m == 0) {
-        state->iteration++;
-        return ITERATE_OPTIMAL;
+    double before = 0.0;
+    for (int j = 0; j < total_vars; j++) {
+        before += state->work_obj[j] * state->work_x[j];
     }
 
-    /* For constrained LPs, need basis and matrix */
-    if (basis == NULL || model->matrix == NULL) {
+    for (int k = 0; k < lu->repairs; k++) {
+        int j = lu->repair_var[k];
+        if (j < 0 || j >= total_vars || basis->var_status[j] >= 0) {
+            continue;
+        }
+        double lb = state->work_lb[j];
+        double ub = state->work_ub[j];
+        double x = state->work_x[j];
+        if (lb > -CXF_INFINITY && (ub >= CXF_INFINITY || x - lb <= ub - x)) {
+            state->work_x[j] = lb;
+            basis->var_status[j] = -1;
+        } else if (ub < CXF_INFINITY) {
+            state->work_x[j] = ub;
+            basis->var_status[j] = -2;
+        }
+    }
+
+    return recompute_solution(state, before);
+}
+
+/**
+ * @brief Estimate the condition of the fresh factors and set the ratio
+ *        test's pivot tolerance from it.
+ *
+ * A well-conditioned basis leaves the pivot tolerance at the ratio test's
+ * default; an ill-conditioned one raises it so that the next pivots avoid
+ * the small elements that made it so. The estimate also shortens the
+ * refactorization interval (cxf_timing_refactor_cause) and is reported as
+ * the BasisCondition attribute.
+ *
+ * @param state Solver context
+ * @param env Environment
+ */
+static void assess_conditioning(SolverContext *state, CxfEnv *env) {
+    double cond;
+    if (cxf_basis_condest(state->basis, &cond) != CXF_OK) {
+        return;  /* No estimate (no matrix): keep the previous one */
+    }
+    state->basis_cond = cond;
+    if (state->model_ref != NULL) {
+        state->model_ref->basis_cond = cond;
+    }
+
+    if (cond > CXF_COND_SEVERE) {
+        state->pivot_tol = PIVOT_TOL_SEVERE * env->feasibility_tol;
+    } else if (cond > CXF_COND_ILL) {
+        state->pivot_tol = PIVOT_TOL_ILL * env->feasibility_tol;
+    } else {
+        state->pivot_tol = 0.0;
+    }
+}
+
+/**
+ * @brief Refactor the basis and record why.
+ *
+ * A singular basis comes back repaired (slacks in place of the deficient
+ * columns); the solution is then resynchronized and the caller has to
+ * price again, since the entering candidate may have become basic.
+ * Shared with the dual simplex (dual.c).
+ *
+ * @param state Solver context
+ * @param env Environment
+ * @param cause CXF_REFACTOR_* cause recorded in the timing statistics
+ * @return CXF_OK, REFACTOR_REPAIRED (1), CXF_ERROR_OUT_OF_MEMORY, or
+ *         CXF_NUMERIC if the basis could not be factored
+ */
+int cxf_simplex_refactor(SolverContext *state, CxfEnv *env, int cause) {
+    int updates = state->basis->pivots_since_refactor;
+    double start = cxf_get_timestamp();
+    int rc = cxf_solver_refactor(state, env);
+    if (rc != CXF_OK) {
+        return (rc == CXF_ERROR_OUT_OF_MEMORY || rc == 1001) ?
+            CXF_ERROR_OUT_OF_MEMORY : CXF_NUMERIC;
+    }
+    cxf_timing_refactor_done(state, cause, updates, cxf_get_timestamp() - start);
+
+    const LUFactors *lu = state->basis->lu;
+    if (lu != NULL && lu->repairs > 0) {
+        rc = resync_after_repair(state);
+        if (rc != CXF_OK) return rc;
+        assess_conditioning(state, env);
+        return REFACTOR_REPAIRED;
+    }
+    assess_conditioning(state, env);
+    return CXF_OK;
+}
+
+/**
+ * @brief Refactor the basis when the scheduler asks for it.
+ *
+ * The decision and its cause come from cxf_timing_refactor_cause and are
+ * recorded in the timing statistics. The reduced costs, otherwise updated
+ * from the pivot row, are recomputed from the fresh factors.
+ *
+ * @param state Solver context
+ * @param env Environment
+ * @return As cxf_simplex_refactor
+ */
+static int refactor_if_needed(SolverContext *state, CxfEnv *env) {
+    int cause = cxf_timing_refactor_cause(state, env);
+    if (cause == CXF_REFACTOR_NONE) {
+        return CXF_OK;
+    }
+    int rc = cxf_simplex_refactor(state, env, cause);
+    if (rc == CXF_OK) {
+        update_reduced_costs(state);
+    }
+    return rc;
+}
+
+/**
+ * @brief Refactor and recompute the basic values from b - N x_N.
+ *
+ * For a driver that finds the primal values have drifted from the
+ * constraints: one factorization and one FTRAN restore A x = b exactly
+ * (up to the accuracy of the fresh factors), and the reduced costs and
+ * the objective follow.
+ *
+ * @param state Solver context
+ * @param env Environment
+ * @return CXF_OK, CXF_ERROR_OUT_OF_MEMORY or CXF_NUMERIC
+ */
+int cxf_simplex_refresh(SolverContext *state, CxfEnv *env) {
+    if (state == NULL || env == NULL || state->basis == NULL ||
+        state->model_ref == NULL) {
         return CXF_ERROR_NULL_ARGUMENT;
     }
 
-    /* Total variables = original + artificials for Phase I */
-    int total_vars = n + m;
+    int rc = cxf_simplex_refactor(state, env, CXF_REFACTOR_ACCURACY);
+    if (rc == REFACTOR_REPAIRED) {
+        if (state->pricing != NULL) {
+            state->pricing->weights_ready = 0;
+        }
+        return CXF_OK;  /* Already resynchronized */
+    }
+    if (rc != CXF_OK) {
+        return rc;
+    }
 
-    /* Allocate work arrays if needed */
-    double *pivotCol = basis->work;
-    if (pivotCol == NULL) {
-        return CXF_ERROR_OUT_OF_MEMORY;
+    int total_vars = state->num_vars + state->num_constrs;
+    double before = 0.0;
+    for (int j = 0; j < total_vars; j++) {
+        before += state->work_obj[j] * state->work_x[j];
     }
+    return recompute_solution(state, before);
+}
 
-    /* Use preallocated column array (reused across iterations) */
-    double *column = state->work_column;
-    if (column == NULL) {
-        return CXF_ERROR_OUT_OF_MEMORY;
+/**
+ * @brief Pivot row alpha_r = e_r^T B^(-1) [A I] over the nonbasic variables.
+ *
+ * One BTRAN of the unit vector e_r gives rho = row r of B^(-1); the row is
+ * then priced by cxf_price_row, which goes column-wise, row-wise or
+ * hyper-sparse row-wise depending on the density of rho. The row-wise
+ * copy is brought in line with the basis while the factors are fresh and
+ * updated on each pivot after that.
+ *
+ * @param state Solver context (rho in work_rho, row in work_alpha)
+ * @param matrix Constraint matrix
+ * @param row Pivot row r
+ * @return CXF_OK or the error of the BTRAN
+ */
+static int compute_pivot_row(SolverContext *state, const SparseMatrix *matrix,
+                             int row) {
+    BasisState *basis = state->basis;
+    int n = state->num_vars;
+    VectorContainer *alpha = state->work_alpha;
+
+    int rc = cxf_btran(basis, row, state->work_rho);
+    if (rc != CXF_OK) {
+        return rc;
+    }
+
+    if (basis->pivots_since_refactor == 0) {
+        cxf_price_rows_sync(state->price_rows, basis->var_status);
+    }
+    cxf_price_row(state->price_rows, matrix, basis->var_status,
+                  basis->diag_coeff, state->work_rho, alpha);
+
+    if (basis->diag_coeff == NULL) {
+        for (int k = 0; k < alpha->size; k++) {
+            int j = alpha->indices[k];
+            if (j >= n) {
+                alpha->values[j] *= get_auxiliary_coeff_fallback(matrix, j - n);
+            }
+        }
+    }
+    return CXF_OK;
+}
+
+/**
+ * @brief One dual update, split into blocks of the pivot row.
+ */
+typedef struct {
+    SolverContext *state;
+    double theta;
+} DualUpdate;
+
+/**
+ * @brief d_j -= theta * alpha_rj over entries k0..k1-1 of the pivot row.
+ */
+static void update_dj_range(SolverContext *state, double theta, int k0, int k1) {
+    const int *status = state->basis->var_status;
+    double *dj = state->work_dj;
+    const VectorContainer *alpha = state->work_alpha;
+    for (int k = k0; k < k1; k++) {
+        int j = alpha->indices[k];
+        if (status[j] < 0) {
+            dj[j] -= theta * alpha->values[j];
+        }
+    }
+}
+
+static void update_dj_task(void *arg, int block) {
+    DualUpdate *u = (DualUpdate *)arg;
+    int size = u->state->work_alpha->size;
+    int k0 = block * PAR_BLOCK_COLS;
+    int k1 = (size - k0 > PAR_BLOCK_COLS) ? k0 + PAR_BLOCK_COLS : size;
+    update_dj_range(u->state, u->theta, k0, k1);
+}
+
+/**
+ * @brief Update the duals and reduced costs across a basis change.
+ *
+ * With theta = d_q / alpha_rq, the new duals are pi + theta * rho and
+ * every nonbasic reduced cost moves by -theta * alpha_rj; the leaving
+ * variable (alpha_rp = 1) gets -theta. Called after the pivot, so the
+ * entering variable is already basic. The entries of the pivot row are
+ * distinct, so a long row is split over the worker pool.
+ *
+ * @param state Solver context with the pivot row of the old basis
+ * @param entering Entering variable q
+ * @param leaving Leaving variable p
+ * @param alpha_rq Pivot element
+ */
+static void update_duals(SolverContext *state, int entering, int leaving,
+                         double alpha_rq) {
+    int m = state->num_constrs;
+    double *dj = state->work_dj;
+    const VectorContainer *alpha = state->work_alpha;
+
+    double theta = dj[entering] / alpha_rq;
+    for (int i = 0; i < m; i++) {
+        state->work_pi[i] += theta * state->work_rho[i];
+    }
+    if (theta != 0.0) {
+        int blocks = (alpha->size + PAR_BLOCK_COLS - 1) / PAR_BLOCK_COLS;
+        if (state->pool != NULL && blocks > 1) {
+            DualUpdate u = {state, theta};
+            cxf_pool_run(state->pool, blocks, update_dj_task, &u);
+        } else {
+            update_dj_range(state, theta, 0, alpha->size);
+        }
+    }
+    dj[entering] = 0.0;
+    dj[leaving] = -theta;
+}
+
+/**
+ * @brief Steepest-edge or Devex choice of the entering variable.
+ *
+ * A fixed variable cannot enter; when one is chosen its weight is frozen
+ * at CXF_INFINITY (see cxf_pricing_update) and the choice is repeated.
+ * A frozen variable chosen means nothing else is attractive.
+ *
+ * With an active heap the choice is its top, and the heap is rebuilt
+ * only after the reduced costs or weights were recomputed; otherwise all
+ * variables are scanned.
+ */
+static int price_steepest(SolverContext *state, CxfEnv *env, int *candidates) {
+    PricingContext *ctx = state->pricing;
+    const int *status = state->basis->var_status;
+    int total_vars = state->num_vars + state->num_constrs;
+
+    int use_heap = (ctx->heap != NULL && ctx->heap_active);
+    if (use_heap && (!ctx->heap_ready || ctx->heap_tol != env->optimality_tol)) {
+        cxf_pricing_heap_build(ctx, state->work_dj, status, env->optimality_tol);
+    }
+
+    for (;;) {
+        int j = use_heap ?
+            cxf_pricing_heap_top(ctx) :
+            cxf_pricing_steepest(ctx, state->work_dj, ctx->weights, status,
+                                 total_vars, env->optimality_tol);
+        if (j < 0 || ctx->weights[j] >= CXF_INFINITY) {
+            return 0;
+        }
+        if (state->work_ub[j] > state->work_lb[j] + CXF_FEASIBILITY_TOL) {
+            candidates[0] = j;
+            return 1;
+        }
+        ctx->weights[j] = CXF_INFINITY;
+        cxf_pricing_heap_touch(ctx, j, state->work_dj, status);
+    }
+}
+
+/**
+ * @brief Bring the pricing heap up to date after a pivot.
+ *
+ * The reduced costs and weights changed over the pivot row only, so only
+ * its entries, the entering and the leaving variable are touched. A
+ * dense pivot row costs more in heap updates than a scan of all
+ * variables: the heap is dropped and pricing scans until the rows are
+ * sparse again.
+ */
+static void touch_pricing_heap(SolverContext *state, int entering, int leaving) {
+    PricingContext *ctx = state->pricing;
+    const VectorContainer *alpha = state->work_alpha;
+    const int *status = state->basis->var_status;
+    const double *dj = state->work_dj;
+
+    ctx->heap_active = (alpha->size <= ctx->num_vars / HEAP_ROW_DIVISOR);
+    if (!ctx->heap_active || !ctx->heap_ready) {
+        ctx->heap_ready = 0;
+        return;
+    }
+    for (int k = 0; k < alpha->size; k++) {
+        cxf_pricing_heap_touch(ctx, alpha->indices[k], dj, status);
+    }
+    cxf_pricing_heap_touch(ctx, entering, dj, status);
+    cxf_pricing_heap_touch(ctx, leaving, dj, status);
+}
+
+/**
+ * @brief Bound flip iteration: the entering variable moves to its opposite
+ *        bound and the basis stays.
+ *
+ * The basic variables follow the FTRAN'd column already in pivotCol, and
+ * the objective improves by |d_q| (ub - lb). Reduced costs and pricing
+ * weights do not change; the candidate set of multiple pricing stays
+ * valid (the flipped variable is no longer attractive).
+ *
+ * @param state Solver context
+ * @param entering Boxed entering variable
+ * @param pivotCol B^(-1) a_entering
+ * @return ITERATE_CONTINUE or an error code
+ */
+static int flip_entering(SolverContext *state, int entering,
+                         const VectorContainer *pivotCol) {
+    double direction = (state->basis->var_status[entering] == -2) ? -1.0 : 1.0;
+    double range = state->work_ub[entering] - state->work_lb[entering];
+
+    int rc = cxf_simplex_flip_sparse(state, entering, pivotCol);
+    if (rc != CXF_OK) {
+        state->minor_count = 0;
+        return rc;
+    }
+    state->obj_value += state->work_dj[entering] * direction * range;
+
+    if (state->pricing != NULL) {
+        cxf_pricing_heap_touch(state->pricing, entering, state->work_dj,
+                               state->basis->var_status);
+    }
+
+    state->iteration++;
+    return ITERATE_CONTINUE;
+}
+
+/**
+ * @brief Choose the entering variable from the reduced costs.
+ *
+ * Steepest edge, Devex and partial pricing go through the pricing
+ * context; a partial pass that finds nothing, and a solve without a
+ * context, use the full Dantzig scan.
+ *
+ * @param state Solver context
+ * @param env Environment
+ * @param candidates Output: candidates, best first [10]
+ * @return Number of candidates (0 if the reduced costs are optimal)
+ */
+static int price_entering(SolverContext *state, CxfEnv *env, int *candidates) {
+    BasisState *basis = state->basis;
+    int total_vars = state->num_vars + state->num_constrs;
+    int num_candidates = 0;
+
+    if (state->pricing != NULL && state->pricing->weights != NULL &&
+        (state->pricing->strategy == 2 || state->pricing->strategy == 3)) {
+        return price_steepest(state, env, candidates);
     }
 
-    /*=========================================================================
-     * Step 1: Pricing - select entering variable
-     * Scan all variables including artificials (indices n to n+m-1)
-     *=========================================================================*/
     if (state->pricing != NULL) {
         num_candidates = cxf_pricing_candidates(
             state->pricing,
@@ -194,9 +757,9 @@ int cxf_simplex_iterate(SolverContext *state, CxfEnv *env) {
             }
         }
         num_candidates = new_count;
-    } else {
-        /* Fallback: scan all variables for most negative reduced cost */
-        num_candidates = 0;
+    }
+    if (num_candidates == 0) {
+        /* Full scan for the largest improving reduced cost */
         double best_rc = -env->optimality_tol;
         for (int j = 0; j < total_vars; j++) {
             if (basis->var_status[j] >= 0) {
@@ -228,58 +791,190 @@ int cxf_simplex_iterate(SolverContext *state, CxfEnv *env) {
         }
     }
 
-    if (num_candidates == 0) {
-        return ITERATE_OPTIMAL;  /* No improving variable found */
+    return num_candidates;
+}
+
+/**
+ * @brief One simplex iteration (see cxf_simplex_iterate).
+ */
+static int simplex_iterate(SolverContext *state, CxfEnv *env) {
+    int rc;
+    int entering, leavingRow;
+    double pivotElement, stepSize;
+    int candidates[10];
+    int num_candidates;
+
+    if (state == NULL || env == NULL) {
+        return CXF_ERROR_NULL_ARGUMENT;
     }
 
-    entering = candidates[0];  /* Take best candidate */
+    BasisState *basis = state->basis;
+    CxfModel *model = state->model_ref;
 
+    if (model == NULL) {
+        return CXF_ERROR_NULL_ARGUMENT;
+    }
+
+    int m = state->num_constrs;
+    int n = state->num_vars;
+
+    /* For unconstrained LP (m=0), immediately optimal at bounds */
+    if (m == 0) {
+        state->iteration++;
+        return ITERATE_OPTIMAL;
+    }
+
+    /* For constrained LPs, need basis and matrix */
+    if (basis == NULL || model->matrix == NULL) {
+        return CXF_ERROR_NULL_ARGUMENT;
+    }
+
+    /* Entering column, transformed in place into the pivot column. It is a
+     * sparse accumulator, so extraction, FTRAN, the ratio test and the
+     * basis update only visit its nonzeros. */
+    VectorContainer *pivotCol = state->work_column;
+    if (pivotCol == NULL) {
+        return CXF_ERROR_OUT_OF_MEMORY;
+    }
 
     /*=========================================================================
-     * Step 2: FTRAN - compute pivot column B^(-1) * a_entering
-     * For artificial vars (entering >= n), generates identity column
+     * Step 1: Refactor first when the scheduler asks for it: no valid
+     * factors in Forrest-Tomlin mode, an unstable update, a failed pivot
+     * residual check, the eta limits, RefactorInterval, or the cost model.
+     * Fresh factors come with freshly computed reduced costs (a repaired
+     * basis included).
      *=========================================================================*/
-    extract_column_ext(model->matrix, basis, entering, n, m, column);
-    rc = cxf_ftran(basis, column, pivotCol);
+    rc = refactor_if_needed(state, env);
+    if (rc != CXF_OK && rc != REFACTOR_REPAIRED) {
+        return rc;
+    }
+    if (rc == REFACTOR_REPAIRED && state->pricing != NULL) {
+        state->pricing->weights_ready = 0;  /* Columns were swapped */
+    }
+    rc = cxf_simplex_edge_check(state);
     if (rc != CXF_OK) {
         return rc;
     }
 
     /*=========================================================================
-     * Step 3: Ratio test - select leaving variable
+     * Step 2: Pricing - select entering variable
+     * Scan all variables including artificials (indices n to n+m-1).
+     * Updated reduced costs are confirmed from scratch before declaring
+     * optimality.
+     *
+     * Multiple pricing takes the next candidate of the current set, whose
+     * column is already FTRAN'd. Once the set is exhausted, a major
+     * iteration recomputes all reduced costs (the only full PRICE) and
+     * loads a new set. Fresh factors start a new major iteration.
      *=========================================================================*/
-    rc = cxf_ratio_test(state, env, entering, pivotCol, m,
-                        &leavingRow, &pivotElement);
-    if (rc == CXF_UNBOUNDED) {
-        return ITERATE_UNBOUNDED;
+    int minor = -1;
+    if (state->minor_cols != NULL) {
+        if (basis->pivots_since_refactor == 0) {
+            state->minor_count = 0;
+        }
+        minor = cxf_simplex_minor_select(state, env->optimality_tol);
+        if (minor < 0) {
+            if (basis->pivots_since_refactor > 0) {
+                update_reduced_costs(state);
+            }
+            num_candidates = price_entering(state, env, candidates);
+            if (num_candidates == 0) {
+                return ITERATE_OPTIMAL;
+            }
+            rc = cxf_simplex_minor_load(state, candidates, num_candidates);
+            if (rc != CXF_OK) {
+                return rc;
+            }
+            minor = cxf_simplex_minor_select(state, env->optimality_tol);
+            if (minor < 0) {
+                return ITERATE_OPTIMAL;
+            }
+        }
+        entering = state->minor_vars[minor];
+    } else {
+        num_candidates = price_entering(state, env, candidates);
+        if (num_candidates == 0 && basis->pivots_since_refactor > 0) {
+            update_reduced_costs(state);
+            num_candidates = price_entering(state, env, candidates);
+        }
+        if (num_candidates == 0) {
+            return ITERATE_OPTIMAL;  /* No improving variable found */
+        }
+
+        entering = candidates[0];  /* Take best candidate */
+
+        /*=====================================================================
+         * Step 3: FTRAN - compute pivot column B^(-1) * a_entering
+         * For artificial vars (entering >= n), generates identity column
+         *=====================================================================*/
+        extract_column_ext(model->matrix, basis, entering, n, m, pivotCol);
+        rc = cxf_ftran_sparse(basis, pivotCol);
+        if (rc != CXF_OK) {
+            return rc;
+        }
     }
+
+    /*=========================================================================
+     * Step 4: Ratio test - select leaving variable, or a bound flip of the
+     * entering variable (leavingRow -1)
+     *=========================================================================*/
+    rc = cxf_ratio_test_long(state, env, entering, pivotCol,
+                             &leavingRow, &pivotElement);
     if (rc != CXF_OK) {
-        return rc;
+        state->minor_count = 0;
+        return (rc == CXF_UNBOUNDED) ? ITERATE_UNBOUNDED : rc;
+    }
+    if (leavingRow < 0) {
+        return flip_entering(state, entering, pivotCol);
     }
 
     /*=========================================================================
-     * Step 4: Compute step size
+     * Step 5: Pivot row e_r^T B^(-1) [A I] for the reduced cost update,
+     * and step size. Minor iterations need no pivot row.
      *=========================================================================*/
     if (fabs(pivotElement) < CXF_PIVOT_TOL) {
+        state->minor_count = 0;
         return CXF_NUMERIC;  /* Pivot too small */
     }
 
+    int have_row = (minor < 0 &&
+                    compute_pivot_row(state, model->matrix, leavingRow) == CXF_OK);
+
+    /* Steepest edge: exact gamma_q and a_j^T B^(-T) alpha_q; Devex: the
+     * reference weight of q. Both before the basis changes. */
+    double gamma_q = 0.0;
+    if (have_row && cxf_simplex_edge_prepare(state, entering, &gamma_q) != CXF_OK) {
+        gamma_q = 0.0;
+    }
+
+    /* Check the pivot against the pivot row; a failure makes the next
+     * iteration refactor. Fresh factors are not checked. */
+    if (have_row && basis->pivots_since_refactor > 0) {
+        state->pivot_residual = fabs(pivotElement - state->work_alpha->values[entering]) /
+                                fabs(pivotElement);
+    }
+
     /* Step size based on ratio test.
-     * When entering var increases by stepSize, basic var changes by -stepSize * pivotElement.
-     * - pivotElement > 0: basic var decreases toward lb
-     * - pivotElement < 0: basic var increases toward ub
+     * When entering var moves by stepSize in its direction (+1 up, -1 down),
+     * basic var changes by -stepSize * direction * pivotElement.
+     * - direction * pivotElement > 0: basic var decreases toward lb
+     * - direction * pivotElement < 0: basic var increases toward ub
      */
     int leaving = basis->basic_vars[leavingRow];
     double x_leaving = state->work_x[leaving];
     double lb_leaving = state->work_lb[leaving];
     double ub_leaving = state->work_ub[leaving];
 
-    if (pivotElement > 0) {
+    /* An entering variable at its upper bound decreases: the basic
+     * variables move the other way */
+    double direction = (basis->var_status[entering] == -2) ? -1.0 : 1.0;
+    double delta = direction * pivotElement;
+    if (delta > 0) {
         /* Basic var decreases toward lower bound */
-        stepSize = (x_leaving - lb_leaving) / pivotElement;
+        stepSize = (x_leaving - lb_leaving) / delta;
     } else {
         /* Basic var increases toward upper bound */
-        stepSize = (x_leaving - ub_leaving) / pivotElement;
+        stepSize = (x_leaving - ub_leaving) / delta;
     }
 
     if (stepSize < 0) {
@@ -313,87 +1008,74 @@ int cxf_simplex_iterate(SolverContext *state, CxfEnv *env) {
     }
 
     /*=========================================================================
-     * Step 5: Pivot - update basis and solution
+     * Step 6: Pivot - update basis and solution
      *=========================================================================*/
-    rc = cxf_simplex_step(state, entering, leavingRow, pivotCol, stepSize);
+    rc = cxf_simplex_step_sparse(state, entering, leavingRow, pivotCol, stepSize);
     if (rc != CXF_OK) {
+        state->minor_count = 0;
         return rc;
     }
+    cxf_timing_basis_update(state);
+    cxf_price_rows_set_basic(state->price_rows, entering,
+                             basis->var_status[entering] >= 0);
+    cxf_price_rows_set_basic(state->price_rows, leaving,
+                             basis->var_status[leaving] >= 0);
 
     /*=========================================================================
-     * Step 6: Update objective value
+     * Step 7: Update objective value
      *=========================================================================*/
     double rc_entering = state->work_dj[entering];
-    state->obj_value += rc_entering * stepSize;
+    state->obj_value += rc_entering * direction * stepSize;
 
     /*=========================================================================
-     * Step 7: Update reduced costs
-     * Recompute all reduced costs after pivot for correctness.
-     * Use BTRAN to properly compute dual prices: π = B^(-T) * c_B
+     * Step 8: Update reduced costs from the pivot row; full repricing
+     * only if the row could not be computed. A minor iteration updates the
+     * candidates only.
      *=========================================================================*/
-    {
-        /* Build c_B vector using preallocated work array */
-        double *cB = state->work_cB;
-        for (int i = 0; i < m; i++) {
-            int basic_var = basis->basic_vars[i];
-            if (basic_var >= 0 && basic_var < total_vars) {
-                cB[i] = state->work_obj[basic_var];
-            } else {
-                cB[i] = 0.0;
-            }
-        }
+    if (minor >= 0) {
+        cxf_simplex_minor_update(state, minor, leavingRow, leaving);
+    } else if (have_row) {
+        update_duals(state, entering, leaving, pivotElement);
+    } else {
+        update_reduced_costs(state);
+    }
 
-        /* Compute π = B^(-T) * c_B using BTRAN */
-        extern int cxf_btran_vec(BasisState *basis, const double *input, double *result);
-        int btran_rc = cxf_btran_vec(basis, cB, state->work_pi);
-        if (btran_rc != CXF_OK) {
-            /* Fallback to simple approximation if BTRAN fails */
-            for (int i = 0; i < m; i++) {
-                state->work_pi[i] = cB[i];
-            }
+    /* Pricing weights across the basis change */
+    if (state->pricing != NULL) {
+        int edges = have_row && gamma_q > 0.0;
+        cxf_pricing_update(state->pricing, entering, leaving, pivotElement,
+                           gamma_q, have_row ? state->work_alpha : NULL,
+                           edges ? state->work_edge : NULL);
+        if (state->pricing->weights != NULL && !edges) {
+            state->pricing->weights_ready = 0;
         }
-
-        /* Compute reduced costs for all variables */
-        for (int j = 0; j < total_vars; j++) {
-            if (basis->var_status[j] >= 0) {
-                /* Basic variable: reduced cost = 0 */
-                state->work_dj[j] = 0.0;
-            } else {
-                /* Nonbasic variable: dj = cj - pi^T * Aj */
-                double dj = state->work_obj[j];
-
-                if (j < n && model->matrix != NULL) {
-                    /* Original variable: subtract pi^T * column_j */
-                    int64_t start = model->matrix->col_ptr[j];
-                    int64_t end = model->matrix->col_ptr[j + 1];
-                    for (int64_t k = start; k < end; k++) {
-                        int row = model->matrix->row_idx[k];
-                        dj -= state->work_pi[row] * model->matrix->values[k];
-                    }
-                } else if (j >= n) {
-                    /* Auxiliary variable j corresponds to row (j - n) */
-                    int row = j - n;
-                    if (row >= 0 && row < m) {
-                        /* Use diag_coeff from basis if available */
-                        double coeff = (basis->diag_coeff != NULL) ?
-                            basis->diag_coeff[row] :
-                            get_auxiliary_coeff_fallback(model->matrix, row);
-                        dj -= state->work_pi[row] * coeff;
-                    }
-                }
-
-                state->work_dj[j] = dj;
-            }
+        if (edges && state->pricing->heap != NULL) {
+            touch_pricing_heap(state, entering, leaving);
+        } else {
+            state->pricing->heap_ready = 0;
         }
     }
 
-    /*=========================================================================
-     * Step 8: Check refactorization
-     *=========================================================================*/
-    if (basis->pivots_since_refactor >= REFACTOR_INTERVAL) {
-        cxf_basis_refactor(basis);
-    }
-
     state->iteration++;
     return ITERATE_CONTINUE;
 }
+
+/**
+ * @brief Perform one simplex iteration.
+ *
+ * The caller may change the reduced costs, bounds or basis between a
+ * result other than ITERATE_CONTINUE and the next call, so the pricing
+ * heap is rebuilt then.
+ *
+ * @param state Solver context
+ * @param env Environment
+ * @return ITERATE_CONTINUE (0) to continue, ITERATE_OPTIMAL (1) if optimal,
+ *         ITERATE_UNBOUNDED (3) if unbounded, or error code
+ */
+int cxf_simplex_iterate(SolverContext *state, CxfEnv *env) {
+    int rc = simplex_iterate(state, env);
+    if (rc != ITERATE_CONTINUE && state != NULL && state->pricing != NULL) {
+        state->pricing->heap_ready = 0;
+    }
+    return rc;
+}
@@ -0,0 +1,218 @@
+/**
+ * @file multi_price.c
+ * @brief Multiple pricing: minor iterations over a set of candidates.
+ *
+ * A major iteration prices all variables, takes the best CXF_MULTI_PRICE
+ * candidates and FTRANs their columns together. The minor iterations that
+ * follow pivot among these candidates only: after each pivot with column
+ * alpha_q and pivot row r the other columns and reduced costs follow from
+ * the eta of the pivot,
+ *
+ *   alpha_rj <- alpha_rj / alpha_rq
+ *   alpha_ij <- alpha_ij - alpha_iq * alpha_rj    (i != r)
+ *   d_j      <- d_j - d_q * alpha_rj
+ *
+ * so a minor iteration needs neither a FTRAN nor a BTRAN nor a PRICE. The
+ * reduced costs of the other variables go stale; the next major iteration
+ * recomputes them all once, when no candidate is attractive any more.
+ * Candidates whose improvement has fallen well below the best one at the
+ * start end the major iteration early: pivoting on them costs more
+ * iterations than the PRICE they save.
+ *
+ * With a worker pool (state->pool) the work of a major iteration is
+ * spread over the threads, PAMI style: the candidate scan is split into
+ * blocks (cxf_pricing_candidates), the candidate columns are scattered
+ * one task per slot, and after each minor pivot every other slot is
+ * carried across it in its own task. The candidate FTRANs stay one
+ * cxf_ftran_multi: it already solves the columns together in a single
+ * sweep of the factors, and the solves share the factor workspaces. Each
+ * slot is written by one task only, so the minor iterations are the same
+ * with any number of threads.
+ */
+
+#include "convexfeld/cxf_solver.h"
+#include "convexfeld/cxf_basis.h"
+#include "convexfeld/cxf_model.h"
+#include "convexfeld/cxf_matrix.h"
+#include "convexfeld/cxf_types.h"
+#include <math.h>
+#include <string.h>
+
+/* A candidate is taken while its |d_j| is at least this fraction of the
+ * best one at the start of the major iteration */
+#define MINOR_DROP_RATIO 0.5
+
+/* Slots are loaded in parallel from this many rows, and carried across a
+ * minor pivot in parallel once the pivot column has this many nonzeros */
+#define MINOR_PAR_NNZ 2048
+
+extern int cxf_ftran_multi(BasisState *basis, int k, const double *columns, double *result);
+extern void cxf_vector_clear(VectorContainer *vec);
+extern void cxf_pool_run(CxfThreadPool *pool, int tasks,
+                         void (*fn)(void *arg, int task), void *arg);
+
+/**
+ * @brief Scatter the column of the candidate in slot s into minor_cols.
+ */
+static void load_slot(void *arg, int s) {
+    SolverContext *state = (SolverContext *)arg;
+    const SparseMatrix *A = state->model_ref->matrix;
+    const BasisState *basis = state->basis;
+    int n = state->num_vars;
+    int j = state->minor_vars[s];
+    double *a = state->minor_cols + (size_t)s * (size_t)state->num_constrs;
+
+    memset(a, 0, (size_t)state->num_constrs * sizeof(double));
+    if (j < n) {
+        for (int64_t p = A->col_ptr[j]; p < A->col_ptr[j + 1]; p++) {
+            a[A->row_idx[p]] += A->values[p];
+        }
+    } else {
+        a[j - n] = (basis->diag_coeff != NULL) ? basis->diag_coeff[j - n] : 1.0;
+    }
+}
+
+/** @brief A minor pivot: the entering slot, its column and pivot row. */
+typedef struct {
+    SolverContext *state;
+    int slot;
+    int row;
+    double alpha_rq;
+    double d_q;
+} MinorPivot;
+
+/**
+ * @brief Carry slot s across the minor pivot (nothing for the entering
+ *        slot or one that has already entered).
+ */
+static void update_slot(void *arg, int s) {
+    const MinorPivot *pv = (const MinorPivot *)arg;
+    SolverContext *state = pv->state;
+    const VectorContainer *alpha_q = state->work_column;
+    if (s == pv->slot || state->minor_vars[s] < 0) {
+        return;
+    }
+
+    double *alpha_j = state->minor_cols + (size_t)s * (size_t)state->num_constrs;
+    double t = alpha_j[pv->row] / pv->alpha_rq;
+    if (t != 0.0) {
+        for (int k = 0; k < alpha_q->size; k++) {
+            int i = alpha_q->indices[k];
+            alpha_j[i] -= alpha_q->values[i] * t;
+        }
+        state->minor_dj[s] -= pv->d_q * t;
+    }
+    alpha_j[pv->row] = t;
+}
+
+/**
+ * @brief Load the candidates of a major iteration.
+ *
+ * Scatters the columns of the first CXF_MULTI_PRICE candidates into
+ * minor_cols (one pool task per slot on long columns) and FTRANs them in one
+ * cxf_ftran_multi; the reduced costs come from work_dj.
+ *
+ * @param state Solver context with minor_cols allocated
+ * @param candidates Candidates, best first
+ * @param count Number of candidates
+ * @return CXF_OK or the error of the FTRAN
+ */
+int cxf_simplex_minor_load(SolverContext *state, const int *candidates, int count) {
+    BasisState *basis = state->basis;
+
+    if (count > CXF_MULTI_PRICE) {
+        count = CXF_MULTI_PRICE;
+    }
+    state->minor_count = 0;
+
+    for (int s = 0; s < count; s++) {
+        state->minor_vars[s] = candidates[s];
+        state->minor_dj[s] = state->work_dj[candidates[s]];
+    }
+    CxfThreadPool *pool = (state->num_constrs >= MINOR_PAR_NNZ) ? state->pool : NULL;
+    cxf_pool_run(pool, count, load_slot, state);
+
+    int rc = cxf_ftran_multi(basis, count, state->minor_cols, state->minor_cols);
+    if (rc != CXF_OK) {
+        return rc;
+    }
+    state->minor_count = count;
+    state->minor_floor = MINOR_DROP_RATIO * fabs(state->minor_dj[0]);
+    return CXF_OK;
+}
+
+/**
+ * @brief Choose the entering candidate of a minor iteration.
+ *
+ * The candidate with the largest improving |d_j| above minor_floor is
+ * selected; its column goes to work_column and its reduced cost to
+ * work_dj. When none is left the set is exhausted and minor_count drops
+ * to 0.
+ *
+ * @param state Solver context
+ * @param tol Optimality tolerance
+ * @return Slot of the entering candidate, or -1
+ */
+int cxf_simplex_minor_select(SolverContext *state, double tol) {
+    const int *status = state->basis->var_status;
+    int m = state->num_constrs;
+    int best = -1;
+    double best_score = (state->minor_floor > tol) ? state->minor_floor : tol;
+
+    for (int s = 0; s < state->minor_count; s++) {
+        int j = state->minor_vars[s];
+        if (j < 0 || status[j] >= 0) continue;
+        double d = state->minor_dj[s];
+        double score = (status[j] == -1) ? -d : (status[j] == -2) ? d : fabs(d);
+        if (score > best_score) {
+            best_score = score;
+            best = s;
+        }
+    }
+    if (best < 0) {
+        state->minor_count = 0;
+        return -1;
+    }
+
+    VectorContainer *col = state->work_column;
+    const double *dense = state->minor_cols + (size_t)best * (size_t)m;
+    cxf_vector_clear(col);
+    for (int i = 0; i < m; i++) {
+        if (fabs(dense[i]) > CXF_ZERO_TOL) {
+            col->values[i] = dense[i];
+            col->indices[col->size++] = i;
+        }
+    }
+    state->work_dj[state->minor_vars[best]] = state->minor_dj[best];
+    return best;
+}
+
+/**
+ * @brief Carry the other candidates across a minor pivot.
+ *
+ * Called after the pivot with the column of the entering candidate still
+ * in work_column (for the old basis). Also sets the reduced costs of the
+ * two variables that changed places. Long pivot columns are applied to
+ * the slots over the pool.
+ *
+ * @param state Solver context
+ * @param slot Slot of the entering candidate
+ * @param row Pivot row r
+ * @param leaving Leaving variable
+ */
+void cxf_simplex_minor_update(SolverContext *state, int slot, int row, int leaving) {
+    MinorPivot pv;
+    pv.state = state;
+    pv.slot = slot;
+    pv.row = row;
+    pv.alpha_rq = state->work_column->values[row];
+    pv.d_q = state->minor_dj[slot];
+    int entering = state->minor_vars[slot];
+
+    CxfThreadPool *pool = (state->work_column->size >= MINOR_PAR_NNZ) ? state->pool : NULL;
+    cxf_pool_run(pool, state->minor_count, update_slot, &pv);
+
+    state->minor_vars[slot] = -1;
+    state->work_dj[entering] = 0.0;
+    state->work_dj[leaving] = -pv.d_q / pv.alpha_rq;
+}
@@ -9,13 +9,100 @@
  * during a simplex pivot. Uses Harris two-pass approach for numerical
  * stability: first pass finds minimum ratio with relaxed tolerance,
  * second pass selects largest pivot magnitude among near-minimum ratios.
+ *
+ * cxf_ratio_test_long is the long-step variant of the primal simplex:
+ * the opposite bound of a boxed entering variable is one more
+ * breakpoint, and when it comes first the entering variable just flips
+ * bounds without a basis change. It also moves an entering variable at
+ * its upper bound in the right direction (down).
  */
 
 #include "convexfeld/cxf_solver.h"
 #include "convexfeld/cxf_env.h"
 #include "convexfeld/cxf_basis.h"
 #include "convexfeld/cxf_types.h"
-#include <math.h>
+#include "convexfeld/cxf_kernels.h"
+
+/**
+ * @brief Harris two-pass ratio test over the listed rows.
+ *
+ * Both passes run through the vector kernels where the CPU has them
+ * (src/kernels). Row i blocks when |d_i| exceeds the pivot tolerance:
+ * as the entering variable increases by theta, the basic variable of row
+ * i changes by -theta * d_i, decreasing toward its lower bound for
+ * d_i > 0 and increasing toward its upper bound for d_i < 0. Ties in the
+ * first pass go to the lowest row so the choice does not depend on the
+ * order in which a sparse column lists its rows.
+ *
+ * @param rows Rows to consider, or NULL for all rows.
+ * @param count Number of rows (num_constrs when rows is NULL).
+ * @param minRatio_out Output: minimum ratio of the first pass (may be NULL).
+ */
+static int ratio_test_rows(SolverContext *state, CxfEnv *env,
+                           const double *pivotColumn, const int *rows, int count,
+                           int *leavingRow_out, double *pivotElement_out,
+                           double *minRatio_out) {
+    const CxfKernels *kernels = cxf_kernels();
+    double feasTol = env->feasibility_tol;
+    double relaxedTol = 10.0 * feasTol;
+
+    CxfRatioScan scan;
+    scan.alpha = pivotColumn;
+    scan.rows = rows;
+    scan.count = count;
+    scan.basic_vars = state->basis->basic_vars;
+    scan.x = state->work_x;
+    scan.lb = state->work_lb;
+    scan.ub = state->work_ub;
+    scan.total_vars = state->num_vars + state->num_constrs;
+    scan.infinity = env->infinity;
+
+    /*
+     * First pass: Find minimum ratio with relaxed tolerance. An
+     * ill-conditioned basis raises the pivot tolerance (state->pivot_tol);
+     * if that leaves no blocking row, the default applies rather than
+     * reporting a bounded column unbounded.
+     */
+    double minRatio;
+    int minRow = -1;
+    if (state->pivot_tol > relaxedTol) {
+        minRow = kernels->ratio_min(&scan, state->pivot_tol, feasTol, &minRatio);
+        if (minRow != -1) {
+            relaxedTol = state->pivot_tol;
+        }
+    }
+    if (minRow == -1) {
+        minRow = kernels->ratio_min(&scan, relaxedTol, feasTol, &minRatio);
+    }
+
+    /* Check for unboundedness */
+    if (minRow == -1) {
+        return CXF_UNBOUNDED;
+    }
+
+    /*
+     * Second pass: Select largest pivot magnitude among near-minimum ratios.
+     * This improves numerical stability by avoiding tiny pivot elements.
+     */
+    int finalRow = kernels->ratio_pivot(&scan, relaxedTol, minRatio + feasTol, minRow);
+
+    *leavingRow_out = finalRow;
+    *pivotElement_out = pivotColumn[finalRow];
+    if (minRatio_out != NULL) {
+        *minRatio_out = minRatio;
+    }
+    return CXF_OK;
+}
+
+/**
+ * @brief Negate the listed entries of a sparse column.
+ */
+static void negate_entries(VectorContainer *column) {
+    for (int k = 0; k < column->size; k++) {
+        int i = column->indices[k];
+        column->values[i] = -column->values[i];
+    }
+}
 
 /**
  * @brief Perform Harris two-pass ratio test to select leaving variable.
@@ -37,13 +124,8 @@
 int cxf_ratio_test(SolverContext *state, CxfEnv *env, int enteringVar,
                    const double *pivotColumn, int columnNZ,
                    int *leavingRow_out, double *pivotElement_out) {
-    double feasTol, infinity, relaxedTol;
-    double minRatio, threshold, maxPivot;
-    int minRow, finalRow;
-    int i, basicVar;
-    double d_i, x_i, lb, ub, ratio;
-
-    /* Suppress unused parameter warnings (for future sparse impl) */
+    /* Suppress unused parameter warnings (sparse columns use
+     * cxf_ratio_test_sparse) */
     (void)enteringVar;
     (void)columnNZ;
 
@@ -53,134 +135,91 @@ int cxf_ratio_test(SolverContext *state, CxfEnv *env, int enteringVar,
         return CXF_ERROR_NULL_ARGUMENT;
     }
 
-    /* Extract tolerances from environment */
-    feasTol = env->feasibility_tol;
-    infinity = env->infinity;
-    relaxedTol = 10.0 * feasTol;
-
-    /* Initialize for first pass */
-    minRatio = infinity;
-    minRow = -1;
+    return ratio_test_rows(state, env, pivotColumn, NULL, state->num_constrs,
+                           leavingRow_out, pivotElement_out, NULL);
+}
 
-    /*
-     * First pass: Find minimum ratio with relaxed tolerance.
-     * Skip near-zero pivot elements to avoid numerical instability.
-     */
-    for (i = 0; i < state->num_constrs; i++) {
-        d_i = pivotColumn[i];
+/**
+ * @brief Harris ratio test on a sparse pivot column.
+ *
+ * Same selection as cxf_ratio_test, visiting only the nonzeros of the
+ * pivot column.
+ *
+ * @param state Solver context containing basis, bounds, and current solution
+ * @param env Environment containing tolerance parameters
+ * @param enteringVar Index of variable entering the basis
+ * @param pivotColumn FTRAN result B^-1 A_entering as a sparse accumulator
+ * @param leavingRow_out Output: row index of leaving variable
+ * @param pivotElement_out Output: pivot element value
+ * @return CXF_OK on success, CXF_UNBOUNDED if no variable reaches bound
+ */
+int cxf_ratio_test_sparse(SolverContext *state, CxfEnv *env, int enteringVar,
+                          const VectorContainer *pivotColumn,
+                          int *leavingRow_out, double *pivotElement_out) {
+    (void)enteringVar;
 
-        /* Skip near-zero pivot elements */
-        if (fabs(d_i) <= relaxedTol) {
-            continue;
-        }
+    if (state == NULL || env == NULL || pivotColumn == NULL ||
+        leavingRow_out == NULL || pivotElement_out == NULL) {
+        return CXF_ERROR_NULL_ARGUMENT;
+    }
 
-        /* Get basic variable at this row */
-        basicVar = state->basis->basic_vars[i];
+    return ratio_test_rows(state, env, pivotColumn->values, pivotColumn->indices,
+                           pivotColumn->size, leavingRow_out, pivotElement_out, NULL);
+}
 
-        /* Skip invalid variable indices
-         * Valid range: [0, num_vars + num_constrs) to include artificials */
-        int total_vars = state->num_vars + state->num_constrs;
-        if (basicVar < 0 || basicVar >= total_vars) {
-            continue;
-        }
+/**
+ * @brief Long-step (bound-flipping) primal ratio test on a sparse column.
+ *
+ * The entering variable moves away from its bound: up from its lower
+ * bound, down from its upper bound, in which case the basic variables
+ * move along -alpha and the rows are scanned with the column negated.
+ * The breakpoints are the Harris minimum ratio of the basic variables
+ * and, for a boxed entering variable, its range ub - lb. If the range
+ * comes first (or no basic variable blocks), the iteration is a bound
+ * flip: no variable leaves and *leavingRow_out is -1.
+ *
+ * @param state Solver context containing basis, bounds, and current solution
+ * @param env Environment containing tolerance parameters
+ * @param enteringVar Index of variable entering the basis
+ * @param pivotColumn FTRAN result B^-1 A_entering as a sparse accumulator
+ *        (negated during the scan, restored on return)
+ * @param leavingRow_out Output: row index of leaving variable, -1 for a flip
+ * @param pivotElement_out Output: pivot element value (0 for a flip)
+ * @return CXF_OK on success, CXF_UNBOUNDED if no variable reaches a bound
+ */
+int cxf_ratio_test_long(SolverContext *state, CxfEnv *env, int enteringVar,
+                        VectorContainer *pivotColumn,
+                        int *leavingRow_out, double *pivotElement_out) {
+    if (state == NULL || env == NULL || pivotColumn == NULL ||
+        leavingRow_out == NULL || pivotElement_out == NULL) {
+        return CXF_ERROR_NULL_ARGUMENT;
+    }
 
-        /* Get current value and bounds */
-        x_i = state->work_x[basicVar];
-        lb = state->work_lb[basicVar];
-        ub = state->work_ub[basicVar];
-
-        /* Compute ratio based on sign of pivot coefficient.
-         * When entering var increases by theta, basic var changes by -theta * d_i.
-         * - If d_i > 0: basic var decreases, hits lower bound
-         * - If d_i < 0: basic var increases, hits upper bound
-         */
-        if (d_i > relaxedTol) {
-            /* Positive coefficient: basic var decreases toward lower bound */
-            if (lb <= -infinity) {
-                continue;  /* Lower bound is infinite */
-            }
-            ratio = (x_i - lb) / d_i;
-        } else if (d_i < -relaxedTol) {
-            /* Negative coefficient: basic var increases toward upper bound */
-            if (ub >= infinity) {
-                continue;  /* Upper bound is infinite */
-            }
-            ratio = (x_i - ub) / d_i;  /* d_i < 0 makes this positive */
-        } else {
-            continue;  /* Coefficient too small */
-        }
+    int status = state->basis->var_status[enteringVar];
+    double lb = state->work_lb[enteringVar];
+    double ub = state->work_ub[enteringVar];
+    int boxed = (status == -1 || status == -2) &&
+                lb > -env->infinity && ub < env->infinity;
 
-        /* Update minimum if this ratio is smaller */
-        if (ratio >= -feasTol && ratio < minRatio) {
-            minRatio = ratio;
-            minRow = i;
-        }
+    if (status == -2) {
+        negate_entries(pivotColumn);
     }
-
-    /* Check for unboundedness */
-    if (minRow == -1) {
-        return CXF_UNBOUNDED;
+    double minRatio = 0.0;
+    int rc = ratio_test_rows(state, env, pivotColumn->values, pivotColumn->indices,
+                             pivotColumn->size, leavingRow_out, pivotElement_out,
+                             &minRatio);
+    if (status == -2) {
+        negate_entries(pivotColumn);
     }
 
-    /*
-     * Second pass: Select largest pivot magnitude among near-minimum ratios.
-     * This improves numerical stability by avoiding tiny pivot elements.
-     */
-    threshold = minRatio + feasTol;
-    maxPivot = fabs(pivotColumn[minRow]);
-    finalRow = minRow;
-
-    for (i = 0; i < state->num_constrs; i++) {
-        d_i = pivotColumn[i];
-
-        /* Skip near-zero pivot elements */
-        if (fabs(d_i) <= relaxedTol) {
-            continue;
-        }
-
-        /* Get basic variable at this row */
-        basicVar = state->basis->basic_vars[i];
-
-        /* Skip invalid variable indices (include artificials) */
-        int total_vars2 = state->num_vars + state->num_constrs;
-        if (basicVar < 0 || basicVar >= total_vars2) {
-            continue;
-        }
-
-        /* Get current value and bounds */
-        x_i = state->work_x[basicVar];
-        lb = state->work_lb[basicVar];
-        ub = state->work_ub[basicVar];
-
-        /* Compute ratio (same logic as first pass) */
-        if (d_i > relaxedTol) {
-            /* Positive coefficient: basic var decreases toward lower bound */
-            if (lb <= -infinity) {
-                continue;
-            }
-            ratio = (x_i - lb) / d_i;
-        } else if (d_i < -relaxedTol) {
-            /* Negative coefficient: basic var increases toward upper bound */
-            if (ub >= infinity) {
-                continue;
-            }
-            ratio = (x_i - ub) / d_i;
-        } else {
-            continue;
-        }
-
-        /* If ratio is within threshold, consider this pivot */
-        if (ratio <= threshold) {
-            if (fabs(d_i) > maxPivot) {
-                maxPivot = fabs(d_i);
-                finalRow = i;
-            }
-        }
+    /* The opposite bound of the entering variable comes first: flip */
+    if (boxed && (rc == CXF_UNBOUNDED || (rc == CXF_OK && ub - lb <= minRatio))) {
+        *leavingRow_out = -1;
+        *pivotElement_out = 0.0;
+        return CXF_OK;
     }
-
-    /* Set output parameters */
-    *leavingRow_out = finalRow;
-    *pivotElement_out = pivotColumn[finalRow];
-
-    return CXF_OK;
+    if (rc == CXF_OK) {
+        *pivotElement_out = pivotColumn->values[*leavingRow_out];
+    }
+    return rc;
 }
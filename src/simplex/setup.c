@@ -81,6 +81,11 @@ static int init_pricing(SolverContext *state) {
         return CXF_OK;
     }
 
+    /* Keep the context cxf_simplex_init made for SimplexPricing */
+    if (state->pricing != NULL) {
+        return CXF_OK;
+    }
+
     /* Create pricing context with 3 levels */
     state->pricing = cxf_pricing_create(n, 3);
     if (state->pricing == NULL) {
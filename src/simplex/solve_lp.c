@@ -11,6 +11,7 @@
 #include "convexfeld/cxf_solver.h"
 #include "convexfeld/cxf_model.h"
 #include "convexfeld/cxf_basis.h"
+#include "convexfeld/cxf_pricing.h"
 #include "convexfeld/cxf_env.h"
 #include "convexfeld/cxf_matrix.h"
 #include "convexfeld/cxf_types.h"
@@ -33,6 +34,11 @@ extern int cxf_extract_solution(SolverContext *state, CxfModel *model);
 extern int cxf_simplex_perturbation(SolverContext *state, CxfEnv *env);
 extern int cxf_simplex_unperturb(SolverContext *state, CxfEnv *env);
 extern int cxf_simplex_refine(SolverContext *state, CxfEnv *env);
+extern int cxf_simplex_refresh(SolverContext *state, CxfEnv *env);
+extern int cxf_dual_simplex(SolverContext *state, CxfEnv *env);
+extern ScratchMark cxf_scratch_mark(const ScratchArena *arena);
+extern void *cxf_scratch_alloc(ScratchArena *arena, size_t size);
+extern void cxf_scratch_release(ScratchArena *arena, ScratchMark mark);
 
 /**
  * @brief Set up Phase I with slack/artificial variables.
@@ -301,6 +307,68 @@ static double get_auxiliary_coeff(const SparseMatrix *mat, int row) {
     return 1.0;
 }
 
+/**
+ * @brief Total violation of the original constraints by the structurals.
+ *
+ * Forms A x in one column-wise pass and sums the amount by which each
+ * row misses its sense (violations within CXF_FEASIBILITY_TOL count as
+ * zero).
+ *
+ * @param state Solver context
+ * @param mat Constraint matrix
+ * @param violation Output: sum of row violations
+ * @return CXF_OK or CXF_ERROR_OUT_OF_MEMORY
+ */
+static int constraint_violation(SolverContext *state, const SparseMatrix *mat,
+                                double *violation) {
+    int n = state->num_vars;
+    int m = state->num_constrs;
+
+    ScratchMark mark = cxf_scratch_mark(&state->scratch);
+    double *ax = (double *)cxf_scratch_alloc(&state->scratch,
+                                             (size_t)m * sizeof(double));
+    if (ax == NULL) {
+        cxf_scratch_release(&state->scratch, mark);
+        return CXF_ERROR_OUT_OF_MEMORY;
+    }
+    memset(ax, 0, (size_t)m * sizeof(double));
+
+    for (int j = 0; j < n; j++) {
+        double xj = state->work_x[j];
+        if (xj == 0.0) continue;
+        for (int64_t k = mat->col_ptr[j]; k < mat->col_ptr[j + 1]; k++) {
+            ax[mat->row_idx[k]] += mat->values[k] * xj;
+        }
+    }
+
+    double total = 0.0;
+    for (int i = 0; i < m; i++) {
+        double rhs = mat->rhs ? mat->rhs[i] : 0;
+        char sense = mat->sense ? mat->sense[i] : '<';
+        double viol = 0;
+        if (sense == '<' || sense == 'L') {
+            if (ax[i] > rhs + CXF_FEASIBILITY_TOL) viol = ax[i] - rhs;
+        } else if (sense == '>' || sense == 'G') {
+            if (ax[i] < rhs - CXF_FEASIBILITY_TOL) viol = rhs - ax[i];
+        } else {
+            viol = fabs(ax[i] - rhs);
+            if (viol < CXF_FEASIBILITY_TOL) viol = 0;
+        }
+#ifdef DEBUG_PHASE1
+        if (viol > 1e-8) {
+            int bv = state->basis->basic_vars[i];
+            fprintf(stderr, "  Row[%d] violation=%.6e, basic_var=%d (%s)\n",
+                    i, viol, bv, (bv >= n) ? "AUX" : "ORIG");
+        }
+#endif
+        total += viol;
+    }
+
+    cxf_scratch_release(&state->scratch, mark);
+    *violation = total;
+    return CXF_OK;
+}
+
 /**
  * @brief Compute reduced costs: dj = cj - pi^T * Aj
  *
@@ -325,37 +393,25 @@ static void compute_reduced_costs(SolverContext *state) {
      * Then solve B^T * π = c_B using BTRAN
      */
 
-    /* Build c_B vector (objective coeffs of basic variables) */
-    double *cB = (double *)calloc((size_t)m, sizeof(double));
-    if (cB == NULL) {
-        /* Fallback to simple approximation if allocation fails */
-        for (int i = 0; i < m; i++) {
-            int basic_var = basis->basic_vars[i];
-            if (basic_var >= 0 && basic_var < total_vars) {
-                state->work_pi[i] = state->work_obj[basic_var];
-            } else {
-                state->work_pi[i] = 0.0;
-            }
-        }
-    } else {
-        for (int i = 0; i < m; i++) {
-            int basic_var = basis->basic_vars[i];
-            if (basic_var >= 0 && basic_var < total_vars) {
-                cB[i] = state->work_obj[basic_var];
-            } else {
-                cB[i] = 0.0;
-            }
+    /* Build c_B vector (objective coeffs of basic variables) in the
+     * preallocated work array */
+    double *cB = state->work_cB;
+    for (int i = 0; i < m; i++) {
+        int basic_var = basis->basic_vars[i];
+        if (basic_var >= 0 && basic_var < total_vars) {
+            cB[i] = state->work_obj[basic_var];
+        } else {
+            cB[i] = 0.0;
         }
+    }
 
-        /* Compute π = B^(-T) * c_B using BTRAN */
-        int rc = cxf_btran_vec(basis, cB, state->work_pi);
-        if (rc != CXF_OK) {
-            /* Fallback to simple approximation if BTRAN fails */
-            for (int i = 0; i < m; i++) {
-                state->work_pi[i] = cB[i];
-            }
+    /* Compute π = B^(-T) * c_B using BTRAN */
+    int rc = cxf_btran_vec(basis, cB, state->work_pi);
+    if (rc != CXF_OK) {
+        /* Fallback to simple approximation if BTRAN fails */
+        for (int i = 0; i < m; i++) {
+            state->work_pi[i] = cB[i];
         }
-        free(cB);
     }
 
     /* Step 2: Compute reduced costs for all variables */
@@ -390,6 +446,10 @@ static void compute_reduced_costs(SolverContext *state) {
             state->work_dj[j] = dj;
         }
     }
+
+    if (state->pricing != NULL) {
+        state->pricing->heap_ready = 0;
+    }
 }
 
 /**
@@ -698,6 +758,25 @@ int cxf_solve_lp(CxfModel *model) {
     rc = cxf_simplex_init(model, &state);
     if (rc != CXF_OK) { model->status = rc; return rc; }
 
+    /* Dual simplex (Method = 1). A dual infeasible problem or a run that
+     * ends in numerical trouble is handed to the primal from scratch. */
+    if (state->solve_mode == 1) {
+        status = cxf_dual_simplex(state, env);
+        if (status != CXF_INF_OR_UNBD && status != CXF_NUMERIC) {
+            model->status = status;
+            if (status == CXF_OPTIMAL) {
+                cxf_simplex_refine(state, env);
+                cxf_extract_solution(state, model);
+            }
+            cxf_simplex_final(state);
+            return model->status;
+        }
+        cxf_simplex_final(state);
+        rc = cxf_simplex_init(model, &state);
+        if (rc != CXF_OK) { model->status = rc; return rc; }
+        state->solve_mode = 0;
+    }
+
     int max_iter = state->max_iterations;
 
     /*=========================================================================
@@ -754,172 +833,27 @@ int cxf_solve_lp(CxfModel *model) {
 
         if (status == ITERATE_OPTIMAL) {
             /* Phase I optimal - check if feasible.
-             * Due to numerical drift, recompute actual constraint violations.
+             * The updated x_B may have drifted from A x = b; if the
+             * constraints disagree, refactor and recompute x_B with one
+             * FTRAN, then measure again.
              */
-            double true_infeasibility = 0;
             SparseMatrix *matrix = model->matrix;
-            for (int i = 0; i < state->num_constrs; i++) {
-                /* Compute Ax for this row */
-                double ax = 0;
-                for (int j = 0; j < state->num_vars; j++) {
-                    int64_t cstart = matrix->col_ptr[j];
-                    int64_t cend = matrix->col_ptr[j + 1];
-                    for (int64_t k = cstart; k < cend; k++) {
-                        if (matrix->row_idx[k] == i) {
-                            ax += matrix->values[k] * state->work_x[j];
-                            break;
-                        }
-                    }
-                }
-                double rhs = matrix->rhs ? matrix->rhs[i] : 0;
-                char sense = matrix->sense ? matrix->sense[i] : '<';
-                double violation = 0;
-                if (sense == '<' || sense == 'L') {
-                    if (ax > rhs + CXF_FEASIBILITY_TOL) violation = ax - rhs;
-                } else if (sense == '>' || sense == 'G') {
-                    if (ax < rhs - CXF_FEASIBILITY_TOL) violation = rhs - ax;
-                } else {
-                    violation = fabs(ax - rhs);
-                    if (violation < CXF_FEASIBILITY_TOL) violation = 0;
+            double true_infeasibility;
+            rc = constraint_violation(state, matrix, &true_infeasibility);
+            if (rc == CXF_OK && true_infeasibility > CXF_FEASIBILITY_TOL) {
+                rc = cxf_simplex_refresh(state, env);
+                if (rc == CXF_OK) {
+                    rc = constraint_violation(state, matrix, &true_infeasibility);
                 }
-                true_infeasibility += violation;
 #ifdef DEBUG_PHASE1
-                if (violation > 1e-8) {
-                    int bv = state->basis->basic_vars[i];
-                    int is_aux = (bv >= state->num_vars);
-                    fprintf(stderr, "  Row[%d] violation=%.6e, basic_var=%d (%s)\n",
-                            i, violation, bv, is_aux ? "AUX" : "ORIG");
-                }
+                fprintf(stderr, "  After refresh: true_infeas=%.10f\n", true_infeasibility);
 #endif
-
             }
-
-            /* If there's numerical drift, recompute basic variable values iteratively.
-             * For each row, solve for the basic variable to satisfy the constraint exactly.
-             * May need multiple iterations due to coupling between constraints.
-             */
-            int correction_iters = 0;
-            while (true_infeasibility > CXF_FEASIBILITY_TOL && correction_iters < 10) {
-                correction_iters++;
-                for (int i = 0; i < state->num_constrs; i++) {
-                    int basic_var = state->basis->basic_vars[i];
-                    double rhs = matrix->rhs ? matrix->rhs[i] : 0;
-
-                    if (basic_var < state->num_vars) {
-                        /* Original variable is basic */
-                        double A_basic = 0;
-                        int64_t cstart = matrix->col_ptr[basic_var];
-                        int64_t cend = matrix->col_ptr[basic_var + 1];
-                        for (int64_t k = cstart; k < cend; k++) {
-                            if (matrix->row_idx[k] == i) {
-                                A_basic = matrix->values[k];
-                                break;
-                            }
-                        }
-                        if (fabs(A_basic) > CXF_ZERO_TOL) {
-                            /* Compute Ax excluding basic variable */
-                            double ax_excl = 0;
-                            for (int j = 0; j < state->num_vars; j++) {
-                                if (j == basic_var) continue;
-                                int64_t jstart = matrix->col_ptr[j];
-                                int64_t jend = matrix->col_ptr[j + 1];
-                                for (int64_t k = jstart; k < jend; k++) {
-                                    if (matrix->row_idx[k] == i) {
-                                        ax_excl += matrix->values[k] * state->work_x[j];
-                                        break;
-                                    }
-                                }
-                            }
-                            /* Include auxiliary if nonbasic */
-                            int aux_var = state->num_vars + i;
-                            if (state->basis->var_status[aux_var] < 0) {
-                                double diag = (state->basis->diag_coeff != NULL) ?
-                                              state->basis->diag_coeff[i] : 1.0;
-                                ax_excl += diag * state->work_x[aux_var];
-                            }
-                            state->work_x[basic_var] = (rhs - ax_excl) / A_basic;
-                        }
-                    } else {
-                        /* Auxiliary is basic */
-                        double ax = 0;
-                        for (int j = 0; j < state->num_vars; j++) {
-                            int64_t jstart = matrix->col_ptr[j];
-                            int64_t jend = matrix->col_ptr[j + 1];
-                            for (int64_t k = jstart; k < jend; k++) {
-                                if (matrix->row_idx[k] == i) {
-                                    ax += matrix->values[k] * state->work_x[j];
-                                    break;
-                                }
-                            }
-                        }
-                        double diag = (state->basis->diag_coeff != NULL) ?
-                                      state->basis->diag_coeff[i] : 1.0;
-                        double new_val = (rhs - ax) / diag;
-                        state->work_x[basic_var] = (new_val > 0) ? new_val : 0;
-                    }
-                }
-
-                /* Recompute true infeasibility after correction */
-                true_infeasibility = 0;
-                for (int i = 0; i < state->num_constrs; i++) {
-                    double ax = 0;
-                    for (int j = 0; j < state->num_vars; j++) {
-                        int64_t cstart = matrix->col_ptr[j];
-                        int64_t cend = matrix->col_ptr[j + 1];
-                        for (int64_t k = cstart; k < cend; k++) {
-                            if (matrix->row_idx[k] == i) {
-                                ax += matrix->values[k] * state->work_x[j];
-                                break;
-                            }
-                        }
-                    }
-                    double rhs = matrix->rhs ? matrix->rhs[i] : 0;
-                    char sense = matrix->sense ? matrix->sense[i] : '<';
-                    double viol = 0;
-                    if (sense == '<' || sense == 'L') {
-                        if (ax > rhs + CXF_FEASIBILITY_TOL) viol = ax - rhs;
-                    } else if (sense == '>' || sense == 'G') {
-                        if (ax < rhs - CXF_FEASIBILITY_TOL) viol = rhs - ax;
-                    } else {
-                        viol = fabs(ax - rhs);
-                        if (viol < CXF_FEASIBILITY_TOL) viol = 0;
-                    }
-                    true_infeasibility += viol;
-                }
-#ifdef DEBUG_PHASE1
-                fprintf(stderr, "  Correction iter %d: true_infeas=%.10f\n", correction_iters, true_infeasibility);
-                if (correction_iters == 10 && true_infeasibility > env->feasibility_tol) {
-                    for (int ii = 0; ii < state->num_constrs; ii++) {
-                        double ax2 = 0;
-                        for (int jj = 0; jj < state->num_vars; jj++) {
-                            int64_t cst = matrix->col_ptr[jj];
-                            int64_t cen = matrix->col_ptr[jj + 1];
-                            for (int64_t kk = cst; kk < cen; kk++) {
-                                if (matrix->row_idx[kk] == ii) {
-                                    ax2 += matrix->values[kk] * state->work_x[jj];
-                                    break;
-                                }
-                            }
-                        }
-                        double rhs2 = matrix->rhs ? matrix->rhs[ii] : 0;
-                        char sense2 = matrix->sense ? matrix->sense[ii] : '<';
-                        double viol2 = 0;
-                        if (sense2 == '<' || sense2 == 'L') {
-                            if (ax2 > rhs2 + CXF_FEASIBILITY_TOL) viol2 = ax2 - rhs2;
-                        } else if (sense2 == '>' || sense2 == 'G') {
-                            if (ax2 < rhs2 - CXF_FEASIBILITY_TOL) viol2 = rhs2 - ax2;
-                        } else {
-                            viol2 = fabs(ax2 - rhs2);
-                        }
-                        if (viol2 > 1e-8) {
-                            int bv2 = state->basis->basic_vars[ii];
-                            fprintf(stderr, "    STUCK row[%d]: viol=%.6e, basic=%d, sense='%c', ax=%.6f, rhs=%.6f\n",
-                                    ii, viol2, bv2, sense2, ax2, rhs2);
-                        }
-                    }
-                }
-#endif
-            }  /* End while correction loop */
+            if (rc != CXF_OK) {
+                model->status = rc;
+                cxf_simplex_final(state);
+                return rc;
+            }
 
             /* Use true_infeasibility as the Phase I objective */
             state->obj_value = true_infeasibility;
@@ -1185,7 +1119,7 @@ int cxf_solve_lp(CxfModel *model) {
             model->status = CXF_ERROR_NOT_SUPPORTED;
             cxf_simplex_final(state);
             return CXF_ERROR_NOT_SUPPORTED;
-        } else if (status < 0) {
+        } else if (status < 0 || status == CXF_NUMERIC) {
             model->status = status;
             cxf_simplex_final(state);
             return status;
@@ -1224,7 +1158,7 @@ int cxf_solve_lp(CxfModel *model) {
         } else if (status == ITERATE_INFEASIBLE) {
             model->status = CXF_INFEASIBLE;
             break;
-        } else if (status < 0) {
+        } else if (status < 0 || status == CXF_NUMERIC) {
             model->status = status;
             break;
         }
@@ -8,6 +8,10 @@
  * Executes the core pivot operation in a simplex iteration. Updates the primal
  * solution, basis representation (via eta vector), and variable status arrays.
  * Called after pricing and ratio test have determined entering/leaving variables.
+ *
+ * cxf_simplex_flip_sparse is the step of a bound flip found by the
+ * long-step ratio test: the entering variable moves to its opposite bound
+ * and the basis stays the same.
  */
 
 #include "convexfeld/cxf_solver.h"
@@ -31,6 +35,86 @@
 extern int cxf_pivot_with_eta(BasisState *basis, int pivotRow,
                               const double *pivotCol, int enteringVar,
                               int leavingVar);
+extern int cxf_pivot_with_eta_sparse(BasisState *basis, int pivotRow,
+                                     const VectorContainer *pivotCol,
+                                     int enteringVar, int leavingVar);
+
+/**
+ * @brief Direction of the entering variable: -1 down from its upper bound,
+ *        +1 up otherwise.
+ */
+static double entering_direction(const SolverContext *state, int entering) {
+    return (state->basis->var_status[entering] == -2) ? -1.0 : 1.0;
+}
+
+/**
+ * @brief Move the basic variables along the pivot column: x_B -= step * d.
+ *
+ * stepSize is signed: negative when the entering variable decreases.
+ *
+ * @param rows Rows to update, or NULL for all rows.
+ * @param count Number of rows (num_constrs when rows is NULL).
+ */
+static void update_basic_values(SolverContext *state, const double *pivotCol,
+                                 const int *rows, int count, double stepSize) {
+    /* This includes both structural variables (0 to n-1) and artificial
+     * variables (n to n+m-1) that may be basic during Phase I. */
+    int total_vars = state->num_vars + state->num_constrs;
+    for (int k = 0; k < count; k++) {
+        int i = (rows != NULL) ? rows[k] : k;
+        int basicVar = state->basis->basic_vars[i];
+
+        /* Skip if not a valid variable index */
+        if (basicVar < 0 || basicVar >= total_vars) {
+            continue;
+        }
+
+        state->work_x[basicVar] -= stepSize * pivotCol[i];
+    }
+}
+
+/**
+ * @brief Set the entering variable to its new value.
+ *
+ * var_status == -1: at lower bound, moving away from it
+ * var_status == -2: at upper bound, moving away from it
+ */
+static void update_entering_value(SolverContext *state, int entering, double stepSize) {
+    if (state->basis->var_status[entering] == -1) {
+        /* At lower bound: new value = lower + stepSize */
+        state->work_x[entering] = state->work_lb[entering] + stepSize;
+    } else {
+        /* At upper bound: new value = upper - stepSize */
+        state->work_x[entering] = state->work_ub[entering] - stepSize;
+    }
+}
+
+/**
+ * @brief Fix the leaving variable status based on which bound it hit.
+ *
+ * pivot_with_eta defaults to -1, but we need to check if it should be -2.
+ * The leaving variable value after pivot is state->work_x[leaving].
+ * Compare to bounds to determine correct status.
+ */
+static void fix_leaving_status(SolverContext *state, int leaving) {
+    if (leaving < 0 || leaving >= (state->num_vars + state->num_constrs)) {
+        return;
+    }
+
+    double x_leave = state->work_x[leaving];
+    double lb_leave = state->work_lb[leaving];
+    double ub_leave = state->work_ub[leaving];
+
+    /* Check if closer to upper or lower bound */
+    double dist_to_lb = fabs(x_leave - lb_leave);
+    double dist_to_ub = fabs(x_leave - ub_leave);
+
+    if (dist_to_ub < dist_to_lb && ub_leave < CXF_INFINITY) {
+        /* At upper bound */
+        state->basis->var_status[leaving] = -2;
+    }
+    /* else keep -1 (at lower bound) as set by pivot_with_eta */
+}
 
 /**
  * @brief Execute simplex pivot operation.
@@ -55,7 +139,7 @@ extern int cxf_pivot_with_eta(BasisState *basis, int pivotRow,
  */
 int cxf_simplex_step(SolverContext *state, int entering, int leavingRow,
                      const double *pivotCol, double stepSize) {
-    int i, basicVar, leaving, result;
+    int leaving, result;
 
     /* Validate inputs */
     if (state == NULL || pivotCol == NULL) {
@@ -69,31 +153,11 @@ int cxf_simplex_step(SolverContext *state, int entering, int leavingRow,
     /* Get leaving variable from basis header */
     leaving = state->basis->basic_vars[leavingRow];
 
-    /* Update all basic variable values: x_B[i] -= stepSize * pivotCol[i]
-     * This includes both structural variables (0 to n-1) and artificial
-     * variables (n to n+m-1) that may be basic during Phase I. */
-    int total_vars = state->num_vars + state->num_constrs;
-    for (i = 0; i < state->num_constrs; i++) {
-        basicVar = state->basis->basic_vars[i];
-
-        /* Skip if not a valid variable index */
-        if (basicVar < 0 || basicVar >= total_vars) {
-            continue;
-        }
-
-        state->work_x[basicVar] -= stepSize * pivotCol[i];
-    }
-
-    /* Update entering variable value based on its current bound status
-     * var_status == -1: at lower bound, moving away from it
-     * var_status == -2: at upper bound, moving away from it */
-    if (state->basis->var_status[entering] == -1) {
-        /* At lower bound: new value = lower + stepSize */
-        state->work_x[entering] = state->work_lb[entering] + stepSize;
-    } else {
-        /* At upper bound: new value = upper - stepSize */
-        state->work_x[entering] = state->work_ub[entering] - stepSize;
-    }
+    /* Update all basic variable values: x_B[i] -= stepSize * pivotCol[i],
+     * with the step negated when the entering variable decreases */
+    update_basic_values(state, pivotCol, NULL, state->num_constrs,
+                        entering_direction(state, entering) * stepSize);
+    update_entering_value(state, entering, stepSize);
 
     /* Create eta vector and update basis state
      * This call handles:
@@ -105,28 +169,89 @@ int cxf_simplex_step(SolverContext *state, int entering, int leavingRow,
      */
     result = cxf_pivot_with_eta(state->basis, leavingRow, pivotCol,
                                 entering, leaving);
+    if (result == CXF_OK) {
+        fix_leaving_status(state, leaving);
+    }
 
-    /* Fix leaving variable status based on which bound it hit.
-     * pivot_with_eta defaults to -1, but we need to check if it should be -2.
-     *
-     * The leaving variable value after pivot is state->work_x[leaving].
-     * Compare to bounds to determine correct status.
-     */
-    if (result == CXF_OK && leaving >= 0 && leaving < (state->num_vars + state->num_constrs)) {
-        double x_leave = state->work_x[leaving];
-        double lb_leave = state->work_lb[leaving];
-        double ub_leave = state->work_ub[leaving];
-
-        /* Check if closer to upper or lower bound */
-        double dist_to_lb = fabs(x_leave - lb_leave);
-        double dist_to_ub = fabs(x_leave - ub_leave);
-
-        if (dist_to_ub < dist_to_lb && ub_leave < CXF_INFINITY) {
-            /* At upper bound */
-            state->basis->var_status[leaving] = -2;
-        }
-        /* else keep -1 (at lower bound) as set by pivot_with_eta */
+    return result;
+}
+
+/**
+ * @brief Execute simplex pivot operation with a sparse pivot column.
+ *
+ * Same as cxf_simplex_step, touching only the rows where the pivot
+ * column is nonzero.
+ *
+ * @param state Solver context containing basis, bounds, and current solution.
+ * @param entering Index of variable entering the basis.
+ * @param leavingRow Row index of leaving variable (0 <= row < m).
+ * @param pivotCol FTRAN result B^(-1) * a_entering as a sparse accumulator.
+ * @param stepSize Step length for pivot (distance to bound).
+ * @return CXF_OK on success, -1 if pivot too small (refactorization needed).
+ */
+int cxf_simplex_step_sparse(SolverContext *state, int entering, int leavingRow,
+                            const VectorContainer *pivotCol, double stepSize) {
+    if (state == NULL || pivotCol == NULL) {
+        return CXF_ERROR_NULL_ARGUMENT;
+    }
+
+    if (state->basis == NULL) {
+        return CXF_ERROR_INVALID_ARGUMENT;
+    }
+
+    int leaving = state->basis->basic_vars[leavingRow];
+
+    update_basic_values(state, pivotCol->values, pivotCol->indices,
+                        pivotCol->size, entering_direction(state, entering) * stepSize);
+    update_entering_value(state, entering, stepSize);
+
+    int result = cxf_pivot_with_eta_sparse(state->basis, leavingRow, pivotCol,
+                                           entering, leaving);
+    if (result == CXF_OK) {
+        fix_leaving_status(state, leaving);
     }
 
     return result;
 }
+
+/**
+ * @brief Bound flip: move a boxed nonbasic variable to its opposite bound.
+ *
+ * The basis does not change; the basic variables move along the FTRAN'd
+ * column of the flipping variable, x_B -= (+/-)(ub - lb) * d.
+ *
+ * @param state Solver context containing basis, bounds, and current solution.
+ * @param entering Index of the flipping variable (at a bound, boxed).
+ * @param pivotCol FTRAN result B^(-1) * a_entering as a sparse accumulator.
+ * @return CXF_OK on success, CXF_ERROR_INVALID_ARGUMENT if the variable is
+ *         not at a finite bound.
+ */
+int cxf_simplex_flip_sparse(SolverContext *state, int entering,
+                            const VectorContainer *pivotCol) {
+    if (state == NULL || pivotCol == NULL) {
+        return CXF_ERROR_NULL_ARGUMENT;
+    }
+
+    if (state->basis == NULL) {
+        return CXF_ERROR_INVALID_ARGUMENT;
+    }
+
+    int status = state->basis->var_status[entering];
+    double lb = state->work_lb[entering];
+    double ub = state->work_ub[entering];
+    if ((status != -1 && status != -2) || lb <= -CXF_INFINITY || ub >= CXF_INFINITY) {
+        return CXF_ERROR_INVALID_ARGUMENT;
+    }
+
+    double range = ub - lb;
+    update_basic_values(state, pivotCol->values, pivotCol->indices,
+                        pivotCol->size, entering_direction(state, entering) * range);
+    if (status == -1) {
+        state->work_x[entering] = ub;
+        state->basis->var_status[entering] = -2;
+    } else {
+        state->work_x[entering] = lb;
+        state->basis->var_status[entering] = -1;
+    }
+    return CXF_OK;
+}
@@ -0,0 +1,230 @@
+/**
+ * @file pool.c
+ * @brief Persistent worker threads for the per-iteration parallel kernels.
+ *
+ * The dense LU starts its threads per call, which pays off for a
+ * factorization but not for kernels that run several times per simplex
+ * iteration (the pivot row PRICE, the reduced cost update, the pricing
+ * scan). A pool keeps threads - 1 workers waiting on a condition
+ * variable; cxf_pool_run hands them a set of tasks and the calling
+ * thread takes part as worker 0.
+ *
+ * Tasks are dealt statically: worker w runs tasks w, w + threads, ...
+ * Callers split their work into tasks whose boundaries do not depend on
+ * the number of threads and combine the task results in task order, so
+ * the results are the same with any pool, or none.
+ *
+ * Without pthreads cxf_pool_create returns NULL and cxf_pool_run runs
+ * the tasks in order on the calling thread.
+ */
+
+#include "convexfeld/cxf_types.h"
+#include <stdlib.h>
+
+#ifdef CXF_HAVE_PTHREADS
+#include <pthread.h>
+#endif
+
+/* Most threads in a pool */
+#define POOL_MAX_THREADS 64
+
+#ifdef CXF_HAVE_PTHREADS
+
+/** Arguments of a worker thread */
+typedef struct {
+    CxfThreadPool *pool;
+    int worker;
+} PoolWorker;
+
+struct CxfThreadPool {
+    int threads;                  /**< Workers including the caller */
+    pthread_t tid[POOL_MAX_THREADS];
+    PoolWorker self[POOL_MAX_THREADS];
+    pthread_mutex_t lock;
+    pthread_cond_t start;         /**< Signalled when a run begins or on stop */
+    pthread_cond_t done;          /**< Signalled when the last worker finishes */
+    unsigned generation;          /**< Runs started so far */
+    int pending;                  /**< Workers still busy with the current run */
+    int stop;                     /**< 1 once the pool is being freed */
+    void (*fn)(void *arg, int task);
+    void *arg;
+    int tasks;
+};
+
+/**
+ * @brief Run the tasks of worker w: w, w + threads, ...
+ */
+static void run_share(CxfThreadPool *pool, int w) {
+    for (int t = w; t < pool->tasks; t += pool->threads) {
+        pool->fn(pool->arg, t);
+    }
+}
+
+static void *pool_worker(void *arg) {
+    PoolWorker *self = (PoolWorker *)arg;
+    CxfThreadPool *pool = self->pool;
+    unsigned seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->stop && pool->generation == seen) {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        if (pool->stop) {
+            break;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        run_share(pool, self->worker);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+#else
+
+struct CxfThreadPool {
+    int threads;
+};
+
+#endif /* CXF_HAVE_PTHREADS */
+
+/**
+ * @brief Free a pool, stopping its workers.
+ *
+ * @param pool Pool to free (NULL is safe)
+ */
+void cxf_pool_free(CxfThreadPool *pool) {
+    if (pool == NULL) {
+        return;
+    }
+#ifdef CXF_HAVE_PTHREADS
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    for (int w = 1; w < pool->threads; w++) {
+        pthread_join(pool->tid[w], NULL);
+    }
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+#endif
+    free(pool);
+}
+
+/**
+ * @brief Start a pool of worker threads.
+ *
+ * @param threads Threads including the caller (capped at 64)
+ * @return New pool, or NULL if threads < 2, pthreads are unavailable or
+ *         the threads could not be started (callers then run serially)
+ */
+CxfThreadPool *cxf_pool_create(int threads) {
+#ifdef CXF_HAVE_PTHREADS
+    if (threads < 2) {
+        return NULL;
+    }
+    if (threads > POOL_MAX_THREADS) {
+        threads = POOL_MAX_THREADS;
+    }
+
+    CxfThreadPool *pool = (CxfThreadPool *)calloc(1, sizeof(CxfThreadPool));
+    if (pool == NULL) {
+        return NULL;
+    }
+    if (pthread_mutex_init(&pool->lock, NULL) != 0) {
+        free(pool);
+        return NULL;
+    }
+    if (pthread_cond_init(&pool->start, NULL) != 0) {
+        pthread_mutex_destroy(&pool->lock);
+        free(pool);
+        return NULL;
+    }
+    if (pthread_cond_init(&pool->done, NULL) != 0) {
+        pthread_cond_destroy(&pool->start);
+        pthread_mutex_destroy(&pool->lock);
+        free(pool);
+        return NULL;
+    }
+
+    /* threads counts the workers started so far (and the caller), so a
+     * failed start leaves a pool that cxf_pool_free can stop */
+    pool->threads = 1;
+    for (int w = 1; w < threads; w++) {
+        pool->self[w].pool = pool;
+        pool->self[w].worker = w;
+        if (pthread_create(&pool->tid[w], NULL, pool_worker, &pool->self[w]) != 0) {
+            break;
+        }
+        pool->threads++;
+    }
+    if (pool->threads < 2) {
+        cxf_pool_free(pool);
+        return NULL;
+    }
+    return pool;
+#else
+    (void)threads;
+    return NULL;
+#endif
+}
+
+/**
+ * @brief Threads of a pool, including the caller.
+ *
+ * @param pool Pool, or NULL
+ * @return Thread count (1 for NULL)
+ */
+int cxf_pool_size(const CxfThreadPool *pool) {
+    return (pool != NULL) ? pool->threads : 1;
+}
+
+/**
+ * @brief Run fn(arg, t) for t = 0..tasks-1 and wait for all of them.
+ *
+ * Tasks run concurrently and in no particular order, so they must write
+ * disjoint data. With a NULL pool, or a single task, they run in order
+ * on the calling thread.
+ *
+ * @param pool Pool, or NULL
+ * @param tasks Number of tasks
+ * @param fn Task function
+ * @param arg Argument passed to every task
+ */
+void cxf_pool_run(CxfThreadPool *pool, int tasks,
+                  void (*fn)(void *arg, int task), void *arg) {
+#ifdef CXF_HAVE_PTHREADS
+    if (pool != NULL && tasks > 1) {
+        pthread_mutex_lock(&pool->lock);
+        pool->fn = fn;
+        pool->arg = arg;
+        pool->tasks = tasks;
+        pool->pending = pool->threads - 1;
+        pool->generation++;
+        pthread_cond_broadcast(&pool->start);
+        pthread_mutex_unlock(&pool->lock);
+
+        run_share(pool, 0);
+
+        pthread_mutex_lock(&pool->lock);
+        while (pool->pending > 0) {
+            pthread_cond_wait(&pool->done, &pool->lock);
+        }
+        pthread_mutex_unlock(&pool->lock);
+        return;
+    }
+#else
+    (void)pool;
+#endif
+    for (int t = 0; t < tasks; t++) {
+        fn(arg, t);
+    }
+}
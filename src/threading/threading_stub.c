@@ -9,6 +9,7 @@
  * - config.c: cxf_get_threads, cxf_set_thread_count
  * - cpu.c: cxf_get_physical_cores (cxf_get_logical_processors in logging/system.c)
  * - seed.c: cxf_generate_seed
+ * - pool.c: cxf_pool_create, cxf_pool_free, cxf_pool_size, cxf_pool_run
  *
  * This file is kept for any remaining stub functions that may be needed.
  */
@@ -5,13 +5,69 @@
  * Implements timing functions for specific solver operations:
  * - cxf_timing_pivot: Record work from simplex pivot operations
  * - cxf_timing_refactor: Determine if refactorization is needed
+ * - cxf_timing_refactor_cause: Refactorization decision with its cause
+ * - cxf_timing_basis_update: Track solve cost and update storage
+ * - cxf_timing_refactor_done: Record a refactorization
+ *
+ * The refactorization policy balances the amortized cost of a fresh
+ * factorization against the growth of FTRAN/BTRAN cost caused by the
+ * basis updates. With refactor work F, solve work s_0 right after the
+ * refactorization and s_i after update i, the average cost per iteration
+ * (F + s_1 + ... + s_k) / k stops decreasing once the accumulated excess
+ * sum(s_i - s_0) exceeds F; that is when a refactorization pays off.
  */
 
 #include "convexfeld/cxf_timing.h"
 #include "convexfeld/cxf_solver.h"
+#include "convexfeld/cxf_basis.h"
 #include "convexfeld/cxf_env.h"
 #include <stddef.h>
 
+/** Relative pivot residual above which the factors are considered inaccurate */
+#define REFACTOR_RESIDUAL_TOL 1e-7
+
+/**
+ * @brief Work of one FTRAN or BTRAN with the current basis representation.
+ *
+ * Counts the entries a dense solve touches: the LU factors, the
+ * Forrest-Tomlin row etas and the PFI eta file.
+ */
+static double basis_solve_work(const BasisState *basis) {
+    double work = (double)basis->m;
+    const LUFactors *lu = basis->lu;
+
+    if (lu != NULL && lu->valid) {
+        work += (double)(lu->L_nnz + lu->U_nnz);
+        if (lu->R_count > 0) {
+            work += (double)(lu->R_start[lu->R_count] + lu->R_count);
+        }
+    }
+    if (basis->eta_count > 0) {
+        work += (double)(basis->eta_start[basis->eta_count] + basis->eta_count);
+    }
+    return work;
+}
+
+/**
+ * @brief Bytes held by the basis updates since the last refactorization.
+ */
+static int64_t basis_update_memory(const BasisState *basis) {
+    int64_t entry = (int64_t)(sizeof(int) + sizeof(double));
+    int64_t bytes = 0;
+    const LUFactors *lu = basis->lu;
+
+    if (lu != NULL && lu->valid && lu->R_count > 0) {
+        bytes += lu->R_start[lu->R_count] * entry;
+        bytes += (int64_t)lu->R_count * (int64_t)(sizeof(int) + sizeof(int64_t));
+    }
+    if (basis->eta_count > 0) {
+        bytes += basis->eta_start[basis->eta_count] * entry;
+        bytes += (int64_t)basis->eta_count *
+                 (int64_t)(2 * sizeof(int) + sizeof(double) + sizeof(int64_t));
+    }
+    return bytes;
+}
+
 /**
  * @brief Record computational work from a simplex pivot operation.
  *
@@ -64,46 +120,167 @@ void cxf_timing_pivot(SolverContext *state,
 }
 
 /**
- * @brief Determine if basis refactorization should be triggered.
+ * @brief Decide whether the basis should be refactored, and why.
  *
- * Evaluates multiple criteria to decide if refactorization is needed:
- * - Hard limits: eta count, eta memory (returns 2 = required)
- * - Soft criteria: FTRAN time degradation, iteration count (returns 1 = recommended)
+ * Criteria in order of precedence:
+ * - Structural: no valid factors, or a Forrest-Tomlin update fell back to
+ *   an eta (only checked when the state has a basis)
+ * - Accuracy: relative pivot residual of the last update above tolerance
+ * - Hard limits: eta count, eta memory
+ * - Soft limits: RefactorInterval iterations (halved when the basis
+ *   condition estimate exceeds CXF_COND_ILL, quartered above CXF_COND_SEVERE),
+ *   and the cost model (the
+ *   accumulated solve work in excess of the baseline exceeds the work of
+ *   the last refactorization)
  *
  * @param state Solver state with refactorization tracking (may be NULL)
  * @param env Environment with refactorization parameters (may be NULL)
- * @return 0 = not needed, 1 = recommended, 2 = required
+ * @return One of the CXF_REFACTOR_* causes (CXF_REFACTOR_NONE if not needed)
  */
-int cxf_timing_refactor(SolverContext *state, CxfEnv *env) {
+int cxf_timing_refactor_cause(SolverContext *state, CxfEnv *env) {
     if (state == NULL || env == NULL) {
-        return 0;  /* Cannot evaluate, assume not needed */
+        return CXF_REFACTOR_NONE;  /* Cannot evaluate, assume not needed */
+    }
+
+    /* Check the basis representation */
+    const BasisState *basis = state->basis;
+    if (basis != NULL && basis->update_method == CXF_BASIS_UPDATE_FT) {
+        if (basis->lu == NULL || !basis->lu->valid) {
+            return CXF_REFACTOR_INITIAL;
+        }
+        if (basis->eta_count > 0) {
+            return CXF_REFACTOR_UNSTABLE;
+        }
+    }
+
+    /* Check accuracy (pointless right after a refactorization) */
+    if (state->eta_count > 0 && state->pivot_residual > REFACTOR_RESIDUAL_TOL) {
+        return CXF_REFACTOR_ACCURACY;
     }
 
     /* Check hard limits */
     if (env->max_eta_count > 0 && state->eta_count > env->max_eta_count) {
-        return 2;  /* Required: exceeded max eta count */
+        return CXF_REFACTOR_ETA_COUNT;
     }
 
     if (env->max_eta_memory > 0 && state->eta_memory > env->max_eta_memory) {
-        return 2;  /* Required: exceeded max eta memory */
+        return CXF_REFACTOR_ETA_MEMORY;
     }
 
-    /* Check performance degradation (FTRAN time) */
-    if (state->ftran_count > 0 && state->baseline_ftran > 0.0) {
-        double avg_ftran = state->total_ftran_time / (double)state->ftran_count;
-        /* Recommend refactor if FTRAN is 3x slower than baseline */
-        if (avg_ftran > state->baseline_ftran * 3.0) {
-            return 1;  /* Recommended: FTRAN degradation */
+    /* Check iteration count; an ill-conditioned basis loses accuracy
+     * faster under updates, so it is refactored sooner */
+    if (env->refactor_interval > 0) {
+        int interval = env->refactor_interval;
+        if (state->basis_cond > CXF_COND_SEVERE) {
+            interval /= 4;
+        } else if (state->basis_cond > CXF_COND_ILL) {
+            interval /= 2;
+        }
+        if (interval < 1) interval = 1;
+        int iters_since = state->iteration - state->last_refactor_iter;
+        if (iters_since >= interval) {
+            return CXF_REFACTOR_INTERVAL;
         }
     }
 
-    /* Check iteration count */
-    if (env->refactor_interval > 0) {
-        int iters_since = state->iteration - state->last_refactor_iter;
-        if (iters_since > env->refactor_interval) {
-            return 1;  /* Recommended: exceeded refactor interval */
+    /* Check the cost model: refactor once the growth in solve cost has
+     * paid for a fresh factorization */
+    if (state->ftran_count > 0 && state->baseline_ftran > 0.0) {
+        double excess = state->total_ftran_time -
+                        state->baseline_ftran * (double)state->ftran_count;
+        if (excess > state->refactor_cost) {
+            return CXF_REFACTOR_COST;
         }
     }
 
-    return 0;  /* Not needed */
+    return CXF_REFACTOR_NONE;
+}
+
+/**
+ * @brief Determine if basis refactorization should be triggered.
+ *
+ * Maps cxf_timing_refactor_cause onto an urgency level: structural,
+ * accuracy and hard-limit causes are required, the interval and the
+ * cost model are recommendations.
+ *
+ * @param state Solver state with refactorization tracking (may be NULL)
+ * @param env Environment with refactorization parameters (may be NULL)
+ * @return 0 = not needed, 1 = recommended, 2 = required
+ */
+int cxf_timing_refactor(SolverContext *state, CxfEnv *env) {
+    switch (cxf_timing_refactor_cause(state, env)) {
+        case CXF_REFACTOR_NONE:
+            return 0;
+        case CXF_REFACTOR_INTERVAL:
+        case CXF_REFACTOR_COST:
+            return 1;
+        default:
+            return 2;
+    }
+}
+
+/**
+ * @brief Track solve cost and update storage after a basis update.
+ *
+ * Adds the solve work of the updated representation to the running
+ * total used by the cost model and refreshes eta_count/eta_memory.
+ *
+ * @param state Solver state (may be NULL)
+ */
+void cxf_timing_basis_update(SolverContext *state) {
+    if (state == NULL || state->basis == NULL) {
+        return;
+    }
+
+    const BasisState *basis = state->basis;
+    state->eta_count = basis->pivots_since_refactor;
+    state->eta_memory = basis_update_memory(basis);
+    state->total_ftran_time += basis_solve_work(basis);
+    state->ftran_count++;
+}
+
+/**
+ * @brief Record a completed refactorization.
+ *
+ * Resets the cost model baseline to the fresh factors and adds the
+ * decision, and any singular-basis repairs it made, to the timing
+ * statistics.
+ *
+ * @param state Solver state (may be NULL)
+ * @param cause CXF_REFACTOR_* cause that triggered the refactorization
+ * @param updates Basis updates discarded by the refactorization
+ * @param seconds Wall time spent refactoring
+ */
+void cxf_timing_refactor_done(SolverContext *state, int cause, int updates,
+                              double seconds) {
+    if (state == NULL) {
+        return;
+    }
+
+    state->eta_count = 0;
+    state->eta_memory = 0;
+    state->total_ftran_time = 0.0;
+    state->ftran_count = 0;
+    state->pivot_residual = 0.0;
+    if (state->basis != NULL) {
+        const LUFactors *lu = state->basis->lu;
+        state->baseline_ftran = basis_solve_work(state->basis);
+        state->refactor_cost = (lu != NULL && lu->valid) ?
+            (double)lu->factor_ops : (double)state->basis->m;
+    }
+
+    TimingState *timing = state->timing;
+    if (timing != NULL) {
+        if (cause < 0 || cause >= CXF_REFACTOR_NUM_CAUSES) {
+            cause = CXF_REFACTOR_NONE;
+        }
+        timing->refactor_count++;
+        timing->refactor_causes[cause]++;
+        timing->last_refactor_cause = cause;
+        timing->last_refactor_updates = updates;
+        timing->refactor_time += seconds;
+        if (state->basis != NULL && state->basis->lu != NULL) {
+            timing->basis_repairs += state->basis->lu->repairs;
+        }
+    }
 }
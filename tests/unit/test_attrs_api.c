@@ -156,6 +156,18 @@ void test_getdblattr_objboundc(void) {
     TEST_ASSERT_EQUAL_DOUBLE(200.0, value);
 }
 
+void test_getdblattr_basiscondition(void) {
+    double value;
+    int status = cxf_getdblattr(model, "BasisCondition", &value);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, status);
+    TEST_ASSERT_EQUAL_DOUBLE(0.0, value); /* Not solved yet */
+
+    model->basis_cond = 3.5e4;
+    status = cxf_getdblattr(model, "BasisCondition", &value);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, status);
+    TEST_ASSERT_EQUAL_DOUBLE(3.5e4, value);
+}
+
 void test_getdblattr_maxcoeff(void) {
     double value;
     int status = cxf_getdblattr(model, "MaxCoeff", &value);
@@ -197,6 +209,7 @@ int main(void) {
     RUN_TEST(test_getdblattr_runtime);
     RUN_TEST(test_getdblattr_objbound);
     RUN_TEST(test_getdblattr_objboundc);
+    RUN_TEST(test_getdblattr_basiscondition);
     RUN_TEST(test_getdblattr_maxcoeff);
     RUN_TEST(test_getdblattr_mincoeff);
 
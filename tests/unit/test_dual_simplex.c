@@ -0,0 +1,209 @@
+/**
+ * @file test_dual_simplex.c
+ * @brief Tests for the dual simplex (Method = 1).
+ *
+ * Small LPs that exercise the dual Phase II directly, the dual Phase I
+ * (free and one-sided variables with the wrong reduced cost sign), bound
+ * flips of boxed variables, equality rows, infeasibility detection, and
+ * the fallback to the primal for dual infeasible problems.
+ */
+
+#include "unity.h"
+#include "convexfeld/convexfeld.h"
+#include "convexfeld/cxf_model.h"
+
+int cxf_addconstr(CxfModel *model, int numnz, const int *cind,
+                  const double *cval, char sense, double rhs, const char *name);
+
+static CxfEnv *env = NULL;
+static CxfModel *model = NULL;
+
+void setUp(void) {
+    cxf_loadenv(&env, NULL);
+    cxf_setintparam(env, "Method", 1);
+    cxf_newmodel(env, &model, "dual", 0, NULL, NULL, NULL, NULL, NULL);
+}
+
+void tearDown(void) {
+    cxf_freemodel(model);
+    model = NULL;
+    cxf_freeenv(env);
+    env = NULL;
+}
+
+static void add_row2(double a0, double a1, char sense, double rhs) {
+    int ind[] = {0, 1};
+    double val[] = {a0, a1};
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_addconstr(model, 2, ind, val, sense, rhs, NULL));
+}
+
+static void solve_expect(int expected_status, double expected_obj) {
+    int status;
+    cxf_optimize(model);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_getintattr(model, "Status", &status));
+    TEST_ASSERT_EQUAL_INT(expected_status, status);
+    if (expected_status == CXF_OPTIMAL) {
+        double obj;
+        TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_getdblattr(model, "ObjVal", &obj));
+        TEST_ASSERT_DOUBLE_WITHIN(1e-6, expected_obj, obj);
+    }
+}
+
+/*******************************************************************************
+ * Dual Phase II from the slack basis
+ ******************************************************************************/
+
+/* min x + 2y  s.t.  x + y >= 3, x - y <= 1, x, y >= 0  ->  x = 2, y = 1 */
+void test_dual_covering_lp(void) {
+    cxf_addvar(model, 0, NULL, NULL, 1.0, 0.0, CXF_INFINITY, CXF_CONTINUOUS, "x");
+    cxf_addvar(model, 0, NULL, NULL, 2.0, 0.0, CXF_INFINITY, CXF_CONTINUOUS, "y");
+    add_row2(1.0, 1.0, '>', 3.0);
+    add_row2(1.0, -1.0, '<', 1.0);
+
+    solve_expect(CXF_OPTIMAL, 4.0);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6, 2.0, model->solution[0]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6, 1.0, model->solution[1]);
+}
+
+/* min x + y  s.t.  x + 2y = 4, 3x + y = 7  ->  x = 2, y = 1 */
+void test_dual_equality_rows(void) {
+    cxf_addvar(model, 0, NULL, NULL, 1.0, 0.0, CXF_INFINITY, CXF_CONTINUOUS, "x");
+    cxf_addvar(model, 0, NULL, NULL, 1.0, 0.0, CXF_INFINITY, CXF_CONTINUOUS, "y");
+    add_row2(1.0, 2.0, '=', 4.0);
+    add_row2(3.0, 1.0, '=', 7.0);
+
+    solve_expect(CXF_OPTIMAL, 3.0);
+}
+
+/*******************************************************************************
+ * Bound flips
+ ******************************************************************************/
+
+/* min -3x - 2y - z  s.t.  x + y + z <= 2, 0 <= x, y, z <= 1  ->  -5 */
+void test_dual_boxed_variables_flip(void) {
+    cxf_addvar(model, 0, NULL, NULL, -3.0, 0.0, 1.0, CXF_CONTINUOUS, "x");
+    cxf_addvar(model, 0, NULL, NULL, -2.0, 0.0, 1.0, CXF_CONTINUOUS, "y");
+    cxf_addvar(model, 0, NULL, NULL, -1.0, 0.0, 1.0, CXF_CONTINUOUS, "z");
+    int ind[] = {0, 1, 2};
+    double val[] = {1.0, 1.0, 1.0};
+    cxf_addconstr(model, 3, ind, val, '<', 2.0, NULL);
+
+    solve_expect(CXF_OPTIMAL, -5.0);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6, 1.0, model->solution[0]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6, 1.0, model->solution[1]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-6, 0.0, model->solution[2]);
+}
+
+/* Several breakpoints passed in one ratio test:
+ * min -x0 - x1 - x2 - x3 + 0.5 x4  s.t.  sum(x) <= 1.5, x4 >= 0.5 - x0,
+ * boxes [0, 1] */
+void test_dual_long_step(void) {
+    double obj[] = {-1.0, -1.0, -1.0, -1.0, 0.5};
+    for (int j = 0; j < 5; j++) {
+        cxf_addvar(model, 0, NULL, NULL, obj[j], 0.0, 1.0, CXF_CONTINUOUS, NULL);
+    }
+    int ind[] = {0, 1, 2, 3, 4};
+    double val[] = {1.0, 1.0, 1.0, 1.0, 1.0};
+    cxf_addconstr(model, 5, ind, val, '<', 1.5, NULL);
+    int ind2[] = {0, 4};
+    double val2[] = {1.0, 1.0};
+    cxf_addconstr(model, 2, ind2, val2, '>', 0.5, NULL);
+
+    solve_expect(CXF_OPTIMAL, -1.5);
+}
+
+/*******************************************************************************
+ * Dual Phase I
+ ******************************************************************************/
+
+/* min -x - y  s.t.  x + y <= 4, x <= 2, y <= 3, x, y >= 0  ->  -4 */
+void test_dual_phase_one_unbounded_above(void) {
+    cxf_addvar(model, 0, NULL, NULL, -1.0, 0.0, CXF_INFINITY, CXF_CONTINUOUS, "x");
+    cxf_addvar(model, 0, NULL, NULL, -1.0, 0.0, CXF_INFINITY, CXF_CONTINUOUS, "y");
+    add_row2(1.0, 1.0, '<', 4.0);
+    add_row2(1.0, 0.0, '<', 2.0);
+    add_row2(0.0, 1.0, '<', 3.0);
+
+    solve_expect(CXF_OPTIMAL, -4.0);
+}
+
+/* min x - y  s.t.  x - y >= -5, x + y <= 10, x, y free  ->  -5 */
+void test_dual_phase_one_free_variables(void) {
+    cxf_addvar(model, 0, NULL, NULL, 1.0, -CXF_INFINITY, CXF_INFINITY, CXF_CONTINUOUS, "x");
+    cxf_addvar(model, 0, NULL, NULL, -1.0, -CXF_INFINITY, CXF_INFINITY, CXF_CONTINUOUS, "y");
+    add_row2(1.0, -1.0, '>', -5.0);
+    add_row2(1.0, 1.0, '<', 10.0);
+
+    solve_expect(CXF_OPTIMAL, -5.0);
+}
+
+/*******************************************************************************
+ * Infeasible and dual infeasible problems
+ ******************************************************************************/
+
+/* x + y <= 1, x + 2y >= 4, 3x - y >= 1, x, y in [0, 10] */
+void test_dual_detects_infeasible(void) {
+    cxf_addvar(model, 0, NULL, NULL, 1.0, 0.0, 10.0, CXF_CONTINUOUS, "x");
+    cxf_addvar(model, 0, NULL, NULL, 1.0, 0.0, 10.0, CXF_CONTINUOUS, "y");
+    add_row2(1.0, 1.0, '<', 1.0);
+    add_row2(1.0, 2.0, '>', 4.0);
+    add_row2(3.0, -1.0, '>', 1.0);
+
+    solve_expect(CXF_INFEASIBLE, 0.0);
+}
+
+/* min -x  s.t.  x - y <= 1, x, y >= 0: dual infeasible, the primal decides */
+void test_dual_infeasible_falls_back_to_primal(void) {
+    cxf_addvar(model, 0, NULL, NULL, -1.0, 0.0, CXF_INFINITY, CXF_CONTINUOUS, "x");
+    cxf_addvar(model, 0, NULL, NULL, 0.0, 0.0, CXF_INFINITY, CXF_CONTINUOUS, "y");
+    add_row2(1.0, -1.0, '<', 1.0);
+
+    solve_expect(CXF_UNBOUNDED, 0.0);
+}
+
+/*******************************************************************************
+ * Larger model
+ ******************************************************************************/
+
+/* Transportation problem, 2 sources x 3 sinks: optimum 275 */
+void test_dual_transportation(void) {
+    double cost[] = {4.0, 6.0, 9.0, 5.0, 3.0, 8.0};
+    double supply[] = {30.0, 40.0};
+    double demand[] = {20.0, 25.0, 15.0};
+
+    for (int j = 0; j < 6; j++) {
+        cxf_addvar(model, 0, NULL, NULL, cost[j], 0.0, CXF_INFINITY, CXF_CONTINUOUS, NULL);
+    }
+    for (int s = 0; s < 2; s++) {
+        int ind[] = {3 * s, 3 * s + 1, 3 * s + 2};
+        double val[] = {1.0, 1.0, 1.0};
+        cxf_addconstr(model, 3, ind, val, '<', supply[s], NULL);
+    }
+    for (int d = 0; d < 3; d++) {
+        int ind[] = {d, 3 + d};
+        double val[] = {1.0, 1.0};
+        cxf_addconstr(model, 2, ind, val, '>', demand[d], NULL);
+    }
+
+    solve_expect(CXF_OPTIMAL, 275.0);
+}
+
+/*******************************************************************************
+ * Test runner
+ ******************************************************************************/
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_dual_covering_lp);
+    RUN_TEST(test_dual_equality_rows);
+    RUN_TEST(test_dual_boxed_variables_flip);
+    RUN_TEST(test_dual_long_step);
+    RUN_TEST(test_dual_phase_one_unbounded_above);
+    RUN_TEST(test_dual_phase_one_free_variables);
+    RUN_TEST(test_dual_detects_infeasible);
+    RUN_TEST(test_dual_infeasible_falls_back_to_primal);
+    RUN_TEST(test_dual_transportation);
+
+    return UNITY_END();
+}
@@ -0,0 +1,192 @@
+/**
+ * @file test_kernels.c
+ * @brief Tests for the pricing and ratio-test kernels.
+ *
+ * Every kernel level the CPU supports must return what the scalar
+ * kernels return, ties and remainders included.
+ */
+
+#include "unity.h"
+#include "convexfeld/cxf_types.h"
+#include "convexfeld/cxf_kernels.h"
+#include <stdlib.h>
+
+#define N 1003  /* Not a multiple of the vector width */
+#define M 517
+
+static unsigned seed;
+
+static unsigned next_rand(void) {
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 8;
+}
+
+/* Values from a small set so that ties occur */
+static double coarse(int spread) {
+    return (double)((int)(next_rand() % (unsigned)(2 * spread + 1)) - spread) / 4.0;
+}
+
+void setUp(void) {
+    seed = 12345u;
+}
+
+void tearDown(void) {
+    cxf_kernel_select(CXF_KERNEL_AVX512);
+}
+
+/*============================================================================
+ * Pricing
+ *===========================================================================*/
+
+static void fill_pricing(double *dj, double *weights, int *status, int n) {
+    for (int j = 0; j < n; j++) {
+        dj[j] = coarse(8);
+        weights[j] = (next_rand() % 7 == 0) ? 0.0 : 1.0 + (double)(next_rand() % 4);
+        int kind = (int)(next_rand() % 5);
+        status[j] = (kind == 0) ? (int)(next_rand() % 100) : -1 - (kind % 3);
+    }
+}
+
+void test_kernel_price_matches_scalar(void) {
+    static double dj[N], weights[N];
+    static int status[N];
+    int top = cxf_kernel_level();
+
+    for (int round = 0; round < 20; round++) {
+        int n = N - round * 37;
+        fill_pricing(dj, weights, status, n);
+
+        cxf_kernel_select(CXF_KERNEL_SCALAR);
+        int scanned_ref = 0;
+        int ref_w = cxf_kernels()->price(dj, weights, status, n, 0.3, &scanned_ref);
+        int ref_d = cxf_kernels()->price(dj, NULL, status, n, 0.3, NULL);
+
+        for (int level = CXF_KERNEL_AVX2; level <= top; level++) {
+            TEST_ASSERT_EQUAL_INT(level, cxf_kernel_select(level));
+            int scanned = 0;
+            TEST_ASSERT_EQUAL_INT(ref_w, cxf_kernels()->price(dj, weights, status, n,
+                                                              0.3, &scanned));
+            TEST_ASSERT_EQUAL_INT(scanned_ref, scanned);
+            TEST_ASSERT_EQUAL_INT(ref_d, cxf_kernels()->price(dj, NULL, status, n,
+                                                              0.3, NULL));
+        }
+    }
+}
+
+void test_kernel_price_ties_go_to_smaller_index(void) {
+    double dj[16];
+    int status[16];
+    for (int j = 0; j < 16; j++) {
+        dj[j] = -1.0;
+        status[j] = -1;
+    }
+    status[0] = 0;
+    dj[5] = 1.0;
+    status[5] = -2;  /* Same improvement at upper bound */
+
+    for (int level = CXF_KERNEL_SCALAR; level <= cxf_kernel_level(); level++) {
+        cxf_kernel_select(level);
+        TEST_ASSERT_EQUAL_INT(1, cxf_kernels()->price(dj, NULL, status, 16, 1e-6, NULL));
+    }
+}
+
+void test_kernel_price_optimal_returns_minus_one(void) {
+    double dj[9] = {1.0, 2.0, -3.0, 0.0, 1e-9, -1.0, 4.0, 0.0, 5.0};
+    int status[9] = {-1, -1, -2, -3, -3, 0, -1, 1, -1};
+    for (int level = CXF_KERNEL_SCALAR; level <= cxf_kernel_level(); level++) {
+        cxf_kernel_select(level);
+        int scanned = 0;
+        TEST_ASSERT_EQUAL_INT(-1, cxf_kernels()->price(dj, NULL, status, 9, 1e-6, &scanned));
+        TEST_ASSERT_EQUAL_INT(7, scanned);
+    }
+}
+
+/*============================================================================
+ * Ratio test
+ *===========================================================================*/
+
+void test_kernel_ratio_matches_scalar(void) {
+    static double alpha[M], x[N], lb[N], ub[N];
+    static int basic_vars[M], rows[M];
+    int top = cxf_kernel_level();
+
+    for (int round = 0; round < 20; round++) {
+        for (int j = 0; j < N; j++) {
+            lb[j] = (next_rand() % 6 == 0) ? -CXF_INFINITY : coarse(4);
+            ub[j] = (next_rand() % 6 == 0) ? CXF_INFINITY : lb[j] + 1.0 + coarse(4);
+            x[j] = lb[j] > -CXF_INFINITY ? lb[j] + 0.25 * (double)(next_rand() % 4) : 0.0;
+        }
+        for (int i = 0; i < M; i++) {
+            alpha[i] = (next_rand() % 3 == 0) ? 0.0 : coarse(6);
+            basic_vars[i] = (next_rand() % 50 == 0) ? -1 : (int)(next_rand() % N);
+            rows[i] = i;
+        }
+        /* Unsorted row list, as a sparse column may give */
+        for (int i = M - 1; i > 0; i--) {
+            int k = (int)(next_rand() % (unsigned)(i + 1));
+            int t = rows[i];
+            rows[i] = rows[k];
+            rows[k] = t;
+        }
+
+        CxfRatioScan scan = {alpha, NULL, M - round, basic_vars, x, lb, ub, N,
+                             CXF_INFINITY};
+        for (int sparse = 0; sparse < 2; sparse++) {
+            scan.rows = sparse ? rows : NULL;
+
+            cxf_kernel_select(CXF_KERNEL_SCALAR);
+            double ref_ratio;
+            int ref_row = cxf_kernels()->ratio_min(&scan, 1e-7, 1e-6, &ref_ratio);
+            int ref_pivot = (ref_row >= 0) ?
+                cxf_kernels()->ratio_pivot(&scan, 1e-7, ref_ratio + 0.3, ref_row) : -1;
+
+            for (int level = CXF_KERNEL_AVX2; level <= top; level++) {
+                cxf_kernel_select(level);
+                double ratio;
+                int row = cxf_kernels()->ratio_min(&scan, 1e-7, 1e-6, &ratio);
+                TEST_ASSERT_EQUAL_INT(ref_row, row);
+                if (row < 0) continue;
+                TEST_ASSERT_EQUAL_DOUBLE(ref_ratio, ratio);
+                TEST_ASSERT_EQUAL_INT(ref_pivot,
+                                      cxf_kernels()->ratio_pivot(&scan, 1e-7, ratio + 0.3, row));
+            }
+        }
+    }
+}
+
+void test_kernel_ratio_skips_infinite_bounds(void) {
+    double alpha[5] = {1.0, -1.0, 2.0, 1e-12, 1.0};
+    int basic_vars[5] = {0, 1, 2, 3, -1};
+    double x[4] = {1.0, 1.0, 4.0, 0.0};
+    double lb[4] = {-CXF_INFINITY, 0.0, 0.0, 0.0};
+    double ub[4] = {2.0, CXF_INFINITY, 9.0, 0.0};
+    CxfRatioScan scan = {alpha, NULL, 5, basic_vars, x, lb, ub, 4, CXF_INFINITY};
+
+    for (int level = CXF_KERNEL_SCALAR; level <= cxf_kernel_level(); level++) {
+        cxf_kernel_select(level);
+        double ratio;
+        TEST_ASSERT_EQUAL_INT(2, cxf_kernels()->ratio_min(&scan, 1e-9, 1e-6, &ratio));
+        TEST_ASSERT_EQUAL_DOUBLE(2.0, ratio);
+    }
+}
+
+void test_kernel_select_caps_level(void) {
+    int top = cxf_kernel_level();
+    TEST_ASSERT_TRUE(top >= CXF_KERNEL_SCALAR && top <= CXF_KERNEL_AVX512);
+    TEST_ASSERT_EQUAL_INT(CXF_KERNEL_SCALAR, cxf_kernel_select(CXF_KERNEL_SCALAR));
+    TEST_ASSERT_TRUE(cxf_kernel_select(CXF_KERNEL_AVX512) <= top);
+    TEST_ASSERT_NOT_NULL(cxf_kernels()->price);
+}
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_kernel_price_matches_scalar);
+    RUN_TEST(test_kernel_price_ties_go_to_smaller_index);
+    RUN_TEST(test_kernel_price_optimal_returns_minus_one);
+    RUN_TEST(test_kernel_ratio_matches_scalar);
+    RUN_TEST(test_kernel_ratio_skips_infinite_bounds);
+    RUN_TEST(test_kernel_select_caps_level);
+
+    return UNITY_END();
+}
@@ -5,13 +5,216 @@
 
 #include "unity.h"
 #include "convexfeld/cxf_basis.h"
+#include "convexfeld/cxf_env.h"
+#include "convexfeld/cxf_model.h"
+#include "convexfeld/cxf_matrix.h"
+#include "convexfeld/cxf_solver.h"
 #include "convexfeld/cxf_types.h"
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
 
 /* External function declarations from basis_state.c */
 BasisState *cxf_basis_create(int m, int n);
 void cxf_basis_free(BasisState *basis);
 
+/* Factorization and solves */
+int cxf_solver_refactor(SolverContext *ctx, CxfEnv *env);
+int cxf_ftran(BasisState *basis, const double *column, double *result);
+int cxf_btran_vec(BasisState *basis, const double *input, double *result);
+int cxf_btran(BasisState *basis, int row, double *result);
+int cxf_addconstr(CxfModel *model, int numnz, const int *cind,
+                  const double *cval, char sense, double rhs, const char *name);
+int cxf_pivot_with_eta(BasisState *basis, int pivotRow, const double *pivotCol,
+                       int enteringVar, int leavingVar);
+int cxf_ftran_multi(BasisState *basis, int k, const double *columns, double *result);
+int cxf_btran_multi(BasisState *basis, int k, const double *input, double *result);
+int cxf_lu_dense_factor(double *a, int n, int *perm, int *cperm, int threads);
+int cxf_basis_condest(BasisState *basis, double *cond);
+
+/*******************************************************************************
+ * Helpers for factorization tests
+ ******************************************************************************/
+
+#define FACT_M 5
+
+/**
+ * Build a 5x5 model whose structural columns need row and column
+ * interchanges (and create fill) when factored.
+ */
+static CxfModel *build_fact_model(CxfEnv *env) {
+    CxfModel *model = NULL;
+    cxf_newmodel(env, &model, "lu", 0, NULL, NULL, NULL, NULL, NULL);
+    for (int j = 0; j < FACT_M; j++) {
+        cxf_addvar(model, 0, NULL, NULL, 0.0, 0.0, 10.0, 'C', NULL);
+    }
+    int    c0[] = {0, 1, 4};          double v0[] = {0.5, 2.0, 1.0};
+    int    c1[] = {0, 2};             double v1[] = {4.0, -1.0};
+    int    c2[] = {1, 2, 3};          double v2[] = {1.0, 3.0, 2.0};
+    int    c3[] = {0, 3, 4};          double v3[] = {1.0, 1.0, -2.0};
+    int    c4[] = {2, 4};             double v4[] = {5.0, 1.0};
+    cxf_addconstr(model, 3, c0, v0, '<', 1.0, NULL);
+    cxf_addconstr(model, 2, c1, v1, '<', 1.0, NULL);
+    cxf_addconstr(model, 3, c2, v2, '<', 1.0, NULL);
+    cxf_addconstr(model, 3, c3, v3, '<', 1.0, NULL);
+    cxf_addconstr(model, 2, c4, v4, '<', 1.0, NULL);
+    return model;
+}
+
+/** Dense B[i][j] for the current basis header. */
+static void dense_basis(SolverContext *ctx, double *B) {
+    int m = ctx->num_constrs;
+    SparseMatrix *A = ctx->model_ref->matrix;
+    for (int k = 0; k < m * m; k++) B[k] = 0.0;
+    for (int j = 0; j < m; j++) {
+        int var = ctx->basis->basic_vars[j];
+        if (var < ctx->num_vars) {
+            for (int64_t p = A->col_ptr[var]; p < A->col_ptr[var + 1]; p++) {
+                B[A->row_idx[p] * m + j] = A->values[p];
+            }
+        } else {
+            B[(var - ctx->num_vars) * m + j] = ctx->basis->diag_coeff[var - ctx->num_vars];
+        }
+    }
+}
+
+/** Assert FTRAN and BTRAN solve with the current basis header. */
+static void assert_solves_basis(SolverContext *ctx) {
+    double B[FACT_M * FACT_M];
+    dense_basis(ctx, B);
+
+    double b[FACT_M] = {1.0, -2.0, 3.0, 0.5, 4.0};
+    double x[FACT_M], y[FACT_M];
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_ftran(ctx->basis, b, x));
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_btran_vec(ctx->basis, b, y));
+    for (int i = 0; i < FACT_M; i++) {
+        double rx = 0.0, ry = 0.0;
+        for (int j = 0; j < FACT_M; j++) {
+            rx += B[i * FACT_M + j] * x[j];
+            ry += B[j * FACT_M + i] * y[j];
+        }
+        TEST_ASSERT_DOUBLE_WITHIN(1e-10, b[i], rx);
+        TEST_ASSERT_DOUBLE_WITHIN(1e-10, b[i], ry);
+    }
+}
+
+static void assert_vectors_close(const double *expected, const double *actual) {
+    for (int k = 0; k < FACT_M; k++) {
+        TEST_ASSERT_DOUBLE_WITHIN(1e-12, expected[k], actual[k]);
+    }
+}
+
+/** Assert hypersparse FTRAN/BTRAN of every unit vector match the dense sweeps. */
+static void assert_hyper_matches_dense(BasisState *basis) {
+    LUFactors *lu = basis->lu;
+    double e[FACT_M], xh[FACT_M], xd[FACT_M];
+    for (int i = 0; i < FACT_M; i++) {
+        for (int k = 0; k < FACT_M; k++) e[k] = (k == i) ? 1.0 : 0.0;
+
+        lu->hyper_threshold = 1.0;
+        lu->ftran_density = lu->btran_density = 0.0;
+        TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_ftran(basis, e, xh));
+        lu->hyper_threshold = -1.0;
+        TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_ftran(basis, e, xd));
+        assert_vectors_close(xd, xh);
+
+        lu->hyper_threshold = 1.0;
+        lu->ftran_density = lu->btran_density = 0.0;
+        TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_btran(basis, i, xh));
+        lu->hyper_threshold = -1.0;
+        TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_btran(basis, i, xd));
+        assert_vectors_close(xd, xh);
+    }
+    lu->hyper_threshold = CXF_HYPER_DENSITY;
+
+    /* Workspace is left clean */
+    for (int k = 0; k < FACT_M; k++) TEST_ASSERT_EQUAL_DOUBLE(0.0, lu->hs_x[k]);
+}
+
+/** Assert BTRAN sweeping the row-wise factors matches the column-wise sweep. */
+static void assert_rowwise_btran_matches(BasisState *basis) {
+    LUFactors *lu = basis->lu;
+    double b[FACT_M] = {1.0, -2.0, 0.0, 0.5, 4.0};
+    double yr[FACT_M], yc[FACT_M];
+    lu->hyper_threshold = -1.0;
+    for (int i = -1; i < FACT_M; i++) {
+        lu->rowwise_threshold = 1.0;
+        lu->btran_density = 0.0;
+        if (i < 0) {
+            TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_btran_vec(basis, b, yr));
+        } else {
+            TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_btran(basis, i, yr));
+        }
+        lu->rowwise_threshold = -1.0;
+        if (i < 0) {
+            TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_btran_vec(basis, b, yc));
+        } else {
+            TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_btran(basis, i, yc));
+        }
+        assert_vectors_close(yc, yr);
+    }
+    lu->hyper_threshold = CXF_HYPER_DENSITY;
+    lu->rowwise_threshold = CXF_ROWWISE_DENSITY;
+}
+
+/** Number of vectors in the multi-solve checks (more than one block) */
+#define MULTI_K (CXF_SOLVE_MULTI_LANES + 3)
+
+/**
+ * Assert cxf_ftran_multi/cxf_btran_multi match one-vector solves. The
+ * hypersparse threshold is disabled so that the interleaved sweeps run.
+ */
+static void assert_multi_matches_single(BasisState *basis) {
+    double in[MULTI_K * FACT_M], out[MULTI_K * FACT_M], one[FACT_M];
+    if (basis->lu != NULL) basis->lu->hyper_threshold = -1.0;
+    for (int j = 0; j < MULTI_K; j++) {
+        for (int i = 0; i < FACT_M; i++) {
+            in[j * FACT_M + i] = (j < FACT_M) ? (i == j) : (double)((i + 1) * (j - 4)) / 3.0;
+        }
+    }
+
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_ftran_multi(basis, MULTI_K, in, out));
+    for (int j = 0; j < MULTI_K; j++) {
+        TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_ftran(basis, in + j * FACT_M, one));
+        assert_vectors_close(one, out + j * FACT_M);
+    }
+
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_btran_multi(basis, MULTI_K, in, out));
+    for (int j = 0; j < MULTI_K; j++) {
+        TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_btran_vec(basis, in + j * FACT_M, one));
+        assert_vectors_close(one, out + j * FACT_M);
+    }
+
+    /* In place */
+    double buf[MULTI_K * FACT_M];
+    memcpy(buf, in, sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_btran_multi(basis, MULTI_K, buf, buf));
+    TEST_ASSERT_EQUAL_DOUBLE_ARRAY(out, buf, MULTI_K * FACT_M);
+    if (basis->lu != NULL) basis->lu->hyper_threshold = CXF_HYPER_DENSITY;
+}
+
+/** Assert the row-wise copies hold the same entries as L and U. */
+static void assert_rowwise_matches(const LUFactors *lu) {
+    double Lc[FACT_M * FACT_M] = {0}, Lr[FACT_M * FACT_M] = {0};
+    double Uc[FACT_M * FACT_M] = {0}, Ur[FACT_M * FACT_M] = {0};
+    for (int k = 0; k < FACT_M; k++) {
+        for (int64_t p = lu->L_col_ptr[k]; p < lu->L_col_ptr[k + 1]; p++) {
+            Lc[lu->L_row_idx[p] * FACT_M + k] = lu->L_values[p];
+        }
+        for (int64_t p = lu->Lr_ptr[k]; p < lu->Lr_ptr[k + 1]; p++) {
+            Lr[k * FACT_M + lu->Lr_idx[p]] = lu->Lr_val[p];
+        }
+        for (int64_t p = lu->U_col_ptr[k]; p < lu->U_col_ptr[k] + lu->U_col_len[k]; p++) {
+            Uc[lu->U_row_idx[p] * FACT_M + k] = lu->U_values[p];
+        }
+        for (int64_t p = lu->Ur_start[k]; p < lu->Ur_start[k] + lu->Ur_len[k]; p++) {
+            Ur[k * FACT_M + lu->Ur_idx[p]] = lu->Ur_val[p];
+        }
+    }
+    TEST_ASSERT_EQUAL_DOUBLE_ARRAY(Lc, Lr, FACT_M * FACT_M);
+    TEST_ASSERT_EQUAL_DOUBLE_ARRAY(Uc, Ur, FACT_M * FACT_M);
+}
+
 void setUp(void) {}
 void tearDown(void) {}
 
@@ -140,10 +343,825 @@ void test_basis_with_lu_field(void) {
     TEST_PASS();
 }
 
+/*******************************************************************************
+ * cxf_lu_factorize tests (via cxf_solver_refactor)
+ ******************************************************************************/
+
+void test_lu_factorize_ftran_btran_solve_basis(void) {
+    CxfEnv *env = NULL;
+    cxf_loadenv(&env, NULL);
+    CxfModel *model = build_fact_model(env);
+    SolverContext *ctx = NULL;
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_simplex_init(model, &ctx));
+
+    /* Four structurals plus the slack of row 3 */
+    int header[FACT_M] = {2, 0, 4, FACT_M + 3, 1};
+    for (int i = 0; i < FACT_M; i++) ctx->basis->basic_vars[i] = header[i];
+
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+    TEST_ASSERT_NOT_NULL(ctx->basis->lu);
+    TEST_ASSERT_EQUAL_INT(1, ctx->basis->lu->valid);
+
+    double B[FACT_M * FACT_M];
+    dense_basis(ctx, B);
+
+    double b[FACT_M] = {1.0, -2.0, 3.0, 0.5, 4.0};
+    double x[FACT_M], y[FACT_M];
+
+    /* FTRAN: B x = b */
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_ftran(ctx->basis, b, x));
+    for (int i = 0; i < FACT_M; i++) {
+        double r = 0.0;
+        for (int j = 0; j < FACT_M; j++) r += B[i * FACT_M + j] * x[j];
+        TEST_ASSERT_DOUBLE_WITHIN(1e-10, b[i], r);
+    }
+
+    /* BTRAN: B^T y = b */
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_btran_vec(ctx->basis, b, y));
+    for (int j = 0; j < FACT_M; j++) {
+        double r = 0.0;
+        for (int i = 0; i < FACT_M; i++) r += B[i * FACT_M + j] * y[i];
+        TEST_ASSERT_DOUBLE_WITHIN(1e-10, b[j], r);
+    }
+
+    cxf_simplex_final(ctx);
+    cxf_freemodel(model);
+    cxf_freeenv(env);
+}
+
+void test_hypersparse_solves_match_dense(void) {
+    CxfEnv *env = NULL;
+    cxf_loadenv(&env, NULL);
+    CxfModel *model = build_fact_model(env);
+    SolverContext *ctx = NULL;
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_simplex_init(model, &ctx));
+
+    int header[FACT_M] = {2, 0, 4, FACT_M + 3, 1};
+    for (int i = 0; i < FACT_M; i++) ctx->basis->basic_vars[i] = header[i];
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+    LUFactors *lu = ctx->basis->lu;
+    TEST_ASSERT_TRUE(lu->L_nnz > 0);
+
+    assert_rowwise_matches(lu);
+    assert_hyper_matches_dense(ctx->basis);
+    assert_rowwise_btran_matches(ctx->basis);
+    assert_multi_matches_single(ctx->basis);
+
+    /* A unit FTRAN touches only the reach of its row */
+    double e[FACT_M] = {0.0};
+    double x[FACT_M];
+    int i = lu->perm_row[FACT_M - 1];
+    e[i] = 1.0;
+    lu->hyper_threshold = 1.0;
+    lu->ftran_density = 0.0;
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_ftran(ctx->basis, e, x));
+    TEST_ASSERT_TRUE(lu->ftran_density > 0.0);
+
+    /* Dense right-hand sides decline the hypersparse path */
+    double dense[FACT_M] = {1.0, 1.0, 1.0, 1.0, 1.0};
+    int pattern[FACT_M] = {0, 1, 2, 3, 4};
+    lu->hyper_threshold = CXF_HYPER_DENSITY;
+    TEST_ASSERT_EQUAL_INT(-1, cxf_lu_ftran_hyper(lu, dense, pattern, FACT_M));
+    TEST_ASSERT_EQUAL_INT(-1, cxf_lu_btran_hyper(lu, dense, pattern, FACT_M));
+
+    cxf_simplex_final(ctx);
+    cxf_freemodel(model);
+    cxf_freeenv(env);
+}
+
+void test_lu_factorize_without_rowwise_factors(void) {
+    CxfEnv *env = NULL;
+    cxf_loadenv(&env, NULL);
+    cxf_setintparam(env, "RowwiseFactors", 0);
+    CxfModel *model = build_fact_model(env);
+    SolverContext *ctx = NULL;
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_simplex_init(model, &ctx));
+    TEST_ASSERT_EQUAL_INT(0, ctx->basis->rowwise_factors);
+
+    int header[FACT_M] = {2, 0, 4, FACT_M + 3, 1};
+    for (int i = 0; i < FACT_M; i++) ctx->basis->basic_vars[i] = header[i];
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+    LUFactors *lu = ctx->basis->lu;
+    TEST_ASSERT_EQUAL_INT(0, lu->rowwise);
+    TEST_ASSERT_EQUAL_INT64(0, lu->Lr_ptr[FACT_M]);
+
+    /* BTRAN declines the hypersparse and row-wise paths and still solves */
+    double e[FACT_M] = {0.0, 1.0, 0.0, 0.0, 0.0};
+    int pattern[FACT_M] = {1};
+    lu->hyper_threshold = 1.0;
+    lu->btran_density = 0.0;
+    TEST_ASSERT_EQUAL_INT(-1, cxf_lu_btran_hyper(lu, e, pattern, 1));
+    assert_solves_basis(ctx);
+    assert_multi_matches_single(ctx->basis);
+
+    cxf_simplex_final(ctx);
+    cxf_freemodel(model);
+    cxf_freeenv(env);
+}
+
+void test_lu_factorize_grows_factor_storage(void) {
+    CxfEnv *env = NULL;
+    cxf_loadenv(&env, NULL);
+    CxfModel *model = build_fact_model(env);
+    SolverContext *ctx = NULL;
+    cxf_simplex_init(model, &ctx);
+
+    for (int i = 0; i < FACT_M; i++) ctx->basis->basic_vars[i] = i;
+
+    /* Tiny estimates force reallocation during factorization */
+    ctx->basis->lu = cxf_lu_create(FACT_M, 1, 1);
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+    TEST_ASSERT_TRUE(ctx->basis->lu->L_capacity >= ctx->basis->lu->L_nnz);
+    TEST_ASSERT_TRUE(ctx->basis->lu->U_capacity >= ctx->basis->lu->U_nnz);
+
+    double B[FACT_M * FACT_M];
+    dense_basis(ctx, B);
+    double b[FACT_M] = {0.0, 1.0, 0.0, 0.0, 0.0};
+    double x[FACT_M];
+    cxf_ftran(ctx->basis, b, x);
+    for (int i = 0; i < FACT_M; i++) {
+        double r = 0.0;
+        for (int j = 0; j < FACT_M; j++) r += B[i * FACT_M + j] * x[j];
+        TEST_ASSERT_DOUBLE_WITHIN(1e-10, b[i], r);
+    }
+
+    cxf_simplex_final(ctx);
+    cxf_freemodel(model);
+    cxf_freeenv(env);
+}
+
+void test_lu_factorize_singular_basis(void) {
+    CxfEnv *env = NULL;
+    cxf_loadenv(&env, NULL);
+    CxfModel *model = build_fact_model(env);
+    SolverContext *ctx = NULL;
+    cxf_simplex_init(model, &ctx);
+    BasisState *basis = ctx->basis;
+
+    /* Column 1 twice: structurally singular, row 1 is left uncovered */
+    int header[FACT_M] = {1, 1, FACT_M + 2, FACT_M + 3, FACT_M + 4};
+    for (int i = 0; i < FACT_M; i++) {
+        basis->basic_vars[i] = header[i];
+        basis->var_status[header[i]] = i;
+    }
+
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+    LUFactors *lu = basis->lu;
+    TEST_ASSERT_EQUAL_INT(1, lu->valid);
+    TEST_ASSERT_EQUAL_INT(FACT_M, lu->rank);
+    TEST_ASSERT_EQUAL_INT(1, lu->repairs);
+    TEST_ASSERT_EQUAL_INT(1, lu->repair_var[0]);
+
+    /* The slack of row 1 took one of the two positions */
+    int pos = basis->var_status[FACT_M + 1];
+    TEST_ASSERT_TRUE(pos == 0 || pos == 1);
+    TEST_ASSERT_EQUAL_INT(FACT_M + 1, basis->basic_vars[pos]);
+    TEST_ASSERT_EQUAL_INT(1 - pos, basis->var_status[1]);
+    assert_solves_basis(ctx);
+
+    /* A sound basis needs no repair */
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+    TEST_ASSERT_EQUAL_INT(0, basis->lu->repairs);
+
+    cxf_simplex_final(ctx);
+    cxf_freemodel(model);
+    cxf_freeenv(env);
+}
+
+void test_lu_factorize_empty_column_keeps_bump(void) {
+    CxfEnv *env = NULL;
+    cxf_loadenv(&env, NULL);
+    CxfModel *model = NULL;
+    cxf_newmodel(env, &model, "empty", 0, NULL, NULL, NULL, NULL, NULL);
+    for (int j = 0; j < FACT_M + 1; j++) {
+        cxf_addvar(model, 0, NULL, NULL, 0.0, 0.0, 10.0, 'C', NULL);
+    }
+    /* x0 has no entries; x1..x4 form a full 4x4 bump on rows 0-3 and
+     * row 4 holds only x5, which stays nonbasic */
+    int c[] = {1, 2, 3, 4};
+    for (int i = 0; i < FACT_M - 1; i++) {
+        double v[] = {1.0, 1.0, 1.0, 1.0};
+        v[i] = 4.0;
+        cxf_addconstr(model, 4, c, v, '<', 1.0, NULL);
+    }
+    int c5[] = {5};
+    double v5[] = {1.0};
+    cxf_addconstr(model, 1, c5, v5, '<', 1.0, NULL);
+
+    SolverContext *ctx = NULL;
+    cxf_simplex_init(model, &ctx);
+    BasisState *basis = ctx->basis;
+    for (int i = 0; i < FACT_M; i++) {
+        basis->basic_vars[i] = i;
+        basis->var_status[i] = i;
+        basis->var_status[FACT_M + 1 + i] = -1;
+    }
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+
+    /* Only the empty column is replaced, by the slack of row 4 */
+    LUFactors *lu = basis->lu;
+    TEST_ASSERT_EQUAL_INT(FACT_M, lu->rank);
+    TEST_ASSERT_EQUAL_INT(1, lu->repairs);
+    TEST_ASSERT_EQUAL_INT(0, lu->repair_var[0]);
+    TEST_ASSERT_EQUAL_INT(2 * FACT_M, basis->basic_vars[0]);
+    for (int j = 1; j < FACT_M; j++) {
+        TEST_ASSERT_EQUAL_INT(j, basis->basic_vars[j]);
+    }
+    assert_solves_basis(ctx);
+
+    cxf_simplex_final(ctx);
+    cxf_freemodel(model);
+    cxf_freeenv(env);
+}
+
+/**
+ * 3x3 basis whose first two columns are parallel, so elimination finds
+ * no acceptable pivot for one of them; dense_min 2 sends it through the
+ * dense kernel instead of Markowitz.
+ */
+static void check_numerical_repair(int dense_min) {
+    CxfEnv *env = NULL;
+    cxf_loadenv(&env, NULL);
+    CxfModel *model = NULL;
+    cxf_newmodel(env, &model, "repair", 0, NULL, NULL, NULL, NULL, NULL);
+    for (int j = 0; j < 3; j++) {
+        cxf_addvar(model, 0, NULL, NULL, 0.0, 0.0, 10.0, 'C', NULL);
+    }
+    int c0[] = {0, 1, 2};
+    double v0[] = {1.0, 2.0, 1.0};
+    double v1[] = {2.0, 4.0, 1.0};
+    double v2[] = {3.0, 6.0, 2.0};
+    cxf_addconstr(model, 3, c0, v0, '<', 1.0, NULL);
+    cxf_addconstr(model, 3, c0, v1, '<', 1.0, NULL);
+    cxf_addconstr(model, 3, c0, v2, '<', 1.0, NULL);
+
+    SolverContext *ctx = NULL;
+    cxf_simplex_init(model, &ctx);
+    BasisState *basis = ctx->basis;
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));  /* Slack basis */
+    basis->lu->dense_min = dense_min;
+    for (int i = 0; i < 3; i++) {
+        basis->basic_vars[i] = i;
+        basis->var_status[i] = i;
+        basis->var_status[3 + i] = -1;
+    }
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+
+    /* Rank 2: one structural left, replaced by a slack */
+    LUFactors *lu = basis->lu;
+    TEST_ASSERT_EQUAL_INT(1, lu->repairs);
+    int out = lu->repair_var[0];
+    TEST_ASSERT_TRUE(out >= 0 && out < 3);
+    TEST_ASSERT_EQUAL_INT(-1, basis->var_status[out]);
+
+    double B[9] = {0.0};
+    for (int j = 0; j < 3; j++) {
+        int var = basis->basic_vars[j];
+        TEST_ASSERT_EQUAL_INT(j, basis->var_status[var]);
+        if (var < 3) {
+            for (int i = 0; i < 3; i++) {
+                B[i * 3 + j] = (i == 0) ? v0[var] : (i == 1) ? v1[var] : v2[var];
+            }
+        } else {
+            B[(var - 3) * 3 + j] = basis->diag_coeff[var - 3];
+        }
+    }
+    double b[3] = {1.0, -2.0, 0.5};
+    double x[3], y[3];
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_ftran(basis, b, x));
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_btran_vec(basis, b, y));
+    for (int i = 0; i < 3; i++) {
+        double rx = 0.0, ry = 0.0;
+        for (int j = 0; j < 3; j++) {
+            rx += B[i * 3 + j] * x[j];
+            ry += B[j * 3 + i] * y[j];
+        }
+        TEST_ASSERT_DOUBLE_WITHIN(1e-10, b[i], rx);
+        TEST_ASSERT_DOUBLE_WITHIN(1e-10, b[i], ry);
+    }
+
+    cxf_simplex_final(ctx);
+    cxf_freemodel(model);
+    cxf_freeenv(env);
+}
+
+void test_lu_factorize_repairs_numerically_singular_basis(void) {
+    check_numerical_repair(CXF_LU_DENSE_MIN);
+}
+
+void test_lu_factorize_repairs_singular_dense_bump(void) {
+    check_numerical_repair(2);
+}
+
+/*******************************************************************************
+ * Dense bump tests
+ ******************************************************************************/
+
+#define DENSE_N 150
+#define DENSE_BYTES (DENSE_N * DENSE_N * sizeof(double))
+
+/** Pseudo-random dense matrix (column-major) with entries in [-1, 1]. */
+static void fill_dense(double *a, int n) {
+    unsigned int seed = 12345u;
+    for (int j = 0; j < n; j++) {
+        for (int i = 0; i < n; i++) {
+            seed = seed * 1103515245u + 12345u;
+            a[j * n + i] = (double)((seed >> 16) % 2001u) / 1000.0 - 1.0;
+        }
+    }
+}
+
+/** A(perm, cperm) = L * U on the first rank columns (every 7th checked). */
+static void assert_dense_factors(const double *a, const double *f, int n,
+                                 const int *perm, const int *cperm, int rank) {
+    for (int j = 0; j < rank; j += 7) {
+        for (int i = 0; i < n; i++) {
+            double r = 0.0;
+            for (int k = 0; k <= (i < j ? i : j); k++) {
+                double l = (k == i) ? 1.0 : f[k * n + i];
+                r += l * f[j * n + k];
+            }
+            TEST_ASSERT_DOUBLE_WITHIN(1e-9, a[cperm[j] * n + perm[i]], r);
+        }
+    }
+}
+
+void test_lu_dense_factor_reconstructs_matrix(void) {
+    int n = DENSE_N;
+    double *a = malloc(DENSE_BYTES);
+    double *f = malloc(DENSE_BYTES);
+    double *g = malloc(DENSE_BYTES);
+    int *perm = malloc(4 * DENSE_N * sizeof(int));
+    int *cperm = perm + n;
+    int *perm4 = perm + 2 * n;
+    int *cperm4 = perm + 3 * n;
+    fill_dense(a, n);
+    memcpy(f, a, DENSE_BYTES);
+    memcpy(g, a, DENSE_BYTES);
+
+    TEST_ASSERT_EQUAL_INT(n, cxf_lu_dense_factor(f, n, perm, cperm, 1));
+    for (int k = 0; k < n; k++) TEST_ASSERT_EQUAL_INT(k, cperm[k]);
+    assert_dense_factors(a, f, n, perm, cperm, n);
+
+    /* Threads split the work, not the arithmetic */
+    TEST_ASSERT_EQUAL_INT(n, cxf_lu_dense_factor(g, n, perm4, cperm4, 4));
+    TEST_ASSERT_EQUAL_INT_ARRAY(perm, perm4, n);
+    TEST_ASSERT_EQUAL_MEMORY(f, g, DENSE_BYTES);
+
+    free(a);
+    free(f);
+    free(g);
+    free(perm);
+}
+
+void test_lu_dense_factor_reports_rank(void) {
+    int n = DENSE_N;
+    double *a = malloc(DENSE_BYTES);
+    double *f = malloc(DENSE_BYTES);
+    int *perm = malloc(2 * DENSE_N * sizeof(int));
+    int *cperm = perm + n;
+    fill_dense(a, n);
+
+    /* Column 60 repeats column 10: it is rejected and moved last, and
+     * the remaining columns still pivot */
+    memcpy(a + 60 * n, a + 10 * n, DENSE_N * sizeof(double));
+    memcpy(f, a, DENSE_BYTES);
+    TEST_ASSERT_EQUAL_INT(n - 1, cxf_lu_dense_factor(f, n, perm, cperm, 2));
+    TEST_ASSERT_EQUAL_INT(60, cperm[n - 1]);
+    assert_dense_factors(a, f, n, perm, cperm, n - 1);
+
+    free(a);
+    free(f);
+    free(perm);
+}
+
+void test_lu_factorize_dense_bump(void) {
+    CxfEnv *env = NULL;
+    cxf_loadenv(&env, NULL);
+    CxfModel *model = build_fact_model(env);
+    SolverContext *ctx = NULL;
+    cxf_simplex_init(model, &ctx);
+
+    int header[FACT_M] = {2, 0, 4, FACT_M + 3, 1};
+    for (int i = 0; i < FACT_M; i++) ctx->basis->basic_vars[i] = header[i];
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+    TEST_ASSERT_EQUAL_INT(0, ctx->basis->lu->dense_size);
+
+    /* Hand the whole bump to the dense kernel */
+    ctx->basis->lu->dense_min = 2;
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+    LUFactors *lu = ctx->basis->lu;
+    TEST_ASSERT_TRUE(lu->dense_size >= 2);
+    TEST_ASSERT_EQUAL_INT(FACT_M, lu->rank);
+    assert_solves_basis(ctx);
+    assert_hyper_matches_dense(ctx->basis);
+    assert_rowwise_matches(lu);
+    assert_multi_matches_single(ctx->basis);
+
+    cxf_simplex_final(ctx);
+    cxf_freemodel(model);
+    cxf_freeenv(env);
+}
+
+/*******************************************************************************
+ * Triangular preprocessing tests
+ ******************************************************************************/
+
+void test_lu_factorize_peels_column_singletons(void) {
+    CxfEnv *env = NULL;
+    cxf_loadenv(&env, NULL);
+    CxfModel *model = build_fact_model(env);
+    SolverContext *ctx = NULL;
+    cxf_simplex_init(model, &ctx);
+
+    /* Slacks isolate row 3, leaving column 3 as a singleton: no bump */
+    int header[FACT_M] = {FACT_M + 0, FACT_M + 1, FACT_M + 2, 3, FACT_M + 4};
+    for (int i = 0; i < FACT_M; i++) ctx->basis->basic_vars[i] = header[i];
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+    TEST_ASSERT_EQUAL_INT(0, ctx->basis->lu->bump_size);
+    TEST_ASSERT_EQUAL_INT(FACT_M, ctx->basis->lu->rank);
+    assert_solves_basis(ctx);
+
+    /* A chain of column singletons triggered by removed rows */
+    int chain[FACT_M] = {3, 0, FACT_M + 1, FACT_M + 2, 4};
+    for (int i = 0; i < FACT_M; i++) ctx->basis->basic_vars[i] = chain[i];
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+    TEST_ASSERT_EQUAL_INT(0, ctx->basis->lu->bump_size);
+    assert_solves_basis(ctx);
+
+    /* One slack; the four structurals form a cycle */
+    int cycle[FACT_M] = {2, 0, 4, FACT_M + 3, 1};
+    for (int i = 0; i < FACT_M; i++) ctx->basis->basic_vars[i] = cycle[i];
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+    TEST_ASSERT_EQUAL_INT(FACT_M - 1, ctx->basis->lu->bump_size);
+    assert_solves_basis(ctx);
+
+    cxf_simplex_final(ctx);
+    cxf_freemodel(model);
+    cxf_freeenv(env);
+}
+
+/**
+ * 3x3 basis: rows 0 and 1 couple all three columns, row 2 only holds
+ * column 2 (coefficient a22), so row 2 is a row singleton.
+ */
+static void check_row_singleton(double a22, int expected_bump) {
+    CxfEnv *env = NULL;
+    cxf_loadenv(&env, NULL);
+    CxfModel *model = NULL;
+    cxf_newmodel(env, &model, "rowsing", 0, NULL, NULL, NULL, NULL, NULL);
+    for (int j = 0; j < 3; j++) {
+        cxf_addvar(model, 0, NULL, NULL, 0.0, 0.0, 10.0, 'C', NULL);
+    }
+    int c01[] = {0, 1, 2};
+    double v0[] = {2.0, 1.0, 1.0};
+    double v1[] = {1.0, 3.0, 1.0};
+    int c2[] = {2};
+    double v2[] = {a22};
+    cxf_addconstr(model, 3, c01, v0, '<', 1.0, NULL);
+    cxf_addconstr(model, 3, c01, v1, '<', 1.0, NULL);
+    cxf_addconstr(model, 1, c2, v2, '<', 1.0, NULL);
+
+    SolverContext *ctx = NULL;
+    cxf_simplex_init(model, &ctx);
+    for (int i = 0; i < 3; i++) ctx->basis->basic_vars[i] = i;
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+    TEST_ASSERT_EQUAL_INT(3, ctx->basis->lu->rank);
+    TEST_ASSERT_EQUAL_INT(expected_bump, ctx->basis->lu->bump_size);
+
+    double B[9] = {2.0, 1.0, 1.0,
+                   1.0, 3.0, 1.0,
+                   0.0, 0.0, a22};
+    double b[3] = {1.0, -2.0, 0.5};
+    double x[3], y[3];
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_ftran(ctx->basis, b, x));
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_btran_vec(ctx->basis, b, y));
+    for (int i = 0; i < 3; i++) {
+        double rx = 0.0, ry = 0.0;
+        for (int j = 0; j < 3; j++) {
+            rx += B[i * 3 + j] * x[j];
+            ry += B[j * 3 + i] * y[j];
+        }
+        TEST_ASSERT_DOUBLE_WITHIN(1e-10, b[i], rx);
+        TEST_ASSERT_DOUBLE_WITHIN(1e-10, b[i], ry);
+    }
+
+    cxf_simplex_final(ctx);
+    cxf_freemodel(model);
+    cxf_freeenv(env);
+}
+
+void test_lu_factorize_peels_row_singletons(void) {
+    check_row_singleton(4.0, 2);
+}
+
+void test_lu_factorize_small_row_singleton_stays_in_bump(void) {
+    /* 1e-3 fails the threshold test against the 1.0 entries of column 2 */
+    check_row_singleton(1e-3, 3);
+}
+
+/*******************************************************************************
+ * Forrest-Tomlin update tests
+ ******************************************************************************/
+
+void test_ft_update_tracks_basis_changes(void) {
+    CxfEnv *env = NULL;
+    cxf_loadenv(&env, NULL);
+    CxfModel *model = build_fact_model(env);
+    SolverContext *ctx = NULL;
+    cxf_simplex_init(model, &ctx);
+    BasisState *basis = ctx->basis;
+    basis->update_method = CXF_BASIS_UPDATE_FT;
+
+    /* Start from the slack basis */
+    for (int i = 0; i < FACT_M; i++) {
+        basis->diag_coeff[i] = (i % 2 == 0) ? 1.0 : -1.0;
+        basis->basic_vars[i] = FACT_M + i;
+        basis->var_status[FACT_M + i] = i;
+    }
+    for (int j = 0; j < FACT_M; j++) basis->var_status[j] = -1;
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+
+    /* Bring in every structural, then cycle some slacks back */
+    int entering[] = {2, 0, 4, 1, 3, FACT_M + 1, FACT_M + 3, 2, FACT_M + 0, 0};
+    int updates = 0;
+    for (size_t s = 0; s < sizeof(entering) / sizeof(entering[0]); s++) {
+        int q = entering[s];
+        if (basis->var_status[q] >= 0) continue;
+
+        double a[FACT_M] = {0.0};
+        if (q < FACT_M) {
+            SparseMatrix *A = model->matrix;
+            for (int64_t p = A->col_ptr[q]; p < A->col_ptr[q + 1]; p++) {
+                a[A->row_idx[p]] = A->values[p];
+            }
+        } else {
+            a[q - FACT_M] = basis->diag_coeff[q - FACT_M];
+        }
+        double alpha[FACT_M];
+        cxf_ftran(basis, a, alpha);
+
+        int r = 0;
+        for (int i = 1; i < FACT_M; i++) {
+            if (fabs(alpha[i]) > fabs(alpha[r])) r = i;
+        }
+        TEST_ASSERT_EQUAL_INT(CXF_OK,
+            cxf_pivot_with_eta(basis, r, alpha, q, basis->basic_vars[r]));
+        updates++;
+
+        /* Updated in place: no eta chain, one row eta per update */
+        TEST_ASSERT_EQUAL_INT(0, basis->eta_count);
+        TEST_ASSERT_EQUAL_INT(updates, basis->lu->R_count);
+        assert_solves_basis(ctx);
+        assert_rowwise_matches(basis->lu);
+        assert_hyper_matches_dense(basis);
+        assert_rowwise_btran_matches(basis);
+        assert_multi_matches_single(basis);
+    }
+    TEST_ASSERT_TRUE(updates >= 8);
+
+    cxf_simplex_final(ctx);
+    cxf_freemodel(model);
+    cxf_freeenv(env);
+}
+
+void test_solve_multi_with_eta_file(void) {
+    CxfEnv *env = NULL;
+    cxf_loadenv(&env, NULL);
+    CxfModel *model = build_fact_model(env);
+    SolverContext *ctx = NULL;
+    cxf_simplex_init(model, &ctx);
+    BasisState *basis = ctx->basis;
+    basis->update_method = CXF_BASIS_UPDATE_PFI;
+
+    for (int i = 0; i < FACT_M; i++) {
+        basis->diag_coeff[i] = (i % 2 == 0) ? 1.0 : -1.0;
+        basis->basic_vars[i] = FACT_M + i;
+        basis->var_status[FACT_M + i] = i;
+    }
+    for (int j = 0; j < FACT_M; j++) basis->var_status[j] = -1;
+
+    /* Diagonal slack basis before any factorization */
+    TEST_ASSERT_NULL(basis->lu);
+    assert_multi_matches_single(basis);
+
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+    int entering[] = {2, 0, 4, 1, 3};
+    for (size_t s = 0; s < sizeof(entering) / sizeof(entering[0]); s++) {
+        int q = entering[s];
+        double a[FACT_M] = {0.0};
+        SparseMatrix *A = model->matrix;
+        for (int64_t p = A->col_ptr[q]; p < A->col_ptr[q + 1]; p++) {
+            a[A->row_idx[p]] = A->values[p];
+        }
+        double alpha[FACT_M];
+        cxf_ftran(basis, a, alpha);
+        int r = 0;
+        for (int i = 1; i < FACT_M; i++) {
+            if (fabs(alpha[i]) > fabs(alpha[r])) r = i;
+        }
+        TEST_ASSERT_EQUAL_INT(CXF_OK,
+            cxf_pivot_with_eta(basis, r, alpha, q, basis->basic_vars[r]));
+        TEST_ASSERT_EQUAL_INT((int)s + 1, basis->eta_count);
+        assert_multi_matches_single(basis);
+    }
+
+    /* Zero vectors are a no-op, negative counts are rejected */
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_ftran_multi(basis, 0, NULL, NULL));
+    double v[FACT_M] = {0.0};
+    TEST_ASSERT_EQUAL_INT(CXF_ERROR_INVALID_ARGUMENT, cxf_btran_multi(basis, -1, v, v));
+
+    cxf_simplex_final(ctx);
+    cxf_freemodel(model);
+    cxf_freeenv(env);
+}
+
+void test_ft_update_rejects_unstable_pivot(void) {
+    CxfEnv *env = NULL;
+    cxf_loadenv(&env, NULL);
+    CxfModel *model = build_fact_model(env);
+    SolverContext *ctx = NULL;
+    cxf_simplex_init(model, &ctx);
+    BasisState *basis = ctx->basis;
+
+    for (int i = 0; i < FACT_M; i++) {
+        basis->diag_coeff[i] = 1.0;
+        basis->basic_vars[i] = FACT_M + i;
+    }
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+
+    /* Near-zero pivot element: update must be refused */
+    double alpha[FACT_M] = {1e-20, 1.0, 0.0, 0.0, 0.0};
+    TEST_ASSERT_EQUAL_INT(-1, cxf_lu_ft_update(basis->lu, 0, alpha, NULL, 0));
+    TEST_ASSERT_EQUAL_INT(0, basis->lu->R_count);
+    assert_solves_basis(ctx);
+
+    cxf_simplex_final(ctx);
+    cxf_freemodel(model);
+    cxf_freeenv(env);
+}
+
 /*******************************************************************************
  * Main test runner
  ******************************************************************************/
 
+/*******************************************************************************
+ * Mixed-precision tests
+ ******************************************************************************/
+
+/** Factor the fact-model basis with MixedPrecision set, dense sweeps only. */
+static SolverContext *mixed_context(CxfEnv *env, CxfModel *model) {
+    SolverContext *ctx = NULL;
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_simplex_init(model, &ctx));
+    TEST_ASSERT_EQUAL_INT(1, ctx->basis->mixed_precision);
+
+    int header[FACT_M] = {2, 0, 4, FACT_M + 3, 1};
+    for (int i = 0; i < FACT_M; i++) ctx->basis->basic_vars[i] = header[i];
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+    ctx->basis->lu->hyper_threshold = -1.0;
+    return ctx;
+}
+
+void test_mixed_precision_solves_refine(void) {
+    CxfEnv *env = NULL;
+    cxf_loadenv(&env, NULL);
+    cxf_setintparam(env, "MixedPrecision", 1);
+    CxfModel *model = build_fact_model(env);
+    SolverContext *ctx = mixed_context(env, model);
+    BasisState *basis = ctx->basis;
+    LUFactors *lu = basis->lu;
+
+    TEST_ASSERT_EQUAL_INT(1, lu->single_L);
+    TEST_ASSERT_EQUAL_INT(1, lu->single_U);
+    TEST_ASSERT_TRUE(lu->L_nnz > 0);
+    for (int64_t p = 0; p < lu->L_nnz; p++) {
+        TEST_ASSERT_EQUAL_FLOAT((float)lu->L_values[p], lu->L_val32[p]);
+    }
+
+    /* Refined results are as accurate as the fp64 solves */
+    assert_solves_basis(ctx);
+    assert_rowwise_btran_matches(basis);
+    TEST_ASSERT_EQUAL_INT(1, lu->single_L);
+    TEST_ASSERT_EQUAL_INT(1, lu->single_U);
+
+    /* A Forrest-Tomlin update drops the U copies only */
+    basis->update_method = CXF_BASIS_UPDATE_FT;
+    double a[FACT_M] = {0.0}, alpha[FACT_M];
+    SparseMatrix *A = model->matrix;
+    for (int64_t p = A->col_ptr[3]; p < A->col_ptr[4]; p++) {
+        a[A->row_idx[p]] = A->values[p];
+    }
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_ftran(basis, a, alpha));
+    int r = 0;
+    for (int i = 1; i < FACT_M; i++) {
+        if (fabs(alpha[i]) > fabs(alpha[r])) r = i;
+    }
+    TEST_ASSERT_EQUAL_INT(CXF_OK,
+        cxf_pivot_with_eta(basis, r, alpha, 3, basis->basic_vars[r]));
+    TEST_ASSERT_EQUAL_INT(1, lu->R_count);
+    TEST_ASSERT_EQUAL_INT(1, lu->single_L);
+    TEST_ASSERT_EQUAL_INT(0, lu->single_U);
+    assert_solves_basis(ctx);
+
+    cxf_simplex_final(ctx);
+    cxf_freemodel(model);
+    cxf_freeenv(env);
+}
+
+void test_mixed_precision_falls_back_to_fp64(void) {
+    CxfEnv *env = NULL;
+    cxf_loadenv(&env, NULL);
+    cxf_setintparam(env, "MixedPrecision", 1);
+    CxfModel *model = build_fact_model(env);
+    SolverContext *ctx = mixed_context(env, model);
+    LUFactors *lu = ctx->basis->lu;
+
+    /* Copies far enough off that refinement cannot converge */
+    for (int64_t p = 0; p < lu->L_nnz; p++) {
+        lu->L_val32[p] *= -50.0f;
+    }
+    for (int64_t p = 0; p < lu->U_used; p++) {
+        lu->U_val32[p] *= -50.0f;
+        lu->Ur_val32[p] *= -50.0f;
+    }
+    assert_solves_basis(ctx);
+    TEST_ASSERT_EQUAL_INT(0, lu->single_L);
+    TEST_ASSERT_EQUAL_INT(0, lu->single_U);
+
+    /* The next factorization rebuilds them */
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+    TEST_ASSERT_EQUAL_INT(1, lu->single_L);
+    TEST_ASSERT_EQUAL_INT(1, lu->single_U);
+
+    cxf_simplex_final(ctx);
+    cxf_freemodel(model);
+    cxf_freeenv(env);
+}
+
+/*******************************************************************************
+ * Condition estimate tests
+ ******************************************************************************/
+
+/** Exact ||B||_1 * ||B^(-1)||_1, with B^(-1) formed column by column. */
+static double exact_condition(SolverContext *ctx) {
+    double B[FACT_M * FACT_M];
+    dense_basis(ctx, B);
+
+    double norm_b = 0.0, norm_inv = 0.0;
+    for (int j = 0; j < FACT_M; j++) {
+        double e[FACT_M] = {0.0}, col[FACT_M];
+        e[j] = 1.0;
+        TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_ftran(ctx->basis, e, col));
+        double sb = 0.0, si = 0.0;
+        for (int i = 0; i < FACT_M; i++) {
+            sb += fabs(B[i * FACT_M + j]);
+            si += fabs(col[i]);
+        }
+        if (sb > norm_b) norm_b = sb;
+        if (si > norm_inv) norm_inv = si;
+    }
+    return norm_b * norm_inv;
+}
+
+void test_basis_condest_brackets_exact_condition(void) {
+    CxfEnv *env = NULL;
+    cxf_loadenv(&env, NULL);
+    CxfModel *model = build_fact_model(env);
+    SolverContext *ctx = NULL;
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_simplex_init(model, &ctx));
+
+    int header[FACT_M] = {2, 0, 4, FACT_M + 3, 1};
+    for (int i = 0; i < FACT_M; i++) ctx->basis->basic_vars[i] = header[i];
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+
+    /* A lower bound, within the usual factor of 3 */
+    double cond = 0.0;
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_basis_condest(ctx->basis, &cond));
+    double exact = exact_condition(ctx);
+    TEST_ASSERT_TRUE(cond <= exact * (1.0 + 1e-12));
+    TEST_ASSERT_TRUE(cond >= exact / 3.0);
+
+    /* A nearly dependent basis column drives the estimate up */
+    SparseMatrix *A = model->matrix;
+    for (int64_t p = A->col_ptr[4]; p < A->col_ptr[5]; p++) {
+        A->values[p] *= 1e-9;
+    }
+    TEST_ASSERT_EQUAL_INT(0, cxf_solver_refactor(ctx, env));
+    double ill = 0.0;
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_basis_condest(ctx->basis, &ill));
+    TEST_ASSERT_TRUE(ill > 1e6 * cond);
+    TEST_ASSERT_TRUE(ill <= exact_condition(ctx) * (1.0 + 1e-12));
+
+    /* Without the matrix there is nothing to measure ||B||_1 against */
+    ctx->basis->matrix = NULL;
+    TEST_ASSERT_EQUAL_INT(CXF_ERROR_INVALID_ARGUMENT,
+                          cxf_basis_condest(ctx->basis, &ill));
+
+    cxf_simplex_final(ctx);
+    cxf_freemodel(model);
+    cxf_freeenv(env);
+}
+
 int main(void) {
     UNITY_BEGIN();
 
@@ -165,5 +1183,37 @@ int main(void) {
     /* Integration tests */
     RUN_TEST(test_basis_with_lu_field);
 
+    /* Factorization tests */
+    RUN_TEST(test_lu_factorize_ftran_btran_solve_basis);
+    RUN_TEST(test_lu_factorize_grows_factor_storage);
+    RUN_TEST(test_lu_factorize_singular_basis);
+    RUN_TEST(test_lu_factorize_empty_column_keeps_bump);
+    RUN_TEST(test_lu_factorize_repairs_numerically_singular_basis);
+    RUN_TEST(test_lu_factorize_repairs_singular_dense_bump);
+    RUN_TEST(test_hypersparse_solves_match_dense);
+    RUN_TEST(test_lu_factorize_without_rowwise_factors);
+
+    /* Dense bump tests */
+    RUN_TEST(test_lu_dense_factor_reconstructs_matrix);
+    RUN_TEST(test_lu_dense_factor_reports_rank);
+    RUN_TEST(test_lu_factorize_dense_bump);
+
+    /* Mixed-precision tests */
+    RUN_TEST(test_mixed_precision_solves_refine);
+    RUN_TEST(test_mixed_precision_falls_back_to_fp64);
+
+    /* Condition estimate tests */
+    RUN_TEST(test_basis_condest_brackets_exact_condition);
+
+    /* Triangular preprocessing tests */
+    RUN_TEST(test_lu_factorize_peels_column_singletons);
+    RUN_TEST(test_lu_factorize_peels_row_singletons);
+    RUN_TEST(test_lu_factorize_small_row_singleton_stays_in_bump);
+
+    /* Forrest-Tomlin update tests */
+    RUN_TEST(test_ft_update_tracks_basis_changes);
+    RUN_TEST(test_solve_multi_with_eta_file);
+    RUN_TEST(test_ft_update_rejects_unstable_pivot);
+
     return UNITY_END();
 }
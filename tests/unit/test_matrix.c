@@ -42,6 +42,17 @@ int cxf_finalize_row_data(SparseMatrix *mat);
 void cxf_sort_indices(int *indices, int n);
 void cxf_sort_indices_values(int *indices, double *values, int n);
 
+/* Pivot row PRICE (matrix/price.c) */
+PriceRows *cxf_price_rows_create(const SparseMatrix *matrix);
+void cxf_price_rows_free(PriceRows *rows);
+void cxf_price_rows_set_basic(PriceRows *rows, int var, int basic);
+void cxf_price_rows_sync(PriceRows *rows, const int *var_status);
+int cxf_price_row(PriceRows *rows, const SparseMatrix *matrix,
+                  const int *var_status, const double *slack_coeff,
+                  const double *rho, VectorContainer *alpha);
+VectorContainer *cxf_vector_create(int dim);
+void cxf_vector_free(VectorContainer *vec);
+
 /*******************************************************************************
  * Test fixtures
  ******************************************************************************/
@@ -394,6 +405,145 @@ void test_sort_indices_values_sync(void) {
     TEST_ASSERT_DOUBLE_WITHIN(1e-12, 30.0, values[2]);  /* Was at index 3 */
 }
 
+/*******************************************************************************
+ * Pivot row PRICE tests
+ ******************************************************************************/
+
+#define PRICE_M 20
+#define PRICE_N 100
+
+/* Row 0 is dense; column j also has an entry in row 1 + j % 19 */
+static SparseMatrix *make_price_matrix(void) {
+    SparseMatrix *mat = cxf_sparse_create();
+    cxf_sparse_init_csc(mat, PRICE_M, PRICE_N, 2 * PRICE_N);
+    for (int j = 0; j < PRICE_N; j++) {
+        mat->col_ptr[j] = 2 * j;
+        mat->row_idx[2 * j] = 0;
+        mat->values[2 * j] = 1.0 + 0.01 * j;
+        mat->row_idx[2 * j + 1] = 1 + j % (PRICE_M - 1);
+        mat->values[2 * j + 1] = (j % 2 == 0) ? 2.0 : -0.5;
+    }
+    mat->col_ptr[PRICE_N] = 2 * PRICE_N;
+    return mat;
+}
+
+/* Every third column and every fourth slack basic */
+static void make_price_status(int *status) {
+    for (int j = 0; j < PRICE_N + PRICE_M; j++) {
+        status[j] = (j % 3 == 0 && j < PRICE_N) || (j >= PRICE_N && j % 4 == 0) ?
+                    0 : -1;
+    }
+}
+
+static void check_price_row(const SparseMatrix *mat, const int *status,
+                            const double *coeff, const double *rho,
+                            const VectorContainer *alpha) {
+    double ref[PRICE_N + PRICE_M] = {0.0};
+    for (int j = 0; j < PRICE_N; j++) {
+        if (status[j] >= 0) continue;
+        for (int64_t p = mat->col_ptr[j]; p < mat->col_ptr[j + 1]; p++) {
+            ref[j] += rho[mat->row_idx[p]] * mat->values[p];
+        }
+    }
+    for (int i = 0; i < PRICE_M; i++) {
+        if (status[PRICE_N + i] < 0) ref[PRICE_N + i] = rho[i] * coeff[i];
+    }
+
+    int listed = 0;
+    for (int k = 0; k < alpha->size; k++) {
+        int j = alpha->indices[k];
+        TEST_ASSERT_TRUE(status[j] < 0);
+        listed++;
+    }
+    int nonzero = 0;
+    for (int j = 0; j < PRICE_N + PRICE_M; j++) {
+        TEST_ASSERT_DOUBLE_WITHIN(1e-12, ref[j], alpha->values[j]);
+        if (alpha->values[j] != 0.0) nonzero++;
+    }
+    TEST_ASSERT_EQUAL_INT(nonzero, listed);
+}
+
+void test_price_row_selects_kernel_by_density(void) {
+    SparseMatrix *mat = make_price_matrix();
+    PriceRows *rows = cxf_price_rows_create(mat);
+    VectorContainer *alpha = cxf_vector_create(PRICE_N + PRICE_M);
+    TEST_ASSERT_NOT_NULL(rows);
+    TEST_ASSERT_NOT_NULL(alpha);
+
+    int status[PRICE_N + PRICE_M];
+    double coeff[PRICE_M];
+    double rho[PRICE_M];
+    make_price_status(status);
+    for (int i = 0; i < PRICE_M; i++) coeff[i] = (i % 2 == 0) ? 1.0 : -1.0;
+    cxf_price_rows_sync(rows, status);
+
+    /* A short row: hyper-sparse */
+    for (int i = 0; i < PRICE_M; i++) rho[i] = 0.0;
+    rho[5] = 3.0;
+    TEST_ASSERT_EQUAL_INT(CXF_PRICE_HYPER,
+                          cxf_price_row(rows, mat, status, coeff, rho, alpha));
+    check_price_row(mat, status, coeff, rho, alpha);
+
+    /* The dense row: row-wise with a dense accumulator */
+    rho[5] = 0.0;
+    rho[0] = -1.5;
+    TEST_ASSERT_EQUAL_INT(CXF_PRICE_ROW,
+                          cxf_price_row(rows, mat, status, coeff, rho, alpha));
+    check_price_row(mat, status, coeff, rho, alpha);
+
+    /* Dense rho: column-wise */
+    for (int i = 0; i < PRICE_M; i++) rho[i] = 0.25 * (i + 1);
+    TEST_ASSERT_EQUAL_INT(CXF_PRICE_COLUMN,
+                          cxf_price_row(rows, mat, status, coeff, rho, alpha));
+    check_price_row(mat, status, coeff, rho, alpha);
+
+    /* Without the row-wise copy */
+    TEST_ASSERT_EQUAL_INT(CXF_PRICE_COLUMN,
+                          cxf_price_row(NULL, mat, status, coeff, rho, alpha));
+    check_price_row(mat, status, coeff, rho, alpha);
+
+    cxf_vector_free(alpha);
+    cxf_price_rows_free(rows);
+    cxf_sparse_free(mat);
+}
+
+void test_price_rows_follow_basis_changes(void) {
+    SparseMatrix *mat = make_price_matrix();
+    PriceRows *rows = cxf_price_rows_create(mat);
+    VectorContainer *alpha = cxf_vector_create(PRICE_N + PRICE_M);
+    int status[PRICE_N + PRICE_M];
+    double coeff[PRICE_M];
+    double rho[PRICE_M] = {0.0};
+    make_price_status(status);
+    for (int i = 0; i < PRICE_M; i++) coeff[i] = 1.0;
+    cxf_price_rows_sync(rows, status);
+
+    /* Pivots: 1 and 7 enter, 0 and 3 leave */
+    int moves[][2] = {{1, 0}, {7, 3}};
+    for (int t = 0; t < 2; t++) {
+        status[moves[t][0]] = 0;
+        status[moves[t][1]] = -1;
+        cxf_price_rows_set_basic(rows, moves[t][0], 1);
+        cxf_price_rows_set_basic(rows, moves[t][1], 0);
+    }
+
+    for (int i = 0; i < PRICE_M; i++) {
+        for (int64_t k = rows->row_start[i]; k < rows->row_start[i + 1]; k++) {
+            int nonbasic_part = k < rows->nonbasic_end[i];
+            TEST_ASSERT_EQUAL_INT(status[rows->col_idx[k]] < 0, nonbasic_part);
+        }
+    }
+
+    rho[0] = 1.0;
+    rho[8] = -2.0;
+    cxf_price_row(rows, mat, status, coeff, rho, alpha);
+    check_price_row(mat, status, coeff, rho, alpha);
+
+    cxf_vector_free(alpha);
+    cxf_price_rows_free(rows);
+    cxf_sparse_free(mat);
+}
+
 /*******************************************************************************
  * Main test runner
  ******************************************************************************/
@@ -442,5 +592,9 @@ int main(void) {
     RUN_TEST(test_sort_indices_single);
     RUN_TEST(test_sort_indices_values_sync);
 
+    /* Pivot row PRICE tests */
+    RUN_TEST(test_price_row_selects_kernel_by_density);
+    RUN_TEST(test_price_rows_follow_basis_changes);
+
     return UNITY_END();
 }
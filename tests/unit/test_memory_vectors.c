@@ -2,7 +2,8 @@
  * @file test_memory_vectors.c
  * @brief TDD tests for vector memory management (M2.1.3)
  *
- * Tests for cxf_vector_free and cxf_alloc_eta.
+ * Tests for the sparse accumulator helpers, cxf_vector_free and
+ * cxf_alloc_eta.
  */
 
 #include "unity.h"
@@ -16,6 +17,9 @@ void *cxf_calloc(size_t count, size_t size);
 void cxf_free(void *ptr);
 
 /* Functions under test */
+VectorContainer *cxf_vector_create(int dim);
+void cxf_vector_clear(VectorContainer *vec);
+void cxf_vector_reindex(VectorContainer *vec);
 void cxf_vector_free(VectorContainer *vec);
 void *cxf_alloc_eta(CxfEnv *env, EtaBuffer *buffer, size_t size);
 void cxf_eta_buffer_init(EtaBuffer *buffer, size_t min_chunk_size);
@@ -108,6 +112,74 @@ void test_vector_free_full_vector(void) {
     TEST_PASS();
 }
 
+/*----------------------------------------------------------------------------*/
+/* Sparse accumulator tests                                                   */
+/*----------------------------------------------------------------------------*/
+
+void test_vector_create_is_zero(void) {
+    VectorContainer *vec = cxf_vector_create(8);
+    TEST_ASSERT_NOT_NULL(vec);
+    TEST_ASSERT_EQUAL_INT(8, vec->capacity);
+    TEST_ASSERT_EQUAL_INT(0, vec->size);
+    for (int i = 0; i < 8; i++) {
+        TEST_ASSERT_EQUAL_DOUBLE(0.0, vec->values[i]);
+    }
+    cxf_vector_free(vec);
+}
+
+void test_vector_create_invalid_dim(void) {
+    TEST_ASSERT_NULL(cxf_vector_create(0));
+    TEST_ASSERT_NULL(cxf_vector_create(-3));
+}
+
+void test_vector_clear_sparse(void) {
+    VectorContainer *vec = cxf_vector_create(16);
+    TEST_ASSERT_NOT_NULL(vec);
+
+    vec->values[3] = 1.5;
+    vec->indices[vec->size++] = 3;
+    vec->values[11] = -2.0;
+    vec->indices[vec->size++] = 11;
+
+    cxf_vector_clear(vec);
+    TEST_ASSERT_EQUAL_INT(0, vec->size);
+    for (int i = 0; i < 16; i++) {
+        TEST_ASSERT_EQUAL_DOUBLE(0.0, vec->values[i]);
+    }
+    cxf_vector_free(vec);
+}
+
+void test_vector_clear_dense(void) {
+    VectorContainer *vec = cxf_vector_create(4);
+    TEST_ASSERT_NOT_NULL(vec);
+
+    for (int i = 0; i < 4; i++) {
+        vec->values[i] = (double)(i + 1);
+        vec->indices[vec->size++] = i;
+    }
+
+    cxf_vector_clear(vec);
+    TEST_ASSERT_EQUAL_INT(0, vec->size);
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_DOUBLE(0.0, vec->values[i]);
+    }
+    cxf_vector_free(vec);
+}
+
+void test_vector_reindex(void) {
+    VectorContainer *vec = cxf_vector_create(6);
+    TEST_ASSERT_NOT_NULL(vec);
+
+    vec->values[1] = 4.0;
+    vec->values[4] = -1.0;
+    cxf_vector_reindex(vec);
+
+    TEST_ASSERT_EQUAL_INT(2, vec->size);
+    TEST_ASSERT_EQUAL_INT(1, vec->indices[0]);
+    TEST_ASSERT_EQUAL_INT(4, vec->indices[1]);
+    cxf_vector_free(vec);
+}
+
 /*----------------------------------------------------------------------------*/
 /* cxf_eta_buffer_init tests                                                  */
 /*----------------------------------------------------------------------------*/
@@ -296,6 +368,13 @@ int main(void) {
     RUN_TEST(test_vector_free_indices_only);
     RUN_TEST(test_vector_free_full_vector);
 
+    /* Sparse accumulator tests */
+    RUN_TEST(test_vector_create_is_zero);
+    RUN_TEST(test_vector_create_invalid_dim);
+    RUN_TEST(test_vector_clear_sparse);
+    RUN_TEST(test_vector_clear_dense);
+    RUN_TEST(test_vector_reindex);
+
     /* cxf_eta_buffer_init tests */
     RUN_TEST(test_eta_buffer_init_basic);
     RUN_TEST(test_eta_buffer_init_custom_size);
@@ -160,6 +160,85 @@ void test_setintparam_max_eta_count_invalid_values(void) {
     TEST_ASSERT_EQUAL_INT(CXF_ERROR_INVALID_ARGUMENT, status);
 }
 
+void test_setintparam_basis_update_values(void) {
+    int status;
+
+    status = cxf_setintparam(env, "BasisUpdate", 0);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, status);
+    TEST_ASSERT_EQUAL_INT(0, env->basis_update);
+
+    status = cxf_setintparam(env, "BasisUpdate", 1);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, status);
+    TEST_ASSERT_EQUAL_INT(1, env->basis_update);
+
+    status = cxf_setintparam(env, "BasisUpdate", 2);
+    TEST_ASSERT_EQUAL_INT(CXF_ERROR_INVALID_ARGUMENT, status);
+}
+
+void test_setintparam_rowwise_factors_values(void) {
+    int status;
+
+    status = cxf_setintparam(env, "RowwiseFactors", 0);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, status);
+    TEST_ASSERT_EQUAL_INT(0, env->rowwise_factors);
+
+    status = cxf_setintparam(env, "RowwiseFactors", 1);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, status);
+    TEST_ASSERT_EQUAL_INT(1, env->rowwise_factors);
+
+    status = cxf_setintparam(env, "RowwiseFactors", -1);
+    TEST_ASSERT_EQUAL_INT(CXF_ERROR_INVALID_ARGUMENT, status);
+}
+
+void test_setintparam_mixed_precision_values(void) {
+    int status;
+
+    status = cxf_setintparam(env, "MixedPrecision", 1);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, status);
+    TEST_ASSERT_EQUAL_INT(1, env->mixed_precision);
+
+    status = cxf_setintparam(env, "MixedPrecision", 0);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, status);
+    TEST_ASSERT_EQUAL_INT(0, env->mixed_precision);
+
+    status = cxf_setintparam(env, "MixedPrecision", 2);
+    TEST_ASSERT_EQUAL_INT(CXF_ERROR_INVALID_ARGUMENT, status);
+}
+
+void test_setintparam_method_values(void) {
+    int status;
+
+    status = cxf_setintparam(env, "Method", 1);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, status);
+    TEST_ASSERT_EQUAL_INT(1, env->method);
+
+    status = cxf_setintparam(env, "Method", 0);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, status);
+    TEST_ASSERT_EQUAL_INT(0, env->method);
+
+    status = cxf_setintparam(env, "Method", 2);
+    TEST_ASSERT_EQUAL_INT(CXF_ERROR_INVALID_ARGUMENT, status);
+}
+
+void test_setintparam_simplex_pricing_values(void) {
+    int status;
+
+    status = cxf_setintparam(env, "SimplexPricing", 1);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, status);
+    TEST_ASSERT_EQUAL_INT(1, env->simplex_pricing);
+
+    status = cxf_setintparam(env, "SimplexPricing", -1);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, status);
+    TEST_ASSERT_EQUAL_INT(-1, env->simplex_pricing);
+
+    status = cxf_setintparam(env, "SimplexPricing", 2);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, status);
+    TEST_ASSERT_EQUAL_INT(2, env->simplex_pricing);
+
+    status = cxf_setintparam(env, "SimplexPricing", 3);
+    TEST_ASSERT_EQUAL_INT(CXF_ERROR_INVALID_ARGUMENT, status);
+}
+
 /*******************************************************************************
  * cxf_getintparam Tests
  ******************************************************************************/
@@ -215,6 +294,41 @@ void test_getintparam_max_eta_count_returns_default(void) {
     TEST_ASSERT_EQUAL_INT(100, value);  /* DEFAULT_MAX_ETA_COUNT */
 }
 
+void test_getintparam_basis_update_returns_default(void) {
+    int value = -1;
+    int status = cxf_getintparam(env, "BasisUpdate", &value);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, status);
+    TEST_ASSERT_EQUAL_INT(1, value);  /* DEFAULT_BASIS_UPDATE (Forrest-Tomlin) */
+}
+
+void test_getintparam_rowwise_factors_returns_default(void) {
+    int value = -1;
+    int status = cxf_getintparam(env, "RowwiseFactors", &value);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, status);
+    TEST_ASSERT_EQUAL_INT(1, value);  /* DEFAULT_ROWWISE_FACTORS */
+}
+
+void test_getintparam_mixed_precision_returns_default(void) {
+    int value = -1;
+    int status = cxf_getintparam(env, "MixedPrecision", &value);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, status);
+    TEST_ASSERT_EQUAL_INT(0, value);  /* DEFAULT_MIXED_PRECISION */
+}
+
+void test_getintparam_method_returns_default(void) {
+    int value = -1;
+    int status = cxf_getintparam(env, "Method", &value);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, status);
+    TEST_ASSERT_EQUAL_INT(0, value);  /* DEFAULT_METHOD */
+}
+
+void test_getintparam_simplex_pricing_returns_default(void) {
+    int value = 0;
+    int status = cxf_getintparam(env, "SimplexPricing", &value);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, status);
+    TEST_ASSERT_EQUAL_INT(-1, value);  /* DEFAULT_SIMPLEX_PRICING */
+}
+
 void test_getintparam_returns_set_value(void) {
     int status;
     int value;
@@ -267,6 +381,11 @@ int main(void) {
     RUN_TEST(test_setintparam_refactor_interval_invalid_values);
     RUN_TEST(test_setintparam_max_eta_count_valid_values);
     RUN_TEST(test_setintparam_max_eta_count_invalid_values);
+    RUN_TEST(test_setintparam_basis_update_values);
+    RUN_TEST(test_setintparam_rowwise_factors_values);
+    RUN_TEST(test_setintparam_mixed_precision_values);
+    RUN_TEST(test_setintparam_method_values);
+    RUN_TEST(test_setintparam_simplex_pricing_values);
 
     /* cxf_getintparam tests */
     RUN_TEST(test_getintparam_null_env_returns_error);
@@ -277,6 +396,11 @@ int main(void) {
     RUN_TEST(test_getintparam_verbosity_returns_default);
     RUN_TEST(test_getintparam_refactor_interval_returns_default);
     RUN_TEST(test_getintparam_max_eta_count_returns_default);
+    RUN_TEST(test_getintparam_basis_update_returns_default);
+    RUN_TEST(test_getintparam_rowwise_factors_returns_default);
+    RUN_TEST(test_getintparam_mixed_precision_returns_default);
+    RUN_TEST(test_getintparam_method_returns_default);
+    RUN_TEST(test_getintparam_simplex_pricing_returns_default);
     RUN_TEST(test_getintparam_returns_set_value);
 
     return UNITY_END();
@@ -16,7 +16,7 @@ BasisState *cxf_basis_create(int m, int n);
 void cxf_basis_free(BasisState *basis);
 int cxf_pivot_with_eta(BasisState *basis, int pivotRow, const double *pivotCol,
                        int enteringVar, int leavingVar);
-void cxf_eta_free(EtaFactors *eta);
+int cxf_basis_refactor(BasisState *basis);
 
 /*******************************************************************************
  * Test fixtures
@@ -164,27 +164,22 @@ void test_pivot_eta_increments_pivots_since_refactor(void) {
     TEST_ASSERT_EQUAL_INT(initial_pivots + 1, test_basis->pivots_since_refactor);
 }
 
-void test_pivot_eta_creates_eta_head(void) {
+void test_pivot_eta_appends_to_eta_file(void) {
     double pivotCol[] = {2.0, 0.5, 0.25};
-    TEST_ASSERT_NULL(test_basis->eta_head);
+    TEST_ASSERT_EQUAL_INT(0, test_basis->eta_count);
 
     cxf_pivot_with_eta(test_basis, 0, pivotCol, 0, 3);
 
-    TEST_ASSERT_NOT_NULL(test_basis->eta_head);
-}
-
-void test_pivot_eta_sets_eta_type_to_2(void) {
-    double pivotCol[] = {2.0, 0.5, 0.25};
-    cxf_pivot_with_eta(test_basis, 0, pivotCol, 0, 3);
-
-    TEST_ASSERT_EQUAL_INT(2, test_basis->eta_head->type);
+    TEST_ASSERT_TRUE(test_basis->eta_capacity >= 1);
+    TEST_ASSERT_NOT_NULL(test_basis->eta_start);
+    TEST_ASSERT_EQUAL_INT64(0, test_basis->eta_start[0]);
 }
 
 void test_pivot_eta_sets_eta_pivot_row(void) {
     double pivotCol[] = {2.0, 0.5, 0.25};
     cxf_pivot_with_eta(test_basis, 1, pivotCol, 0, 4);
 
-    TEST_ASSERT_EQUAL_INT(1, test_basis->eta_head->pivot_row);
+    TEST_ASSERT_EQUAL_INT(1, test_basis->eta_row[0]);
 }
 
 void test_pivot_eta_sets_eta_pivot_var(void) {
@@ -192,7 +187,7 @@ void test_pivot_eta_sets_eta_pivot_var(void) {
     int enteringVar = 2;
     cxf_pivot_with_eta(test_basis, 0, pivotCol, enteringVar, 3);
 
-    TEST_ASSERT_EQUAL_INT(enteringVar, test_basis->eta_head->pivot_var);
+    TEST_ASSERT_EQUAL_INT(enteringVar, test_basis->eta_var[0]);
 }
 
 void test_pivot_eta_sets_eta_multiplier(void) {
@@ -200,7 +195,7 @@ void test_pivot_eta_sets_eta_multiplier(void) {
     cxf_pivot_with_eta(test_basis, 0, pivotCol, 0, 3);
 
     /* pivot_elem = pivot value (raw) = 2.0 */
-    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 2.0, test_basis->eta_head->pivot_elem);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 2.0, test_basis->eta_pivot[0]);
 }
 
 /*******************************************************************************
@@ -213,7 +208,7 @@ void test_pivot_eta_sparse_column_counts_nnz(void) {
     cxf_pivot_with_eta(test_basis, 0, pivotCol, 0, 3);
 
     /* nnz = 1 (only row 1 is nonzero, excluding pivot row) */
-    TEST_ASSERT_EQUAL_INT(1, test_basis->eta_head->nnz);
+    TEST_ASSERT_EQUAL_INT64(1, test_basis->eta_start[1] - test_basis->eta_start[0]);
 }
 
 void test_pivot_eta_dense_column_counts_nnz(void) {
@@ -221,7 +216,7 @@ void test_pivot_eta_dense_column_counts_nnz(void) {
     cxf_pivot_with_eta(test_basis, 0, pivotCol, 0, 3);
 
     /* nnz = 2 (rows 1 and 2 are nonzero, excluding pivot row 0) */
-    TEST_ASSERT_EQUAL_INT(2, test_basis->eta_head->nnz);
+    TEST_ASSERT_EQUAL_INT64(2, test_basis->eta_start[1] - test_basis->eta_start[0]);
 }
 
 void test_pivot_eta_computes_eta_values(void) {
@@ -231,12 +226,12 @@ void test_pivot_eta_computes_eta_values(void) {
     /* Values are stored raw (unscaled, positive):
      * eta[1] = 0.6 (raw column value)
      * eta[2] = 0.4 (raw column value) */
-    EtaFactors *eta = test_basis->eta_head;
-    TEST_ASSERT_EQUAL_INT(2, eta->nnz);
-    TEST_ASSERT_EQUAL_INT(1, eta->indices[0]);
-    TEST_ASSERT_EQUAL_INT(2, eta->indices[1]);
-    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 0.6, eta->values[0]);
-    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 0.4, eta->values[1]);
+    int64_t p = test_basis->eta_start[0];
+    TEST_ASSERT_EQUAL_INT64(2, test_basis->eta_start[1] - p);
+    TEST_ASSERT_EQUAL_INT(1, test_basis->eta_idx[p]);
+    TEST_ASSERT_EQUAL_INT(2, test_basis->eta_idx[p + 1]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 0.6, test_basis->eta_val[p]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 0.4, test_basis->eta_val[p + 1]);
 }
 
 void test_pivot_eta_identity_column_has_zero_nnz(void) {
@@ -244,9 +239,8 @@ void test_pivot_eta_identity_column_has_zero_nnz(void) {
     double pivotCol[] = {1.0, 0.0, 0.0};
     cxf_pivot_with_eta(test_basis, 0, pivotCol, 0, 3);
 
-    TEST_ASSERT_EQUAL_INT(0, test_basis->eta_head->nnz);
-    TEST_ASSERT_NULL(test_basis->eta_head->indices);
-    TEST_ASSERT_NULL(test_basis->eta_head->values);
+    TEST_ASSERT_EQUAL_INT(1, test_basis->eta_count);
+    TEST_ASSERT_EQUAL_INT64(0, test_basis->eta_start[1] - test_basis->eta_start[0]);
 }
 
 /*******************************************************************************
@@ -286,10 +280,53 @@ void test_pivot_eta_multiple_pivots_chain_etas(void) {
     cxf_pivot_with_eta(test_basis, 1, pivotCol2, 1, 4);
 
     TEST_ASSERT_EQUAL_INT(2, test_basis->eta_count);
-    /* New eta is prepended to head */
-    TEST_ASSERT_EQUAL_INT(1, test_basis->eta_head->pivot_row);
-    TEST_ASSERT_NOT_NULL(test_basis->eta_head->next);
-    TEST_ASSERT_EQUAL_INT(0, test_basis->eta_head->next->pivot_row);
+    /* Eta file is chronological: the new eta follows the old one */
+    TEST_ASSERT_EQUAL_INT(0, test_basis->eta_row[0]);
+    TEST_ASSERT_EQUAL_INT(1, test_basis->eta_row[1]);
+    TEST_ASSERT_EQUAL_INT64(test_basis->eta_start[1], test_basis->eta_start[0] + 2);
+    TEST_ASSERT_EQUAL_INT64(test_basis->eta_start[2], test_basis->eta_start[1] + 2);
+}
+
+void test_pivot_eta_file_grows_and_keeps_contents(void) {
+    double pivotCol[] = {2.0, 0.5, 0.25};
+
+    for (int k = 0; k < 100; k++) {
+        pivotCol[0] = 2.0 + k;
+        TEST_ASSERT_EQUAL_INT(CXF_OK,
+                              cxf_pivot_with_eta(test_basis, k % 3, pivotCol, 0, 3));
+    }
+
+    TEST_ASSERT_EQUAL_INT(100, test_basis->eta_count);
+    TEST_ASSERT_TRUE(test_basis->eta_capacity >= 100);
+    for (int k = 0; k < 100; k++) {
+        TEST_ASSERT_EQUAL_INT(k % 3, test_basis->eta_row[k]);
+        TEST_ASSERT_EQUAL_INT64(2, test_basis->eta_start[k + 1] - test_basis->eta_start[k]);
+    }
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 101.0, test_basis->eta_pivot[99]);
+}
+
+void test_pivot_eta_refactor_reuses_eta_file(void) {
+    double pivotCol[] = {2.0, 0.5, 0.25};
+
+    for (int k = 0; k < 40; k++) {
+        cxf_pivot_with_eta(test_basis, 0, pivotCol, 0, 3);
+    }
+    int *row = test_basis->eta_row;
+    int *idx = test_basis->eta_idx;
+    int capacity = test_basis->eta_capacity;
+
+    /* Refactoring the slack basis drops the etas but keeps the storage */
+    test_basis->basic_vars[0] = 3;
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_basis_refactor(test_basis));
+    TEST_ASSERT_EQUAL_INT(0, test_basis->eta_count);
+
+    for (int k = 0; k < 40; k++) {
+        cxf_pivot_with_eta(test_basis, 0, pivotCol, 0, 3);
+    }
+    TEST_ASSERT_EQUAL_PTR(row, test_basis->eta_row);
+    TEST_ASSERT_EQUAL_PTR(idx, test_basis->eta_idx);
+    TEST_ASSERT_EQUAL_INT(capacity, test_basis->eta_capacity);
+    TEST_ASSERT_EQUAL_INT64(0, test_basis->eta_start[0]);
 }
 
 /*******************************************************************************
@@ -320,8 +357,7 @@ int main(void) {
     RUN_TEST(test_pivot_eta_updates_var_status);
     RUN_TEST(test_pivot_eta_increments_eta_count);
     RUN_TEST(test_pivot_eta_increments_pivots_since_refactor);
-    RUN_TEST(test_pivot_eta_creates_eta_head);
-    RUN_TEST(test_pivot_eta_sets_eta_type_to_2);
+    RUN_TEST(test_pivot_eta_appends_to_eta_file);
     RUN_TEST(test_pivot_eta_sets_eta_pivot_row);
     RUN_TEST(test_pivot_eta_sets_eta_pivot_var);
     RUN_TEST(test_pivot_eta_sets_eta_multiplier);
@@ -339,6 +375,8 @@ int main(void) {
 
     /* Multiple pivots test */
     RUN_TEST(test_pivot_eta_multiple_pivots_chain_etas);
+    RUN_TEST(test_pivot_eta_file_grows_and_keeps_contents);
+    RUN_TEST(test_pivot_eta_refactor_reuses_eta_file);
 
     return UNITY_END();
 }
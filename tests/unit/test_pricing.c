@@ -31,9 +31,21 @@ int cxf_pricing_steepest(PricingContext *ctx, const double *reduced_costs,
                          int num_vars, double tolerance);
 
 /* Post-pivot update */
-int cxf_pricing_update(PricingContext *ctx, int entering_var, int leaving_row,
-                       const double *pivot_column, const double *pivot_row,
-                       int num_rows);
+int cxf_pricing_update(PricingContext *ctx, int entering_var, int leaving_var,
+                       double pivot_elem, double gamma_entering,
+                       const VectorContainer *pivot_row,
+                       const VectorContainer *edge_dots);
+
+/* Heap of the attractive variables */
+void cxf_pricing_heap_build(PricingContext *ctx, const double *dj,
+                            const int *status, double tolerance);
+void cxf_pricing_heap_touch(PricingContext *ctx, int j, const double *dj,
+                            const int *status);
+int cxf_pricing_heap_top(const PricingContext *ctx);
+
+/* Sparse vectors for the pivot row */
+VectorContainer *cxf_vector_create(int dim);
+void cxf_vector_free(VectorContainer *vec);
 
 /* Cache management */
 void cxf_pricing_invalidate(PricingContext *ctx, int flags);
@@ -185,6 +197,27 @@ void test_pricing_candidates_skips_basic_vars(void) {
     cxf_pricing_free(ctx);
 }
 
+void test_pricing_candidates_ranked_by_weight(void) {
+    PricingContext *ctx = cxf_pricing_create(4, 1);
+    TEST_ASSERT_NOT_NULL(ctx);
+    cxf_pricing_init(ctx, 4, 3);
+    TEST_ASSERT_NOT_NULL(ctx->weights);
+
+    /* |d| / sqrt(w): 3 / 3 = 1 for x0, 2 / 1 = 2 for x1 */
+    ctx->weights[0] = 9.0;
+    double reduced_costs[] = {-3.0, -2.0, 0.0, 0.0};
+    int var_status[] = {VAR_AT_LOWER, VAR_AT_LOWER, 0, 1};
+    int candidates[4] = {0};
+
+    int count = cxf_pricing_candidates(ctx, reduced_costs, var_status, 4,
+                                        1e-6, candidates, 4);
+    TEST_ASSERT_EQUAL_INT(2, count);
+    TEST_ASSERT_EQUAL_INT(1, candidates[0]);
+    TEST_ASSERT_EQUAL_INT(0, candidates[1]);
+
+    cxf_pricing_free(ctx);
+}
+
 void test_pricing_candidates_optimal(void) {
     PricingContext *ctx = cxf_pricing_create(5, 1);
     TEST_ASSERT_NOT_NULL(ctx);
@@ -272,6 +305,75 @@ void test_pricing_steepest_handles_zero_weight(void) {
     cxf_pricing_free(ctx);
 }
 
+/*============================================================================
+ * Pricing heap Tests
+ *===========================================================================*/
+
+void test_pricing_heap_top_matches_steepest(void) {
+    enum { N = 40 };
+    PricingContext *ctx = cxf_pricing_create(N, 1);
+    TEST_ASSERT_NOT_NULL(ctx);
+    cxf_pricing_init(ctx, N, 3);
+    TEST_ASSERT_NOT_NULL(ctx->heap);
+
+    double dj[N];
+    int status[N];
+    unsigned seed = 7;
+    for (int j = 0; j < N; j++) {
+        seed = seed * 1103515245u + 12345u;
+        dj[j] = (double)((int)(seed >> 16) % 200 - 100) / 10.0;
+        status[j] = (j % 5 == 0) ? j / 5 : (j % 3 == 0) ? VAR_AT_UPPER : VAR_AT_LOWER;
+        ctx->weights[j] = 1.0 + (double)((seed >> 8) % 50);
+    }
+
+    cxf_pricing_heap_build(ctx, dj, status, 1e-6);
+    TEST_ASSERT_EQUAL_INT(cxf_pricing_steepest(ctx, dj, ctx->weights, status, N, 1e-6),
+                          cxf_pricing_heap_top(ctx));
+
+    /* Change a few entries per round, as a pivot row would */
+    for (int round = 0; round < 30; round++) {
+        for (int k = 0; k < 4; k++) {
+            seed = seed * 1103515245u + 12345u;
+            int j = (int)((seed >> 16) % N);
+            dj[j] = (double)((int)(seed >> 4) % 200 - 100) / 10.0;
+            ctx->weights[j] = 1.0 + (double)((seed >> 8) % 50);
+            if (status[j] < 0 && k == 3) {
+                status[j] = -status[j] - 1;  /* Becomes basic */
+            } else if (status[j] >= 0 && k == 2) {
+                status[j] = VAR_AT_LOWER;
+            }
+            cxf_pricing_heap_touch(ctx, j, dj, status);
+        }
+        TEST_ASSERT_EQUAL_INT(cxf_pricing_steepest(ctx, dj, ctx->weights, status, N, 1e-6),
+                              cxf_pricing_heap_top(ctx));
+    }
+
+    /* A frozen weight takes the variable out */
+    int top = cxf_pricing_heap_top(ctx);
+    TEST_ASSERT_TRUE(top >= 0);
+    ctx->weights[top] = CXF_INFINITY;
+    cxf_pricing_heap_touch(ctx, top, dj, status);
+    TEST_ASSERT_NOT_EQUAL(top, cxf_pricing_heap_top(ctx));
+
+    cxf_pricing_free(ctx);
+}
+
+void test_pricing_heap_not_ready_after_invalidate(void) {
+    PricingContext *ctx = cxf_pricing_create(3, 1);
+    TEST_ASSERT_NOT_NULL(ctx);
+    cxf_pricing_init(ctx, 3, 2);
+
+    double dj[] = {-1.0, -2.0, 0.0};
+    int status[] = {VAR_AT_LOWER, VAR_AT_LOWER, 0};
+    cxf_pricing_heap_build(ctx, dj, status, 1e-6);
+    TEST_ASSERT_EQUAL_INT(1, cxf_pricing_heap_top(ctx));
+
+    cxf_pricing_invalidate(ctx, CXF_INVALID_WEIGHTS);
+    TEST_ASSERT_EQUAL_INT(-1, cxf_pricing_heap_top(ctx));
+
+    cxf_pricing_free(ctx);
+}
+
 /*============================================================================
  * cxf_pricing_update Tests
  *===========================================================================*/
@@ -281,23 +383,92 @@ void test_pricing_update_basic(void) {
     TEST_ASSERT_NOT_NULL(ctx);
     cxf_pricing_init(ctx, 5, 1);
 
-    double pivot_column[] = {0.5, 1.0, 0.0};
-    double pivot_row[] = {0.1, 0.2, 0.0, 0.0, 0.0};
-
-    int result = cxf_pricing_update(ctx, 2, 1, pivot_column, pivot_row, 3);
+    int result = cxf_pricing_update(ctx, 2, 1, 0.5, 0.0, NULL, NULL);
     TEST_ASSERT_EQUAL_INT(CXF_OK, result);
+    TEST_ASSERT_EQUAL_INT(1, ctx->last_pivot_iteration);
 
     cxf_pricing_free(ctx);
 }
 
 void test_pricing_update_null_context(void) {
-    double pivot_column[] = {0.5, 1.0};
-    double pivot_row[] = {0.1, 0.2};
-
-    int result = cxf_pricing_update(NULL, 0, 0, pivot_column, pivot_row, 2);
+    int result = cxf_pricing_update(NULL, 0, 0, 1.0, 0.0, NULL, NULL);
     TEST_ASSERT_EQUAL_INT(CXF_ERROR_NULL_ARGUMENT, result);
 }
 
+/* A = [1 2; 3 1] with slacks s0, s1 (vars 2, 3) basic. x0 enters, s1
+ * leaves (alpha_q = (1, 3), pivot 3). Exact weights for the new basis
+ * [e0 a0]: gamma_x1 = 35/9, gamma_s1 = 11/9. */
+void test_pricing_update_steepest_edge_recurrence(void) {
+    PricingContext *ctx = cxf_pricing_create(4, 1);
+    TEST_ASSERT_NOT_NULL(ctx);
+    cxf_pricing_init(ctx, 4, 2);
+    TEST_ASSERT_NOT_NULL(ctx->weights);
+    ctx->weights[0] = 11.0;  /* 1 + ||(1, 3)||^2 */
+    ctx->weights[1] = 6.0;   /* 1 + ||(2, 1)||^2 */
+
+    VectorContainer *row = cxf_vector_create(4);
+    VectorContainer *dots = cxf_vector_create(4);
+    TEST_ASSERT_NOT_NULL(row);
+    TEST_ASSERT_NOT_NULL(dots);
+
+    /* Pivot row e_1^T [A I] over the nonbasic x0, x1 */
+    row->values[0] = 3.0;
+    row->values[1] = 1.0;
+    row->indices[0] = 0;
+    row->indices[1] = 1;
+    row->size = 2;
+
+    /* tau = alpha_q = (1, 3); a_x1^T tau = 5 */
+    dots->values[0] = 10.0;
+    dots->values[1] = 5.0;
+    dots->indices[0] = 0;
+    dots->indices[1] = 1;
+    dots->size = 2;
+
+    int result = cxf_pricing_update(ctx, 0, 3, 3.0, 11.0, row, dots);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, result);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 35.0 / 9.0, ctx->weights[1]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 11.0 / 9.0, ctx->weights[3]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 0.0, ctx->weight_error);
+    TEST_ASSERT_EQUAL_INT64(1, ctx->weight_pivots);
+
+    cxf_vector_free(row);
+    cxf_vector_free(dots);
+    cxf_pricing_free(ctx);
+}
+
+void test_pricing_update_devex_keeps_larger_weight(void) {
+    PricingContext *ctx = cxf_pricing_create(4, 1);
+    TEST_ASSERT_NOT_NULL(ctx);
+    cxf_pricing_init(ctx, 4, 3);
+    TEST_ASSERT_NOT_NULL(ctx->weights);
+    TEST_ASSERT_NOT_NULL(ctx->reference);
+    ctx->weights[0] = 2.0;
+    ctx->weights[2] = 5.0;
+
+    VectorContainer *row = cxf_vector_create(4);
+    TEST_ASSERT_NOT_NULL(row);
+    row->values[0] = 2.0;
+    row->values[1] = 3.0;
+    row->values[2] = 1.0;
+    row->indices[0] = 0;
+    row->indices[1] = 1;
+    row->indices[2] = 2;
+    row->size = 3;
+
+    /* Reference weight of x0 is 8: the stored 2 is off by a factor of 4 */
+    int result = cxf_pricing_update(ctx, 0, 3, 2.0, 8.0, row, NULL);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, result);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 18.0, ctx->weights[1]);  /* 1.5^2 * 8 */
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 5.0, ctx->weights[2]);   /* 0.5^2 * 8 < 5 */
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 2.0, ctx->weights[3]);   /* 8 / 2^2 */
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 3.0, ctx->weight_error);
+    TEST_ASSERT_EQUAL_INT64(1, ctx->weight_pivots);
+
+    cxf_vector_free(row);
+    cxf_pricing_free(ctx);
+}
+
 /*============================================================================
  * cxf_pricing_invalidate Tests
  *===========================================================================*/
@@ -407,6 +578,7 @@ int main(void) {
     RUN_TEST(test_pricing_candidates_finds_positive_rc_at_upper);
     RUN_TEST(test_pricing_candidates_skips_basic_vars);
     RUN_TEST(test_pricing_candidates_optimal);
+    RUN_TEST(test_pricing_candidates_ranked_by_weight);
 
     /* cxf_pricing_steepest */
     RUN_TEST(test_pricing_steepest_basic);
@@ -414,9 +586,15 @@ int main(void) {
     RUN_TEST(test_pricing_steepest_optimal_returns_minus_one);
     RUN_TEST(test_pricing_steepest_handles_zero_weight);
 
+    /* Pricing heap */
+    RUN_TEST(test_pricing_heap_top_matches_steepest);
+    RUN_TEST(test_pricing_heap_not_ready_after_invalidate);
+
     /* cxf_pricing_update */
     RUN_TEST(test_pricing_update_basic);
     RUN_TEST(test_pricing_update_null_context);
+    RUN_TEST(test_pricing_update_steepest_edge_recurrence);
+    RUN_TEST(test_pricing_update_devex_keeps_larger_weight);
 
     /* cxf_pricing_invalidate */
     RUN_TEST(test_pricing_invalidate_candidates);
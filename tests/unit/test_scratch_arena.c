@@ -0,0 +1,381 @@
+/**
+ * @file test_scratch_arena.c
+ * @brief Tests for the solver scratch arena and the allocation-free loop.
+ *
+ * Covers cxf_scratch_* (mark/alloc/release, block reuse) and checks that
+ * steady-state simplex iterations perform no heap allocation, also with a
+ * worker pool. The latter counts calls by interposing malloc/calloc/realloc
+ * (glibc only).
+ */
+
+#include "unity.h"
+#include "convexfeld/cxf_env.h"
+#include "convexfeld/cxf_model.h"
+#include "convexfeld/cxf_solver.h"
+#include "convexfeld/cxf_basis.h"
+#include "convexfeld/cxf_matrix.h"
+#include "convexfeld/cxf_types.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+/* Functions under test */
+int cxf_scratch_init(ScratchArena *arena, size_t initial_size);
+void cxf_scratch_free(ScratchArena *arena);
+ScratchMark cxf_scratch_mark(const ScratchArena *arena);
+void *cxf_scratch_alloc(ScratchArena *arena, size_t size);
+void cxf_scratch_release(ScratchArena *arena, ScratchMark mark);
+int cxf_simplex_iterate(SolverContext *state, CxfEnv *env);
+int cxf_addconstr(CxfModel *model, int numnz, const int *cind,
+                  const double *cval, char sense, double rhs,
+                  const char *constrname);
+int cxf_addconstrs(CxfModel *model, int numconstrs, int numnz,
+                   const int *cbeg, const int *cind, const double *cval,
+                   const char *sense, const double *rhs,
+                   const char **constrnames);
+
+/*----------------------------------------------------------------------------*/
+/* Heap call counter                                                          */
+/*----------------------------------------------------------------------------*/
+
+static long heap_calls = 0;
+
+#if defined(__GLIBC__)
+#define HAVE_HEAP_COUNTER 1
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size) {
+    heap_calls++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    heap_calls++;
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    heap_calls++;
+    return __libc_realloc(ptr, size);
+}
+#else
+#define HAVE_HEAP_COUNTER 0
+#endif
+
+void setUp(void) {}
+void tearDown(void) {}
+
+/*----------------------------------------------------------------------------*/
+/* Arena tests                                                                */
+/*----------------------------------------------------------------------------*/
+
+void test_scratch_alloc_is_aligned(void) {
+    ScratchArena arena;
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_scratch_init(&arena, 1024));
+
+    char *a = cxf_scratch_alloc(&arena, 3);
+    double *b = cxf_scratch_alloc(&arena, 5 * sizeof(double));
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_EQUAL_UINT64(0, (uintptr_t)a % 16);
+    TEST_ASSERT_EQUAL_UINT64(0, (uintptr_t)b % 16);
+    TEST_ASSERT_TRUE((char *)b >= a + 3);
+
+    cxf_scratch_free(&arena);
+}
+
+void test_scratch_release_rewinds(void) {
+    ScratchArena arena;
+    cxf_scratch_init(&arena, 1024);
+
+    ScratchMark mark = cxf_scratch_mark(&arena);
+    void *first = cxf_scratch_alloc(&arena, 100);
+    cxf_scratch_release(&arena, mark);
+    void *again = cxf_scratch_alloc(&arena, 100);
+    TEST_ASSERT_EQUAL_PTR(first, again);
+
+    cxf_scratch_free(&arena);
+}
+
+void test_scratch_nested_marks(void) {
+    ScratchArena arena;
+    cxf_scratch_init(&arena, 1024);
+
+    void *outer = cxf_scratch_alloc(&arena, 64);
+    ScratchMark mark = cxf_scratch_mark(&arena);
+    void *inner = cxf_scratch_alloc(&arena, 64);
+    cxf_scratch_release(&arena, mark);
+    void *next = cxf_scratch_alloc(&arena, 32);
+
+    TEST_ASSERT_TRUE(inner != outer);
+    TEST_ASSERT_EQUAL_PTR(inner, next);
+
+    cxf_scratch_free(&arena);
+}
+
+void test_scratch_grows_then_reuses_blocks(void) {
+    ScratchArena arena;
+    cxf_scratch_init(&arena, 0);
+    TEST_ASSERT_EQUAL_INT64(0, arena.heapAllocs);
+
+    for (int round = 0; round < 3; round++) {
+        ScratchMark mark = cxf_scratch_mark(&arena);
+        for (int k = 0; k < 8; k++) {
+            TEST_ASSERT_NOT_NULL(cxf_scratch_alloc(&arena, 3000));
+        }
+        TEST_ASSERT_NOT_NULL(cxf_scratch_alloc(&arena, 100000));
+        cxf_scratch_release(&arena, mark);
+    }
+
+    /* All growth happens in the first round */
+    int64_t grown = arena.heapAllocs;
+    TEST_ASSERT_TRUE(grown > 0);
+    ScratchMark mark = cxf_scratch_mark(&arena);
+    for (int k = 0; k < 8; k++) {
+        cxf_scratch_alloc(&arena, 3000);
+    }
+    cxf_scratch_alloc(&arena, 100000);
+    cxf_scratch_release(&arena, mark);
+    TEST_ASSERT_EQUAL_INT64(grown, arena.heapAllocs);
+
+    cxf_scratch_free(&arena);
+}
+
+/*----------------------------------------------------------------------------*/
+/* Allocation-free iteration loop                                             */
+/*----------------------------------------------------------------------------*/
+
+#define LOOP_N 600
+#define LOOP_M 400
+#define LOOP_NZ 5
+#define LOOP_REFACTOR 20
+
+/**
+ * @brief Sparse LP with <= rows and nonnegative rhs; the slack basis is
+ *        feasible, so iterations can run without Phase I.
+ */
+static void build_loop_model(CxfModel *model) {
+    for (int j = 0; j < LOOP_N; j++) {
+        cxf_addvar(model, 0, NULL, NULL, -(1.0 + (j % 7) * 0.5), 0.0, 1e3, 'C', NULL);
+    }
+    for (int i = 0; i < LOOP_M; i++) {
+        int cind[LOOP_NZ];
+        double cval[LOOP_NZ];
+        int nz = 0;
+        for (int k = 0; k < LOOP_NZ; k++) {
+            int col = (i * 7 + k * 37 + k * k * 11) % LOOP_N;
+            int dup = 0;
+            for (int q = 0; q < nz; q++) {
+                if (cind[q] == col) dup = 1;
+            }
+            if (dup) continue;
+            cind[nz] = col;
+            cval[nz] = 1.0 + ((i + k) % 5) * 0.25;
+            nz++;
+        }
+        cxf_addconstr(model, nz, cind, cval, '<', 10.0 + (i % 7), NULL);
+    }
+}
+
+/**
+ * @brief Install the slack basis (what Phase I setup does for <= rows).
+ */
+static void install_slack_basis(SolverContext *state) {
+    BasisState *basis = state->basis;
+    SparseMatrix *mat = state->model_ref->matrix;
+    int n = state->num_vars;
+
+    for (int j = 0; j < n; j++) {
+        basis->var_status[j] = -1;
+        state->work_x[j] = 0.0;
+    }
+    for (int i = 0; i < state->num_constrs; i++) {
+        basis->basic_vars[i] = n + i;
+        basis->var_status[n + i] = i;
+        basis->diag_coeff[i] = 1.0;
+        state->work_x[n + i] = mat->rhs[i];
+    }
+}
+
+/* Wide model for the pooled loop: enough variables for a worker pool
+ * (POOL_MIN_VARS) and for a pooled partial pricing section. Only every
+ * WIDE_STRIDE-th column has entries (and a negative cost), which keeps
+ * building the matrix row by row fast. */
+#define WIDE_N 84000
+#define WIDE_M 200
+#define WIDE_STRIDE 28
+#define WIDE_ITERATIONS 400
+
+/**
+ * @brief Wide LP with <= rows: column j = k * WIDE_STRIDE has entries in
+ *        rows k mod m and (7k + 3) mod m; the other columns are empty and
+ *        never attractive, but every pricing scan still covers them.
+ */
+static CxfModel *build_wide_model(CxfEnv *env) {
+    static double obj[WIDE_N], lb[WIDE_N], ub[WIDE_N];
+    for (int j = 0; j < WIDE_N; j++) {
+        obj[j] = (j % WIDE_STRIDE == 0) ? -(1.0 + (j % 7) * 0.5) : 1.0;
+        lb[j] = 0.0;
+        ub[j] = 1e3;
+    }
+    CxfModel *model = NULL;
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_newmodel(env, &model, "alloc_pool", WIDE_N,
+                                               obj, lb, ub, NULL, NULL));
+
+    int cols = WIDE_N / WIDE_STRIDE;
+    int *beg = malloc((WIDE_M + 1) * sizeof(int));
+    int *ind = malloc((size_t)(2 * cols) * sizeof(int));
+    double *val = malloc((size_t)(2 * cols) * sizeof(double));
+    char sense[WIDE_M];
+    double rhs[WIDE_M];
+    TEST_ASSERT_NOT_NULL(beg);
+    TEST_ASSERT_NOT_NULL(ind);
+    TEST_ASSERT_NOT_NULL(val);
+    int nz = 0;
+    for (int i = 0; i < WIDE_M; i++) {
+        beg[i] = nz;
+        sense[i] = '<';
+        rhs[i] = 10.0 + (i % 7);
+        for (int k = 0; k < cols; k++) {
+            if (k % WIDE_M == i || (7 * k + 3) % WIDE_M == i) {
+                ind[nz] = k * WIDE_STRIDE;
+                val[nz] = 1.0 + ((i + k) % 5) * 0.25;
+                nz++;
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_addconstrs(model, WIDE_M, nz, beg, ind, val,
+                                                 sense, rhs, NULL));
+    free(beg);
+    free(ind);
+    free(val);
+    return model;
+}
+
+/**
+ * @brief Iterate from the slack basis and count the heap calls of the
+ *        steady-state iterations.
+ *
+ * @param max_iterations Stop after this many iterations if not optimal
+ * @param measured_out Output: iterations measured
+ * @param status_out Output: status of the last iteration
+ * @return Heap calls during the measured iterations
+ */
+static long count_loop_calls(SolverContext *state, CxfEnv *env, int max_iterations,
+                             int *measured_out, int *status_out) {
+    /* The first refactorization cycle sizes the arena and the update
+     * storage of the factors; everything after it is steady state. */
+    int refactors = 0;
+    int measured = 0;
+    long calls = 0;
+    int status = 0;
+    while (status == 0 && state->iteration < max_iterations) {
+        int before_pivots = state->basis->pivots_since_refactor;
+        long before = heap_calls;
+        status = cxf_simplex_iterate(state, env);
+        if (state->basis->pivots_since_refactor <= before_pivots) {
+            refactors++;  /* Refactorizations rebuild the factors and may allocate */
+        } else if (refactors >= 2) {
+            calls += heap_calls - before;
+            measured++;
+        }
+    }
+    *measured_out = measured;
+    *status_out = status;
+    return calls;
+}
+
+void test_iteration_loop_allocates_nothing(void) {
+#if HAVE_HEAP_COUNTER
+    CxfEnv *env = NULL;
+    CxfModel *model = NULL;
+    cxf_loadenv(&env, NULL);
+    cxf_setintparam(env, "RefactorInterval", LOOP_REFACTOR);
+    cxf_newmodel(env, &model, "alloc_loop", 0, NULL, NULL, NULL, NULL, NULL);
+    build_loop_model(model);
+
+    SolverContext *state = NULL;
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_simplex_init(model, &state));
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_simplex_setup(state, env));
+    install_slack_basis(state);
+
+    int measured = 0;
+    int status = 0;
+    long calls = count_loop_calls(state, env, 5000, &measured, &status);
+
+    TEST_ASSERT_EQUAL_INT(1, status);  /* Optimal */
+    TEST_ASSERT_TRUE(measured >= 2 * LOOP_REFACTOR);
+    TEST_ASSERT_EQUAL_INT64(0, calls);
+
+    cxf_simplex_final(state);
+    cxf_freemodel(model);
+    cxf_freeenv(env);
+#else
+    TEST_IGNORE_MESSAGE("malloc interposition needs glibc");
+#endif
+}
+
+/**
+ * @brief Pooled loop under the given SimplexPricing: the parallel PRICE,
+ *        d_j updates and pricing scans allocate nothing either.
+ */
+static void check_pooled_loop_allocates_nothing(int pricing) {
+#if HAVE_HEAP_COUNTER
+    CxfEnv *env = NULL;
+    CxfModel *model = NULL;
+    cxf_loadenv(&env, NULL);
+    cxf_setintparam(env, "OutputFlag", 0);
+    cxf_setintparam(env, "RefactorInterval", LOOP_REFACTOR);
+    cxf_setintparam(env, "SimplexPricing", pricing);
+    env->thread_count = 4;  /* Even on a smaller machine */
+    model = build_wide_model(env);
+
+    SolverContext *state = NULL;
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_simplex_init(model, &state));
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_simplex_setup(state, env));
+    TEST_ASSERT_NOT_NULL(state->pool);
+    install_slack_basis(state);
+
+    int measured = 0;
+    int status = 0;
+    long calls = count_loop_calls(state, env, WIDE_ITERATIONS, &measured, &status);
+
+    TEST_ASSERT_TRUE(status == 0 || status == 1);
+    TEST_ASSERT_TRUE(measured >= 2 * LOOP_REFACTOR);
+    TEST_ASSERT_EQUAL_INT64(0, calls);
+
+    cxf_simplex_final(state);
+    cxf_freemodel(model);
+    cxf_freeenv(env);
+#else
+    (void)pricing;
+    TEST_IGNORE_MESSAGE("malloc interposition needs glibc");
+#endif
+}
+
+void test_pooled_loop_allocates_nothing(void) {
+    check_pooled_loop_allocates_nothing(-1);  /* Devex */
+}
+
+void test_pooled_multiple_pricing_allocates_nothing(void) {
+    check_pooled_loop_allocates_nothing(0);   /* Partial: candidate scans */
+}
+
+/*----------------------------------------------------------------------------*/
+/* Main test runner                                                           */
+/*----------------------------------------------------------------------------*/
+
+int main(void) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_scratch_alloc_is_aligned);
+    RUN_TEST(test_scratch_release_rewinds);
+    RUN_TEST(test_scratch_nested_marks);
+    RUN_TEST(test_scratch_grows_then_reuses_blocks);
+    RUN_TEST(test_iteration_loop_allocates_nothing);
+    RUN_TEST(test_pooled_loop_allocates_nothing);
+    RUN_TEST(test_pooled_multiple_pricing_allocates_nothing);
+
+    return UNITY_END();
+}
@@ -10,7 +10,11 @@
 #include "convexfeld/cxf_env.h"
 #include "convexfeld/cxf_model.h"
 #include "convexfeld/cxf_solver.h"
+#include "convexfeld/cxf_basis.h"
+#include "convexfeld/cxf_matrix.h"
+#include "convexfeld/cxf_pricing.h"
 #include "convexfeld/cxf_types.h"
+#include <math.h>
 
 /* External declarations - to be implemented in M7.1.x */
 int cxf_simplex_iterate(SolverContext *state, CxfEnv *env);
@@ -19,6 +23,10 @@ int cxf_simplex_post_iterate(SolverContext *state, CxfEnv *env);
 double cxf_simplex_get_objval(SolverContext *state);
 int cxf_simplex_set_iteration_limit(SolverContext *state, int limit);
 int cxf_simplex_get_iteration_limit(SolverContext *state);
+int cxf_btran_vec(BasisState *basis, const double *input, double *result);
+int cxf_ftran(BasisState *basis, const double *column, double *result);
+int cxf_addconstr(CxfModel *model, int numnz, const int *cind,
+                  const double *cval, char sense, double rhs, const char *name);
 
 /* Test fixtures */
 static CxfEnv *env = NULL;
@@ -76,6 +84,337 @@ void test_simplex_iterate_increments_iteration(void) {
     cxf_simplex_final(state);
 }
 
+void test_simplex_iterate_updated_reduced_costs_match_full(void) {
+    /* min -x - 2y - z  s.t.  x + y + z <= 4, x + 3y <= 6, y + 2z <= 5,
+     * x, y, z in [0, 3], from the slack basis */
+    cxf_addvar(model, 0, NULL, NULL, -1.0, 0.0, 3.0, 'C', "x");
+    cxf_addvar(model, 0, NULL, NULL, -2.0, 0.0, 3.0, 'C', "y");
+    cxf_addvar(model, 0, NULL, NULL, -1.0, 0.0, 3.0, 'C', "z");
+    int ind1[] = {0, 1, 2}, ind2[] = {0, 1}, ind3[] = {1, 2};
+    double val1[] = {1.0, 1.0, 1.0}, val2[] = {1.0, 3.0}, val3[] = {1.0, 2.0};
+    cxf_addconstr(model, 3, ind1, val1, '<', 4.0, NULL);
+    cxf_addconstr(model, 2, ind2, val2, '<', 6.0, NULL);
+    cxf_addconstr(model, 2, ind3, val3, '<', 5.0, NULL);
+
+    SolverContext *state = NULL;
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_simplex_init(model, &state));
+    cxf_simplex_setup(state, env);
+
+    int n = 3, m = 3;
+    BasisState *basis = state->basis;
+    const SparseMatrix *A = model->matrix;
+    for (int j = 0; j < n; j++) {
+        basis->var_status[j] = -1;
+        state->work_x[j] = 0.0;
+    }
+    for (int i = 0; i < m; i++) {
+        basis->basic_vars[i] = n + i;
+        basis->var_status[n + i] = i;
+        basis->diag_coeff[i] = 1.0;
+        state->work_x[n + i] = A->rhs[i];
+        state->work_dj[n + i] = 0.0;
+    }
+
+    double cB[3], pi[3];
+    int status = 0;
+    for (int it = 0; it < 20 && status == 0; it++) {
+        status = cxf_simplex_iterate(state, env);
+        if (status != 0) break;
+
+        /* Reduced costs from scratch: d = c - A^T B^(-T) c_B */
+        for (int i = 0; i < m; i++) {
+            cB[i] = state->work_obj[basis->basic_vars[i]];
+        }
+        TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_btran_vec(basis, cB, pi));
+        for (int j = 0; j < n + m; j++) {
+            if (basis->var_status[j] >= 0) continue;
+            double d = state->work_obj[j];
+            if (j < n) {
+                for (int64_t k = A->col_ptr[j]; k < A->col_ptr[j + 1]; k++) {
+                    d -= pi[A->row_idx[k]] * A->values[k];
+                }
+            } else {
+                d -= pi[j - n] * basis->diag_coeff[j - n];
+            }
+            TEST_ASSERT_DOUBLE_WITHIN(1e-9, d, state->work_dj[j]);
+        }
+        for (int i = 0; i < m; i++) {
+            TEST_ASSERT_DOUBLE_WITHIN(1e-9, pi[i], state->work_pi[i]);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(1, status);  /* Optimal */
+    TEST_ASSERT_TRUE(state->iteration > 1);
+
+    cxf_simplex_final(state);
+}
+
+void test_simplex_iterate_steepest_edge_weights_match_exact(void) {
+    /* Same LP as above, priced by steepest edge */
+    cxf_setintparam(env, "SimplexPricing", 1);
+    cxf_addvar(model, 0, NULL, NULL, -1.0, 0.0, 3.0, 'C', "x");
+    cxf_addvar(model, 0, NULL, NULL, -2.0, 0.0, 3.0, 'C', "y");
+    cxf_addvar(model, 0, NULL, NULL, -1.0, 0.0, 3.0, 'C', "z");
+    int ind1[] = {0, 1, 2}, ind2[] = {0, 1}, ind3[] = {1, 2};
+    double val1[] = {1.0, 1.0, 1.0}, val2[] = {1.0, 3.0}, val3[] = {1.0, 2.0};
+    cxf_addconstr(model, 3, ind1, val1, '<', 4.0, NULL);
+    cxf_addconstr(model, 2, ind2, val2, '<', 6.0, NULL);
+    cxf_addconstr(model, 2, ind3, val3, '<', 5.0, NULL);
+
+    SolverContext *state = NULL;
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_simplex_init(model, &state));
+    cxf_simplex_setup(state, env);
+    TEST_ASSERT_NOT_NULL(state->pricing);
+    TEST_ASSERT_NOT_NULL(state->pricing->weights);
+
+    int n = 3, m = 3;
+    BasisState *basis = state->basis;
+    const SparseMatrix *A = model->matrix;
+    for (int j = 0; j < n; j++) {
+        basis->var_status[j] = -1;
+        state->work_x[j] = 0.0;
+    }
+    for (int i = 0; i < m; i++) {
+        basis->basic_vars[i] = n + i;
+        basis->var_status[n + i] = i;
+        basis->diag_coeff[i] = 1.0;
+        state->work_x[n + i] = A->rhs[i];
+        state->work_dj[n + i] = 0.0;
+    }
+
+    /* Updated weights against 1 + ||B^(-1) a_j||^2 after every pivot */
+    double a[3], y[3];
+    int status = 0;
+    for (int it = 0; it < 20 && status == 0; it++) {
+        status = cxf_simplex_iterate(state, env);
+        if (status != 0) break;
+        TEST_ASSERT_TRUE(state->pricing->weights_ready);
+
+        for (int j = 0; j < n + m; j++) {
+            if (basis->var_status[j] >= 0) continue;
+            for (int i = 0; i < m; i++) a[i] = 0.0;
+            if (j < n) {
+                for (int64_t k = A->col_ptr[j]; k < A->col_ptr[j + 1]; k++) {
+                    a[A->row_idx[k]] = A->values[k];
+                }
+            } else {
+                a[j - n] = basis->diag_coeff[j - n];
+            }
+            TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_ftran(basis, a, y));
+            double gamma = 1.0;
+            for (int i = 0; i < m; i++) gamma += y[i] * y[i];
+            TEST_ASSERT_DOUBLE_WITHIN(1e-9 * gamma, gamma, state->pricing->weights[j]);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(1, status);  /* Optimal */
+    TEST_ASSERT_TRUE(state->iteration > 1);
+
+    cxf_simplex_final(state);
+}
+
+void test_simplex_iterate_devex_reference_framework(void) {
+    /* Same LP, priced by Devex (also the default) */
+    cxf_setintparam(env, "SimplexPricing", 2);
+    cxf_addvar(model, 0, NULL, NULL, -1.0, 0.0, 3.0, 'C', "x");
+    cxf_addvar(model, 0, NULL, NULL, -2.0, 0.0, 3.0, 'C', "y");
+    cxf_addvar(model, 0, NULL, NULL, -1.0, 0.0, 3.0, 'C', "z");
+    int ind1[] = {0, 1, 2}, ind2[] = {0, 1}, ind3[] = {1, 2};
+    double val1[] = {1.0, 1.0, 1.0}, val2[] = {1.0, 3.0}, val3[] = {1.0, 2.0};
+    cxf_addconstr(model, 3, ind1, val1, '<', 4.0, NULL);
+    cxf_addconstr(model, 2, ind2, val2, '<', 6.0, NULL);
+    cxf_addconstr(model, 2, ind3, val3, '<', 5.0, NULL);
+
+    SolverContext *state = NULL;
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_simplex_init(model, &state));
+    cxf_simplex_setup(state, env);
+    TEST_ASSERT_NOT_NULL(state->pricing);
+    TEST_ASSERT_NOT_NULL(state->pricing->reference);
+    TEST_ASSERT_NULL(state->work_tau);  /* Steepest edge only */
+
+    int n = 3, m = 3;
+    BasisState *basis = state->basis;
+    for (int j = 0; j < n; j++) {
+        basis->var_status[j] = -1;
+        state->work_x[j] = 0.0;
+    }
+    for (int i = 0; i < m; i++) {
+        basis->basic_vars[i] = n + i;
+        basis->var_status[n + i] = i;
+        basis->diag_coeff[i] = 1.0;
+        state->work_x[n + i] = model->matrix->rhs[i];
+        state->work_dj[n + i] = 0.0;
+    }
+
+    int status = cxf_simplex_iterate(state, env);
+    TEST_ASSERT_EQUAL_INT(0, status);
+    TEST_ASSERT_TRUE(state->pricing->weight_resets >= 1);
+    /* Framework of the first reset: the structurals, nonbasic at the start */
+    for (int j = 0; j < n; j++) {
+        TEST_ASSERT_EQUAL_INT(1, state->pricing->reference[j]);
+    }
+    for (int i = 0; i < m; i++) {
+        TEST_ASSERT_EQUAL_INT(0, state->pricing->reference[n + i]);
+    }
+
+    for (int it = 0; it < 20 && status == 0; it++) {
+        status = cxf_simplex_iterate(state, env);
+        for (int j = 0; j < n + m; j++) {
+            if (basis->var_status[j] < 0) {
+                TEST_ASSERT_TRUE(state->pricing->weights[j] >= 1.0);
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(1, status);  /* Optimal */
+
+    cxf_simplex_final(state);
+}
+
+void test_simplex_iterate_minor_iterations_match_ftran(void) {
+    /* Same LP, partial pricing: all three columns are candidates at once */
+    cxf_setintparam(env, "SimplexPricing", 0);
+    cxf_addvar(model, 0, NULL, NULL, -1.0, 0.0, 3.0, 'C', "x");
+    cxf_addvar(model, 0, NULL, NULL, -2.0, 0.0, 3.0, 'C', "y");
+    cxf_addvar(model, 0, NULL, NULL, -1.0, 0.0, 3.0, 'C', "z");
+    int ind1[] = {0, 1, 2}, ind2[] = {0, 1}, ind3[] = {1, 2};
+    double val1[] = {1.0, 1.0, 1.0}, val2[] = {1.0, 3.0}, val3[] = {1.0, 2.0};
+    cxf_addconstr(model, 3, ind1, val1, '<', 4.0, NULL);
+    cxf_addconstr(model, 2, ind2, val2, '<', 6.0, NULL);
+    cxf_addconstr(model, 2, ind3, val3, '<', 5.0, NULL);
+
+    SolverContext *state = NULL;
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_simplex_init(model, &state));
+    cxf_simplex_setup(state, env);
+    TEST_ASSERT_NOT_NULL(state->minor_cols);
+
+    int n = 3, m = 3;
+    BasisState *basis = state->basis;
+    const SparseMatrix *A = model->matrix;
+    for (int j = 0; j < n; j++) {
+        basis->var_status[j] = -1;
+        state->work_x[j] = 0.0;
+        state->work_dj[j] = state->work_obj[j];
+    }
+    for (int i = 0; i < m; i++) {
+        basis->basic_vars[i] = n + i;
+        basis->var_status[n + i] = i;
+        basis->diag_coeff[i] = 1.0;
+        state->work_x[n + i] = A->rhs[i];
+        state->work_dj[n + i] = 0.0;
+    }
+
+    /* Candidates carried across minor pivots against B^(-1) a_j and
+     * c_j - c_B^T B^(-1) a_j of the current basis */
+    double a[3], y[3];
+    int status = 0, minors = 0;
+    for (int it = 0; it < 20 && status == 0; it++) {
+        int before = state->minor_count;
+        status = cxf_simplex_iterate(state, env);
+        if (status != 0) break;
+        if (before > 0 && state->minor_count > 0) minors++;
+
+        for (int s = 0; s < state->minor_count; s++) {
+            int j = state->minor_vars[s];
+            if (j < 0) continue;
+            for (int i = 0; i < m; i++) a[i] = 0.0;
+            for (int64_t k = A->col_ptr[j]; k < A->col_ptr[j + 1]; k++) {
+                a[A->row_idx[k]] = A->values[k];
+            }
+            TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_ftran(basis, a, y));
+            double d = state->work_obj[j];
+            for (int i = 0; i < m; i++) {
+                TEST_ASSERT_DOUBLE_WITHIN(1e-9, y[i], state->minor_cols[s * m + i]);
+                d -= state->work_obj[basis->basic_vars[i]] * y[i];
+            }
+            TEST_ASSERT_DOUBLE_WITHIN(1e-9, d, state->minor_dj[s]);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(1, status);  /* Optimal */
+    TEST_ASSERT_TRUE(minors >= 1);
+
+    cxf_simplex_final(state);
+}
+
+void test_simplex_iterate_boxed_entering_flips_bounds(void) {
+    /* min -x0 - x1 - x2 - x3  s.t.  x0 + x1 + x2 + x3 <= 10, x in [0, 1]:
+     * every column reaches its upper bound before the slack blocks */
+    for (int j = 0; j < 4; j++) {
+        cxf_addvar(model, 0, NULL, NULL, -1.0, 0.0, 1.0, 'C', NULL);
+    }
+    int ind[] = {0, 1, 2, 3};
+    double val[] = {1.0, 1.0, 1.0, 1.0};
+    cxf_addconstr(model, 4, ind, val, '<', 10.0, NULL);
+
+    SolverContext *state = NULL;
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_simplex_init(model, &state));
+    cxf_simplex_setup(state, env);
+
+    int n = 4;
+    BasisState *basis = state->basis;
+    for (int j = 0; j < n; j++) {
+        basis->var_status[j] = -1;
+        state->work_x[j] = 0.0;
+        state->work_dj[j] = state->work_obj[j];
+    }
+    basis->basic_vars[0] = n;
+    basis->var_status[n] = 0;
+    basis->diag_coeff[0] = 1.0;
+    state->work_x[n] = 10.0;
+    state->work_dj[n] = 0.0;
+    double obj_before = state->obj_value;
+
+    int status = 0;
+    for (int it = 0; it < 20 && status == 0; it++) {
+        status = cxf_simplex_iterate(state, env);
+    }
+    TEST_ASSERT_EQUAL_INT(1, status);  /* Optimal */
+
+    /* Four flips, no basis change */
+    TEST_ASSERT_EQUAL_INT(4, state->iteration);
+    TEST_ASSERT_EQUAL_INT(n, basis->basic_vars[0]);
+    for (int j = 0; j < n; j++) {
+        TEST_ASSERT_EQUAL_INT(-2, basis->var_status[j]);
+        TEST_ASSERT_EQUAL_DOUBLE(1.0, state->work_x[j]);
+    }
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 6.0, state->work_x[n]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, -4.0, state->obj_value - obj_before);
+
+    cxf_simplex_final(state);
+}
+
+void test_simplex_iterate_entering_at_upper_moves_down(void) {
+    /* min x  s.t.  -x <= -1, x in [0, 3], starting at x = 3: x decreases
+     * until the slack s = x - 1 reaches 0, then x is basic at 1 */
+    cxf_addvar(model, 0, NULL, NULL, 1.0, 0.0, 3.0, 'C', "x");
+    int ind[] = {0};
+    double val[] = {-1.0};
+    cxf_addconstr(model, 1, ind, val, '<', -1.0, NULL);
+
+    SolverContext *state = NULL;
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_simplex_init(model, &state));
+    cxf_simplex_setup(state, env);
+
+    BasisState *basis = state->basis;
+    basis->var_status[0] = -2;
+    state->work_x[0] = 3.0;
+    state->work_dj[0] = state->work_obj[0];
+    basis->basic_vars[0] = 1;
+    basis->var_status[1] = 0;
+    basis->diag_coeff[0] = 1.0;
+    state->work_x[1] = 2.0;
+    state->work_dj[1] = 0.0;
+
+    int status = cxf_simplex_iterate(state, env);
+    TEST_ASSERT_EQUAL_INT(0, status);
+    TEST_ASSERT_EQUAL_INT(0, basis->basic_vars[0]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 1.0, state->work_x[0]);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 0.0, state->work_x[1]);
+    TEST_ASSERT_EQUAL_INT(-1, basis->var_status[1]);
+
+    status = cxf_simplex_iterate(state, env);
+    TEST_ASSERT_EQUAL_INT(1, status);  /* Optimal */
+
+    cxf_simplex_final(state);
+}
+
 /* Phase transition tests */
 void test_phase_end_null_args_fail(void) {
     TEST_ASSERT_EQUAL_INT(CXF_ERROR_NULL_ARGUMENT, cxf_simplex_phase_end(NULL, env));
@@ -200,6 +539,12 @@ int main(void) {
     RUN_TEST(test_simplex_iterate_null_args_fail);
     RUN_TEST(test_simplex_iterate_returns_valid_status);
     RUN_TEST(test_simplex_iterate_increments_iteration);
+    RUN_TEST(test_simplex_iterate_updated_reduced_costs_match_full);
+    RUN_TEST(test_simplex_iterate_steepest_edge_weights_match_exact);
+    RUN_TEST(test_simplex_iterate_devex_reference_framework);
+    RUN_TEST(test_simplex_iterate_minor_iterations_match_ftran);
+    RUN_TEST(test_simplex_iterate_boxed_entering_flips_bounds);
+    RUN_TEST(test_simplex_iterate_entering_at_upper_moves_down);
     /* Phase transition tests */
     RUN_TEST(test_phase_end_null_args_fail);
     RUN_TEST(test_phase_end_transitions_to_phase2);
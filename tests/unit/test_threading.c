@@ -6,6 +6,11 @@
 #include "unity.h"
 #include "convexfeld/cxf_types.h"
 #include "convexfeld/cxf_env.h"
+#include "convexfeld/cxf_model.h"
+#include "convexfeld/cxf_pricing.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
 
 /* Forward declarations for threading functions */
 int cxf_get_logical_processors(void);
@@ -15,10 +20,29 @@ int cxf_get_threads(CxfEnv *env);
 void cxf_env_acquire_lock(CxfEnv *env);
 void cxf_leave_critical_section(CxfEnv *env);
 int cxf_generate_seed(void);
+CxfThreadPool *cxf_pool_create(int threads);
+void cxf_pool_free(CxfThreadPool *pool);
+int cxf_pool_size(const CxfThreadPool *pool);
+void cxf_pool_run(CxfThreadPool *pool, int tasks,
+                  void (*fn)(void *arg, int task), void *arg);
 
 /* API functions */
 int cxf_loadenv(CxfEnv **envP, const char *logfilename);
 int cxf_freeenv(CxfEnv *env);
+int cxf_newmodel(CxfEnv *env, CxfModel **modelP, const char *name,
+                 int numvars, double *obj, double *lb, double *ub,
+                 char *vtype, char **varnames);
+int cxf_addconstrs(CxfModel *model, int numconstrs, int numnz,
+                   const int *cbeg, const int *cind, const double *cval,
+                   const char *sense, const double *rhs,
+                   const char **constrnames);
+int cxf_setintparam(CxfEnv *env, const char *paramname, int value);
+int cxf_optimize(CxfModel *model);
+PricingContext *cxf_pricing_create(int num_vars, int max_levels);
+void cxf_pricing_free(PricingContext *ctx);
+int cxf_pricing_candidates(PricingContext *ctx, const double *reduced_costs,
+                           const int *var_status, int num_vars, double tolerance,
+                           int *candidates, int max_candidates);
 
 static CxfEnv *env = NULL;
 
@@ -85,6 +109,12 @@ void test_set_thread_count_caps_at_logical(void) {
     int logical = cxf_get_logical_processors();
     int result = cxf_set_thread_count(env, logical + 100);
     TEST_ASSERT_EQUAL_INT(CXF_OK, result);
+    TEST_ASSERT_EQUAL_INT(logical, cxf_get_threads(env));
+}
+
+void test_set_thread_count_is_stored(void) {
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_set_thread_count(env, 1));
+    TEST_ASSERT_EQUAL_INT(1, cxf_get_threads(env));
 }
 
 /*============================================================================
@@ -141,6 +171,199 @@ void test_generate_seed_varies(void) {
     TEST_ASSERT_FALSE(all_same);
 }
 
+/*============================================================================
+ * Worker pool Tests
+ *===========================================================================*/
+
+#define POOL_TASKS 1000
+
+typedef struct {
+    int runs[POOL_TASKS];
+    int order[POOL_TASKS];
+    int next;
+} PoolRecord;
+
+static void record_task(void *arg, int task) {
+    PoolRecord *rec = (PoolRecord *)arg;
+    rec->runs[task]++;
+    rec->order[rec->next++] = task;  /* Only read for a serial run */
+}
+
+void test_pool_single_thread_is_null(void) {
+    TEST_ASSERT_NULL(cxf_pool_create(1));
+    TEST_ASSERT_EQUAL_INT(1, cxf_pool_size(NULL));
+    cxf_pool_free(NULL);
+}
+
+void test_pool_null_runs_tasks_in_order(void) {
+    static PoolRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    cxf_pool_run(NULL, POOL_TASKS, record_task, &rec);
+    for (int t = 0; t < POOL_TASKS; t++) {
+        TEST_ASSERT_EQUAL_INT(1, rec.runs[t]);
+        TEST_ASSERT_EQUAL_INT(t, rec.order[t]);
+    }
+}
+
+static void count_task(void *arg, int task) {
+    ((int *)arg)[task]++;
+}
+
+void test_pool_runs_every_task_once(void) {
+    /* Pthreads may be missing from the build: a NULL pool runs serially */
+    CxfThreadPool *pool = cxf_pool_create(4);
+    if (pool != NULL) {
+        TEST_ASSERT_EQUAL_INT(4, cxf_pool_size(pool));
+    }
+    static int runs[POOL_TASKS];
+    for (int round = 0; round < 50; round++) {
+        int tasks = 1 + (round * 37) % POOL_TASKS;
+        memset(runs, 0, sizeof(runs));
+        cxf_pool_run(pool, tasks, count_task, runs);
+        for (int t = 0; t < POOL_TASKS; t++) {
+            TEST_ASSERT_EQUAL_INT(t < tasks ? 1 : 0, runs[t]);
+        }
+    }
+    cxf_pool_free(pool);
+}
+
+/*============================================================================
+ * Thread count independence of a solve
+ *===========================================================================*/
+
+#define WIDE_M 40
+#define WIDE_N 9000
+
+/* Few rows, many columns, every column in the last row: the pivot rows
+ * are long enough for the parallel PRICE and d_j updates */
+static CxfModel *make_wide_model(CxfEnv *e) {
+    static double obj[WIDE_N], lb[WIDE_N], ub[WIDE_N];
+    unsigned seed = 12345u;
+    for (int j = 0; j < WIDE_N; j++) {
+        seed = seed * 1103515245u + 12345u;
+        obj[j] = -1.0 - (double)(seed % 1000) / 100.0;
+        lb[j] = 0.0;
+        ub[j] = CXF_INFINITY;
+    }
+    CxfModel *model = NULL;
+    if (cxf_newmodel(e, &model, "wide", WIDE_N, obj, lb, ub, NULL, NULL) != CXF_OK) {
+        return NULL;
+    }
+
+    int cap = (WIDE_M + 1) * WIDE_N;
+    int *beg = malloc((WIDE_M + 1) * sizeof(int));
+    int *ind = malloc((size_t)cap * sizeof(int));
+    double *val = malloc((size_t)cap * sizeof(double));
+    char sense[WIDE_M + 1];
+    double rhs[WIDE_M + 1];
+    int nz = 0;
+    for (int i = 0; i <= WIDE_M; i++) {
+        beg[i] = nz;
+        sense[i] = '<';
+        rhs[i] = (i < WIDE_M) ? 100.0 + i : 1000.0;
+        for (int j = 0; j < WIDE_N; j++) {
+            seed = seed * 1103515245u + 12345u;
+            if (i == WIDE_M || (seed >> 8) % 10 == 0) {
+                ind[nz] = j;
+                val[nz] = (i == WIDE_M) ? 1.0 : 1.0 + (double)((seed >> 4) % 100) / 10.0;
+                nz++;
+            }
+        }
+    }
+    int rc = cxf_addconstrs(model, WIDE_M + 1, nz, beg, ind, val, sense, rhs, NULL);
+    free(beg);
+    free(ind);
+    free(val);
+    if (rc != CXF_OK) {
+        cxf_freemodel(model);
+        return NULL;
+    }
+    return model;
+}
+
+/* Solve the wide model with one thread and with four under the given
+ * SimplexPricing and check that both take the same path */
+static void check_solve_independent_of_thread_count(int pricing) {
+    cxf_setintparam(env, "OutputFlag", 0);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_setintparam(env, "SimplexPricing", pricing));
+    CxfModel *serial = make_wide_model(env);
+    TEST_ASSERT_NOT_NULL(serial);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_set_thread_count(env, 1));
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_optimize(serial));
+    TEST_ASSERT_EQUAL_INT(CXF_OPTIMAL, serial->status);
+
+    /* Four threads even on a smaller machine (cxf_set_thread_count caps) */
+    env->thread_count = 4;
+    CxfModel *parallel = make_wide_model(env);
+    TEST_ASSERT_NOT_NULL(parallel);
+    TEST_ASSERT_EQUAL_INT(CXF_OK, cxf_optimize(parallel));
+    TEST_ASSERT_EQUAL_INT(CXF_OPTIMAL, parallel->status);
+
+    /* Same path: bit-identical objective, primal and dual values */
+    TEST_ASSERT_EQUAL_MEMORY(&serial->obj_val, &parallel->obj_val, sizeof(double));
+    TEST_ASSERT_EQUAL_MEMORY(serial->solution, parallel->solution,
+                             WIDE_N * sizeof(double));
+    TEST_ASSERT_EQUAL_MEMORY(serial->pi, parallel->pi,
+                             (WIDE_M + 1) * sizeof(double));
+
+    cxf_freemodel(serial);
+    cxf_freemodel(parallel);
+}
+
+void test_solve_independent_of_thread_count(void) {
+    check_solve_independent_of_thread_count(-1);
+}
+
+void test_multiple_pricing_independent_of_thread_count(void) {
+    /* Partial pricing: major and minor iterations */
+    check_solve_independent_of_thread_count(0);
+}
+
+#define CAND_N 100000
+#define CAND_MAX 10
+
+void test_candidates_independent_of_pool(void) {
+    double *dj = malloc(CAND_N * sizeof(double));
+    int *status = malloc(CAND_N * sizeof(int));
+    PricingContext *ctx = cxf_pricing_create(CAND_N, 1);
+    TEST_ASSERT_NOT_NULL(dj);
+    TEST_ASSERT_NOT_NULL(status);
+    TEST_ASSERT_NOT_NULL(ctx);
+
+    /* Coarse reduced costs, so that many candidates tie */
+    unsigned seed = 777u;
+    for (int j = 0; j < CAND_N; j++) {
+        seed = seed * 1103515245u + 12345u;
+        status[j] = ((seed >> 8) % 3 == 0) ? 0 : -1 - (int)((seed >> 12) % 3);
+        dj[j] = (double)((int)((seed >> 16) % 41) - 20);
+    }
+
+    int serial[CAND_MAX], parallel[CAND_MAX];
+    int serial_count = cxf_pricing_candidates(ctx, dj, status, CAND_N, 1e-6,
+                                              serial, CAND_MAX);
+    CxfThreadPool *pool = cxf_pool_create(4);
+    ctx->pool = pool;
+    int parallel_count = cxf_pricing_candidates(ctx, dj, status, CAND_N, 1e-6,
+                                                parallel, CAND_MAX);
+    ctx->pool = NULL;
+
+    TEST_ASSERT_EQUAL_INT(CAND_MAX, serial_count);
+    TEST_ASSERT_EQUAL_INT(serial_count, parallel_count);
+    TEST_ASSERT_EQUAL_INT_ARRAY(serial, parallel, CAND_MAX);
+
+    /* Most attractive first, ties by index */
+    for (int k = 1; k < CAND_MAX; k++) {
+        double prev = fabs(dj[serial[k - 1]]);
+        double cur = fabs(dj[serial[k]]);
+        TEST_ASSERT_TRUE(prev > cur || (prev == cur && serial[k - 1] < serial[k]));
+    }
+
+    cxf_pool_free(pool);
+    cxf_pricing_free(ctx);
+    free(status);
+    free(dj);
+}
+
 /*============================================================================
  * Main
  *===========================================================================*/
@@ -162,6 +385,7 @@ int main(void) {
     RUN_TEST(test_set_thread_count_null_env);
     RUN_TEST(test_set_thread_count_invalid);
     RUN_TEST(test_set_thread_count_caps_at_logical);
+    RUN_TEST(test_set_thread_count_is_stored);
 
     /* cxf_get_threads tests */
     RUN_TEST(test_get_threads_null_env_returns_zero);
@@ -176,5 +400,15 @@ int main(void) {
     RUN_TEST(test_generate_seed_non_negative);
     RUN_TEST(test_generate_seed_varies);
 
+    /* Worker pool tests */
+    RUN_TEST(test_pool_single_thread_is_null);
+    RUN_TEST(test_pool_null_runs_tasks_in_order);
+    RUN_TEST(test_pool_runs_every_task_once);
+
+    /* Thread count independence */
+    RUN_TEST(test_solve_independent_of_thread_count);
+    RUN_TEST(test_multiple_pricing_independent_of_thread_count);
+    RUN_TEST(test_candidates_independent_of_pool);
+
     return UNITY_END();
 }
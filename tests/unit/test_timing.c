@@ -13,6 +13,7 @@
 #include "convexfeld/cxf_types.h"
 #include "convexfeld/cxf_timing.h"
 #include "convexfeld/cxf_solver.h"
+#include "convexfeld/cxf_basis.h"
 #include "convexfeld/cxf_env.h"
 #include <math.h>
 #include <string.h>
@@ -23,6 +24,9 @@ void cxf_timing_pivot(SolverContext *state,
                       double ratio_work,
                       double update_work);
 int cxf_timing_refactor(SolverContext *state, CxfEnv *env);
+int cxf_timing_refactor_cause(SolverContext *state, CxfEnv *env);
+void cxf_timing_refactor_done(SolverContext *state, int cause, int updates,
+                              double seconds);
 
 /* API functions */
 int cxf_loadenv(CxfEnv **envP, const char *logfilename);
@@ -44,6 +48,15 @@ void setUp(void) {
         timing.last_elapsed[i] = 0.0;
         timing.avg_time[i] = 0.0;
     }
+
+    timing.refactor_count = 0;
+    for (int i = 0; i < CXF_REFACTOR_NUM_CAUSES; i++) {
+        timing.refactor_causes[i] = 0;
+    }
+    timing.last_refactor_cause = CXF_REFACTOR_NONE;
+    timing.last_refactor_updates = 0;
+    timing.refactor_time = 0.0;
+    timing.basis_repairs = 0;
 }
 
 void tearDown(void) {
@@ -416,6 +429,35 @@ void test_timing_refactor_recommended_iterations(void) {
     cxf_freeenv(env);
 }
 
+void test_timing_refactor_interval_shortened_when_ill_conditioned(void) {
+    CxfEnv *env = NULL;
+    cxf_loadenv(&env, NULL);
+    env->max_eta_count = 1000;
+    env->max_eta_memory = 10000000;
+    env->refactor_interval = 100;
+
+    SolverContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.eta_count = 10;
+    ctx.iteration = 30;
+    ctx.basis_cond = 1e3;
+
+    TEST_ASSERT_EQUAL_INT(CXF_REFACTOR_NONE, cxf_timing_refactor_cause(&ctx, env));
+
+    /* Ill-conditioned: half the interval */
+    ctx.basis_cond = 10.0 * CXF_COND_ILL;
+    TEST_ASSERT_EQUAL_INT(CXF_REFACTOR_NONE, cxf_timing_refactor_cause(&ctx, env));
+    ctx.iteration = 50;
+    TEST_ASSERT_EQUAL_INT(CXF_REFACTOR_INTERVAL, cxf_timing_refactor_cause(&ctx, env));
+
+    /* Severely ill-conditioned: a quarter */
+    ctx.iteration = 25;
+    ctx.basis_cond = 10.0 * CXF_COND_SEVERE;
+    TEST_ASSERT_EQUAL_INT(CXF_REFACTOR_INTERVAL, cxf_timing_refactor_cause(&ctx, env));
+
+    cxf_freeenv(env);
+}
+
 void test_timing_refactor_recommended_ftran_degradation(void) {
     CxfEnv *env = NULL;
     cxf_loadenv(&env, NULL);
@@ -436,6 +478,73 @@ void test_timing_refactor_recommended_ftran_degradation(void) {
     cxf_freeenv(env);
 }
 
+void test_timing_refactor_cost_waits_for_refactor_cost(void) {
+    CxfEnv *env = NULL;
+    cxf_loadenv(&env, NULL);
+    env->refactor_interval = 1000;
+
+    SolverContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.eta_count = 10;
+    ctx.baseline_ftran = 100.0;
+    ctx.ftran_count = 10;
+    ctx.total_ftran_time = 1500.0;  /* Excess over baseline = 500 */
+
+    ctx.refactor_cost = 800.0;
+    TEST_ASSERT_EQUAL_INT(CXF_REFACTOR_NONE, cxf_timing_refactor_cause(&ctx, env));
+
+    ctx.refactor_cost = 400.0;
+    TEST_ASSERT_EQUAL_INT(CXF_REFACTOR_COST, cxf_timing_refactor_cause(&ctx, env));
+    TEST_ASSERT_EQUAL_INT(1, cxf_timing_refactor(&ctx, env));
+
+    cxf_freeenv(env);
+}
+
+void test_timing_refactor_required_accuracy(void) {
+    CxfEnv *env = NULL;
+    cxf_loadenv(&env, NULL);
+
+    SolverContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.pivot_residual = 1e-3;
+
+    /* Fresh factors are not refactored again */
+    TEST_ASSERT_EQUAL_INT(CXF_REFACTOR_NONE, cxf_timing_refactor_cause(&ctx, env));
+
+    ctx.eta_count = 5;
+    TEST_ASSERT_EQUAL_INT(CXF_REFACTOR_ACCURACY, cxf_timing_refactor_cause(&ctx, env));
+    TEST_ASSERT_EQUAL_INT(2, cxf_timing_refactor(&ctx, env));
+
+    cxf_freeenv(env);
+}
+
+void test_timing_refactor_done_records_cause(void) {
+    SolverContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.timing = &timing;
+    ctx.eta_count = 20;
+    ctx.eta_memory = 4096;
+    ctx.ftran_count = 20;
+    ctx.total_ftran_time = 1000.0;
+    ctx.pivot_residual = 1e-3;
+
+    cxf_timing_refactor_done(&ctx, CXF_REFACTOR_COST, 20, 0.25);
+    cxf_timing_refactor_done(&ctx, CXF_REFACTOR_INTERVAL, 50, 0.5);
+
+    TEST_ASSERT_EQUAL_INT(0, ctx.eta_count);
+    TEST_ASSERT_EQUAL_INT64(0, ctx.eta_memory);
+    TEST_ASSERT_EQUAL_INT(0, ctx.ftran_count);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 0.0, ctx.total_ftran_time);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 0.0, ctx.pivot_residual);
+
+    TEST_ASSERT_EQUAL_INT(2, timing.refactor_count);
+    TEST_ASSERT_EQUAL_INT(1, timing.refactor_causes[CXF_REFACTOR_COST]);
+    TEST_ASSERT_EQUAL_INT(1, timing.refactor_causes[CXF_REFACTOR_INTERVAL]);
+    TEST_ASSERT_EQUAL_INT(CXF_REFACTOR_INTERVAL, timing.last_refactor_cause);
+    TEST_ASSERT_EQUAL_INT(50, timing.last_refactor_updates);
+    TEST_ASSERT_DOUBLE_WITHIN(1e-12, 0.75, timing.refactor_time);
+}
+
 /*============================================================================
  * Main
  *===========================================================================*/
@@ -482,7 +591,11 @@ int main(void) {
     RUN_TEST(test_timing_refactor_required_eta_count);
     RUN_TEST(test_timing_refactor_required_eta_memory);
     RUN_TEST(test_timing_refactor_recommended_iterations);
+    RUN_TEST(test_timing_refactor_interval_shortened_when_ill_conditioned);
     RUN_TEST(test_timing_refactor_recommended_ftran_degradation);
+    RUN_TEST(test_timing_refactor_cost_waits_for_refactor_cost);
+    RUN_TEST(test_timing_refactor_required_accuracy);
+    RUN_TEST(test_timing_refactor_done_records_cause);
 
     return UNITY_END();
 }